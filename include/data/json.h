@@ -573,6 +573,11 @@ typedef int (*json_append_bytes_t)(const char *bytes, size_t len,
  * (2) no UTF-8 validation is performed; and
  * (3) only integer numbers are supported (no strtod() in the minimal libc).
  *
+ * Keys are looked up starting with the field after the one decoded
+ * last, so that objects whose keys come in descriptor order, like the
+ * ones written by json_obj_encode(), cost one comparison per key.  For
+ * objects with many fields in another order, see json_obj_parse_indexed().
+ *
  * @param json Pointer to JSON-encoded value to be parsed
  *
  * @param len Length of JSON-encoded value
@@ -581,7 +586,7 @@ typedef int (*json_append_bytes_t)(const char *bytes, size_t len,
  *
  * @param descr_len Number of elements in the descriptor array. Must be less
  * than 31 due to implementation detail reasons (if more fields are
- * necessary, use two descriptors)
+ * necessary, use json_obj_parse64() or two descriptors)
  *
  * @param val Pointer to the struct to hold the decoded values
  *
@@ -592,6 +597,168 @@ int json_obj_parse(char *json, size_t len,
 	const struct json_obj_descr *descr, size_t descr_len,
 	void *val);
 
+/**
+ * @brief Parses the JSON-encoded object pointed to by @a json, with up to
+ * 62 fields
+ *
+ * Same as json_obj_parse(), except that the bitmap of decoded fields is
+ * returned as an int64_t, so that descriptors can have more fields.
+ *
+ * @param json Pointer to JSON-encoded value to be parsed
+ *
+ * @param len Length of JSON-encoded value
+ *
+ * @param descr Pointer to the descriptor array
+ *
+ * @param descr_len Number of elements in the descriptor array. Must be less
+ * than 63.
+ *
+ * @param val Pointer to the struct to hold the decoded values
+ *
+ * @return < 0 if error, bitmap of decoded fields on success (bit 0
+ * is set if first field in the descriptor has been properly decoded, etc).
+ */
+int64_t json_obj_parse64(char *json, size_t len,
+			 const struct json_obj_descr *descr, size_t descr_len,
+			 void *val);
+
+/**
+ * @brief Build the index of a descriptor used by json_obj_parse_indexed()
+ *
+ * The index holds the positions of the fields of @p descr sorted by
+ * name, so that it only needs to be built once for a descriptor, for
+ * instance at initialization, and can be kept with it.
+ *
+ * @param descr Pointer to the descriptor array
+ *
+ * @param descr_len Number of elements in the descriptor array. Must be less
+ * than 63.
+ *
+ * @param index Array of @p descr_len elements to hold the index
+ *
+ * @return 0 on success, -EINVAL if two fields have the same name.
+ */
+int json_obj_descr_index(const struct json_obj_descr *descr,
+			 size_t descr_len, uint8_t *index);
+
+/**
+ * @brief Parses the JSON-encoded object pointed to by @a json, looking
+ * keys up in a sorted index of the descriptor
+ *
+ * Same as json_obj_parse64(), except that a key which is not in the
+ * field after the one decoded last is found with a binary search of
+ * @p index, built with json_obj_descr_index(), instead of comparing it
+ * with every field.  This makes objects with many fields whose keys do
+ * not come in descriptor order faster to decode.  Nested objects are
+ * decoded as with json_obj_parse64().
+ *
+ * @param json Pointer to JSON-encoded value to be parsed
+ *
+ * @param len Length of JSON-encoded value
+ *
+ * @param descr Pointer to the descriptor array
+ *
+ * @param descr_len Number of elements in the descriptor array. Must be less
+ * than 63.
+ *
+ * @param index Index of @p descr built by json_obj_descr_index()
+ *
+ * @param val Pointer to the struct to hold the decoded values
+ *
+ * @return < 0 if error, bitmap of decoded fields on success (bit 0
+ * is set if first field in the descriptor has been properly decoded, etc).
+ */
+int64_t json_obj_parse_indexed(char *json, size_t len,
+			       const struct json_obj_descr *descr,
+			       size_t descr_len, const uint8_t *index,
+			       void *val);
+
+/**
+ * @brief State of a JSON object read in pieces
+ *
+ * See json_obj_stream_init().
+ */
+struct json_obj_stream {
+	char *buf;
+	size_t buf_size;
+	size_t len;
+	int depth;
+	bool in_string;
+	bool escape;
+};
+
+/**
+ * @brief Start reading a JSON object in pieces
+ *
+ * The pieces given to json_obj_stream_feed(), for instance as they are
+ * received from a socket or found in the fragments of a net_buf, are
+ * copied to @p buf until the object is complete.  Finding the end of the
+ * object only looks at each byte once, so the object can then be decoded
+ * with json_obj_stream_parse() without scanning it again for its end.
+ * The decoded strings point into @p buf.
+ *
+ * @param stream Stream state to initialize
+ *
+ * @param buf Buffer to hold the object
+ *
+ * @param buf_size Size of @p buf
+ */
+void json_obj_stream_init(struct json_obj_stream *stream, char *buf,
+			  size_t buf_size);
+
+/**
+ * @brief Feed the next piece of a JSON object
+ *
+ * White space before the object is skipped, and the bytes after its end
+ * are left alone, so that they can be fed to the stream of the next
+ * object.
+ *
+ * @param stream Stream state
+ *
+ * @param data Next bytes of the object
+ *
+ * @param len Number of bytes in @p data
+ *
+ * @return Number of bytes of @p data consumed, 0 once the object is
+ * complete, -EINVAL if the data does not start with an object, or
+ * -ENOMEM if the object does not fit in the buffer.
+ */
+ssize_t json_obj_stream_feed(struct json_obj_stream *stream,
+			     const char *data, size_t len);
+
+/**
+ * @brief Check whether a whole JSON object has been fed to the stream
+ *
+ * @param stream Stream state
+ *
+ * @return true if the closing brace of the object has been fed
+ */
+static inline bool json_obj_stream_complete(
+	const struct json_obj_stream *stream)
+{
+	return stream->len > 0 && stream->depth == 0;
+}
+
+/**
+ * @brief Parse the JSON object fed to a stream
+ *
+ * Same as json_obj_parse64(), on the object held by the stream.
+ *
+ * @param stream Stream state
+ *
+ * @param descr Pointer to the descriptor array
+ *
+ * @param descr_len Number of elements in the descriptor array
+ *
+ * @param val Pointer to the struct to hold the decoded values
+ *
+ * @return -EAGAIN if the object is not complete yet, otherwise the same
+ * as json_obj_parse64()
+ */
+int64_t json_obj_stream_parse(struct json_obj_stream *stream,
+			      const struct json_obj_descr *descr,
+			      size_t descr_len, void *val);
+
 /**
  * @brief Escapes the string so it can be used to encode JSON objects
  *
@@ -52,6 +52,15 @@ extern "C" {
 
 struct disk_operations;
 
+/* Sector cache state of a disk, managed by the disk access layer */
+struct disk_cache_state {
+	uint32_t sector_count;
+	/* Sector following the last read, to detect sequential reads */
+	uint32_t next_sector;
+	bool checked;
+	bool enabled;
+};
+
 struct disk_info {
 	sys_dnode_t node;
 	char *name;
@@ -59,6 +68,61 @@ struct disk_info {
 	/* Disk device associated to this disk.
 	 */
 	const struct device *dev;
+#if defined(CONFIG_DISK_CACHE)
+	struct disk_cache_state cache;
+#endif
+#if defined(CONFIG_DISK_ACCESS_ASYNC)
+	/* Serializes the operations of the disk access thread with the
+	 * synchronous calls, initialized on registration.
+	 */
+	struct k_mutex lock;
+#endif
+};
+
+/* Statistics of the sector cache, shared by all disks */
+struct disk_cache_stats {
+	/* Sectors read from the cache */
+	uint32_t hits;
+	/* Sectors read from the disk on request */
+	uint32_t misses;
+	/* Sectors read from the disk ahead of requests */
+	uint32_t readahead;
+};
+
+/* Operations of asynchronous requests */
+#define DISK_REQ_READ			0
+#define DISK_REQ_WRITE			1
+
+/* Segment of a scatter-gather request */
+struct disk_sg {
+	/* num_sector sectors of data, only read by write requests */
+	void *buf;
+	uint32_t start_sector;
+	uint32_t num_sector;
+};
+
+struct disk_req;
+
+typedef void (*disk_req_cb_t)(struct disk_req *req, int result);
+
+/* Asynchronous request, owned by the disk access layer until completed */
+struct disk_req {
+	/* Reserved for the request queue */
+	void *fifo_reserved;
+	struct disk_info *disk;
+	const struct disk_sg *sg;
+	uint16_t sg_count;
+	/* DISK_REQ_READ or DISK_REQ_WRITE */
+	uint8_t op;
+	/* 0 on success, negative errno code on fail */
+	int result;
+	/* Called from the disk access thread on completion, if not NULL */
+	disk_req_cb_t cb;
+	void *user_data;
+#if defined(CONFIG_POLL)
+	/* Raised with the result on completion, if not NULL */
+	struct k_poll_signal *signal;
+#endif
 };
 
 struct disk_operations {
@@ -69,6 +133,13 @@ struct disk_operations {
 	int (*write)(struct disk_info *disk, const uint8_t *data_buf,
 		     uint32_t start_sector, uint32_t num_sector);
 	int (*ioctl)(struct disk_info *disk, uint8_t cmd, void *buff);
+	/* Optional, transfer several segments of asynchronous requests in
+	 * one operation, so that the driver can merge the adjacent ones.
+	 * Segments which are adjacent both on the disk and in memory are
+	 * already merged.
+	 */
+	int (*transfer)(struct disk_info *disk, uint8_t op,
+			const struct disk_sg *sg, size_t sg_count);
 };
 
 /*
@@ -129,6 +200,44 @@ int disk_access_write(const char *pdrv, const uint8_t *data_buf,
  */
 int disk_access_ioctl(const char *pdrv, uint8_t cmd, void *buff);
 
+/*
+ * @brief Get the statistics of the sector cache
+ *
+ * @param[out] stats  Statistics since boot or the last reset
+ */
+void disk_access_cache_stats_get(struct disk_cache_stats *stats);
+
+/*
+ * @brief Reset the statistics of the sector cache
+ */
+void disk_access_cache_stats_reset(void);
+
+/*
+ * @brief Drop every sector from the sector cache
+ *
+ * Needed if a disk is modified without going through the disk access
+ * layer.
+ */
+void disk_access_cache_invalidate(void);
+
+/*
+ * @brief Submit an asynchronous request
+ *
+ * Requests are done in the order they are submitted, by the disk access
+ * thread. Adjacent segments of successive requests of the same disk and
+ * operation are merged. If a transfer fails, all the requests merged in it
+ * fail. On completion, the result is stored in the request, the callback
+ * is called and the signal is raised. The request and its segments and
+ * buffers must stay valid until then.
+ *
+ * @param[in] pdrv  Disk name
+ * @param[in] req   Request with the operation, the segments and the
+ *                  completion callback or signal
+ *
+ * @return 0 if the request is queued, negative errno code on fail
+ */
+int disk_access_submit(const char *pdrv, struct disk_req *req);
+
 int disk_access_register(struct disk_info *disk);
 
 int disk_access_unregister(struct disk_info *disk);
@@ -30,6 +30,26 @@ extern "C" {
  * @{
  */
 
+/**
+ * @brief Non-volatile Storage garbage collection state
+ *
+ * @param sec_addr Address of the sector being garbage collected
+ * @param addr Address of the next allocation table entry to examine
+ * @param stop_addr Address of the last allocation table entry to examine
+ * @param walk Set while allocation table entries are left to examine
+ * @param active Set while the sector is being garbage collected
+ * @param blocked Set when the next entry to move does not fit in the write
+ * sector
+ */
+struct nvs_gc_state {
+	uint32_t sec_addr;
+	uint32_t addr;
+	uint32_t stop_addr;
+	bool walk;
+	bool active;
+	bool blocked;
+};
+
 /**
  * @brief Non-volatile Storage File system structure
  *
@@ -43,6 +63,14 @@ extern "C" {
  * @param write_block_size Alignment size
  * @param nvs_lock Mutex
  * @param flash_device Flash Device
+ * @param lookup_id Ids in the lookup cache
+ * @param lookup_addr Address of the latest ATE of each cached id
+ * @param lookup_full Set when an id did not fit in the lookup cache
+ * @param sum_bloom Bloom filter of the ids written in the current sector
+ * @param sum_ate_cnt Number of ATEs written in the current sector
+ * @param gc_work Work item of the background garbage collection
+ * @param gc State of the background garbage collection
+ * @param gc_erased Number of erased sectors after the write sector
  */
 struct nvs_fs {
 	off_t offset;		/* filesystem offset in flash */
@@ -57,6 +85,20 @@ struct nvs_fs {
 	struct k_mutex nvs_lock;
 	const struct device *flash_device;
 	const struct flash_parameters *flash_parameters;
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+	uint16_t lookup_id[CONFIG_NVS_LOOKUP_CACHE_SIZE];
+	uint32_t lookup_addr[CONFIG_NVS_LOOKUP_CACHE_SIZE];
+	bool lookup_full;
+#endif
+#ifdef CONFIG_NVS_SECTOR_SUMMARY
+	uint8_t sum_bloom[CONFIG_NVS_SECTOR_SUMMARY_BLOOM_SIZE];
+	uint16_t sum_ate_cnt;
+#endif
+#ifdef CONFIG_NVS_GC_BACKGROUND
+	struct k_delayed_work gc_work;
+	struct nvs_gc_state gc;
+	uint16_t gc_erased;
+#endif
 };
 
 /**
@@ -208,6 +208,11 @@ struct _thread_base {
 	uint8_t cpu_mask;
 #endif
 
+#ifdef CONFIG_SCHED_CPU_QUEUES
+	/* Index of the CPU whose ready queue holds this thread */
+	uint8_t runq_cpu;
+#endif
+
 	/* data returned by APIs */
 	void *swap_data;
 
@@ -4333,12 +4338,32 @@ static inline uint32_t k_mem_slab_num_free_get(struct k_mem_slab *slab)
  * @{
  */
 
+#ifdef CONFIG_HEAP_TCACHE
+#define Z_HEAP_TCACHE_CLASSES (CONFIG_HEAP_TCACHE_MAX_BYTES / 8)
+
+/* Per-CPU cache of free small blocks of a k_heap.  Size class N holds
+ * blocks of at least (N + 1) * 8 usable bytes, chained through their
+ * first word.
+ */
+struct z_heap_tcache {
+	struct k_spinlock lock;
+	void *blocks[Z_HEAP_TCACHE_CLASSES];
+	uint8_t count[Z_HEAP_TCACHE_CLASSES];
+	uint32_t hits;
+	uint32_t misses;
+};
+#endif
+
 /* kernel synchronized heap struct */
 
 struct k_heap {
 	struct sys_heap heap;
 	_wait_q_t wait_q;
 	struct k_spinlock lock;
+#ifdef CONFIG_HEAP_TCACHE
+	struct z_heap_tcache tcache[CONFIG_MP_NUM_CPUS];
+	atomic_t tcache_waiters;
+#endif
 };
 
 /**
@@ -4387,6 +4412,42 @@ void *k_heap_alloc(struct k_heap *h, size_t bytes, k_timeout_t timeout);
  */
 void k_heap_free(struct k_heap *h, void *mem);
 
+#if defined(CONFIG_HEAP_TCACHE) || defined(__DOXYGEN__)
+/** @brief k_heap allocation cache statistics */
+struct k_heap_tcache_stats {
+	/** Allocations served from a per-CPU cache */
+	uint32_t hits;
+	/** Cacheable allocations that had to go to the heap */
+	uint32_t misses;
+	/** Bytes of free blocks currently held in the per-CPU caches */
+	size_t stranded_bytes;
+};
+
+/**
+ * @brief Get k_heap allocation cache statistics
+ *
+ * Sums up the statistics of the per-CPU allocation caches of a heap
+ * (see @option{CONFIG_HEAP_TCACHE}).
+ *
+ * @param h Heap to query
+ * @param stats Structure to fill in
+ */
+void k_heap_tcache_stats_get(struct k_heap *h,
+			     struct k_heap_tcache_stats *stats);
+
+/**
+ * @brief Return all cached blocks of a k_heap
+ *
+ * Frees every block held in the per-CPU allocation caches of the heap
+ * back into it.  This is done automatically when an allocation would
+ * otherwise fail; it is also useful before inspecting the heap, e.g.
+ * with sys_heap_validate().
+ *
+ * @param h Heap to flush
+ */
+void k_heap_tcache_flush(struct k_heap *h);
+#endif
+
 /**
  * @brief Define a static k_heap
  *
@@ -685,6 +685,15 @@ void __printf_like(2, 3) log_from_user(struct log_msg_ids src_level,
  */
 uint32_t z_log_get_s_mask(const char *str, uint32_t nargs);
 
+/**
+ * @brief Check if address is in read only section.
+ *
+ * @param addr Address.
+ *
+ * @return True if address identified within read only section.
+ */
+bool z_log_is_rodata(const void *addr);
+
 /* Internal function used by log_from_user(). */
 __syscall void z_log_string_from_user(uint32_t src_level_val, const char *str);
 
@@ -766,7 +775,7 @@ static inline log_arg_t z_log_do_strdup(uint32_t msk, uint32_t idx,
 
 	if (msk & (1 << idx)) {
 		const char *str = (const char *)param;
-		/* is_rodata(str) is not checked,
+		/* z_log_is_rodata(str) is not checked,
 		 * because log_strdup does it.
 		 * Hence, we will do only optional check
 		 * if already not duplicated.
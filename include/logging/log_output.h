@@ -50,6 +50,11 @@ extern "C" {
  */
 #define LOG_OUTPUT_FLAG_FORMAT_SYST		BIT(7)
 
+/** @brief Flag forcing binary records decoded on the host with a dictionary
+ *         generated from the ELF file.
+ */
+#define LOG_OUTPUT_FLAG_FORMAT_DICT		BIT(8)
+
 /**
  * @brief Prototype of the function processing output data.
  *
@@ -154,6 +159,17 @@ void log_output_hexdump(const struct log_output *log_output,
  */
 void log_output_dropped_process(const struct log_output *log_output, uint32_t cnt);
 
+/** @brief Process dropped messages indication in dictionary format.
+ *
+ * Function writes a binary record with the number of lost log messages, for
+ * outputs using @ref LOG_OUTPUT_FLAG_FORMAT_DICT.
+ *
+ * @param log_output Pointer to the log output instance.
+ * @param cnt        Number of dropped messages.
+ */
+void log_output_dropped_dict_process(const struct log_output *log_output,
+				     uint32_t cnt);
+
 /** @brief Flush output buffer.
  *
  * @param log_output Pointer to the log output instance.
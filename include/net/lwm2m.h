@@ -661,6 +661,79 @@ int lwm2m_engine_get_float64(char *pathstr, float64_value_t *buf);
  */
 int lwm2m_engine_get_objlnk(char *pathstr, struct lwm2m_objlnk *buf);
 
+struct lwm2m_engine_obj_inst;
+struct lwm2m_engine_obj_field;
+struct lwm2m_engine_res;
+struct lwm2m_engine_res_inst;
+
+/**
+ * @brief Pre-resolved resource (instance) path
+ *
+ * Filled in by lwm2m_engine_get_res_handle().  The members are private to
+ * the engine.
+ */
+struct lwm2m_engine_res_handle {
+	struct lwm2m_engine_obj_inst *obj_inst;
+	struct lwm2m_engine_obj_field *obj_field;
+	struct lwm2m_engine_res *res;
+	struct lwm2m_engine_res_inst *res_inst;
+	uint32_t generation;
+	uint16_t obj_id;
+	uint16_t obj_inst_id;
+	uint16_t res_id;
+	uint16_t res_inst_id;
+	uint8_t level;
+};
+
+/**
+ * @brief Resolve a resource (instance) path into a handle
+ *
+ * Use this function once for resources which are set or read often, and
+ * lwm2m_engine_set_by_handle() and lwm2m_engine_get_by_handle() afterwards,
+ * which skip parsing the path and looking up the resource.  Handles stay
+ * valid when object instances are deleted: they look up the resource again
+ * on their next use, and fail if it is gone.  When the resource does not
+ * exist yet, an error is returned but the handle is still filled in, and
+ * looks the resource up on every use until it exists.
+ *
+ * @param[in] pathstr LwM2M path string "obj/obj-inst/res(/res-inst)"
+ * @param[out] handle Resource handle
+ *
+ * @return 0 for success or negative in case of error.
+ */
+int lwm2m_engine_get_res_handle(char *pathstr,
+				struct lwm2m_engine_res_handle *handle);
+
+/**
+ * @brief Set resource (instance) value through a handle
+ *
+ * Behaves as the lwm2m_engine_set_*() function for the type of the
+ * resource.
+ *
+ * @param[in] handle Resource handle from lwm2m_engine_get_res_handle()
+ * @param[in] value Value in the data type of the resource
+ * @param[in] len Size of the value, or the string length for strings
+ *
+ * @return 0 for success or negative in case of error.
+ */
+int lwm2m_engine_set_by_handle(struct lwm2m_engine_res_handle *handle,
+			       void *value, uint16_t len);
+
+/**
+ * @brief Get resource (instance) value through a handle
+ *
+ * Behaves as the lwm2m_engine_get_*() function for the type of the
+ * resource.
+ *
+ * @param[in] handle Resource handle from lwm2m_engine_get_res_handle()
+ * @param[out] buf Buffer to copy data into
+ * @param[in] buflen Length of buffer
+ *
+ * @return 0 for success or negative in case of error.
+ */
+int lwm2m_engine_get_by_handle(struct lwm2m_engine_res_handle *handle,
+			       void *buf, uint16_t buflen);
+
 
 /**
  * @brief Set resource (instance) read callback
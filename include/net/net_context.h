@@ -93,6 +93,20 @@ typedef void (*net_context_recv_cb_t)(struct net_context *context,
 				      int status,
 				      void *user_data);
 
+/**
+ * @typedef net_context_zc_cb_t
+ * @brief Zero-copy send completion callback.
+ *
+ * @details Called once the network stack holds no more references to the
+ * application buffers given to net_context_sendmsg_zc(). For UDP this is
+ * after the packet has been sent, for TCP after the data has been
+ * acknowledged by the peer, or the connection closed. The callback can
+ * run in the TX or RX thread, so it must not block.
+ *
+ * @param user_data The user data given in net_context_sendmsg_zc() call.
+ */
+typedef void (*net_context_zc_cb_t)(void *user_data);
+
 /**
  * @typedef net_context_send_cb_t
  * @brief Network data send callback.
@@ -275,6 +289,10 @@ __net_socket struct net_context {
 		struct k_fifo accept_q;
 	};
 
+#if defined(CONFIG_NET_SOCKETS_EPOLL)
+	/** Interest sets watching this socket */
+	sys_slist_t epoll_watchers;
+#endif /* CONFIG_NET_SOCKETS_EPOLL */
 #endif /* CONFIG_NET_SOCKETS */
 
 #if defined(CONFIG_NET_OFFLOAD)
@@ -974,6 +992,54 @@ int net_context_sendmsg(struct net_context *context,
 			k_timeout_t timeout,
 			void *user_data);
 
+/**
+ * @brief Send application owned data in iovec without copying it.
+ *
+ * @details This works like net_context_sendmsg() but the network buffers
+ * point directly to the memory given in msghdr instead of holding a copy
+ * of it. The application must not modify or free that memory until the
+ * completion callback has been called. If this function returns an error,
+ * the callback is not called and the memory can be reused immediately.
+ * Only UDP and TCP contexts are supported, and a UDP datagram must fit
+ * into the MTU of the network interface. Other contexts return
+ * -EOPNOTSUPP. TCP segments point to the application memory too, so it
+ * is read again when a segment is retransmitted.
+ *
+ * @param context The network context to use.
+ * @param msghdr The data to send
+ * @param flags Flags for the sending.
+ * @param cb Caller-supplied completion callback, can be NULL.
+ * @param timeout How long to wait for network buffers.
+ * @param user_data Caller-supplied user data.
+ *
+ * @return numbers of bytes sent on success, a negative errno otherwise
+ */
+#if defined(CONFIG_NET_CONTEXT_ZEROCOPY)
+int net_context_sendmsg_zc(struct net_context *context,
+			   const struct msghdr *msghdr,
+			   int flags,
+			   net_context_zc_cb_t cb,
+			   k_timeout_t timeout,
+			   void *user_data);
+#else
+static inline int net_context_sendmsg_zc(struct net_context *context,
+					 const struct msghdr *msghdr,
+					 int flags,
+					 net_context_zc_cb_t cb,
+					 k_timeout_t timeout,
+					 void *user_data)
+{
+	ARG_UNUSED(context);
+	ARG_UNUSED(msghdr);
+	ARG_UNUSED(flags);
+	ARG_UNUSED(cb);
+	ARG_UNUSED(timeout);
+	ARG_UNUSED(user_data);
+
+	return -EOPNOTSUPP;
+}
+#endif
+
 /**
  * @brief Receive network data from a peer specified by context.
  *
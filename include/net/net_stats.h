@@ -246,6 +246,20 @@ struct net_stats_tc {
 };
 
 
+/**
+ * @brief Connection handler lookup statistics
+ */
+struct net_stats_conn {
+	/** Number of UDP/TCP packets matched against the handlers */
+	net_stats_t lookups;
+
+	/** Total number of handlers examined by those lookups */
+	net_stats_t depth;
+
+	/** Largest number of handlers examined by a single lookup */
+	net_stats_t max_depth;
+};
+
 /**
  * @brief Power management statistics
  */
@@ -298,6 +312,11 @@ struct net_stats {
 	struct net_stats_udp udp;
 #endif
 
+#if defined(CONFIG_NET_STATISTICS_CONN)
+	/** Connection handler lookup statistics */
+	struct net_stats_conn conn;
+#endif
+
 #if defined(CONFIG_NET_STATISTICS_IPV6_ND)
 	/** IPv6 neighbor discovery statistics */
 	struct net_stats_ipv6_nd ipv6_nd;
@@ -26,6 +26,7 @@
 #include <net/net_ip.h>
 #include <net/dns_resolve.h>
 #include <net/socket_select.h>
+#include <net/socket_epoll.h>
 #include <stdlib.h>
 
 #ifdef __cplusplus
@@ -385,6 +386,72 @@ static inline ssize_t zsock_recv(int sock, void *buf, size_t max_len,
 	return zsock_recvfrom(sock, buf, max_len, flags, NULL, NULL);
 }
 
+#if defined(CONFIG_NET_SOCKETS_ZEROCOPY)
+struct net_buf;
+
+/**
+ * @typedef zsock_zc_cb_t
+ * @brief Zero-copy send completion callback.
+ *
+ * @details Called once the network stack no longer references the
+ * buffers given to zsock_sendmsg_zc(). This is after the data has been
+ * sent (UDP) or acknowledged by the peer (TCP). The callback runs in a
+ * network stack thread and must not block.
+ *
+ * @param user_data The user data given to zsock_sendmsg_zc().
+ */
+typedef void (*zsock_zc_cb_t)(void *user_data);
+
+/**
+ * @brief Send data without copying it
+ *
+ * @details
+ * Works like zsock_sendmsg(), except that the network buffers refer to
+ * the memory described by @p msg directly. That memory must stay valid
+ * and unmodified until @p cb has been called. If the call fails, @p cb
+ * is not called and the memory can be reused at once. Only available to
+ * kernel mode threads, for native UDP and TCP sockets; other sockets
+ * fail with EOPNOTSUPP. A UDP datagram must fit into the MTU of the
+ * network interface.
+ *
+ * @param sock Socket descriptor
+ * @param msg Data to send and optional destination address
+ * @param flags ZSOCK_MSG_DONTWAIT or 0
+ * @param cb Completion callback, can be NULL
+ * @param user_data Passed to @p cb
+ *
+ * @return Number of bytes queued, or -1 with errno set
+ */
+ssize_t zsock_sendmsg_zc(int sock, const struct msghdr *msg, int flags,
+			 zsock_zc_cb_t cb, void *user_data);
+
+/**
+ * @brief Receive data without copying it
+ *
+ * @details
+ * Works like zsock_recvfrom(), except that instead of copying the data
+ * into a caller supplied buffer, the network buffers holding it are
+ * loaned to the caller. On return @p frags points to a fragment chain
+ * holding only payload. A datagram socket returns one whole datagram,
+ * a stream socket the data of one received segment. The caller must
+ * release the chain with net_buf_unref() once done with it, as held
+ * buffers are not available for receiving further packets. ZSOCK_MSG_PEEK
+ * is not supported. Only available to kernel mode threads, for native UDP
+ * and TCP sockets.
+ *
+ * @param sock Socket descriptor
+ * @param frags Set to the received fragment chain, or NULL if no data
+ * @param flags ZSOCK_MSG_DONTWAIT or 0
+ * @param src_addr Source address of a datagram, can be NULL
+ * @param addrlen Length of @p src_addr, value-result argument
+ *
+ * @return Number of bytes in @p frags, 0 at end of stream, or -1 with
+ * errno set
+ */
+ssize_t zsock_recvfrom_zc(int sock, struct net_buf **frags, int flags,
+			  struct sockaddr *src_addr, socklen_t *addrlen);
+#endif /* CONFIG_NET_SOCKETS_ZEROCOPY */
+
 /**
  * @brief Control blocking/non-blocking mode of a socket
  *
@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_INCLUDE_NET_SOCKET_EPOLL_H_
+#define ZEPHYR_INCLUDE_NET_SOCKET_EPOLL_H_
+
+/**
+ * @brief BSD Sockets compatible API
+ * @defgroup bsd_sockets BSD Sockets compatible API
+ * @ingroup networking
+ * @{
+ */
+
+#include <zephyr/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ZSOCK_EPOLL* values are compatible with Linux */
+/** zsock_epoll_ctl: Add a socket to the interest set */
+#define ZSOCK_EPOLL_CTL_ADD 1
+/** zsock_epoll_ctl: Remove a socket from the interest set */
+#define ZSOCK_EPOLL_CTL_DEL 2
+/** zsock_epoll_ctl: Change the events watched on a socket */
+#define ZSOCK_EPOLL_CTL_MOD 3
+
+/** zsock_epoll: Socket is readable, same as ZSOCK_POLLIN */
+#define ZSOCK_EPOLLIN 0x001
+/** zsock_epoll: Socket is writable, same as ZSOCK_POLLOUT */
+#define ZSOCK_EPOLLOUT 0x004
+/** zsock_epoll: Error condition (output value only) */
+#define ZSOCK_EPOLLERR 0x008
+/** zsock_epoll: Connection closed (output value only) */
+#define ZSOCK_EPOLLHUP 0x010
+/** zsock_epoll: Report a socket once per readiness notification */
+#define ZSOCK_EPOLLET (1U << 31)
+
+typedef union zsock_epoll_data {
+	void *ptr;
+	int fd;
+	uint32_t u32;
+	uint64_t u64;
+} zsock_epoll_data_t;
+
+struct zsock_epoll_event {
+	uint32_t events;
+	zsock_epoll_data_t data;
+};
+
+/**
+ * @brief Create an interest set for scalable event notification
+ *
+ * @details
+ * @rst
+ * Creates an interest set to which sockets are added with
+ * :c:func:`zsock_epoll_ctl()`, and which is waited on with
+ * :c:func:`zsock_epoll_wait()`. Unlike :c:func:`zsock_poll()`, the set
+ * is kept between calls and sockets report readiness to it as data
+ * arrives, so a wait only costs time for the sockets which are ready.
+ * The returned descriptor is released with :c:func:`zsock_close()`.
+ * Only native sockets can be added to the set, and the set is only
+ * available to kernel mode threads.
+ * This function is also exposed as ``epoll_create1()``
+ * if :option:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ * @endrst
+ *
+ * @param flags Must be 0
+ *
+ * @return Descriptor of the interest set, or -1 with errno set
+ */
+int zsock_epoll_create(int flags);
+
+/**
+ * @brief Add, modify or remove a socket in an interest set
+ *
+ * @details
+ * @rst
+ * See the Linux ``epoll_ctl()`` manual page for the description.
+ * Sockets are removed from all interest sets when they are closed.
+ * Sockets which cannot report their readiness make the call fail
+ * with EPERM.
+ * This function is also exposed as ``epoll_ctl()``
+ * if :option:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ * @endrst
+ *
+ * @param epfd Interest set descriptor
+ * @param op ZSOCK_EPOLL_CTL_ADD, ZSOCK_EPOLL_CTL_MOD or ZSOCK_EPOLL_CTL_DEL
+ * @param fd Socket descriptor
+ * @param event Events to watch and data to report, ignored for
+ *              ZSOCK_EPOLL_CTL_DEL
+ *
+ * @return 0 on success, or -1 with errno set
+ */
+int zsock_epoll_ctl(int epfd, int op, int fd,
+		    struct zsock_epoll_event *event);
+
+/**
+ * @brief Wait for sockets in an interest set to become ready
+ *
+ * @details
+ * @rst
+ * See the Linux ``epoll_wait()`` manual page for the description.
+ * Sockets are level triggered unless added with ZSOCK_EPOLLET, and
+ * sockets still ready after a wait are reported after the other ready
+ * sockets by the next one.
+ * This function is also exposed as ``epoll_wait()``
+ * if :option:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ * @endrst
+ *
+ * @param epfd Interest set descriptor
+ * @param events Array filled with the ready sockets
+ * @param maxevents Size of @p events
+ * @param timeout Timeout in milliseconds, negative to wait forever
+ *
+ * @return Number of ready sockets, 0 on timeout, or -1 with errno set
+ */
+int zsock_epoll_wait(int epfd, struct zsock_epoll_event *events,
+		     int maxevents, int timeout);
+
+#ifdef CONFIG_NET_SOCKETS_POSIX_NAMES
+
+#define epoll_event zsock_epoll_event
+#define epoll_data_t zsock_epoll_data_t
+
+#define EPOLL_CTL_ADD ZSOCK_EPOLL_CTL_ADD
+#define EPOLL_CTL_DEL ZSOCK_EPOLL_CTL_DEL
+#define EPOLL_CTL_MOD ZSOCK_EPOLL_CTL_MOD
+
+#define EPOLLIN ZSOCK_EPOLLIN
+#define EPOLLOUT ZSOCK_EPOLLOUT
+#define EPOLLERR ZSOCK_EPOLLERR
+#define EPOLLHUP ZSOCK_EPOLLHUP
+#define EPOLLET ZSOCK_EPOLLET
+
+static inline int epoll_create1(int flags)
+{
+	return zsock_epoll_create(flags);
+}
+
+static inline int epoll_ctl(int epfd, int op, int fd,
+			    struct zsock_epoll_event *event)
+{
+	return zsock_epoll_ctl(epfd, op, fd, event);
+}
+
+static inline int epoll_wait(int epfd, struct zsock_epoll_event *events,
+			     int maxevents, int timeout)
+{
+	return zsock_epoll_wait(epfd, events, maxevents, timeout);
+}
+
+#endif /* CONFIG_NET_SOCKETS_POSIX_NAMES */
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* ZEPHYR_INCLUDE_NET_SOCKET_EPOLL_H_ */
@@ -333,6 +333,52 @@ int settings_save_one(const char *name, const void *value, size_t val_len);
  */
 int settings_delete(const char *name);
 
+/**
+ * Start a transaction of settings saves.
+ *
+ * Settings are staged in RAM with @ref settings_save_stage and written to
+ * the storage back-end together by @ref settings_save_commit. The calling
+ * thread holds the settings lock until the transaction is committed or
+ * aborted, so saves from other threads wait for it.
+ *
+ * @return 0 on success, -EBUSY if the thread already started a
+ * transaction, -ENOENT if there is no storage back-end.
+ */
+int settings_save_begin(void);
+
+/**
+ * Stage a setting in the current transaction.
+ *
+ * A setting staged again replaces the staged value. A NULL value, or a
+ * value of length 0, stages the deletion of the setting.
+ *
+ * @param name Name/key of the settings item.
+ * @param value Pointer to the value of the settings item.
+ * @param val_len Length of the value.
+ *
+ * @return 0 on success, -EINVAL if the thread did not start a
+ * transaction, -ENOMEM if the staging buffer is full.
+ */
+int settings_save_stage(const char *name, const void *value, size_t val_len);
+
+/**
+ * Write the staged settings to the storage back-end and end the
+ * transaction.
+ *
+ * Settings are written in one batch, in the order in which they were last
+ * staged, and back-ends skip the values which did not change. Writing
+ * stops at the first error, leaving the settings written before it saved.
+ *
+ * @return 0 on success, -EINVAL if the thread did not start a
+ * transaction, other negative values on back-end errors.
+ */
+int settings_save_commit(void);
+
+/**
+ * Drop the staged settings and end the transaction.
+ */
+void settings_save_abort(void);
+
 /**
  * Call commit for all settings handler. This should apply all
  * settings which has been set, but not applied yet.
@@ -426,7 +472,7 @@ struct settings_store_itf {
 	 */
 
 	int (*csi_save_start)(struct settings_store *cs);
-	/**< Handler called before an export operation.
+	/**< Handler called before an export operation or a transaction.
 	 *
 	 * Parameters:
 	 *  - cs - Corresponding backend handler node
@@ -444,7 +490,7 @@ struct settings_store_itf {
 	 */
 
 	int (*csi_save_end)(struct settings_store *cs);
-	/**< Handler called after an export operation.
+	/**< Handler called after an export operation or a transaction.
 	 *
 	 * Parameters:
 	 *  - cs - Corresponding backend handler node
@@ -141,6 +141,8 @@ enum {
 	ZFD_IOCTL_POLL_PREPARE,
 	ZFD_IOCTL_POLL_UPDATE,
 	ZFD_IOCTL_POLL_OFFLOAD,
+	ZFD_IOCTL_EPOLL_WATCHERS,
+	ZFD_IOCTL_EPOLL_EVENTS,
 };
 
 #ifdef __cplusplus
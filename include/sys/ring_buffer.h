@@ -35,7 +35,9 @@ struct ring_buf {
 						   */
 		} item_mode;
 		struct ring_buf_misc_byte_mode {
-			uint32_t tmp_tail;
+			uint32_t tmp_tail; /**< Claimed tail, or the
+					    * ring_buf_put_mp() state.
+					    */
 			uint32_t tmp_head;
 		} byte_mode;
 	} misc;
@@ -51,9 +53,21 @@ struct ring_buf {
 /**
  * @defgroup ring_buffer_apis Ring Buffer APIs
  * @ingroup kernel_apis
+ *
+ * One producer and one consumer, for example an ISR and a thread, can
+ * use a ring buffer at the same time without any locking: the producer
+ * only updates the tail and the consumer only updates the head, and
+ * each index is published after the data it covers. Byte mode ring
+ * buffers can also be filled by several producers at once using
+ * ring_buf_put_mp().
+ *
  * @{
  */
 
+/** @internal Masking value for a ring buffer of @a size elements. */
+#define Z_RING_BUF_MASK(size) \
+	(((size) & ((size) - 1)) == 0 ? (size) - 1 : 0)
+
 /**
  * @brief Statically define and initialize a high performance ring buffer.
  *
@@ -82,7 +96,8 @@ struct ring_buf {
  * @brief Statically define and initialize a standard ring buffer.
  *
  * This macro establishes a ring buffer of an arbitrary size. A standard
- * ring buffer uses modulo arithmetic operations to maintain itself.
+ * ring buffer uses modulo arithmetic operations to maintain itself,
+ * unless @a size32 happens to be a power of 2.
  *
  * The ring buffer can be accessed outside the module where it is defined
  * using:
@@ -96,13 +111,15 @@ struct ring_buf {
 	static uint32_t _ring_buffer_data_##name[size32]; \
 	struct ring_buf name = { \
 		.size = size32, \
+		.mask = Z_RING_BUF_MASK(size32), \
 		.buf = { .buf32 = _ring_buffer_data_##name} \
 	}
 
 /**
  * @brief Statically define and initialize a ring buffer for byte data.
  *
- * This macro establishes a ring buffer of an arbitrary size.
+ * This macro establishes a ring buffer of an arbitrary size. A power of 2
+ * size lets the ring buffer use masking instead of modulo arithmetic.
  *
  * The ring buffer can be accessed outside the module where it is defined
  * using:
@@ -116,6 +133,7 @@ struct ring_buf {
 	static uint8_t _ring_buffer_data_##name[size8]; \
 	struct ring_buf name = { \
 		.size = size8, \
+		.mask = Z_RING_BUF_MASK(size8), \
 		.buf = { .buf8 = _ring_buffer_data_##name} \
 	}
 
@@ -169,6 +187,57 @@ static inline uint32_t z_ring_buf_custom_space_get(uint32_t size, uint32_t head,
 	return (size - tail) + head - 1U;
 }
 
+/** @brief Read an index updated by the other side of the ring buffer.
+ *
+ * @note Function for internal use.
+ *
+ * The load is ordered before the following accesses to the data area,
+ * so that data covered by the index is seen as written (or read) by
+ * the other side.
+ *
+ * @param idx Address of the head or tail index.
+ *
+ * @return Index value.
+ */
+static inline uint32_t z_ring_buf_load(const uint32_t *idx)
+{
+	return __atomic_load_n(idx, __ATOMIC_ACQUIRE);
+}
+
+/** @brief Publish a new head or tail index.
+ *
+ * @note Function for internal use.
+ *
+ * The store is ordered after the preceding accesses to the data area.
+ *
+ * @param idx Address of the head or tail index.
+ * @param val New index value.
+ */
+static inline void z_ring_buf_store(uint32_t *idx, uint32_t val)
+{
+	__atomic_store_n(idx, val, __ATOMIC_RELEASE);
+}
+
+/** @brief Determine free space between two indexes of a ring buffer.
+ *
+ * @note Function for internal use.
+ *
+ * @param buf  Address of ring buffer.
+ * @param head Ring buffer head.
+ * @param tail Ring buffer tail.
+ *
+ * @return Ring buffer free space (in 32-bit words or bytes).
+ */
+static inline uint32_t z_ring_buf_space(const struct ring_buf *buf,
+					uint32_t head, uint32_t tail)
+{
+	if (likely(buf->mask)) {
+		return (head - tail - 1U) & buf->mask;
+	}
+
+	return z_ring_buf_custom_space_get(buf->size, head, tail);
+}
+
 /**
  * @brief Determine if a ring buffer is empty.
  *
@@ -178,12 +247,16 @@ static inline uint32_t z_ring_buf_custom_space_get(uint32_t size, uint32_t head,
  */
 static inline int ring_buf_is_empty(struct ring_buf *buf)
 {
-	return (buf->head == buf->tail);
+	return (z_ring_buf_load(&buf->head) == z_ring_buf_load(&buf->tail));
 }
 
 /**
  * @brief Reset ring buffer state.
  *
+ * @warning
+ * The ring buffer must not be used by producers or consumers while it
+ * is being reset.
+ *
  * @param buf Address of ring buffer.
  */
 static inline void ring_buf_reset(struct ring_buf *buf)
@@ -202,7 +275,8 @@ static inline void ring_buf_reset(struct ring_buf *buf)
  */
 static inline uint32_t ring_buf_space_get(struct ring_buf *buf)
 {
-	return z_ring_buf_custom_space_get(buf->size, buf->head, buf->tail);
+	return z_ring_buf_space(buf, z_ring_buf_load(&buf->head),
+				z_ring_buf_load(&buf->tail));
 }
 
 /**
@@ -323,7 +397,8 @@ int ring_buf_put_finish(struct ring_buf *buf, uint32_t size);
  * @warning
  * Use cases involving multiple writers to the ring buffer must prevent
  * concurrent write operations, either by preventing all writers from
- * being preempted or by using a mutex to govern writes to the ring buffer.
+ * being preempted, by using a mutex to govern writes to the ring buffer
+ * or by using @ref ring_buf_put_mp instead.
  *
  * @warning
  * Ring buffer instance should not mix byte access and item access
@@ -337,6 +412,36 @@ int ring_buf_put_finish(struct ring_buf *buf, uint32_t size);
  */
 uint32_t ring_buf_put(struct ring_buf *buf, const uint8_t *data, uint32_t size);
 
+/**
+ * @brief Write (copy) data to a ring buffer shared by several producers.
+ *
+ * This routine writes data to a ring buffer @a buf like @ref ring_buf_put,
+ * but any number of threads and ISRs can call it at the same time without
+ * locking. Space is reserved with an atomic operation, and the data
+ * becomes visible to the consumer once every producer which reserved
+ * space before it has finished copying. Unlike @ref ring_buf_put, the
+ * data is either written as a whole or not at all, so that data from
+ * different calls is never interleaved.
+ *
+ * @warning
+ * A ring buffer written with this routine must not be written with
+ * @ref ring_buf_put_claim or @ref ring_buf_put at the same time, and its
+ * size must not exceed 16 MB.
+ *
+ * @warning
+ * Ring buffer instance should not mix byte access and item access
+ * (calls prefixed with ring_buf_item_).
+ *
+ * @param buf Address of ring buffer.
+ * @param data Address of data.
+ * @param size Data size (in bytes).
+ *
+ * @retval Number of bytes written, either @a size or 0 if the ring buffer
+ *	   does not have enough free space.
+ */
+uint32_t ring_buf_put_mp(struct ring_buf *buf, const uint8_t *data,
+			 uint32_t size);
+
 /**
  * @brief Get address of a valid data in a ring buffer.
  *
@@ -118,6 +118,23 @@ void *sys_heap_aligned_alloc(struct sys_heap *h, size_t align, size_t bytes);
  */
 void sys_heap_free(struct sys_heap *h, void *mem);
 
+/** @brief Get the usable size of an allocated block
+ *
+ * Returns the number of bytes that may actually be used at @a mem,
+ * which is at least the size that was requested when it was
+ * allocated, and may be somewhat more due to the heap's internal
+ * chunk granularity.
+ *
+ * @note Only the header of the block itself is read, so this does
+ * not need to be synchronized with other operations on the heap as
+ * long as the caller owns the block.
+ *
+ * @param h Heap from which the block was allocated
+ * @param mem A pointer previously returned from sys_heap_alloc()
+ * @return Usable size of the block, in bytes
+ */
+size_t sys_heap_usable_size(struct sys_heap *h, void *mem);
+
 /** @brief Validate heap integrity
  *
  * Validates the internal integrity of a sys_heap.  Intended for unit
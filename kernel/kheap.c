@@ -8,11 +8,16 @@
 #include <ksched.h>
 #include <wait_q.h>
 #include <init.h>
+#include <string.h>
 
 void k_heap_init(struct k_heap *h, void *mem, size_t bytes)
 {
 	z_waitq_init(&h->wait_q);
 	sys_heap_init(&h->heap, mem, bytes);
+#ifdef CONFIG_HEAP_TCACHE
+	(void)memset(h->tcache, 0, sizeof(h->tcache));
+	atomic_clear(&h->tcache_waiters);
+#endif
 }
 
 static int statics_init(const struct device *unused)
@@ -26,17 +31,242 @@ static int statics_init(const struct device *unused)
 
 SYS_INIT(statics_init, PRE_KERNEL_1, CONFIG_KERNEL_INIT_PRIORITY_OBJECTS);
 
+#ifdef CONFIG_HEAP_TCACHE
+/* Per-CPU allocation caches.
+ *
+ * Small allocations are served from a per-CPU stack of free blocks
+ * for their 8-byte size class.  An empty class is refilled with
+ * CONFIG_HEAP_TCACHE_BATCH blocks under a single acquisition of the
+ * heap lock, and a class holding CONFIG_HEAP_TCACHE_DEPTH blocks
+ * gives back a batch the same way.  To the sys_heap, cached blocks
+ * are simply allocated, so its invariants are unaffected.
+ *
+ * Lock order is cache lock, then heap lock.  A thread about to pend
+ * on the heap first bumps tcache_waiters and then drains every cache;
+ * frees check the counter under their cache lock and bypass the cache
+ * while it is set, so no block can be stranded in a cache while
+ * somebody waits for memory.
+ */
+#define TC_CLASSES Z_HEAP_TCACHE_CLASSES
+
+static inline size_t tc_class_bytes(int cls)
+{
+	return (cls + 1) * 8;
+}
+
+static inline struct z_heap_tcache *tc_lock(struct k_heap *h,
+					    unsigned int *irq,
+					    k_spinlock_key_t *key)
+{
+	struct z_heap_tcache *tc;
+
+	/* Pin ourselves to the CPU before choosing its cache */
+	*irq = arch_irq_lock();
+	tc = &h->tcache[_current_cpu->id];
+	*key = k_spin_lock(&tc->lock);
+
+	return tc;
+}
+
+static inline void tc_unlock(struct z_heap_tcache *tc, unsigned int irq,
+			     k_spinlock_key_t key)
+{
+	k_spin_unlock(&tc->lock, key);
+	arch_irq_unlock(irq);
+}
+
+static inline void *tc_pop(struct z_heap_tcache *tc, int cls)
+{
+	void *mem = tc->blocks[cls];
+
+	tc->blocks[cls] = *(void **)mem;
+	tc->count[cls]--;
+
+	return mem;
+}
+
+static inline void tc_push(struct z_heap_tcache *tc, int cls, void *mem)
+{
+	*(void **)mem = tc->blocks[cls];
+	tc->blocks[cls] = mem;
+	tc->count[cls]++;
+}
+
+static void *tc_alloc(struct k_heap *h, size_t bytes)
+{
+	int cls = (bytes + 7) / 8 - 1;
+	struct z_heap_tcache *tc;
+	k_spinlock_key_t key, hkey;
+	unsigned int irq;
+	void *ret = NULL;
+
+	tc = tc_lock(h, &irq, &key);
+
+	if (tc->count[cls] != 0U) {
+		ret = tc_pop(tc, cls);
+		tc->hits++;
+	} else {
+		tc->misses++;
+
+		hkey = k_spin_lock(&h->lock);
+		ret = sys_heap_alloc(&h->heap, tc_class_bytes(cls));
+		for (int i = 1; ret != NULL && i < CONFIG_HEAP_TCACHE_BATCH;
+		     i++) {
+			void *mem = sys_heap_alloc(&h->heap,
+						   tc_class_bytes(cls));
+
+			if (mem == NULL) {
+				break;
+			}
+			tc_push(tc, cls, mem);
+		}
+		k_spin_unlock(&h->lock, hkey);
+	}
+
+	tc_unlock(tc, irq, key);
+	return ret;
+}
+
+/* Returns true if the block was absorbed by the cache */
+static bool tc_free(struct k_heap *h, void *mem)
+{
+	size_t usable = sys_heap_usable_size(&h->heap, mem);
+	struct z_heap_tcache *tc;
+	k_spinlock_key_t key, hkey;
+	unsigned int irq;
+	bool cached = false;
+	int cls;
+
+	/* Blocks are filed under the largest class they can serve.
+	 * Anything much larger than the biggest class is not worth
+	 * holding on to.
+	 */
+	if (usable < 8 || usable / 8 > TC_CLASSES) {
+		return false;
+	}
+	cls = usable / 8 - 1;
+
+	tc = tc_lock(h, &irq, &key);
+
+	if (atomic_get(&h->tcache_waiters) == 0) {
+		cached = true;
+
+		if (tc->count[cls] < CONFIG_HEAP_TCACHE_DEPTH) {
+			tc_push(tc, cls, mem);
+		} else {
+			hkey = k_spin_lock(&h->lock);
+			sys_heap_free(&h->heap, mem);
+			for (int i = 1; i < CONFIG_HEAP_TCACHE_BATCH; i++) {
+				sys_heap_free(&h->heap, tc_pop(tc, cls));
+			}
+			k_spin_unlock(&h->lock, hkey);
+		}
+	}
+
+	tc_unlock(tc, irq, key);
+	return cached;
+}
+
+/* Frees every cached block back to the heap.  Must be called without
+ * the heap lock held.
+ */
+static void tc_drain(struct k_heap *h)
+{
+	for (int cpu = 0; cpu < CONFIG_MP_NUM_CPUS; cpu++) {
+		struct z_heap_tcache *tc = &h->tcache[cpu];
+		k_spinlock_key_t key = k_spin_lock(&tc->lock);
+		k_spinlock_key_t hkey = k_spin_lock(&h->lock);
+
+		for (int cls = 0; cls < TC_CLASSES; cls++) {
+			while (tc->count[cls] != 0U) {
+				sys_heap_free(&h->heap, tc_pop(tc, cls));
+			}
+		}
+
+		k_spin_unlock(&h->lock, hkey);
+		k_spin_unlock(&tc->lock, key);
+	}
+}
+
+void k_heap_tcache_flush(struct k_heap *h)
+{
+	k_spinlock_key_t key;
+
+	tc_drain(h);
+
+	key = k_spin_lock(&h->lock);
+	if (z_unpend_all(&h->wait_q) != 0) {
+		z_reschedule(&h->lock, key);
+	} else {
+		k_spin_unlock(&h->lock, key);
+	}
+}
+
+void k_heap_tcache_stats_get(struct k_heap *h,
+			     struct k_heap_tcache_stats *stats)
+{
+	stats->hits = 0U;
+	stats->misses = 0U;
+	stats->stranded_bytes = 0U;
+
+	for (int cpu = 0; cpu < CONFIG_MP_NUM_CPUS; cpu++) {
+		struct z_heap_tcache *tc = &h->tcache[cpu];
+		k_spinlock_key_t key = k_spin_lock(&tc->lock);
+
+		stats->hits += tc->hits;
+		stats->misses += tc->misses;
+
+		for (int cls = 0; cls < TC_CLASSES; cls++) {
+			for (void *mem = tc->blocks[cls]; mem != NULL;
+			     mem = *(void **)mem) {
+				stats->stranded_bytes +=
+					sys_heap_usable_size(&h->heap, mem);
+			}
+		}
+
+		k_spin_unlock(&tc->lock, key);
+	}
+}
+#endif /* CONFIG_HEAP_TCACHE */
+
 void *k_heap_alloc(struct k_heap *h, size_t bytes, k_timeout_t timeout)
 {
 	int64_t now, end = z_timeout_end_calc(timeout);
 	void *ret = NULL;
-	k_spinlock_key_t key = k_spin_lock(&h->lock);
+	k_spinlock_key_t key;
 
 	__ASSERT(!arch_is_in_isr() || K_TIMEOUT_EQ(timeout, K_NO_WAIT), "");
 
+#ifdef CONFIG_HEAP_TCACHE
+	bool drained = false;
+
+	if (bytes != 0 && bytes <= CONFIG_HEAP_TCACHE_MAX_BYTES) {
+		ret = tc_alloc(h, bytes);
+		if (ret != NULL) {
+			return ret;
+		}
+	}
+#endif
+
+	key = k_spin_lock(&h->lock);
+
 	while (ret == NULL) {
 		ret = sys_heap_alloc(&h->heap, bytes);
 
+#ifdef CONFIG_HEAP_TCACHE
+		/* Before giving up or pending, reclaim whatever the
+		 * per-CPU caches are holding and try again.
+		 */
+		if (ret == NULL && !drained && bytes != 0) {
+			drained = true;
+			atomic_inc(&h->tcache_waiters);
+			k_spin_unlock(&h->lock, key);
+			tc_drain(h);
+			key = k_spin_lock(&h->lock);
+			continue;
+		}
+#endif
+
 		now = z_tick_get();
 		if ((ret != NULL) || ((end - now) <= 0)) {
 			break;
@@ -47,13 +277,27 @@ void *k_heap_alloc(struct k_heap *h, size_t bytes, k_timeout_t timeout)
 		key = k_spin_lock(&h->lock);
 	}
 
+#ifdef CONFIG_HEAP_TCACHE
+	if (drained) {
+		atomic_dec(&h->tcache_waiters);
+	}
+#endif
+
 	k_spin_unlock(&h->lock, key);
 	return ret;
 }
 
 void k_heap_free(struct k_heap *h, void *mem)
 {
-	k_spinlock_key_t key = k_spin_lock(&h->lock);
+	k_spinlock_key_t key;
+
+#ifdef CONFIG_HEAP_TCACHE
+	if (mem != NULL && tc_free(h, mem)) {
+		return;
+	}
+#endif
+
+	key = k_spin_lock(&h->lock);
 
 	sys_heap_free(&h->heap, mem);
 
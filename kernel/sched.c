@@ -16,6 +16,7 @@
 #include <kernel_internal.h>
 #include <logging/log.h>
 #include <sys/atomic.h>
+#include <sys/math_extras.h>
 LOG_MODULE_DECLARE(os);
 
 /* Maximum time between the time a self-aborting thread flags itself
@@ -181,6 +182,262 @@ static ALWAYS_INLINE struct k_thread *_priq_dumb_mask_best(sys_dlist_t *pq)
 }
 #endif
 
+#ifdef CONFIG_SCHED_CPU_QUEUES
+/* With per-CPU ready queues every runnable thread sits in the queue of
+ * one CPU (recorded in base.runq_cpu), preferably the one it last ran
+ * on so it stays cache-hot there.  A CPU choosing its next thread
+ * takes the best one eligible to run on it across its own queue and
+ * those of its peers, "stealing" from a peer only when that finds
+ * something strictly better than the local choice.  So the global
+ * priority order is kept, but pinned or idle-but-runnable threads of
+ * other CPUs are never walked and IPIs are only sent when a peer
+ * actually has to switch.
+ *
+ * Each queue has its own lock in runq_lock[], taken inside
+ * sched_spinlock by the code changing thread states, and alone by
+ * runq_keep_current().  runq_prio[] holds the priority of the best
+ * thread of each queue, so that peers are compared without locking or
+ * walking their queues.  (The locks are not in struct _ready_q because
+ * kernel_structs.h cannot include spinlock.h.)
+ */
+#define RUNQ_EMPTY_PRIO INT_MAX
+
+static struct k_spinlock runq_lock[CONFIG_MP_NUM_CPUS];
+static atomic_t runq_prio[CONFIG_MP_NUM_CPUS];
+
+static ALWAYS_INLINE bool cpu_allowed(struct k_thread *thread, int cpu)
+{
+#ifdef CONFIG_SCHED_CPU_MASK
+	return (thread->base.cpu_mask & BIT(cpu)) != 0;
+#else
+	return true;
+#endif
+}
+
+/* True if @cpu would switch to @thread were it made runnable now */
+static bool cpu_would_run(struct k_thread *thread, int cpu)
+{
+	struct k_thread *curr = _kernel.cpus[cpu].current;
+
+	if (curr == NULL || !cpu_allowed(thread, cpu)) {
+		return false;
+	}
+
+	return z_is_idle_thread_object(curr) ||
+		(z_is_t1_higher_prio_than_t2(thread, curr) &&
+		 (is_preempt(curr) || is_metairq(thread)));
+}
+
+static int runq_cpu_pick(struct k_thread *thread)
+{
+	int home = thread->base.cpu;
+	int fallback = -1;
+
+	if (home >= CONFIG_MP_NUM_CPUS) {
+		home = _current_cpu->id;
+	}
+
+	if (cpu_would_run(thread, home)) {
+		return home;
+	}
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		if (!cpu_allowed(thread, i)) {
+			continue;
+		}
+		if (fallback < 0) {
+			fallback = i;
+		}
+		if (_kernel.cpus[i].current != NULL &&
+		    z_is_idle_thread_object(_kernel.cpus[i].current)) {
+			return i;
+		}
+	}
+
+	/* A thread with all CPUs masked off is legal per the API (it
+	 * just never runs), park it at home
+	 */
+	return (cpu_allowed(thread, home) || fallback < 0) ? home : fallback;
+}
+
+/* Best thread of a queue, whichever CPUs it may run on */
+static ALWAYS_INLINE struct k_thread *runq_head(struct _ready_q *rq)
+{
+#ifdef CONFIG_SCHED_CPU_MASK
+	return z_priq_dumb_best(&rq->runq);
+#else
+	return _priq_run_best(&rq->runq);
+#endif
+}
+
+/* Called with the queue's lock held after it changed */
+static ALWAYS_INLINE void runq_publish(int cpu)
+{
+	struct k_thread *head = runq_head(&_kernel.cpus[cpu].ready_q);
+
+	atomic_set(&runq_prio[cpu], head != NULL ? head->base.prio
+						 : RUNQ_EMPTY_PRIO);
+}
+
+/* True if a queue whose best thread has priority @prio may hold a
+ * thread to run before one of priority @than.  Deadlines break ties
+ * between equal priorities, which the published priority can't tell.
+ */
+static ALWAYS_INLINE bool runq_prio_beats(int prio, int than)
+{
+	if (IS_ENABLED(CONFIG_SCHED_DEADLINE)) {
+		return prio != RUNQ_EMPTY_PRIO && prio <= than;
+	}
+
+	return prio < than;
+}
+
+static ALWAYS_INLINE void runq_add(struct k_thread *thread)
+{
+	int cpu = runq_cpu_pick(thread);
+	k_spinlock_key_t key = k_spin_lock(&runq_lock[cpu]);
+
+	thread->base.runq_cpu = cpu;
+	_priq_run_add(&_kernel.cpus[cpu].ready_q.runq, thread);
+	runq_publish(cpu);
+	k_spin_unlock(&runq_lock[cpu], key);
+}
+
+static ALWAYS_INLINE void runq_remove(struct k_thread *thread)
+{
+	int cpu = thread->base.runq_cpu;
+	k_spinlock_key_t key = k_spin_lock(&runq_lock[cpu]);
+
+	_priq_run_remove(&_kernel.cpus[cpu].ready_q.runq, thread);
+	runq_publish(cpu);
+	k_spin_unlock(&runq_lock[cpu], key);
+}
+
+/* Best thread eligible to run on this CPU.  A peer's queue is only
+ * locked when its published priority beats the best thread found so
+ * far, which is when a thread may be stolen from it.
+ */
+static ALWAYS_INLINE struct k_thread *runq_best(void)
+{
+	int me = _current_cpu->id;
+	struct k_thread *thread, *peer;
+	k_spinlock_key_t key;
+	int prio;
+
+	key = k_spin_lock(&runq_lock[me]);
+	thread = _priq_run_best(&_current_cpu->ready_q.runq);
+	k_spin_unlock(&runq_lock[me], key);
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		if (i == me) {
+			continue;
+		}
+
+		prio = (thread != NULL) ? thread->base.prio : RUNQ_EMPTY_PRIO;
+		if (!runq_prio_beats(atomic_get(&runq_prio[i]), prio)) {
+			continue;
+		}
+
+		key = k_spin_lock(&runq_lock[i]);
+		peer = _priq_run_best(&_kernel.cpus[i].ready_q.runq);
+		k_spin_unlock(&runq_lock[i], key);
+
+		if (peer != NULL && (thread == NULL ||
+				     z_is_t1_higher_prio_than_t2(peer, thread))) {
+			thread = peer;
+		}
+	}
+
+	return thread;
+}
+
+/* True if next_up() would keep _current on this CPU, found from the
+ * local queue and the priorities published by the peers without
+ * sched_spinlock, so that the exit of most interrupts doesn't take
+ * it.  Anything else goes through next_up().  The thread state is
+ * read unlocked: a CPU suspending or aborting _current, or readying a
+ * thread which should preempt it, sends an IPI or is seen at the next
+ * reschedule point, as when this CPU waited for sched_spinlock.
+ */
+static bool runq_keep_current(void)
+{
+	struct _cpu *cpu = _current_cpu;
+	struct k_thread *curr = cpu->current;
+	struct k_thread *thread;
+	k_spinlock_key_t key;
+	bool preempt;
+
+	if (cpu->pending_abort != NULL || z_is_thread_queued(curr) ||
+	    z_is_thread_prevented_from_running(curr) ||
+	    (curr->base.thread_state & _THREAD_ABORTING) != 0U) {
+		return false;
+	}
+
+#if (CONFIG_NUM_METAIRQ_PRIORITIES > 0) && (CONFIG_NUM_COOP_PRIORITIES > 0)
+	if (cpu->metairq_preempted != NULL) {
+		return false;
+	}
+#endif
+
+	key = k_spin_lock(&runq_lock[cpu->id]);
+	thread = _priq_run_best(&cpu->ready_q.runq);
+	preempt = thread != NULL && z_is_t1_higher_prio_than_t2(thread, curr);
+	k_spin_unlock(&runq_lock[cpu->id], key);
+
+	if (preempt) {
+		return false;
+	}
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		if (i != cpu->id &&
+		    runq_prio_beats(atomic_get(&runq_prio[i]),
+				    curr->base.prio)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static bool need_sched_ipi(struct k_thread *thread)
+{
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		if (i != _current_cpu->id && cpu_would_run(thread, i)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+#else
+static ALWAYS_INLINE void runq_add(struct k_thread *thread)
+{
+	_priq_run_add(&_kernel.ready_q.runq, thread);
+}
+
+static ALWAYS_INLINE void runq_remove(struct k_thread *thread)
+{
+	_priq_run_remove(&_kernel.ready_q.runq, thread);
+}
+
+static ALWAYS_INLINE struct k_thread *runq_best(void)
+{
+	return _priq_run_best(&_kernel.ready_q.runq);
+}
+
+static inline bool need_sched_ipi(struct k_thread *thread)
+{
+	ARG_UNUSED(thread);
+
+	return true;
+}
+
+static inline bool runq_keep_current(void)
+{
+	return false;
+}
+#endif /* CONFIG_SCHED_CPU_QUEUES */
+
 static ALWAYS_INLINE struct k_thread *next_up(void)
 {
 	struct k_thread *thread;
@@ -192,7 +449,7 @@ static ALWAYS_INLINE struct k_thread *next_up(void)
 		return _current_cpu->idle_thread;
 	}
 
-	thread = _priq_run_best(&_kernel.ready_q.runq);
+	thread = runq_best();
 
 #if (CONFIG_NUM_METAIRQ_PRIORITIES > 0) && (CONFIG_NUM_COOP_PRIORITIES > 0)
 	/* MetaIRQs must always attempt to return back to a
@@ -262,16 +519,20 @@ static ALWAYS_INLINE struct k_thread *next_up(void)
 	/* Put _current back into the queue */
 	if (thread != _current && active &&
 		!z_is_idle_thread_object(_current) && !queued) {
-		_priq_run_add(&_kernel.ready_q.runq, _current);
+		runq_add(_current);
 		z_mark_thread_as_queued(_current);
 	}
 
 	/* Take the new _current out of the queue */
 	if (z_is_thread_queued(thread)) {
-		_priq_run_remove(&_kernel.ready_q.runq, thread);
+		runq_remove(thread);
 	}
 	z_mark_thread_as_not_queued(thread);
 
+#ifdef CONFIG_SCHED_CPU_QUEUES
+	thread->base.cpu = _current_cpu->id;
+#endif
+
 	return thread;
 #endif
 }
@@ -279,9 +540,9 @@ static ALWAYS_INLINE struct k_thread *next_up(void)
 static void move_thread_to_end_of_prio_q(struct k_thread *thread)
 {
 	if (z_is_thread_queued(thread)) {
-		_priq_run_remove(&_kernel.ready_q.runq, thread);
+		runq_remove(thread);
 	}
-	_priq_run_add(&_kernel.ready_q.runq, thread);
+	runq_add(thread);
 	z_mark_thread_as_queued(thread);
 	update_cache(thread == _current);
 }
@@ -415,11 +676,13 @@ static void ready_thread(struct k_thread *thread)
 {
 	if (z_is_thread_ready(thread)) {
 		sys_trace_thread_ready(thread);
-		_priq_run_add(&_kernel.ready_q.runq, thread);
+		runq_add(thread);
 		z_mark_thread_as_queued(thread);
 		update_cache(0);
 #if defined(CONFIG_SMP) &&  defined(CONFIG_SCHED_IPI_SUPPORTED)
-		arch_sched_ipi();
+		if (need_sched_ipi(thread)) {
+			arch_sched_ipi();
+		}
 #endif
 	}
 }
@@ -458,7 +721,7 @@ void z_impl_k_thread_suspend(struct k_thread *thread)
 
 	LOCKED(&sched_spinlock) {
 		if (z_is_thread_queued(thread)) {
-			_priq_run_remove(&_kernel.ready_q.runq, thread);
+			runq_remove(thread);
 			z_mark_thread_as_not_queued(thread);
 		}
 		z_mark_thread_as_suspended(thread);
@@ -539,8 +802,7 @@ void z_thread_single_abort(struct k_thread *thread)
 
 		if (z_is_thread_ready(thread)) {
 			if (z_is_thread_queued(thread)) {
-				_priq_run_remove(&_kernel.ready_q.runq,
-						 thread);
+				runq_remove(thread);
 				z_mark_thread_as_not_queued(thread);
 			}
 			update_cache(thread == _current);
@@ -617,7 +879,7 @@ void z_thread_single_abort(struct k_thread *thread)
 static void unready_thread(struct k_thread *thread)
 {
 	if (z_is_thread_queued(thread)) {
-		_priq_run_remove(&_kernel.ready_q.runq, thread);
+		runq_remove(thread);
 		z_mark_thread_as_not_queued(thread);
 	}
 	update_cache(thread == _current);
@@ -775,9 +1037,9 @@ bool z_set_prio(struct k_thread *thread, int prio)
 		if (need_sched) {
 			/* Don't requeue on SMP if it's the running thread */
 			if (!IS_ENABLED(CONFIG_SMP) || z_is_thread_queued(thread)) {
-				_priq_run_remove(&_kernel.ready_q.runq, thread);
+				runq_remove(thread);
 				thread->base.prio = prio;
-				_priq_run_add(&_kernel.ready_q.runq, thread);
+				runq_add(thread);
 			} else {
 				thread->base.prio = prio;
 			}
@@ -902,6 +1164,10 @@ void *z_get_next_switch_handle(void *interrupted)
 	z_check_stack_sentinel();
 
 #ifdef CONFIG_SMP
+	if (runq_keep_current()) {
+		return _current->switch_handle;
+	}
+
 	LOCKED(&sched_spinlock) {
 		struct k_thread *thread = next_up();
 
@@ -1105,14 +1371,14 @@ int z_unpend_all(_wait_q_t *wait_q)
 	return need_sched;
 }
 
-void z_sched_init(void)
+static void init_ready_q(struct _ready_q *rq)
 {
 #ifdef CONFIG_SCHED_DUMB
-	sys_dlist_init(&_kernel.ready_q.runq);
+	sys_dlist_init(&rq->runq);
 #endif
 
 #ifdef CONFIG_SCHED_SCALABLE
-	_kernel.ready_q.runq = (struct _priq_rb) {
+	rq->runq = (struct _priq_rb) {
 		.tree = {
 			.lessthan_fn = z_priq_rb_lessthan,
 		}
@@ -1120,8 +1386,20 @@ void z_sched_init(void)
 #endif
 
 #ifdef CONFIG_SCHED_MULTIQ
-	for (int i = 0; i < ARRAY_SIZE(_kernel.ready_q.runq.queues); i++) {
-		sys_dlist_init(&_kernel.ready_q.runq.queues[i]);
+	for (int i = 0; i < ARRAY_SIZE(rq->runq.queues); i++) {
+		sys_dlist_init(&rq->runq.queues[i]);
+	}
+#endif
+}
+
+void z_sched_init(void)
+{
+	init_ready_q(&_kernel.ready_q);
+
+#ifdef CONFIG_SCHED_CPU_QUEUES
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		init_ready_q(&_kernel.cpus[i].ready_q);
+		atomic_set(&runq_prio[i], RUNQ_EMPTY_PRIO);
 	}
 #endif
 
@@ -1182,8 +1460,8 @@ void z_impl_k_thread_deadline_set(k_tid_t tid, int deadline)
 	LOCKED(&sched_spinlock) {
 		thread->base.prio_deadline = k_cycle_get_32() + deadline;
 		if (z_is_thread_queued(thread)) {
-			_priq_run_remove(&_kernel.ready_q.runq, thread);
-			_priq_run_add(&_kernel.ready_q.runq, thread);
+			runq_remove(thread);
+			runq_add(thread);
 		}
 	}
 }
@@ -1212,10 +1490,9 @@ void z_impl_k_yield(void)
 		LOCKED(&sched_spinlock) {
 			if (!IS_ENABLED(CONFIG_SMP) ||
 			    z_is_thread_queued(_current)) {
-				_priq_run_remove(&_kernel.ready_q.runq,
-						 _current);
+				runq_remove(_current);
 			}
-			_priq_run_add(&_kernel.ready_q.runq, _current);
+			runq_add(_current);
 			z_mark_thread_as_queued(_current);
 			update_cache(1);
 		}
@@ -1394,7 +1671,7 @@ void z_sched_abort(struct k_thread *thread)
 			thread->base.thread_state |= _THREAD_DEAD;
 			k_spin_unlock(&sched_spinlock, key);
 		} else if (z_is_thread_queued(thread)) {
-			_priq_run_remove(&_kernel.ready_q.runq, thread);
+			runq_remove(thread);
 			z_mark_thread_as_not_queued(thread);
 			thread->base.thread_state |= _THREAD_DEAD;
 			k_spin_unlock(&sched_spinlock, key);
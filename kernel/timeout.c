@@ -11,6 +11,7 @@
 #include <syscall_handler.h>
 #include <drivers/timer/system_timer.h>
 #include <sys_clock.h>
+#include <sys/math_extras.h>
 
 #define LOCKED(lck) for (k_spinlock_key_t __i = {},			\
 					  __key = k_spin_lock(lck);	\
@@ -19,8 +20,6 @@
 
 static uint64_t curr_tick;
 
-static sys_dlist_t timeout_list = SYS_DLIST_STATIC_INIT(&timeout_list);
-
 static struct k_spinlock timeout_lock;
 
 #define MAX_WAIT (IS_ENABLED(CONFIG_SYSTEM_CLOCK_SLOPPY_IDLE) \
@@ -41,6 +40,286 @@ static inline int z_vrfy_z_clock_hw_cycles_per_sec_runtime_get(void)
 #endif /* CONFIG_USERSPACE */
 #endif /* CONFIG_TIMER_READS_ITS_FREQUENCY_AT_RUNTIME */
 
+static int32_t elapsed(void)
+{
+	return announce_remaining == 0 ? z_clock_elapsed() : 0U;
+}
+
+/* Timeout queue backends.  Each one provides, all to be called with
+ * timeout_lock held:
+ *
+ * insert_timeout(): queue a timeout expiring @ticks after curr_tick,
+ *     returning true if it is now the first one to expire.
+ * remove_timeout(): unqueue a pending timeout.
+ * first_dticks(): ticks from curr_tick to the first expiry, or -1.
+ * pop_expired(): unqueue and return the first timeout expiring
+ *     within @ticks of curr_tick, storing that distance in @dt.
+ * advance_queue(): move the queue @ticks forward with nothing expiring.
+ * timeout_rem(): ticks left on a timeout, relative to now.
+ */
+#ifdef CONFIG_TIMEOUT_QUEUE_WHEEL
+
+#define WHEEL_BITS CONFIG_TIMEOUT_QUEUE_WHEEL_SLOT_BITS
+#define WHEEL_SLOTS BIT(WHEEL_BITS)
+#define WHEEL_LEVELS CONFIG_TIMEOUT_QUEUE_WHEEL_LEVELS
+#define WHEEL_SPAN_BITS (WHEEL_BITS * WHEEL_LEVELS)
+
+/* Hierarchical timing wheel.  A pending timeout stores its absolute
+ * expiry tick in dticks, and lives on the level given by the most
+ * significant WHEEL_BITS-wide digit in which that expiry differs from
+ * wheel_tick, in the slot given by its own digit at that level.  So
+ * every timeout on a level expires after all of those on the levels
+ * below it, and the lowest occupied slot of the lowest occupied level
+ * holds the next deadline.  Slot lists are only initialized once
+ * their bit in wheel_occupied gets set.  Timeouts beyond the top
+ * level wait, unsorted, on wheel_overflow.
+ */
+static sys_dlist_t wheel_slots[WHEEL_LEVELS][WHEEL_SLOTS];
+static uint64_t wheel_occupied[WHEEL_LEVELS];
+static sys_dlist_t wheel_overflow = SYS_DLIST_STATIC_INIT(&wheel_overflow);
+
+/* Tick the wheel is positioned at.  Equal to curr_tick except while
+ * z_clock_announce() is walking it forward.
+ */
+static uint64_t wheel_tick;
+
+/* Cached earliest pending expiry, UINT64_MAX if the wheel is empty */
+static uint64_t wheel_next;
+static bool wheel_next_valid;
+
+static int wheel_level(uint64_t expiry)
+{
+	uint64_t diff = expiry ^ wheel_tick;
+
+	if (diff < WHEEL_SLOTS) {
+		return 0;
+	}
+
+	return (63 - u64_count_leading_zeros(diff)) / WHEEL_BITS;
+}
+
+static int wheel_slot(uint64_t expiry, int lvl)
+{
+	return (expiry >> (lvl * WHEEL_BITS)) & (WHEEL_SLOTS - 1);
+}
+
+static uint64_t wheel_slot_start(int lvl, int slot)
+{
+	int shift = (lvl + 1) * WHEEL_BITS;
+
+	return ((wheel_tick >> shift) << shift)
+		| ((uint64_t)slot << (lvl * WHEEL_BITS));
+}
+
+static void wheel_insert(struct _timeout *to)
+{
+	int lvl = wheel_level(to->dticks);
+	int slot;
+
+	if (lvl >= WHEEL_LEVELS) {
+		sys_dlist_append(&wheel_overflow, &to->node);
+		return;
+	}
+
+	slot = wheel_slot(to->dticks, lvl);
+	if ((wheel_occupied[lvl] & BIT64(slot)) == 0ULL) {
+		sys_dlist_init(&wheel_slots[lvl][slot]);
+		wheel_occupied[lvl] |= BIT64(slot);
+	}
+	sys_dlist_append(&wheel_slots[lvl][slot], &to->node);
+}
+
+/* Re-files the timeouts of a slot (or of the overflow list) once
+ * wheel_tick has been moved up to its start.
+ */
+static void wheel_cascade(int lvl, int slot)
+{
+	sys_dlist_t pending;
+	sys_dlist_t *list;
+	sys_dnode_t *node;
+
+	sys_dlist_init(&pending);
+
+	if (lvl < WHEEL_LEVELS) {
+		list = &wheel_slots[lvl][slot];
+		wheel_occupied[lvl] &= ~BIT64(slot);
+	} else {
+		list = &wheel_overflow;
+	}
+
+	while ((node = sys_dlist_get(list)) != NULL) {
+		sys_dlist_append(&pending, node);
+	}
+
+	while ((node = sys_dlist_get(&pending)) != NULL) {
+		wheel_insert(CONTAINER_OF(node, struct _timeout, node));
+	}
+}
+
+/* Earliest pending expiry.  The cache is kept up to date by
+ * insert_timeout() and stays valid when a timeout sharing the earliest
+ * level 0 slot is removed, since all timeouts of a level 0 slot expire
+ * on the same tick.  Only removing the last timeout of that slot, or
+ * the earliest timeout of a higher level slot, costs a scan here: of
+ * the lowest occupied slot, which holds only timeouts expiring within
+ * 2^(lvl * WHEEL_BITS) ticks of each other, or of the overflow list
+ * when the wheel itself is empty.
+ */
+static uint64_t wheel_first_expiry(void)
+{
+	sys_dlist_t *list = &wheel_overflow;
+	struct _timeout *t;
+
+	if (wheel_next_valid) {
+		return wheel_next;
+	}
+
+	for (int lvl = 0; lvl < WHEEL_LEVELS; lvl++) {
+		if (wheel_occupied[lvl] != 0ULL) {
+			int slot = u64_count_trailing_zeros(wheel_occupied[lvl]);
+
+			list = &wheel_slots[lvl][slot];
+			if (lvl == 0) {
+				t = CONTAINER_OF(sys_dlist_peek_head(list),
+						 struct _timeout, node);
+				wheel_next = t->dticks;
+				wheel_next_valid = true;
+				return wheel_next;
+			}
+			break;
+		}
+	}
+
+	wheel_next = UINT64_MAX;
+	SYS_DLIST_FOR_EACH_CONTAINER(list, t, node) {
+		wheel_next = MIN(wheel_next, (uint64_t)t->dticks);
+	}
+	wheel_next_valid = true;
+
+	return wheel_next;
+}
+
+static bool insert_timeout(struct _timeout *to, k_ticks_t ticks)
+{
+	to->dticks = curr_tick + ticks;
+	wheel_insert(to);
+
+	if (!wheel_next_valid) {
+		return wheel_first_expiry() == (uint64_t)to->dticks;
+	}
+
+	if ((uint64_t)to->dticks < wheel_next) {
+		wheel_next = to->dticks;
+		return true;
+	}
+
+	return false;
+}
+
+static void remove_timeout(struct _timeout *t)
+{
+	int lvl = wheel_level(t->dticks);
+	bool same_tick_left = false;
+
+	sys_dlist_remove(&t->node);
+
+	if (lvl < WHEEL_LEVELS) {
+		int slot = wheel_slot(t->dticks, lvl);
+
+		if (sys_dlist_is_empty(&wheel_slots[lvl][slot])) {
+			wheel_occupied[lvl] &= ~BIT64(slot);
+		} else {
+			same_tick_left = (lvl == 0);
+		}
+	}
+
+	if ((uint64_t)t->dticks == wheel_next && !same_tick_left) {
+		wheel_next_valid = false;
+	}
+}
+
+static k_ticks_t first_dticks(void)
+{
+	uint64_t next = wheel_first_expiry();
+
+	return next == UINT64_MAX ? -1 : (k_ticks_t)(next - curr_tick);
+}
+
+static struct _timeout *pop_expired(int32_t ticks, int32_t *dt)
+{
+	uint64_t target = curr_tick + ticks;
+
+	for (;;) {
+		uint64_t start;
+		int lvl, slot = 0;
+
+		for (lvl = 0; lvl < WHEEL_LEVELS; lvl++) {
+			if (wheel_occupied[lvl] != 0ULL) {
+				break;
+			}
+		}
+
+		if (lvl < WHEEL_LEVELS) {
+			slot = u64_count_trailing_zeros(wheel_occupied[lvl]);
+			start = wheel_slot_start(lvl, slot);
+		} else if (!sys_dlist_is_empty(&wheel_overflow)) {
+			/* Skip to the top level span of the first far
+			 * timeout rather than walking every span before it
+			 */
+			start = (wheel_first_expiry() >> WHEEL_SPAN_BITS)
+				<< WHEEL_SPAN_BITS;
+		} else {
+			break;
+		}
+
+		if (start > target) {
+			break;
+		}
+
+		/* Nothing expires before the start of this slot, so the
+		 * wheel can jump straight there.  Level 0 slots hold
+		 * timeouts for exactly that tick, higher levels need to
+		 * be spread out over the levels below first.
+		 */
+		wheel_tick = start;
+		if (lvl == 0) {
+			sys_dnode_t *node = sys_dlist_peek_head(
+				&wheel_slots[0][slot]);
+			struct _timeout *t = CONTAINER_OF(node,
+							  struct _timeout,
+							  node);
+
+			*dt = (int32_t)(t->dticks - curr_tick);
+			remove_timeout(t);
+			return t;
+		}
+
+		wheel_cascade(lvl, slot);
+	}
+
+	wheel_tick = target;
+	return NULL;
+}
+
+static void advance_queue(int32_t ticks)
+{
+	/* pop_expired() already moved wheel_tick to the new curr_tick */
+	ARG_UNUSED(ticks);
+}
+
+static k_ticks_t timeout_rem(const struct _timeout *timeout)
+{
+	if (z_is_inactive_timeout(timeout)) {
+		return 0;
+	}
+
+	return timeout->dticks - (k_ticks_t)(curr_tick + elapsed());
+}
+
+#else /* !CONFIG_TIMEOUT_QUEUE_WHEEL */
+
+static sys_dlist_t timeout_list = SYS_DLIST_STATIC_INIT(&timeout_list);
+
 static struct _timeout *first(void)
 {
 	sys_dnode_t *t = sys_dlist_peek_head(&timeout_list);
@@ -55,6 +334,27 @@ static struct _timeout *next(struct _timeout *t)
 	return n == NULL ? NULL : CONTAINER_OF(n, struct _timeout, node);
 }
 
+static bool insert_timeout(struct _timeout *to, k_ticks_t ticks)
+{
+	struct _timeout *t;
+
+	to->dticks = ticks;
+	for (t = first(); t != NULL; t = next(t)) {
+		if (t->dticks > to->dticks) {
+			t->dticks -= to->dticks;
+			sys_dlist_insert(&t->node, &to->node);
+			break;
+		}
+		to->dticks -= t->dticks;
+	}
+
+	if (t == NULL) {
+		sys_dlist_append(&timeout_list, &to->node);
+	}
+
+	return to == first();
+}
+
 static void remove_timeout(struct _timeout *t)
 {
 	if (next(t) != NULL) {
@@ -64,17 +364,62 @@ static void remove_timeout(struct _timeout *t)
 	sys_dlist_remove(&t->node);
 }
 
-static int32_t elapsed(void)
+static k_ticks_t first_dticks(void)
 {
-	return announce_remaining == 0 ? z_clock_elapsed() : 0U;
+	struct _timeout *to = first();
+
+	return to == NULL ? -1 : to->dticks;
+}
+
+static struct _timeout *pop_expired(int32_t ticks, int32_t *dt)
+{
+	struct _timeout *t = first();
+
+	if (t == NULL || t->dticks > ticks) {
+		return NULL;
+	}
+
+	*dt = t->dticks;
+	t->dticks = 0;
+	remove_timeout(t);
+
+	return t;
+}
+
+static void advance_queue(int32_t ticks)
+{
+	if (first() != NULL) {
+		first()->dticks -= ticks;
+	}
+}
+
+/* must be locked */
+static k_ticks_t timeout_rem(const struct _timeout *timeout)
+{
+	k_ticks_t ticks = 0;
+
+	if (z_is_inactive_timeout(timeout)) {
+		return 0;
+	}
+
+	for (struct _timeout *t = first(); t != NULL; t = next(t)) {
+		ticks += t->dticks;
+		if (timeout == t) {
+			break;
+		}
+	}
+
+	return ticks - elapsed();
 }
 
+#endif /* CONFIG_TIMEOUT_QUEUE_WHEEL */
+
 static int32_t next_timeout(void)
 {
-	struct _timeout *to = first();
+	k_ticks_t dt = first_dticks();
 	int32_t ticks_elapsed = elapsed();
-	int32_t ret = to == NULL ? MAX_WAIT
-		: MIN(MAX_WAIT, MAX(0, to->dticks - ticks_elapsed));
+	int32_t ret = dt < 0 ? MAX_WAIT
+		: MIN(MAX_WAIT, MAX(0, dt - ticks_elapsed));
 
 #ifdef CONFIG_TIMESLICING
 	if (_current_cpu->slice_ticks && _current_cpu->slice_ticks < ret) {
@@ -106,23 +451,7 @@ void z_add_timeout(struct _timeout *to, _timeout_func_t fn,
 	ticks = MAX(1, ticks);
 
 	LOCKED(&timeout_lock) {
-		struct _timeout *t;
-
-		to->dticks = ticks + elapsed();
-		for (t = first(); t != NULL; t = next(t)) {
-			if (t->dticks > to->dticks) {
-				t->dticks -= to->dticks;
-				sys_dlist_insert(&t->node, &to->node);
-				break;
-			}
-			to->dticks -= t->dticks;
-		}
-
-		if (t == NULL) {
-			sys_dlist_append(&timeout_list, &to->node);
-		}
-
-		if (to == first()) {
+		if (insert_timeout(to, ticks + elapsed())) {
 			z_clock_set_timeout(next_timeout(), false);
 		}
 	}
@@ -142,25 +471,6 @@ int z_abort_timeout(struct _timeout *to)
 	return ret;
 }
 
-/* must be locked */
-static k_ticks_t timeout_rem(const struct _timeout *timeout)
-{
-	k_ticks_t ticks = 0;
-
-	if (z_is_inactive_timeout(timeout)) {
-		return 0;
-	}
-
-	for (struct _timeout *t = first(); t != NULL; t = next(t)) {
-		ticks += t->dticks;
-		if (timeout == t) {
-			break;
-		}
-	}
-
-	return ticks - elapsed();
-}
-
 k_ticks_t z_timeout_remaining(const struct _timeout *timeout)
 {
 	k_ticks_t ticks = 0;
@@ -224,26 +534,21 @@ void z_clock_announce(int32_t ticks)
 #endif
 
 	k_spinlock_key_t key = k_spin_lock(&timeout_lock);
+	struct _timeout *t;
+	int32_t dt;
 
 	announce_remaining = ticks;
 
-	while (first() != NULL && first()->dticks <= announce_remaining) {
-		struct _timeout *t = first();
-		int dt = t->dticks;
-
+	while ((t = pop_expired(announce_remaining, &dt)) != NULL) {
 		curr_tick += dt;
 		announce_remaining -= dt;
-		t->dticks = 0;
-		remove_timeout(t);
 
 		k_spin_unlock(&timeout_lock, key);
 		t->fn(t);
 		key = k_spin_lock(&timeout_lock);
 	}
 
-	if (first() != NULL) {
-		first()->dticks -= announce_remaining;
-	}
+	advance_queue(announce_remaining);
 
 	curr_tick += announce_remaining;
 	announce_remaining = 0;
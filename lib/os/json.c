@@ -424,9 +424,9 @@ static bool equivalent_types(enum json_tokens type1, enum json_tokens type2)
 	return type1 == type2;
 }
 
-static int obj_parse(struct json_obj *obj,
-		     const struct json_obj_descr *descr, size_t descr_len,
-		     void *val);
+static int64_t obj_parse(struct json_obj *obj,
+			 const struct json_obj_descr *descr, size_t descr_len,
+			 const uint8_t *index, void *val);
 static int arr_parse(struct json_obj *obj,
 		     const struct json_obj_descr *elem_descr,
 		     size_t max_elements, void *field, void *val);
@@ -441,10 +441,13 @@ static int decode_value(struct json_obj *obj,
 	}
 
 	switch (descr->type) {
-	case JSON_TOK_OBJECT_START:
-		return obj_parse(obj, descr->object.sub_descr,
-				 descr->object.sub_descr_len,
-				 field);
+	case JSON_TOK_OBJECT_START: {
+		int64_t ret = obj_parse(obj, descr->object.sub_descr,
+					descr->object.sub_descr_len, NULL,
+					field);
+
+		return (ret < 0) ? ret : 0;
+	}
 	case JSON_TOK_LIST_START:
 		return arr_parse(obj, descr->array.element_descr,
 				 descr->array.n_elements, field, val);
@@ -536,50 +539,142 @@ static int arr_parse(struct json_obj *obj,
 	return -EINVAL;
 }
 
-static int obj_parse(struct json_obj *obj, const struct json_obj_descr *descr,
-		     size_t descr_len, void *val)
+/* Order of the descriptors in an index: shorter names first, so that
+ * most keys are told apart by their length.
+ */
+static int descr_cmp(const struct json_obj_descr *descr,
+		     const char *key, size_t key_len)
+{
+	if (key_len != descr->field_name_len) {
+		return (key_len < descr->field_name_len) ? -1 : 1;
+	}
+
+	return memcmp(key, descr->field_name, key_len);
+}
+
+static int find_field(const struct json_obj_descr *descr, size_t descr_len,
+		      const uint8_t *index, size_t start,
+		      int64_t decoded_fields,
+		      const struct json_obj_key_value *kv)
+{
+	size_t i, n, lo, hi, mid;
+	int cmp;
+
+	if (index == NULL) {
+		/* Keys usually come in descriptor order, so look for the
+		 * key in the field after the last decoded one first.
+		 */
+		for (n = 0, i = start; n < descr_len; n++, i++) {
+			if (i == descr_len) {
+				i = 0;
+			}
+
+			/* Field has been decoded already, skip */
+			if (decoded_fields & ((int64_t)1 << i)) {
+				continue;
+			}
+
+			if (!descr_cmp(&descr[i], kv->key, kv->key_len)) {
+				return i;
+			}
+		}
+
+		return -1;
+	}
+
+	/* Keys in descriptor order still match the next field at once */
+	if (start < descr_len &&
+	    !(decoded_fields & ((int64_t)1 << start)) &&
+	    !descr_cmp(&descr[start], kv->key, kv->key_len)) {
+		return start;
+	}
+
+	lo = 0;
+	hi = descr_len;
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		i = index[mid];
+
+		cmp = descr_cmp(&descr[i], kv->key, kv->key_len);
+		if (cmp == 0) {
+			return (decoded_fields & ((int64_t)1 << i)) ? -1 : i;
+		}
+
+		if (cmp < 0) {
+			hi = mid;
+		} else {
+			lo = mid + 1;
+		}
+	}
+
+	return -1;
+}
+
+static int64_t obj_parse(struct json_obj *obj,
+			 const struct json_obj_descr *descr, size_t descr_len,
+			 const uint8_t *index, void *val)
 {
 	struct json_obj_key_value kv;
-	int32_t decoded_fields = 0;
-	size_t i;
-	int ret;
+	int64_t decoded_fields = 0;
+	size_t start = 0;
+	void *decode_field;
+	int i, ret;
 
 	while (!obj_next(obj, &kv)) {
 		if (kv.value.type == JSON_TOK_OBJECT_END) {
 			return decoded_fields;
 		}
 
-		for (i = 0; i < descr_len; i++) {
-			void *decode_field = (char *)val + descr[i].offset;
+		i = find_field(descr, descr_len, index, start, decoded_fields,
+			       &kv);
+		if (i < 0) {
+			continue;
+		}
 
-			/* Field has been decoded already, skip */
-			if (decoded_fields & (1 << i)) {
-				continue;
-			}
+		/* Store the decoded value */
+		decode_field = (char *)val + descr[i].offset;
+		ret = decode_value(obj, &descr[i], &kv.value, decode_field,
+				   val);
+		if (ret < 0) {
+			return ret;
+		}
 
-			/* Check if it's the i-th field */
-			if (kv.key_len != descr[i].field_name_len) {
-				continue;
-			}
+		decoded_fields |= (int64_t)1 << i;
+		start = i + 1;
+	}
 
-			if (memcmp(kv.key, descr[i].field_name,
-				   descr[i].field_name_len)) {
-				continue;
+	return -EINVAL;
+}
+
+int json_obj_descr_index(const struct json_obj_descr *descr,
+			 size_t descr_len, uint8_t *index)
+{
+	size_t i, j;
+	int cmp;
+
+	__ASSERT_NO_MSG(descr_len < (sizeof(int64_t) * CHAR_BIT - 1));
+
+	/* Insertion sort, an index is built once for a descriptor */
+	for (i = 0; i < descr_len; i++) {
+		for (j = i; j > 0; j--) {
+			cmp = descr_cmp(&descr[index[j - 1]],
+					descr[i].field_name,
+					descr[i].field_name_len);
+			if (cmp == 0) {
+				return -EINVAL;
 			}
 
-			/* Store the decoded value */
-			ret = decode_value(obj, &descr[i], &kv.value,
-					   decode_field, val);
-			if (ret < 0) {
-				return ret;
+			if (cmp > 0) {
+				break;
 			}
 
-			decoded_fields |= 1<<i;
-			break;
+			index[j] = index[j - 1];
 		}
+
+		index[j] = i;
 	}
 
-	return -EINVAL;
+	return 0;
 }
 
 int json_obj_parse(char *payload, size_t len,
@@ -596,7 +691,120 @@ int json_obj_parse(char *payload, size_t len,
 		return ret;
 	}
 
-	return obj_parse(&obj, descr, descr_len, val);
+	/* With fewer than 31 fields the bitmap fits in an int */
+	return (int)obj_parse(&obj, descr, descr_len, NULL, val);
+}
+
+int64_t json_obj_parse64(char *payload, size_t len,
+			 const struct json_obj_descr *descr, size_t descr_len,
+			 void *val)
+{
+	struct json_obj obj;
+	int64_t ret;
+
+	__ASSERT_NO_MSG(descr_len < (sizeof(ret) * CHAR_BIT - 1));
+
+	ret = obj_init(&obj, payload, len);
+	if (ret < 0) {
+		return ret;
+	}
+
+	return obj_parse(&obj, descr, descr_len, NULL, val);
+}
+
+int64_t json_obj_parse_indexed(char *payload, size_t len,
+			       const struct json_obj_descr *descr,
+			       size_t descr_len, const uint8_t *index,
+			       void *val)
+{
+	struct json_obj obj;
+	int64_t ret;
+
+	__ASSERT_NO_MSG(descr_len < (sizeof(ret) * CHAR_BIT - 1));
+
+	ret = obj_init(&obj, payload, len);
+	if (ret < 0) {
+		return ret;
+	}
+
+	return obj_parse(&obj, descr, descr_len, index, val);
+}
+
+void json_obj_stream_init(struct json_obj_stream *stream, char *buf,
+			  size_t buf_size)
+{
+	stream->buf = buf;
+	stream->buf_size = buf_size;
+	stream->len = 0;
+	stream->depth = 0;
+	stream->in_string = false;
+	stream->escape = false;
+}
+
+ssize_t json_obj_stream_feed(struct json_obj_stream *stream,
+			     const char *data, size_t len)
+{
+	size_t i;
+
+	for (i = 0; i < len && !json_obj_stream_complete(stream); i++) {
+		char chr = data[i];
+
+		if (stream->len == 0) {
+			if (isspace((unsigned char)chr)) {
+				continue;
+			}
+
+			if (chr != '{') {
+				return -EINVAL;
+			}
+		}
+
+		if (stream->len == stream->buf_size) {
+			return -ENOMEM;
+		}
+
+		stream->buf[stream->len++] = chr;
+
+		if (stream->in_string) {
+			if (stream->escape) {
+				stream->escape = false;
+			} else if (chr == '\\') {
+				stream->escape = true;
+			} else if (chr == '"') {
+				stream->in_string = false;
+			}
+
+			continue;
+		}
+
+		switch (chr) {
+		case '"':
+			stream->in_string = true;
+			break;
+		case '{':
+		case '[':
+			stream->depth++;
+			break;
+		case '}':
+		case ']':
+			stream->depth--;
+			break;
+		}
+	}
+
+	return i;
+}
+
+int64_t json_obj_stream_parse(struct json_obj_stream *stream,
+			      const struct json_obj_descr *descr,
+			      size_t descr_len, void *val)
+{
+	if (!json_obj_stream_complete(stream)) {
+		return -EAGAIN;
+	}
+
+	return json_obj_parse64(stream->buf, stream->len, descr, descr_len,
+				val);
 }
 
 static char escape_as(char chr)
@@ -21,6 +21,25 @@ struct ring_element {
 	uint32_t  value  :8;  /**< Room for small integral values */
 };
 
+/** @brief Wraps index if it exceeds the limit.
+ *
+ * Power of 2 sized buffers are wrapped with a mask, other buffers rely on
+ * @a val being less than twice the buffer size.
+ *
+ * @param buf  Address of ring buffer.
+ * @param val  Value
+ *
+ * @return value % buffer size.
+ */
+static inline uint32_t wrap(struct ring_buf *buf, uint32_t val)
+{
+	if (likely(buf->mask)) {
+		return val & buf->mask;
+	}
+
+	return val >= buf->size ? (val - buf->size) : val;
+}
+
 int ring_buf_item_put(struct ring_buf *buf, uint16_t type, uint8_t value,
 		      uint32_t *data, uint8_t size32)
 {
@@ -34,19 +53,12 @@ int ring_buf_item_put(struct ring_buf *buf, uint16_t type, uint8_t value,
 		header->length = size32;
 		header->value = value;
 
-		if (likely(buf->mask)) {
-			for (i = 0U; i < size32; ++i) {
-				index = (i + buf->tail + 1) & buf->mask;
-				buf->buf.buf32[index] = data[i];
-			}
-			buf->tail = (buf->tail + size32 + 1) & buf->mask;
-		} else {
-			for (i = 0U; i < size32; ++i) {
-				index = (i + buf->tail + 1) % buf->size;
-				buf->buf.buf32[index] = data[i];
-			}
-			buf->tail = (buf->tail + size32 + 1) % buf->size;
+		for (i = 0U; i < size32; ++i) {
+			index = wrap(buf, i + buf->tail + 1);
+			buf->buf.buf32[index] = data[i];
 		}
+
+		z_ring_buf_store(&buf->tail, wrap(buf, buf->tail + size32 + 1));
 		rc = 0U;
 	} else {
 		buf->misc.item_mode.dropped_put_count++;
@@ -77,41 +89,23 @@ int ring_buf_item_get(struct ring_buf *buf, uint16_t *type, uint8_t *value,
 	*type = header->type;
 	*value = header->value;
 
-	if (likely(buf->mask)) {
-		for (i = 0U; i < header->length; ++i) {
-			index = (i + buf->head + 1) & buf->mask;
-			data[i] = buf->buf.buf32[index];
-		}
-		buf->head = (buf->head + header->length + 1) & buf->mask;
-	} else {
-		for (i = 0U; i < header->length; ++i) {
-			index = (i + buf->head + 1) % buf->size;
-			data[i] = buf->buf.buf32[index];
-		}
-		buf->head = (buf->head + header->length + 1) % buf->size;
+	for (i = 0U; i < header->length; ++i) {
+		index = wrap(buf, i + buf->head + 1);
+		data[i] = buf->buf.buf32[index];
 	}
 
-	return 0;
-}
+	z_ring_buf_store(&buf->head,
+			 wrap(buf, buf->head + header->length + 1));
 
-/** @brief Wraps index if it exceeds the limit.
- *
- * @param val  Value
- * @param max  Max.
- *
- * @return value % max.
- */
-static inline uint32_t wrap(uint32_t val, uint32_t max)
-{
-	return val >= max ? (val - max) : val;
+	return 0;
 }
 
 uint32_t ring_buf_put_claim(struct ring_buf *buf, uint8_t **data, uint32_t size)
 {
 	uint32_t space, trail_size, allocated;
 
-	space = z_ring_buf_custom_space_get(buf->size, buf->head,
-					    buf->misc.byte_mode.tmp_tail);
+	space = z_ring_buf_space(buf, z_ring_buf_load(&buf->head),
+				 buf->misc.byte_mode.tmp_tail);
 
 	/* Limit requested size to available size. */
 	size = MIN(size, space);
@@ -122,19 +116,22 @@ uint32_t ring_buf_put_claim(struct ring_buf *buf, uint8_t **data, uint32_t size)
 
 	*data = &buf->buf.buf8[buf->misc.byte_mode.tmp_tail];
 	buf->misc.byte_mode.tmp_tail =
-		wrap(buf->misc.byte_mode.tmp_tail + allocated, buf->size);
+		wrap(buf, buf->misc.byte_mode.tmp_tail + allocated);
 
 	return allocated;
 }
 
 int ring_buf_put_finish(struct ring_buf *buf, uint32_t size)
 {
+	uint32_t tail;
+
 	if (size > ring_buf_space_get(buf)) {
 		return -EINVAL;
 	}
 
-	buf->tail = wrap(buf->tail + size, buf->size);
-	buf->misc.byte_mode.tmp_tail = buf->tail;
+	tail = wrap(buf, buf->tail + size);
+	z_ring_buf_store(&buf->tail, tail);
+	buf->misc.byte_mode.tmp_tail = tail;
 
 	return 0;
 }
@@ -160,14 +157,66 @@ uint32_t ring_buf_put(struct ring_buf *buf, const uint8_t *data, uint32_t size)
 	return total_size;
 }
 
+/* With multiple producers tmp_tail holds the number of producers still
+ * copying data in its upper bits, and the index up to which space has
+ * been reserved in its lower bits. Both are updated together, so that
+ * the last producer to finish knows that everything reserved so far has
+ * been written and can be published.
+ */
+#define MP_INDEX_BITS 24
+#define MP_WRITER BIT(MP_INDEX_BITS)
+#define MP_INDEX_MASK (MP_WRITER - 1)
+
+uint32_t ring_buf_put_mp(struct ring_buf *buf, const uint8_t *data,
+			 uint32_t size)
+{
+	atomic_t *state = (atomic_t *)&buf->misc.byte_mode.tmp_tail;
+	atomic_val_t old;
+	uint32_t start, space, trail_size;
+
+	__ASSERT_NO_MSG(buf->size <= MP_WRITER);
+
+	do {
+		old = atomic_get(state);
+		start = (uint32_t)old & MP_INDEX_MASK;
+		space = z_ring_buf_space(buf, z_ring_buf_load(&buf->head),
+					 start);
+		if (size > space || size == 0U) {
+			return 0;
+		}
+	} while (!atomic_cas(state, old,
+			     (uint32_t)old + MP_WRITER - start +
+			     wrap(buf, start + size)));
+
+	trail_size = buf->size - start;
+	if (size <= trail_size) {
+		memcpy(&buf->buf.buf8[start], data, size);
+	} else {
+		memcpy(&buf->buf.buf8[start], data, trail_size);
+		memcpy(buf->buf.buf8, data + trail_size, size - trail_size);
+	}
+
+	/* While other producers are still copying, the data reserved after
+	 * theirs cannot be published yet; the last one out publishes it.
+	 */
+	do {
+		old = atomic_get(state);
+		if (((uint32_t)old & ~MP_INDEX_MASK) == MP_WRITER) {
+			z_ring_buf_store(&buf->tail,
+					 (uint32_t)old & MP_INDEX_MASK);
+		}
+	} while (!atomic_cas(state, old, (uint32_t)old - MP_WRITER));
+
+	return size;
+}
+
 uint32_t ring_buf_get_claim(struct ring_buf *buf, uint8_t **data, uint32_t size)
 {
 	uint32_t space, granted_size, trail_size;
 
 	space = (buf->size - 1) -
-		z_ring_buf_custom_space_get(buf->size,
-					    buf->misc.byte_mode.tmp_head,
-					    buf->tail);
+		z_ring_buf_space(buf, buf->misc.byte_mode.tmp_head,
+				 z_ring_buf_load(&buf->tail));
 	trail_size = buf->size - buf->misc.byte_mode.tmp_head;
 
 	/* Limit requested size to available size. */
@@ -178,7 +227,7 @@ uint32_t ring_buf_get_claim(struct ring_buf *buf, uint8_t **data, uint32_t size)
 
 	*data = &buf->buf.buf8[buf->misc.byte_mode.tmp_head];
 	buf->misc.byte_mode.tmp_head =
-		wrap(buf->misc.byte_mode.tmp_head + granted_size, buf->size);
+		wrap(buf, buf->misc.byte_mode.tmp_head + granted_size);
 
 	return granted_size;
 }
@@ -186,13 +235,15 @@ uint32_t ring_buf_get_claim(struct ring_buf *buf, uint8_t **data, uint32_t size)
 int ring_buf_get_finish(struct ring_buf *buf, uint32_t size)
 {
 	uint32_t allocated = (buf->size - 1) - ring_buf_space_get(buf);
+	uint32_t head;
 
 	if (size > allocated) {
 		return -EINVAL;
 	}
 
-	buf->head = wrap(buf->head + size, buf->size);
-	buf->misc.byte_mode.tmp_head = buf->head;
+	head = wrap(buf, buf->head + size);
+	z_ring_buf_store(&buf->head, head);
+	buf->misc.byte_mode.tmp_head = head;
 
 	return 0;
 }
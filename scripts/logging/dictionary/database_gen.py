@@ -0,0 +1,135 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2020 The Zephyr Project Contributors
+#
+# SPDX-License-Identifier: Apache-2.0
+"""
+Generate the database used to decode dictionary based logs
+
+With CONFIG_LOG_DICTIONARY_SUPPORT, backends send the addresses of the
+format strings and of the source names instead of the strings themselves.
+This script extracts what is needed to turn them back into text from the
+ELF file: the byte order and the pointer size of the target, the names of
+the log sources in the order of their IDs, and the content of the read only
+sections, in which the format strings and the constant string arguments
+are found.
+
+The database is a JSON file read by log_parser.py.
+"""
+
+import argparse
+import json
+import sys
+
+from elftools.elf.constants import SH_FLAGS
+from elftools.elf.elffile import ELFFile
+from elftools.elf.sections import SymbolTableSection
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+
+    parser.add_argument("elffile", help="Zephyr ELF binary")
+    parser.add_argument("dbfile", help="Output dictionary database (JSON)")
+
+    return parser.parse_args()
+
+
+def read_only_sections(elf):
+    """Yield the allocated, non writable sections which hold data"""
+    for section in elf.iter_sections():
+        flags = section['sh_flags']
+
+        if section['sh_type'] != 'SHT_PROGBITS':
+            continue
+
+        if not flags & SH_FLAGS.SHF_ALLOC or flags & SH_FLAGS.SHF_WRITE:
+            continue
+
+        if section['sh_size'] == 0:
+            continue
+
+        yield section
+
+
+def read_string(sections, addr):
+    for section in sections:
+        start = section['sh_addr']
+        data = section.data()
+
+        if start <= addr < start + len(data):
+            end = data.find(b'\0', addr - start)
+            if end < 0:
+                end = len(data)
+
+            return data[addr - start:end].decode('utf-8', 'replace')
+
+    return None
+
+
+def log_sources(elf, sections):
+    """Return the source names, indexed by source ID"""
+    symtab = elf.get_section_by_name('.symtab')
+    if not isinstance(symtab, SymbolTableSection):
+        sys.exit("no symbol table in the ELF file")
+
+    start = end = None
+    stride = 0
+
+    for sym in symtab.iter_symbols():
+        if sym.name == '__log_const_start':
+            start = sym['st_value']
+        elif sym.name == '__log_const_end':
+            end = sym['st_value']
+        elif sym.name.startswith('log_const_') and sym['st_size']:
+            stride = sym['st_size']
+
+    if start is None or end is None or stride == 0:
+        return []
+
+    ptr_size = elf.elfclass // 8
+    byteorder = 'little' if elf.little_endian else 'big'
+    names = []
+
+    for section in elf.iter_sections():
+        base = section['sh_addr']
+        if section['sh_type'] == 'SHT_NOBITS' or \
+           not base <= start < base + section['sh_size']:
+            continue
+
+        data = section.data()
+        for addr in range(start, end, stride):
+            offset = addr - base
+            name = int.from_bytes(data[offset:offset + ptr_size], byteorder)
+            names.append(read_string(sections, name) or hex(name))
+
+        break
+
+    return names
+
+
+def main():
+    args = parse_args()
+
+    with open(args.elffile, 'rb') as f:
+        elf = ELFFile(f)
+        sections = list(read_only_sections(elf))
+
+        database = {
+            'little_endian': elf.little_endian,
+            'pointer_size': elf.elfclass // 8,
+            'sources': log_sources(elf, sections),
+            'sections': [{
+                'name': section.name,
+                'address': section['sh_addr'],
+                'data': section.data().hex(),
+            } for section in sections],
+        }
+
+    with open(args.dbfile, 'w') as f:
+        json.dump(database, f)
+
+
+if __name__ == "__main__":
+    main()
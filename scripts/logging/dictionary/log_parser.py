@@ -0,0 +1,244 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2020 The Zephyr Project Contributors
+#
+# SPDX-License-Identifier: Apache-2.0
+"""
+Decode dictionary based logs
+
+Reads the binary output of a backend using LOG_OUTPUT_FLAG_FORMAT_DICT
+(see subsys/logging/log_output_dict.c for the record format) from a file,
+a serial port or stdin, and prints the messages using the database which
+database_gen.py generated from the ELF file.
+"""
+
+import argparse
+import json
+import re
+import struct
+import sys
+
+MSG_STD = 1
+MSG_HEXDUMP = 2
+MSG_DROPPED = 3
+
+LEVELS = ['', 'err', 'wrn', 'inf', 'dbg']
+
+# flags, width, precision, length modifier and conversion
+FMT_SPEC = re.compile(r'%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d+))?'
+                      r'(hh|h|ll|l|j|z|t|L)?([diouxXcspeEfgGaA%])')
+
+
+class Database:
+    def __init__(self, path):
+        with open(path) as f:
+            db = json.load(f)
+
+        self.endian = '<' if db['little_endian'] else '>'
+        self.ptr_size = db['pointer_size']
+        self.sources = db['sources']
+        self.sections = [(s['address'], bytes.fromhex(s['data']))
+                         for s in db['sections']]
+
+    def string(self, addr):
+        for start, data in self.sections:
+            if start <= addr < start + len(data):
+                end = data.find(b'\0', addr - start)
+                if end < 0:
+                    end = len(data)
+
+                return data[addr - start:end].decode('utf-8', 'replace')
+
+        return None
+
+    def source(self, source_id):
+        if source_id < len(self.sources):
+            return self.sources[source_id]
+
+        return '<source %d>' % source_id
+
+
+class Reader:
+    def __init__(self, stream, db):
+        self.stream = stream
+        self.db = db
+        self.word = 'Q' if db.ptr_size == 8 else 'I'
+
+    def read(self, length):
+        data = self.stream.read(length)
+        if len(data) != length:
+            raise EOFError
+
+        return data
+
+    def unpack(self, fmt):
+        fmt = self.db.endian + fmt.replace('W', self.word)
+        return struct.unpack(fmt, self.read(struct.calcsize(fmt)))
+
+    def cstring(self):
+        data = bytearray()
+        while True:
+            c = self.read(1)
+            if c == b'\0':
+                return data.decode('utf-8', 'replace')
+
+            data += c
+
+
+def to_signed(value, bits):
+    value &= (1 << bits) - 1
+    if value & (1 << (bits - 1)):
+        value -= 1 << bits
+
+    return value
+
+
+def format_message(db, fmt, args, strings):
+    """Format the C string fmt with the raw argument words"""
+    word_bits = db.ptr_size * 8
+    args = iter(args)
+
+    def convert(m):
+        flags, width, precision, length, conv = m.groups()
+
+        if conv == '%':
+            return '%'
+
+        value = next(args, 0)
+        bits = word_bits if length in ('l', 'll', 'j', 'z', 't') else 32
+        spec = '%' + flags + (width or '')
+        if precision is not None:
+            spec += '.' + precision
+
+        if conv in 'di':
+            return (spec + 'd') % to_signed(value, bits)
+        if conv in 'ouxX':
+            return (spec + conv) % (value & ((1 << bits) - 1))
+        if conv == 'c':
+            return (spec + 'c') % chr(value & 0xff)
+        if conv == 'p':
+            return (spec + 's') % ('0x%x' % value)
+        if conv == 's':
+            if value in strings:
+                s = strings[value]
+            else:
+                s = db.string(value)
+            return (spec + 's') % (s if s is not None else
+                                   '<string @0x%x>' % value)
+
+        # Floating point arguments are not supported by the logger
+        return '<%s>' % m.group(0)
+
+    return FMT_SPEC.sub(convert, fmt)
+
+
+def header(db, ids, timestamp, args):
+    level = ids & 0x7
+    domain = (ids >> 3) & 0x7
+    source = ids >> 6
+
+    if args.freq:
+        ts = '[%012.6f]' % (timestamp / args.freq)
+    else:
+        ts = '[%010u]' % timestamp
+
+    prefix = '%s <%s> ' % (ts, LEVELS[level] if level < len(LEVELS) else
+                           level)
+    if domain:
+        prefix += '%d/' % domain
+
+    return prefix + db.source(source) + ': '
+
+
+def hexdump(data, indent):
+    lines = []
+
+    for offset in range(0, len(data), 16):
+        chunk = data[offset:offset + 16]
+        text = ''.join(chr(b) if 32 <= b < 127 else '.' for b in chunk)
+        lines.append('%s%-48s|%s' % (indent, ' '.join('%02x' % b
+                                                     for b in chunk), text))
+
+    return '\n'.join(lines)
+
+
+def decode(stream, db, args, out):
+    reader = Reader(stream, db)
+
+    while True:
+        try:
+            msg_type, = reader.unpack('B')
+        except EOFError:
+            return
+
+        if msg_type == MSG_DROPPED:
+            cnt, = reader.unpack('I')
+            out.write('--- %u messages dropped ---\n' % cnt)
+            continue
+
+        if msg_type not in (MSG_STD, MSG_HEXDUMP):
+            sys.exit('unknown record type %d, wrong database or lost '
+                     'synchronization' % msg_type)
+
+        ids, timestamp, addr = reader.unpack('HIW')
+        level = ids & 0x7
+        prefix = header(db, ids, timestamp, args) if level else ''
+
+        if msg_type == MSG_STD:
+            nargs, copied = reader.unpack('BH')
+            words = reader.unpack('W' * nargs)
+            strings = {}
+            for i in range(nargs):
+                if copied & (1 << i):
+                    strings[words[i]] = reader.cstring()
+
+            fmt = db.string(addr)
+            if fmt is None:
+                fmt = '<format @0x%x>' % addr
+
+            text = format_message(db, fmt, words, strings)
+            out.write(prefix + text + ('\n' if level else ''))
+        else:
+            length, = reader.unpack('H')
+            data = reader.read(length)
+
+            if not level:
+                # Raw string logged with printk
+                out.write(data.decode('utf-8', 'replace'))
+                continue
+
+            metadata = db.string(addr) if addr else ''
+            out.write(prefix + (metadata or '') + '\n')
+            out.write(hexdump(data, ' ' * len(prefix)) + '\n')
+
+        out.flush()
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+
+    parser.add_argument("dbfile", help="Dictionary database (JSON)")
+    parser.add_argument("logfile", nargs='?',
+                        help="Binary log, a file or a serial port "
+                             "(stdin if not given)")
+    parser.add_argument("--freq", type=int,
+                        help="Timestamp frequency, to print the timestamps "
+                             "in seconds")
+
+    return parser.parse_args()
+
+
+def main():
+    args = parse_args()
+    db = Database(args.dbfile)
+
+    if args.logfile:
+        with open(args.logfile, 'rb', buffering=0) as f:
+            decode(f, db, args, sys.stdout)
+    else:
+        decode(sys.stdin.buffer, db, args, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()
@@ -80,6 +80,103 @@ static sys_slist_t db;
 
 static atomic_t init;
 
+#if defined(CONFIG_BT_GATT_HANDLE_INDEX)
+/* Handle ranges of the static and dynamic services sorted by handle. The
+ * length is -1 before the static services are counted and while the
+ * services don't fit, attributes are then found by walking the services.
+ */
+static struct gatt_range {
+	uint16_t start;
+	uint16_t end;
+	uint16_t attr_count;
+	const struct bt_gatt_attr *attrs;
+	/* NULL for static services */
+	struct bt_gatt_service *svc;
+} gatt_ranges[CONFIG_BT_GATT_HANDLE_INDEX_SIZE];
+
+static int gatt_ranges_len = -1;
+
+static bool gatt_ranges_add(uint16_t start, uint16_t end,
+			    const struct bt_gatt_attr *attrs,
+			    uint16_t attr_count, struct bt_gatt_service *svc)
+{
+	struct gatt_range *range;
+
+	if (gatt_ranges_len == ARRAY_SIZE(gatt_ranges)) {
+		return false;
+	}
+
+	range = &gatt_ranges[gatt_ranges_len++];
+	range->start = start;
+	range->end = end;
+	range->attrs = attrs;
+	range->attr_count = attr_count;
+	range->svc = svc;
+
+	return true;
+}
+
+static void gatt_ranges_build(void)
+{
+#if defined(CONFIG_BT_GATT_DYNAMIC_DB)
+	struct bt_gatt_service *svc;
+#endif
+	uint16_t handle = 1U;
+
+	gatt_ranges_len = 0;
+
+	Z_STRUCT_SECTION_FOREACH(bt_gatt_service_static, static_svc) {
+		if (!static_svc->attr_count) {
+			continue;
+		}
+
+		if (!gatt_ranges_add(handle,
+				     handle + static_svc->attr_count - 1,
+				     static_svc->attrs, static_svc->attr_count,
+				     NULL)) {
+			goto overflow;
+		}
+
+		handle += static_svc->attr_count;
+	}
+
+#if defined(CONFIG_BT_GATT_DYNAMIC_DB)
+	/* Dynamic services always come after the static ones */
+	SYS_SLIST_FOR_EACH_CONTAINER(&db, svc, node) {
+		if (!gatt_ranges_add(svc->attrs[0].handle,
+				     svc->attrs[svc->attr_count - 1].handle,
+				     svc->attrs, svc->attr_count, svc)) {
+			goto overflow;
+		}
+	}
+#endif /* CONFIG_BT_GATT_DYNAMIC_DB */
+
+	return;
+
+overflow:
+	BT_DBG("Too many services for the handle index");
+	gatt_ranges_len = -1;
+}
+
+/* Returns the first range which ends at or after the handle */
+static int gatt_ranges_find(uint16_t handle)
+{
+	int lo = 0, hi = gatt_ranges_len;
+
+	while (lo < hi) {
+		int mid = (lo + hi) / 2;
+
+		if (gatt_ranges[mid].end < handle) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+
+	return lo;
+}
+#endif /* CONFIG_BT_GATT_HANDLE_INDEX */
+
 static ssize_t read_name(struct bt_conn *conn, const struct bt_gatt_attr *attr,
 			 void *buf, uint16_t len, uint16_t offset)
 {
@@ -813,6 +910,22 @@ static void gatt_insert(struct bt_gatt_service *svc, uint16_t last_handle)
 		return;
 	}
 
+#if defined(CONFIG_BT_GATT_HANDLE_INDEX)
+	if (gatt_ranges_len >= 0) {
+		int pos = gatt_ranges_find(svc->attrs[0].handle);
+
+		/* Insert after the last service ending before this one */
+		if (pos > 0 && gatt_ranges[pos - 1].svc) {
+			sys_slist_insert(&db, &gatt_ranges[pos - 1].svc->node,
+					 &svc->node);
+		} else {
+			sys_slist_prepend(&db, &svc->node);
+		}
+
+		return;
+	}
+#endif /* CONFIG_BT_GATT_HANDLE_INDEX */
+
 	/* DB shall always have its service in ascending order */
 	SYS_SLIST_FOR_EACH_CONTAINER(&db, tmp, node) {
 		if (tmp->attrs[0].handle > svc->attrs[0].handle) {
@@ -868,6 +981,10 @@ populate:
 
 	gatt_insert(svc, last_handle);
 
+#if defined(CONFIG_BT_GATT_HANDLE_INDEX)
+	gatt_ranges_build();
+#endif
+
 	return 0;
 }
 #endif /* CONFIG_BT_GATT_DYNAMIC_DB */
@@ -1033,6 +1150,10 @@ void bt_gatt_init(void)
 		last_static_handle += svc->attr_count;
 	}
 
+#if defined(CONFIG_BT_GATT_HANDLE_INDEX)
+	gatt_ranges_build();
+#endif
+
 #if defined(CONFIG_BT_GATT_CACHING)
 	k_delayed_work_init(&db_hash_work, db_hash_process);
 
@@ -1155,6 +1276,10 @@ static int gatt_unregister(struct bt_gatt_service *svc)
 		return -ENOENT;
 	}
 
+#if defined(CONFIG_BT_GATT_HANDLE_INDEX)
+	gatt_ranges_build();
+#endif
+
 	for (uint16_t i = 0; i < svc->attr_count; i++) {
 		struct bt_gatt_attr *attr = &svc->attrs[i];
 
@@ -1290,16 +1415,12 @@ uint16_t bt_gatt_attr_get_handle(const struct bt_gatt_attr *attr)
 	Z_STRUCT_SECTION_FOREACH(bt_gatt_service_static, static_svc) {
 		/* Skip ahead if start is not within service attributes array */
 		if ((attr < &static_svc->attrs[0]) ||
-		    (attr > &static_svc->attrs[static_svc->attr_count - 1])) {
+		    (attr >= &static_svc->attrs[static_svc->attr_count])) {
 			handle += static_svc->attr_count;
 			continue;
 		}
 
-		for (size_t i = 0; i < static_svc->attr_count; i++, handle++) {
-			if (attr == &static_svc->attrs[i]) {
-				return handle;
-			}
-		}
+		return handle + (attr - static_svc->attrs);
 	}
 
 	return 0;
@@ -1470,6 +1591,59 @@ static void foreach_attr_type_dyndb(uint16_t start_handle, uint16_t end_handle,
 #endif /* CONFIG_BT_GATT_DYNAMIC_DB */
 }
 
+#if defined(CONFIG_BT_GATT_HANDLE_INDEX)
+static void foreach_attr_type_indexed(uint16_t start_handle,
+				      uint16_t end_handle,
+				      const struct bt_uuid *uuid,
+				      const void *attr_data,
+				      uint16_t num_matches,
+				      bt_gatt_attr_func_t func, void *user_data)
+{
+	int pos;
+
+	for (pos = gatt_ranges_find(start_handle); pos < gatt_ranges_len;
+	     pos++) {
+		const struct gatt_range *range = &gatt_ranges[pos];
+		const struct bt_gatt_attr *attrs = range->attrs;
+		size_t i = 0, hi = range->attr_count;
+
+		if (range->start > end_handle) {
+			return;
+		}
+
+		/* Skip to the first attribute within the requested range */
+		if (!range->svc) {
+			if (start_handle > range->start) {
+				i = start_handle - range->start;
+			}
+		} else {
+			while (i < hi) {
+				size_t mid = (i + hi) / 2;
+
+				if (attrs[mid].handle < start_handle) {
+					i = mid + 1;
+				} else {
+					hi = mid;
+				}
+			}
+		}
+
+		for (; i < range->attr_count; i++) {
+			uint16_t handle = range->svc ? attrs[i].handle :
+					  range->start + i;
+
+			if (gatt_foreach_iter(&attrs[i], handle, start_handle,
+					      end_handle, uuid, attr_data,
+					      &num_matches, func,
+					      user_data) ==
+			    BT_GATT_ITER_STOP) {
+				return;
+			}
+		}
+	}
+}
+#endif /* CONFIG_BT_GATT_HANDLE_INDEX */
+
 void bt_gatt_foreach_attr_type(uint16_t start_handle, uint16_t end_handle,
 			       const struct bt_uuid *uuid,
 			       const void *attr_data, uint16_t num_matches,
@@ -1481,6 +1655,15 @@ void bt_gatt_foreach_attr_type(uint16_t start_handle, uint16_t end_handle,
 		num_matches = UINT16_MAX;
 	}
 
+#if defined(CONFIG_BT_GATT_HANDLE_INDEX)
+	if (gatt_ranges_len >= 0) {
+		foreach_attr_type_indexed(start_handle, end_handle, uuid,
+					  attr_data, num_matches, func,
+					  user_data);
+		return;
+	}
+#endif /* CONFIG_BT_GATT_HANDLE_INDEX */
+
 	if (start_handle <= last_static_handle) {
 		uint16_t handle = 1;
 
@@ -99,14 +99,120 @@ NET_BUF_POOL_DEFINE(loopback_buf_pool, CONFIG_BT_MESH_LOOPBACK_BUFS,
 static uint32_t dup_cache[CONFIG_BT_MESH_MSG_CACHE_SIZE];
 static int   dup_cache_next;
 
+#if defined(CONFIG_BT_MESH_MSG_CACHE_HASH)
+/* Open addressing hash table over the entries of a cache, holding the
+ * cache index + 1 of the entries, or 0 for an empty slot. Collisions are
+ * resolved by linear probing, and entries are removed with backward
+ * shift deletion so that no tombstones are left. The caches themselves
+ * stay rings, so the oldest entry is evicted as without the table.
+ */
+#define CACHE_HASH_SIZE (2 * CONFIG_BT_MESH_MSG_CACHE_SIZE)
+
+struct cache_hash {
+	uint16_t slots[CACHE_HASH_SIZE];
+	uint32_t (*key)(uint16_t idx);
+};
+
+static uint32_t msg_cache_key(uint16_t idx)
+{
+	return ((uint32_t)msg_cache[idx].src << 17) | msg_cache[idx].seq;
+}
+
+static uint32_t dup_cache_key(uint16_t idx)
+{
+	return dup_cache[idx];
+}
+
+static struct cache_hash msg_cache_hash = { .key = msg_cache_key };
+static struct cache_hash dup_cache_hash = { .key = dup_cache_key };
+
+static uint32_t cache_hash_home(uint32_t key)
+{
+	return ((key * 2654435761U) >> 8) % CACHE_HASH_SIZE;
+}
+
+static bool cache_hash_find(const struct cache_hash *hash, uint32_t key)
+{
+	uint32_t slot = cache_hash_home(key);
+	uint16_t entry;
+
+	while ((entry = hash->slots[slot]) != 0U) {
+		if (hash->key(entry - 1) == key) {
+			return true;
+		}
+
+		slot = (slot + 1) % CACHE_HASH_SIZE;
+	}
+
+	return false;
+}
+
+static void cache_hash_add(struct cache_hash *hash, uint16_t idx)
+{
+	uint32_t slot = cache_hash_home(hash->key(idx));
+
+	while (hash->slots[slot]) {
+		slot = (slot + 1) % CACHE_HASH_SIZE;
+	}
+
+	hash->slots[slot] = idx + 1;
+}
+
+/* Must be called before the key of the entry changes. Entries which
+ * were never added are ignored.
+ */
+static void cache_hash_del(struct cache_hash *hash, uint16_t idx)
+{
+	uint32_t slot = cache_hash_home(hash->key(idx));
+	uint32_t next, home;
+	uint16_t entry;
+
+	while (hash->slots[slot] != idx + 1) {
+		if (!hash->slots[slot]) {
+			return;
+		}
+
+		slot = (slot + 1) % CACHE_HASH_SIZE;
+	}
+
+	/* Move back the following entries of the cluster which would no
+	 * longer be found once the slot is emptied.
+	 */
+	for (next = (slot + 1) % CACHE_HASH_SIZE;
+	     (entry = hash->slots[next]) != 0U;
+	     next = (next + 1) % CACHE_HASH_SIZE) {
+		home = cache_hash_home(hash->key(entry - 1));
+		if ((next + CACHE_HASH_SIZE - home) % CACHE_HASH_SIZE >=
+		    (next + CACHE_HASH_SIZE - slot) % CACHE_HASH_SIZE) {
+			hash->slots[slot] = entry;
+			slot = next;
+		}
+	}
+
+	hash->slots[slot] = 0U;
+}
+#endif /* CONFIG_BT_MESH_MSG_CACHE_HASH */
+
 static bool check_dup(struct net_buf_simple *data)
 {
 	const uint8_t *tail = net_buf_simple_tail(data);
 	uint32_t val;
+#if !defined(CONFIG_BT_MESH_MSG_CACHE_HASH)
 	int i;
+#endif
 
 	val = sys_get_be32(tail - 4) ^ sys_get_be32(tail - 8);
 
+#if defined(CONFIG_BT_MESH_MSG_CACHE_HASH)
+	if (cache_hash_find(&dup_cache_hash, val)) {
+		return true;
+	}
+
+	cache_hash_del(&dup_cache_hash, dup_cache_next);
+	dup_cache[dup_cache_next] = val;
+	cache_hash_add(&dup_cache_hash, dup_cache_next);
+	dup_cache_next++;
+#else
 	for (i = 0; i < ARRAY_SIZE(dup_cache); i++) {
 		if (dup_cache[i] == val) {
 			return true;
@@ -114,6 +220,7 @@ static bool check_dup(struct net_buf_simple *data)
 	}
 
 	dup_cache[dup_cache_next++] = val;
+#endif
 	dup_cache_next %= ARRAY_SIZE(dup_cache);
 
 	return false;
@@ -121,6 +228,11 @@ static bool check_dup(struct net_buf_simple *data)
 
 static bool msg_cache_match(struct net_buf_simple *pdu)
 {
+#if defined(CONFIG_BT_MESH_MSG_CACHE_HASH)
+	return cache_hash_find(&msg_cache_hash,
+			       ((uint32_t)SRC(pdu->data) << 17) |
+			       (SEQ(pdu->data) & BIT_MASK(17)));
+#else
 	uint16_t i;
 
 	for (i = 0U; i < ARRAY_SIZE(msg_cache); i++) {
@@ -131,13 +243,20 @@ static bool msg_cache_match(struct net_buf_simple *pdu)
 	}
 
 	return false;
+#endif
 }
 
 static void msg_cache_add(struct bt_mesh_net_rx *rx)
 {
 	rx->msg_cache_idx = msg_cache_next++;
+#if defined(CONFIG_BT_MESH_MSG_CACHE_HASH)
+	cache_hash_del(&msg_cache_hash, rx->msg_cache_idx);
+#endif
 	msg_cache[rx->msg_cache_idx].src = rx->ctx.addr;
 	msg_cache[rx->msg_cache_idx].seq = rx->seq;
+#if defined(CONFIG_BT_MESH_MSG_CACHE_HASH)
+	cache_hash_add(&msg_cache_hash, rx->msg_cache_idx);
+#endif
 	msg_cache_next %= ARRAY_SIZE(msg_cache);
 }
 
@@ -438,6 +557,9 @@ int bt_mesh_net_create(uint16_t idx, uint8_t flags, const uint8_t key[16],
 	BT_DBG("NetKey %s", bt_hex(key, 16));
 
 	(void)memset(msg_cache, 0, sizeof(msg_cache));
+#if defined(CONFIG_BT_MESH_MSG_CACHE_HASH)
+	(void)memset(msg_cache_hash.slots, 0, sizeof(msg_cache_hash.slots));
+#endif
 	msg_cache_next = 0U;
 
 	sub = &bt_mesh.sub[0];
@@ -1351,6 +1473,9 @@ void bt_mesh_net_recv(struct net_buf_simple *data, int8_t rssi,
 	 */
 	if (bt_mesh_trans_recv(&buf, &rx) == -EAGAIN) {
 		BT_WARN("Removing rejected message from Network Message Cache");
+#if defined(CONFIG_BT_MESH_MSG_CACHE_HASH)
+		cache_hash_del(&msg_cache_hash, rx.msg_cache_idx);
+#endif
 		msg_cache[rx.msg_cache_idx].src = BT_MESH_ADDR_UNASSIGNED;
 		/* Rewind the next index now that we're not using this entry */
 		msg_cache_next = rx.msg_cache_idx;
@@ -32,10 +32,86 @@
 
 static struct bt_mesh_rpl replay_list[CONFIG_BT_MESH_CRPL];
 
+#if defined(CONFIG_BT_MESH_RPL_HASH)
+/* Open addressing hash table over the replay list, holding the list
+ * index + 1 of the entries, or 0 for an empty slot. The settings code
+ * clears entries directly, so slots may refer to entries whose source
+ * has since changed: lookups compare the source of the entry, and the
+ * table is rebuilt from the list before it gets too full.
+ */
+#define RPL_HASH_SIZE (2 * CONFIG_BT_MESH_CRPL)
+
+static uint16_t rpl_hash[RPL_HASH_SIZE];
+static uint32_t rpl_hash_used;
+
+static uint32_t rpl_slot(uint16_t src)
+{
+	return ((src * 2654435761U) >> 8) % RPL_HASH_SIZE;
+}
+
+static void rpl_hash_put(uint16_t idx)
+{
+	uint32_t slot = rpl_slot(replay_list[idx].src);
+
+	while (rpl_hash[slot]) {
+		slot = (slot + 1) % RPL_HASH_SIZE;
+	}
+
+	rpl_hash[slot] = idx + 1;
+	rpl_hash_used++;
+}
+
+static void rpl_hash_rebuild(void)
+{
+	uint16_t i;
+
+	(void)memset(rpl_hash, 0, sizeof(rpl_hash));
+	rpl_hash_used = 0U;
+
+	for (i = 0U; i < ARRAY_SIZE(replay_list); i++) {
+		if (replay_list[i].src) {
+			rpl_hash_put(i);
+		}
+	}
+}
+
+static void rpl_hash_add(struct bt_mesh_rpl *rpl)
+{
+	/* Stale slots are only dropped by a rebuild, which leaves the
+	 * table at most half full.
+	 */
+	if (rpl_hash_used >= RPL_HASH_SIZE * 3 / 4) {
+		rpl_hash_rebuild();
+	} else {
+		rpl_hash_put(rpl - replay_list);
+	}
+}
+#endif /* CONFIG_BT_MESH_RPL_HASH */
+
+static struct bt_mesh_rpl *rpl_empty(void)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(replay_list); i++) {
+		if (!replay_list[i].src) {
+			return &replay_list[i];
+		}
+	}
+
+	return NULL;
+}
+
 void bt_mesh_rpl_update(struct bt_mesh_rpl *rpl,
 		struct bt_mesh_net_rx *rx)
 {
+#if defined(CONFIG_BT_MESH_RPL_HASH)
+	if (rpl->src != rx->ctx.addr) {
+		rpl->src = rx->ctx.addr;
+		rpl_hash_add(rpl);
+	}
+#else
 	rpl->src = rx->ctx.addr;
+#endif
 	rpl->seq = rx->seq;
 	rpl->old_iv = rx->old_iv;
 
@@ -44,6 +120,40 @@ void bt_mesh_rpl_update(struct bt_mesh_rpl *rpl,
 	}
 }
 
+static bool rpl_check_entry(struct bt_mesh_rpl *rpl,
+			    struct bt_mesh_net_rx *rx,
+			    struct bt_mesh_rpl **match)
+{
+	/* Empty slot */
+	if (!rpl->src) {
+		if (match) {
+			*match = rpl;
+		} else {
+			bt_mesh_rpl_update(rpl, rx);
+		}
+
+		return false;
+	}
+
+	/* Existing slot for given address */
+	if (rx->old_iv && !rpl->old_iv) {
+		return true;
+	}
+
+	if ((!rx->old_iv && rpl->old_iv) ||
+	    rpl->seq < rx->seq) {
+		if (match) {
+			*match = rpl;
+		} else {
+			bt_mesh_rpl_update(rpl, rx);
+		}
+
+		return false;
+	}
+
+	return true;
+}
+
 /* Check the Replay Protection List for a replay attempt. If non-NULL match
  * parameter is given the RPL slot is returned but it is not immediately
  * updated (needed for segmented messages), whereas if a NULL match is given
@@ -52,7 +162,10 @@ void bt_mesh_rpl_update(struct bt_mesh_rpl *rpl,
 bool bt_mesh_rpl_check(struct bt_mesh_net_rx *rx,
 		struct bt_mesh_rpl **match)
 {
+	struct bt_mesh_rpl *rpl;
+#if !defined(CONFIG_BT_MESH_RPL_HASH)
 	int i;
+#endif
 
 	/* Don't bother checking messages from ourselves */
 	if (rx->net_if == BT_MESH_NET_IF_LOCAL) {
@@ -64,40 +177,28 @@ bool bt_mesh_rpl_check(struct bt_mesh_net_rx *rx,
 		return false;
 	}
 
-	for (i = 0; i < ARRAY_SIZE(replay_list); i++) {
-		struct bt_mesh_rpl *rpl = &replay_list[i];
-
-		/* Empty slot */
-		if (!rpl->src) {
-			if (match) {
-				*match = rpl;
-			} else {
-				bt_mesh_rpl_update(rpl, rx);
-			}
-
-			return false;
-		}
-
-		/* Existing slot for given address */
-		if (rpl->src == rx->ctx.addr) {
-			if (rx->old_iv && !rpl->old_iv) {
-				return true;
-			}
+#if defined(CONFIG_BT_MESH_RPL_HASH)
+	/* Look for the source first, the list may have holes left by
+	 * bt_mesh_rpl_reset() in front of its entry.
+	 */
+	rpl = bt_mesh_rpl_find(rx->ctx.addr);
+	if (!rpl) {
+		rpl = rpl_empty();
+	}
 
-			if ((!rx->old_iv && rpl->old_iv) ||
-			    rpl->seq < rx->seq) {
-				if (match) {
-					*match = rpl;
-				} else {
-					bt_mesh_rpl_update(rpl, rx);
-				}
+	if (rpl) {
+		return rpl_check_entry(rpl, rx, match);
+	}
+#else
+	for (i = 0; i < ARRAY_SIZE(replay_list); i++) {
+		rpl = &replay_list[i];
 
-				return false;
-			} else {
-				return true;
-			}
+		/* Empty slot or existing slot for given address */
+		if (!rpl->src || rpl->src == rx->ctx.addr) {
+			return rpl_check_entry(rpl, rx, match);
 		}
 	}
+#endif
 
 	BT_ERR("RPL is full!");
 	return true;
@@ -111,11 +212,26 @@ void bt_mesh_rpl_clear(void)
 		bt_mesh_clear_rpl();
 	} else {
 		(void)memset(replay_list, 0, sizeof(replay_list));
+#if defined(CONFIG_BT_MESH_RPL_HASH)
+		rpl_hash_rebuild();
+#endif
 	}
 }
 
 struct bt_mesh_rpl *bt_mesh_rpl_find(uint16_t src)
 {
+#if defined(CONFIG_BT_MESH_RPL_HASH)
+	uint32_t slot = rpl_slot(src);
+	uint16_t entry;
+
+	while ((entry = rpl_hash[slot]) != 0U) {
+		if (replay_list[entry - 1].src == src) {
+			return &replay_list[entry - 1];
+		}
+
+		slot = (slot + 1) % RPL_HASH_SIZE;
+	}
+#else
 	int i;
 
 	for (i = 0; i < ARRAY_SIZE(replay_list); i++) {
@@ -123,22 +239,23 @@ struct bt_mesh_rpl *bt_mesh_rpl_find(uint16_t src)
 			return &replay_list[i];
 		}
 	}
+#endif
 
 	return NULL;
 }
 
 struct bt_mesh_rpl *bt_mesh_rpl_alloc(uint16_t src)
 {
-	int i;
+	struct bt_mesh_rpl *rpl = rpl_empty();
 
-	for (i = 0; i < ARRAY_SIZE(replay_list); i++) {
-		if (!replay_list[i].src) {
-			replay_list[i].src = src;
-			return &replay_list[i];
-		}
+	if (rpl) {
+		rpl->src = src;
+#if defined(CONFIG_BT_MESH_RPL_HASH)
+		rpl_hash_add(rpl);
+#endif
 	}
 
-	return NULL;
+	return rpl;
 }
 
 void bt_mesh_rpl_foreach(bt_mesh_rpl_func_t func, void *user_data)
@@ -148,6 +265,11 @@ void bt_mesh_rpl_foreach(bt_mesh_rpl_func_t func, void *user_data)
 	for (i = 0; i < ARRAY_SIZE(replay_list); i++) {
 		func(&replay_list[i], user_data);
 	}
+
+#if defined(CONFIG_BT_MESH_RPL_HASH)
+	/* The callback may have cleared entries */
+	rpl_hash_rebuild();
+#endif
 }
 
 void bt_mesh_rpl_reset(void)
@@ -172,4 +294,8 @@ void bt_mesh_rpl_reset(void)
 			}
 		}
 	}
+
+#if defined(CONFIG_BT_MESH_RPL_HASH)
+	rpl_hash_rebuild();
+#endif
 }
@@ -13,6 +13,8 @@
 #include <errno.h>
 #include <device.h>
 
+#include "disk_cache.h"
+
 #define LOG_LEVEL CONFIG_DISK_LOG_LEVEL
 #include <logging/log.h>
 LOG_MODULE_REGISTER(disk);
@@ -53,6 +55,23 @@ struct disk_info *disk_access_get_di(const char *name)
 	return disk;
 }
 
+/* The disk access thread runs driver operations while the application
+ * calls the synchronous API, the disk lock keeps them from overlapping.
+ */
+static inline void disk_lock(struct disk_info *disk)
+{
+#if defined(CONFIG_DISK_ACCESS_ASYNC)
+	k_mutex_lock(&disk->lock, K_FOREVER);
+#endif
+}
+
+static inline void disk_unlock(struct disk_info *disk)
+{
+#if defined(CONFIG_DISK_ACCESS_ASYNC)
+	k_mutex_unlock(&disk->lock);
+#endif
+}
+
 int disk_access_init(const char *pdrv)
 {
 	struct disk_info *disk = disk_access_get_di(pdrv);
@@ -60,7 +79,14 @@ int disk_access_init(const char *pdrv)
 
 	if ((disk != NULL) && (disk->ops != NULL) &&
 				(disk->ops->init != NULL)) {
+		disk_lock(disk);
 		rc = disk->ops->init(disk);
+
+		if (IS_ENABLED(CONFIG_DISK_CACHE) && rc == 0) {
+			disk_cache_reset(disk);
+		}
+
+		disk_unlock(disk);
 	}
 
 	return rc;
@@ -73,12 +99,36 @@ int disk_access_status(const char *pdrv)
 
 	if ((disk != NULL) && (disk->ops != NULL) &&
 				(disk->ops->status != NULL)) {
+		disk_lock(disk);
 		rc = disk->ops->status(disk);
+		disk_unlock(disk);
 	}
 
 	return rc;
 }
 
+static int disk_read(struct disk_info *disk, uint8_t *data_buf,
+		     uint32_t start_sector, uint32_t num_sector)
+{
+	if (IS_ENABLED(CONFIG_DISK_CACHE)) {
+		return disk_cache_read(disk, data_buf, start_sector,
+				       num_sector);
+	}
+
+	return disk->ops->read(disk, data_buf, start_sector, num_sector);
+}
+
+static int disk_write(struct disk_info *disk, const uint8_t *data_buf,
+		      uint32_t start_sector, uint32_t num_sector)
+{
+	if (IS_ENABLED(CONFIG_DISK_CACHE)) {
+		return disk_cache_write(disk, data_buf, start_sector,
+					num_sector);
+	}
+
+	return disk->ops->write(disk, data_buf, start_sector, num_sector);
+}
+
 int disk_access_read(const char *pdrv, uint8_t *data_buf,
 		     uint32_t start_sector, uint32_t num_sector)
 {
@@ -87,7 +137,9 @@ int disk_access_read(const char *pdrv, uint8_t *data_buf,
 
 	if ((disk != NULL) && (disk->ops != NULL) &&
 				(disk->ops->read != NULL)) {
-		rc = disk->ops->read(disk, data_buf, start_sector, num_sector);
+		disk_lock(disk);
+		rc = disk_read(disk, data_buf, start_sector, num_sector);
+		disk_unlock(disk);
 	}
 
 	return rc;
@@ -101,7 +153,9 @@ int disk_access_write(const char *pdrv, const uint8_t *data_buf,
 
 	if ((disk != NULL) && (disk->ops != NULL) &&
 				(disk->ops->write != NULL)) {
-		rc = disk->ops->write(disk, data_buf, start_sector, num_sector);
+		disk_lock(disk);
+		rc = disk_write(disk, data_buf, start_sector, num_sector);
+		disk_unlock(disk);
 	}
 
 	return rc;
@@ -114,12 +168,218 @@ int disk_access_ioctl(const char *pdrv, uint8_t cmd, void *buf)
 
 	if ((disk != NULL) && (disk->ops != NULL) &&
 				(disk->ops->ioctl != NULL)) {
+		disk_lock(disk);
 		rc = disk->ops->ioctl(disk, cmd, buf);
+		disk_unlock(disk);
 	}
 
 	return rc;
 }
 
+#if defined(CONFIG_DISK_ACCESS_ASYNC)
+/* Asynchronous requests are queued and done by the disk access thread. It
+ * takes the queued requests in batches and gathers the segments of the
+ * successive requests of a disk and an operation in one scatter-gather
+ * list, merging the segments which are adjacent on the disk and in memory.
+ * The list is given to the transfer operation of the driver, or done one
+ * segment at a time. A request is completed once all its segments are
+ * done.
+ */
+struct async_batch {
+	struct disk_req *reqs[CONFIG_DISK_ACCESS_ASYNC_BATCH];
+	size_t count;
+	/* Requests before this one are completed */
+	size_t done;
+	/* First and last requests with segments in the list */
+	size_t first;
+	size_t last;
+	struct disk_sg sg[CONFIG_DISK_ACCESS_ASYNC_SG_MAX];
+	size_t sg_count;
+	struct disk_info *disk;
+	uint8_t op;
+	/* 0 if the segments cannot be merged */
+	uint32_t sector_size;
+};
+
+static K_FIFO_DEFINE(async_fifo);
+static struct async_batch batch;
+
+static void async_complete(struct disk_req *req)
+{
+#if defined(CONFIG_POLL)
+	struct k_poll_signal *signal = req->signal;
+#endif
+	int result = req->result;
+
+	/* the request may be reused once completed */
+	if (req->cb != NULL) {
+		req->cb(req, result);
+	}
+
+#if defined(CONFIG_POLL)
+	if (signal != NULL) {
+		k_poll_signal_raise(signal, result);
+	}
+#endif
+}
+
+static int async_transfer(struct async_batch *b)
+{
+	struct disk_info *disk = b->disk;
+	int rc = 0;
+
+	disk_lock(disk);
+
+	/* the sector cache is only updated by reads and writes */
+	if (!IS_ENABLED(CONFIG_DISK_CACHE) && disk->ops->transfer != NULL) {
+		rc = disk->ops->transfer(disk, b->op, b->sg, b->sg_count);
+		disk_unlock(disk);
+		return rc;
+	}
+
+	for (size_t i = 0; i < b->sg_count && rc == 0; i++) {
+		struct disk_sg *sg = &b->sg[i];
+
+		if (b->op == DISK_REQ_READ) {
+			rc = disk_read(disk, sg->buf, sg->start_sector,
+				       sg->num_sector);
+		} else {
+			rc = disk_write(disk, sg->buf, sg->start_sector,
+					sg->num_sector);
+		}
+	}
+
+	disk_unlock(disk);
+
+	return rc;
+}
+
+/* Do the gathered segments and complete the requests before the next one */
+static void async_flush(struct async_batch *b, size_t next)
+{
+	int rc;
+
+	if (b->sg_count > 0) {
+		rc = async_transfer(b);
+		for (size_t i = b->first; i <= b->last && rc != 0; i++) {
+			if (b->reqs[i]->result == 0) {
+				b->reqs[i]->result = rc;
+			}
+		}
+
+		b->sg_count = 0;
+	}
+
+	while (b->done < next) {
+		async_complete(b->reqs[b->done++]);
+	}
+}
+
+static void async_add(struct async_batch *b, size_t idx,
+		      const struct disk_sg *sg)
+{
+	struct disk_req *req = b->reqs[idx];
+
+	if (b->sg_count > 0 && req->disk == b->disk && req->op == b->op) {
+		struct disk_sg *prev = &b->sg[b->sg_count - 1];
+		uint8_t *prev_end = (uint8_t *)prev->buf +
+				    prev->num_sector * b->sector_size;
+
+		if (b->sector_size != 0U && sg->buf == prev_end &&
+		    sg->start_sector == prev->start_sector + prev->num_sector) {
+			prev->num_sector += sg->num_sector;
+			b->last = idx;
+			return;
+		}
+
+		if (b->sg_count < ARRAY_SIZE(b->sg)) {
+			b->sg[b->sg_count++] = *sg;
+			b->last = idx;
+			return;
+		}
+	}
+
+	async_flush(b, idx);
+
+	if (req->disk != b->disk) {
+		b->disk = req->disk;
+		disk_lock(b->disk);
+		if (b->disk->ops->ioctl == NULL ||
+		    b->disk->ops->ioctl(b->disk, DISK_IOCTL_GET_SECTOR_SIZE,
+					&b->sector_size) != 0) {
+			b->sector_size = 0U;
+		}
+		disk_unlock(b->disk);
+	}
+
+	b->op = req->op;
+	b->sg[0] = *sg;
+	b->sg_count = 1;
+	b->first = idx;
+	b->last = idx;
+}
+
+static void async_thread(void *p1, void *p2, void *p3)
+{
+	struct async_batch *b = &batch;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		b->reqs[0] = k_fifo_get(&async_fifo, K_FOREVER);
+		b->count = 1;
+		while (b->count < ARRAY_SIZE(b->reqs)) {
+			b->reqs[b->count] = k_fifo_get(&async_fifo, K_NO_WAIT);
+			if (b->reqs[b->count] == NULL) {
+				break;
+			}
+
+			b->count++;
+		}
+
+		b->done = 0;
+		for (size_t i = 0; i < b->count; i++) {
+			const struct disk_req *req = b->reqs[i];
+
+			for (size_t j = 0; j < req->sg_count; j++) {
+				async_add(b, i, &req->sg[j]);
+			}
+		}
+
+		async_flush(b, b->count);
+
+		/* the requests may be freed, and their disks unregistered */
+		b->disk = NULL;
+	}
+}
+
+K_THREAD_DEFINE(disk_async, CONFIG_DISK_ACCESS_ASYNC_STACK_SIZE,
+		async_thread, NULL, NULL, NULL,
+		CONFIG_DISK_ACCESS_ASYNC_PRIORITY, 0, 0);
+
+int disk_access_submit(const char *pdrv, struct disk_req *req)
+{
+	struct disk_info *disk = disk_access_get_di(pdrv);
+
+	if ((disk == NULL) || (disk->ops == NULL) || (req->sg_count == 0U)) {
+		return -EINVAL;
+	}
+
+	if ((req->op == DISK_REQ_READ) ? (disk->ops->read == NULL) :
+	    (req->op != DISK_REQ_WRITE || disk->ops->write == NULL)) {
+		return -EINVAL;
+	}
+
+	req->disk = disk;
+	req->result = 0;
+	k_fifo_put(&async_fifo, req);
+
+	return 0;
+}
+#endif /* CONFIG_DISK_ACCESS_ASYNC */
+
 int disk_access_register(struct disk_info *disk)
 {
 	int rc = 0;
@@ -137,6 +397,10 @@ int disk_access_register(struct disk_info *disk)
 		goto reg_err;
 	}
 
+#if defined(CONFIG_DISK_ACCESS_ASYNC)
+	k_mutex_init(&disk->lock);
+#endif
+
 	/*  append to the disk list */
 	sys_dlist_append(&disk_access_list, &disk->node);
 	LOG_DBG("disk interface(%s) registred", disk->name);
@@ -163,6 +427,11 @@ int disk_access_unregister(struct disk_info *disk)
 	}
 	/* remove disk node from the list */
 	sys_dlist_remove(&disk->node);
+
+	if (IS_ENABLED(CONFIG_DISK_CACHE)) {
+		disk_cache_reset(disk);
+	}
+
 	LOG_DBG("disk interface(%s) unregistred", disk->name);
 unreg_err:
 	k_mutex_unlock(&mutex);
@@ -29,6 +29,10 @@ static uint8_t *fs_buff = read_copy_buf;
 #define GET_SIZE_TO_BOUNDARY(start, block_size) \
 	(block_size - (start & (block_size - 1)))
 
+#if CONFIG_DISK_FLASH_CACHE_BLOCKS > 0
+static void cache_read(uint8_t *buff, off_t start_addr, uint32_t size);
+#endif
+
 static off_t lba_to_address(uint32_t sector_num)
 {
 	off_t flash_addr;
@@ -71,6 +75,9 @@ static int disk_flash_access_read(struct disk_info *disk, uint8_t *buff,
 	uint32_t remaining;
 	uint32_t len;
 	uint32_t num_read;
+#if CONFIG_DISK_FLASH_CACHE_BLOCKS > 0
+	uint8_t *start_buff = buff;
+#endif
 
 	fl_addr = lba_to_address(start_sector);
 	remaining = (sector_count * SECTOR_SIZE);
@@ -92,6 +99,11 @@ static int disk_flash_access_read(struct disk_info *disk, uint8_t *buff,
 		remaining -= len;
 	}
 
+#if CONFIG_DISK_FLASH_CACHE_BLOCKS > 0
+	cache_read(start_buff, lba_to_address(start_sector),
+		   sector_count * SECTOR_SIZE);
+#endif
+
 	return 0;
 }
 
@@ -186,6 +198,207 @@ static int update_flash_block(off_t start_addr, uint32_t size, const void *buff)
 	return 0;
 }
 
+#if CONFIG_DISK_FLASH_CACHE_BLOCKS > 0
+/* Write-back cache of erase blocks. Partial block writes are copied into
+ * a cached block, and the sectors written are tracked so that the block
+ * does not have to be read from flash first. The other sectors are read
+ * when the block is written back, on sync or on eviction of the least
+ * recently used block. A block filled by sequential writes is written
+ * back without reading anything.
+ */
+#define SECTORS_PER_BLOCK (CONFIG_DISK_ERASE_BLOCK_SIZE / SECTOR_SIZE)
+#define CACHE_NO_BLOCK ((off_t)-1)
+
+BUILD_ASSERT(CONFIG_DISK_ERASE_BLOCK_SIZE % SECTOR_SIZE == 0,
+	     "Erase block size must be a multiple of the sector size");
+
+struct flash_cache_block {
+	/* Erase-aligned flash address, CACHE_NO_BLOCK if unused */
+	off_t addr;
+	uint32_t last_use;
+	uint32_t written[DIV_ROUND_UP(SECTORS_PER_BLOCK, 32)];
+	uint8_t __aligned(4) data[CONFIG_DISK_ERASE_BLOCK_SIZE];
+};
+
+static struct flash_cache_block cache[CONFIG_DISK_FLASH_CACHE_BLOCKS];
+static uint32_t cache_use_cnt;
+
+static bool cache_sector_written(struct flash_cache_block *block, int sector)
+{
+	return block->written[sector / 32] & BIT(sector % 32);
+}
+
+static bool cache_block_full(struct flash_cache_block *block)
+{
+	for (int i = 0; i < SECTORS_PER_BLOCK; i++) {
+		if (!cache_sector_written(block, i)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static struct flash_cache_block *cache_find(off_t addr)
+{
+	for (int i = 0; i < ARRAY_SIZE(cache); i++) {
+		if (cache[i].addr == addr) {
+			return &cache[i];
+		}
+	}
+
+	return NULL;
+}
+
+static int cache_flush_block(struct flash_cache_block *block)
+{
+	off_t fl_addr = block->addr;
+
+	if (fl_addr == CACHE_NO_BLOCK) {
+		return 0;
+	}
+
+	/* fill in the sectors which were not written from flash */
+	if (!cache_block_full(block)) {
+		for (int i = 0; i < SECTORS_PER_BLOCK; i++) {
+			if (cache_sector_written(block, i)) {
+				continue;
+			}
+
+			if (flash_read(flash_dev, fl_addr + i * SECTOR_SIZE,
+				       &block->data[i * SECTOR_SIZE],
+				       SECTOR_SIZE) != 0) {
+				return -EIO;
+			}
+		}
+	}
+
+	if (update_flash_block(fl_addr, CONFIG_DISK_ERASE_BLOCK_SIZE,
+			       block->data) != 0) {
+		return -EIO;
+	}
+
+	block->addr = CACHE_NO_BLOCK;
+
+	return 0;
+}
+
+static int cache_sync(void)
+{
+	for (int i = 0; i < ARRAY_SIZE(cache); i++) {
+		if (cache_flush_block(&cache[i]) != 0) {
+			return -EIO;
+		}
+	}
+
+	return 0;
+}
+
+/* Return the cached block for addr, evicting the least recently used
+ * block if addr is not cached.
+ */
+static struct flash_cache_block *cache_get(off_t addr)
+{
+	struct flash_cache_block *block = cache_find(addr);
+
+	if (block == NULL) {
+		block = &cache[0];
+
+		for (int i = 0; i < ARRAY_SIZE(cache); i++) {
+			if (cache[i].addr == CACHE_NO_BLOCK) {
+				block = &cache[i];
+				break;
+			}
+
+			if ((int32_t)(cache[i].last_use -
+				      block->last_use) < 0) {
+				block = &cache[i];
+			}
+		}
+
+		if (cache_flush_block(block) != 0) {
+			return NULL;
+		}
+
+		block->addr = addr;
+		(void)memset(block->written, 0, sizeof(block->written));
+	}
+
+	block->last_use = ++cache_use_cnt;
+
+	return block;
+}
+
+/* input is within one erase block, size is a multiple of SECTOR_SIZE */
+static int cache_write(off_t start_addr, uint32_t size, const uint8_t *buff)
+{
+	off_t fl_addr = ROUND_DOWN(start_addr, CONFIG_DISK_ERASE_BLOCK_SIZE);
+	uint32_t offset = start_addr - fl_addr;
+	struct flash_cache_block *block;
+
+	if (size == CONFIG_DISK_ERASE_BLOCK_SIZE) {
+		/* whole block, the cached copy is outdated */
+		block = cache_find(fl_addr);
+		if (block != NULL) {
+			block->addr = CACHE_NO_BLOCK;
+		}
+
+		return update_flash_block(fl_addr, size, buff);
+	}
+
+	block = cache_get(fl_addr);
+	if (block == NULL) {
+		return -EIO;
+	}
+
+	memcpy(&block->data[offset], buff, size);
+
+	for (int i = offset / SECTOR_SIZE;
+	     i < (offset + size) / SECTOR_SIZE; i++) {
+		block->written[i / 32] |= BIT(i % 32);
+	}
+
+	return 0;
+}
+
+/* overwrite data read from flash with the sectors written in the cache */
+static void cache_read(uint8_t *buff, off_t start_addr, uint32_t size)
+{
+	for (int i = 0; i < ARRAY_SIZE(cache); i++) {
+		struct flash_cache_block *block = &cache[i];
+
+		if (block->addr == CACHE_NO_BLOCK ||
+		    block->addr >= start_addr + size ||
+		    block->addr + CONFIG_DISK_ERASE_BLOCK_SIZE <= start_addr) {
+			continue;
+		}
+
+		for (int j = 0; j < SECTORS_PER_BLOCK; j++) {
+			off_t addr = block->addr + j * SECTOR_SIZE;
+
+			if (addr < start_addr || addr >= start_addr + size ||
+			    !cache_sector_written(block, j)) {
+				continue;
+			}
+
+			memcpy(&buff[addr - start_addr],
+			       &block->data[j * SECTOR_SIZE], SECTOR_SIZE);
+		}
+	}
+}
+#endif /* CONFIG_DISK_FLASH_CACHE_BLOCKS > 0 */
+
+/* input is within one erase block */
+static int write_flash_block(off_t start_addr, uint32_t size,
+			     const void *buff)
+{
+#if CONFIG_DISK_FLASH_CACHE_BLOCKS > 0
+	return cache_write(start_addr, size, buff);
+#else
+	return update_flash_block(start_addr, size, buff);
+#endif
+}
+
 static int disk_flash_access_write(struct disk_info *disk, const uint8_t *buff,
 				 uint32_t start_sector, uint32_t sector_count)
 {
@@ -206,7 +419,7 @@ static int disk_flash_access_write(struct disk_info *disk, const uint8_t *buff,
 		block_bnd = block_bnd & ~(CONFIG_DISK_ERASE_BLOCK_SIZE - 1);
 		if ((fl_addr + remaining) < block_bnd) {
 			/* not over block boundary (a partial block also) */
-			if (update_flash_block(fl_addr, remaining, buff) != 0) {
+			if (write_flash_block(fl_addr, remaining, buff) != 0) {
 				return -EIO;
 			}
 			return 0;
@@ -217,7 +430,7 @@ static int disk_flash_access_write(struct disk_info *disk, const uint8_t *buff,
 						CONFIG_DISK_ERASE_BLOCK_SIZE);
 
 		/* write first partial block */
-		if (update_flash_block(fl_addr, size, buff) != 0) {
+		if (write_flash_block(fl_addr, size, buff) != 0) {
 			return -EIO;
 		}
 
@@ -234,8 +447,8 @@ static int disk_flash_access_write(struct disk_info *disk, const uint8_t *buff,
 			break;
 		}
 
-		rc = update_flash_block(fl_addr, CONFIG_DISK_ERASE_BLOCK_SIZE,
-					 buff);
+		rc = write_flash_block(fl_addr, CONFIG_DISK_ERASE_BLOCK_SIZE,
+				       buff);
 		if (rc != 0) {
 			return -EIO;
 		}
@@ -247,7 +460,7 @@ static int disk_flash_access_write(struct disk_info *disk, const uint8_t *buff,
 
 	/* remaining partial block */
 	if (remaining) {
-		if (update_flash_block(fl_addr, remaining, buff) != 0) {
+		if (write_flash_block(fl_addr, remaining, buff) != 0) {
 			return -EIO;
 		}
 	}
@@ -259,7 +472,11 @@ static int disk_flash_access_ioctl(struct disk_info *disk, uint8_t cmd, void *bu
 {
 	switch (cmd) {
 	case DISK_IOCTL_CTRL_SYNC:
+#if CONFIG_DISK_FLASH_CACHE_BLOCKS > 0
+		return cache_sync();
+#else
 		return 0;
+#endif
 	case DISK_IOCTL_GET_SECTOR_COUNT:
 		*(uint32_t *)buff = CONFIG_DISK_VOLUME_SIZE / SECTOR_SIZE;
 		return 0;
@@ -293,6 +510,12 @@ static int disk_flash_init(const struct device *dev)
 {
 	ARG_UNUSED(dev);
 
+#if CONFIG_DISK_FLASH_CACHE_BLOCKS > 0
+	for (int i = 0; i < ARRAY_SIZE(cache); i++) {
+		cache[i].addr = CACHE_NO_BLOCK;
+	}
+#endif
+
 	return disk_access_register(&flash_disk);
 }
 
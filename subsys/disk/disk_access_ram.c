@@ -61,6 +61,24 @@ static int disk_ram_access_write(struct disk_info *disk, const uint8_t *buff,
 	return 0;
 }
 
+static int disk_ram_access_transfer(struct disk_info *disk, uint8_t op,
+				    const struct disk_sg *sg, size_t sg_count)
+{
+	for (size_t i = 0; i < sg_count; i++) {
+		size_t len = sg[i].num_sector * RAMDISK_SECTOR_SIZE;
+
+		if (op == DISK_REQ_READ) {
+			memcpy(sg[i].buf, lba_to_address(sg[i].start_sector),
+			       len);
+		} else {
+			memcpy(lba_to_address(sg[i].start_sector), sg[i].buf,
+			       len);
+		}
+	}
+
+	return 0;
+}
+
 static int disk_ram_access_ioctl(struct disk_info *disk, uint8_t cmd, void *buff)
 {
 	switch (cmd) {
@@ -88,6 +106,7 @@ static const struct disk_operations ram_disk_ops = {
 	.read = disk_ram_access_read,
 	.write = disk_ram_access_write,
 	.ioctl = disk_ram_access_ioctl,
+	.transfer = disk_ram_access_transfer,
 };
 
 static struct disk_info ram_disk = {
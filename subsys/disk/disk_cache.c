@@ -0,0 +1,291 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <kernel.h>
+#include <zephyr/types.h>
+#include <sys/util.h>
+#include <disk/disk_access.h>
+#include <errno.h>
+
+#include "disk_cache.h"
+
+/* Read cache of disk sectors, shared by all the disks whose sector size is
+ * CONFIG_DISK_CACHE_SECTOR_SIZE. Writes go to the disk and update the
+ * cached copies, so that the cache never holds data which is not on the
+ * disk. When a read starts where the previous read of the disk ended, the
+ * following sectors are read ahead once less than half of the readahead
+ * window is cached.
+ */
+
+#define SECTOR_SIZE CONFIG_DISK_CACHE_SECTOR_SIZE
+#define READAHEAD CONFIG_DISK_CACHE_READAHEAD
+
+/* Larger reads, of file data, go to the disk without evicting the sectors
+ * which are read repeatedly, like FAT and directory sectors.
+ */
+#define MAX_CACHED_READ MAX(CONFIG_DISK_CACHE_SECTORS / 2, 1)
+
+struct cache_entry {
+	/* NULL if the entry is unused */
+	struct disk_info *disk;
+	uint32_t sector;
+	uint32_t last_use;
+	uint8_t __aligned(4) data[SECTOR_SIZE];
+};
+
+static struct cache_entry entries[CONFIG_DISK_CACHE_SECTORS];
+static uint32_t use_cnt;
+static struct disk_cache_stats stats;
+
+#if READAHEAD > 0
+static uint8_t __aligned(4) readahead_buf[READAHEAD * SECTOR_SIZE];
+#endif
+
+/* Disk operations are done with the lock held, so that a sector cannot be
+ * read into the cache while it is being written.
+ */
+static K_MUTEX_DEFINE(cache_lock);
+
+static struct cache_entry *cache_find(struct disk_info *disk, uint32_t sector)
+{
+	for (int i = 0; i < ARRAY_SIZE(entries); i++) {
+		if (entries[i].disk == disk && entries[i].sector == sector) {
+			return &entries[i];
+		}
+	}
+
+	return NULL;
+}
+
+static void cache_add(struct disk_info *disk, uint32_t sector,
+		      const uint8_t *data)
+{
+	struct cache_entry *entry = cache_find(disk, sector);
+
+	if (entry == NULL) {
+		entry = &entries[0];
+
+		for (int i = 0; i < ARRAY_SIZE(entries); i++) {
+			if (entries[i].disk == NULL) {
+				entry = &entries[i];
+				break;
+			}
+
+			if ((int32_t)(entries[i].last_use -
+				      entry->last_use) < 0) {
+				entry = &entries[i];
+			}
+		}
+
+		entry->disk = disk;
+		entry->sector = sector;
+	}
+
+	memcpy(entry->data, data, SECTOR_SIZE);
+	entry->last_use = ++use_cnt;
+}
+
+static void cache_drop(struct disk_info *disk, uint32_t start_sector,
+		       uint32_t num_sector)
+{
+	for (int i = 0; i < ARRAY_SIZE(entries); i++) {
+		if (entries[i].disk == disk &&
+		    entries[i].sector - start_sector < num_sector) {
+			entries[i].disk = NULL;
+		}
+	}
+}
+
+static bool disk_cacheable(struct disk_info *disk)
+{
+	struct disk_cache_state *state = &disk->cache;
+	uint32_t sector_size;
+
+	if (state->checked) {
+		return state->enabled;
+	}
+
+	state->checked = true;
+	state->enabled = false;
+
+	if (disk->ops->ioctl == NULL ||
+	    disk->ops->ioctl(disk, DISK_IOCTL_GET_SECTOR_SIZE,
+			     &sector_size) != 0 ||
+	    sector_size != SECTOR_SIZE ||
+	    disk->ops->ioctl(disk, DISK_IOCTL_GET_SECTOR_COUNT,
+			     &state->sector_count) != 0) {
+		return false;
+	}
+
+	state->next_sector = UINT32_MAX;
+	state->enabled = true;
+
+	return true;
+}
+
+#if READAHEAD > 0
+static void cache_readahead(struct disk_info *disk, uint32_t sector)
+{
+	uint32_t end = MIN(sector + READAHEAD, disk->cache.sector_count);
+	uint32_t first = sector;
+	uint32_t count;
+
+	if (sector >= end) {
+		return;
+	}
+
+	while (first < end && cache_find(disk, first) != NULL) {
+		first++;
+	}
+
+	/* read once less than half of the window is cached */
+	if (first == end || (first - sector) * 2 >= READAHEAD) {
+		return;
+	}
+
+	count = end - first;
+
+	/* a failure is reported by the read which needs the sectors */
+	if (disk->ops->read(disk, readahead_buf, first, count) != 0) {
+		return;
+	}
+
+	for (uint32_t i = 0; i < count; i++) {
+		cache_add(disk, first + i, &readahead_buf[i * SECTOR_SIZE]);
+	}
+
+	stats.readahead += count;
+}
+#endif
+
+int disk_cache_read(struct disk_info *disk, uint8_t *data_buf,
+		    uint32_t start_sector, uint32_t num_sector)
+{
+	uint32_t i = 0U;
+	int rc = 0;
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	if (!disk_cacheable(disk) || num_sector > MAX_CACHED_READ) {
+		rc = disk->ops->read(disk, data_buf, start_sector, num_sector);
+		goto out;
+	}
+
+	while (i < num_sector) {
+		struct cache_entry *entry = cache_find(disk, start_sector + i);
+		uint32_t run = 1U;
+
+		if (entry != NULL) {
+			memcpy(&data_buf[i * SECTOR_SIZE], entry->data,
+			       SECTOR_SIZE);
+			entry->last_use = ++use_cnt;
+			stats.hits++;
+			i++;
+			continue;
+		}
+
+		/* read the missing sectors in one request */
+		while (i + run < num_sector &&
+		       cache_find(disk, start_sector + i + run) == NULL) {
+			run++;
+		}
+
+		rc = disk->ops->read(disk, &data_buf[i * SECTOR_SIZE],
+				     start_sector + i, run);
+		if (rc != 0) {
+			goto out;
+		}
+
+		for (uint32_t j = i; j < i + run; j++) {
+			cache_add(disk, start_sector + j,
+				  &data_buf[j * SECTOR_SIZE]);
+		}
+
+		stats.misses += run;
+		i += run;
+	}
+
+#if READAHEAD > 0
+	if (start_sector == disk->cache.next_sector) {
+		cache_readahead(disk, start_sector + num_sector);
+	}
+#endif
+
+	disk->cache.next_sector = start_sector + num_sector;
+
+out:
+	k_mutex_unlock(&cache_lock);
+
+	return rc;
+}
+
+int disk_cache_write(struct disk_info *disk, const uint8_t *data_buf,
+		     uint32_t start_sector, uint32_t num_sector)
+{
+	int rc;
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	rc = disk->ops->write(disk, data_buf, start_sector, num_sector);
+
+	if (!disk->cache.checked) {
+		/* nothing can be cached yet */
+	} else if (rc != 0) {
+		/* the content of the sectors is unknown */
+		cache_drop(disk, start_sector, num_sector);
+	} else {
+		for (int i = 0; i < ARRAY_SIZE(entries); i++) {
+			uint32_t offset = entries[i].sector - start_sector;
+
+			if (entries[i].disk == disk && offset < num_sector) {
+				memcpy(entries[i].data,
+				       &data_buf[offset * SECTOR_SIZE],
+				       SECTOR_SIZE);
+			}
+		}
+	}
+
+	k_mutex_unlock(&cache_lock);
+
+	return rc;
+}
+
+void disk_cache_reset(struct disk_info *disk)
+{
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	/* the media may have been changed */
+	cache_drop(disk, 0, UINT32_MAX);
+	disk->cache.checked = false;
+
+	k_mutex_unlock(&cache_lock);
+}
+
+void disk_access_cache_stats_get(struct disk_cache_stats *cache_stats)
+{
+	k_mutex_lock(&cache_lock, K_FOREVER);
+	*cache_stats = stats;
+	k_mutex_unlock(&cache_lock);
+}
+
+void disk_access_cache_stats_reset(void)
+{
+	k_mutex_lock(&cache_lock, K_FOREVER);
+	(void)memset(&stats, 0, sizeof(stats));
+	k_mutex_unlock(&cache_lock);
+}
+
+void disk_access_cache_invalidate(void)
+{
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	for (int i = 0; i < ARRAY_SIZE(entries); i++) {
+		entries[i].disk = NULL;
+	}
+
+	k_mutex_unlock(&cache_lock);
+}
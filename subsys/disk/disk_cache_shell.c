@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <shell/shell.h>
+#include <disk/disk_access.h>
+
+static int cmd_disk_cache_stats(const struct shell *shell, size_t argc,
+				char **argv)
+{
+	struct disk_cache_stats stats;
+	uint32_t reads;
+
+	disk_access_cache_stats_get(&stats);
+	reads = stats.hits + stats.misses;
+
+	shell_print(shell, "hits:      %u", stats.hits);
+	shell_print(shell, "misses:    %u", stats.misses);
+	shell_print(shell, "readahead: %u", stats.readahead);
+	shell_print(shell, "hit rate:  %u%%",
+		    reads ? (uint32_t)((uint64_t)stats.hits * 100U / reads) : 0);
+
+	return 0;
+}
+
+static int cmd_disk_cache_reset(const struct shell *shell, size_t argc,
+				char **argv)
+{
+	disk_access_cache_stats_reset();
+
+	return 0;
+}
+
+static int cmd_disk_cache_invalidate(const struct shell *shell, size_t argc,
+				     char **argv)
+{
+	disk_access_cache_invalidate();
+
+	return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_disk_cache,
+	/* Alphabetically sorted. */
+	SHELL_CMD(invalidate, NULL, "Drop all cached sectors",
+		  cmd_disk_cache_invalidate),
+	SHELL_CMD(reset, NULL, "Reset the statistics", cmd_disk_cache_reset),
+	SHELL_CMD(stats, NULL, "Print the statistics", cmd_disk_cache_stats),
+	SHELL_SUBCMD_SET_END /* Array terminated. */
+);
+
+SHELL_CMD_REGISTER(disk_cache, &sub_disk_cache, "Disk sector cache commands",
+		   NULL);
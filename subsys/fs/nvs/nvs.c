@@ -29,6 +29,112 @@ static inline size_t nvs_al_size(struct nvs_fs *fs, size_t len)
 }
 /* end basic routines */
 
+/* lookup cache routines */
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+/* The lookup cache is an open addressing hash table from id to the
+ * address of the latest ate of that id.  An id without any entry in
+ * flash (e.g. whose last ate was a deletion that has been garbage
+ * collected) is kept with address NVS_LOOKUP_NONE.  As long as every id
+ * fits, an id that is not in the table does not exist in flash;
+ * once the table is full such ids have to be looked up the slow way.
+ */
+static inline size_t nvs_lookup_pos(uint16_t id)
+{
+	/* ids are often allocated consecutively, spread them out */
+	uint32_t hash = id * 0x9E3779B1U;
+
+	return (hash >> 16) % CONFIG_NVS_LOOKUP_CACHE_SIZE;
+}
+
+/* returns the slot holding id, or the free slot where it belongs, or -1
+ * if id is not in the table and there is no room for it.
+ */
+static int nvs_lookup_slot(struct nvs_fs *fs, uint16_t id)
+{
+	size_t pos = nvs_lookup_pos(id);
+
+	for (size_t i = 0; i < CONFIG_NVS_LOOKUP_CACHE_SIZE; i++) {
+		if ((fs->lookup_addr[pos] == NVS_LOOKUP_EMPTY) ||
+		    (fs->lookup_id[pos] == id)) {
+			return pos;
+		}
+		if (++pos == CONFIG_NVS_LOOKUP_CACHE_SIZE) {
+			pos = 0;
+		}
+	}
+	return -1;
+}
+
+static void nvs_lookup_clear(struct nvs_fs *fs)
+{
+	(void)memset(fs->lookup_addr, 0xff, sizeof(fs->lookup_addr));
+	fs->lookup_full = false;
+}
+
+/* lookup the address of the latest ate of id, returns false if the cache
+ * cannot tell. Otherwise addr is set to the address of the ate or to
+ * NVS_LOOKUP_NONE if there is none.
+ */
+static bool nvs_lookup_get(struct nvs_fs *fs, uint16_t id, uint32_t *addr)
+{
+	int slot = nvs_lookup_slot(fs, id);
+
+	if ((slot < 0) || (fs->lookup_addr[slot] == NVS_LOOKUP_EMPTY)) {
+		if (fs->lookup_full) {
+			return false;
+		}
+		*addr = NVS_LOOKUP_NONE;
+		return true;
+	}
+
+	*addr = fs->lookup_addr[slot];
+	return true;
+}
+
+/* record addr as the address of the latest ate of id */
+static void nvs_lookup_set(struct nvs_fs *fs, uint16_t id, uint32_t addr)
+{
+	int slot = nvs_lookup_slot(fs, id);
+
+	if (slot < 0) {
+		fs->lookup_full = true;
+		return;
+	}
+
+	fs->lookup_id[slot] = id;
+	fs->lookup_addr[slot] = addr;
+}
+
+/* forget all ate's in the sector of addr, after it has been erased */
+static void nvs_lookup_invalidate(struct nvs_fs *fs, uint32_t addr)
+{
+	addr >>= ADDR_SECT_SHIFT;
+
+	for (size_t i = 0; i < CONFIG_NVS_LOOKUP_CACHE_SIZE; i++) {
+		/* EMPTY and NONE never match a sector number */
+		if ((fs->lookup_addr[i] >> ADDR_SECT_SHIFT) == addr) {
+			fs->lookup_addr[i] = NVS_LOOKUP_NONE;
+		}
+	}
+}
+#else
+static inline bool nvs_lookup_get(struct nvs_fs *fs, uint16_t id,
+				  uint32_t *addr)
+{
+	return false;
+}
+
+static inline void nvs_lookup_set(struct nvs_fs *fs, uint16_t id,
+				  uint32_t addr)
+{
+}
+
+static inline void nvs_lookup_invalidate(struct nvs_fs *fs, uint32_t addr)
+{
+}
+#endif /* CONFIG_NVS_LOOKUP_CACHE */
+/* end lookup cache routines */
+
 /* flash routines */
 /* basic aligned flash write to nvs address */
 static int nvs_flash_al_wrt(struct nvs_fs *fs, uint32_t addr, const void *data,
@@ -252,6 +358,9 @@ static int nvs_flash_erase_sector(struct nvs_fs *fs, uint32_t addr)
 		return rc;
 	}
 	(void) flash_write_protection_set(fs->flash_device, true);
+
+	nvs_lookup_invalidate(fs, addr);
+
 	return 0;
 }
 
@@ -296,6 +405,171 @@ static int nvs_ate_cmp_const(const struct nvs_ate *entry, uint8_t value)
 	return 0;
 }
 
+/* sector summary routines */
+#ifdef CONFIG_NVS_SECTOR_SUMMARY
+/* When a sector is closed, a summary of its ate's is written after its
+ * data if there is room for it. Walks looking for an id skip the sectors
+ * whose summary tells that they have no valid ate of that id, and gc
+ * erases the sectors without valid ate's right away. Sectors closed
+ * without a valid summary are walked through as usual.
+ */
+static inline size_t nvs_sum_size(struct nvs_fs *fs)
+{
+	return nvs_al_size(fs, sizeof(struct nvs_sector_sum));
+}
+
+/* bits of the bloom filter set by id */
+static inline void nvs_sum_bits(uint16_t id, size_t *bit1, size_t *bit2)
+{
+	*bit1 = (((uint32_t)id * 0x9E3779B1U) >> 16) % NVS_SUM_BLOOM_BITS;
+	*bit2 = (((uint32_t)id * 0x85EBCA77U) >> 16) % NVS_SUM_BLOOM_BITS;
+}
+
+static void nvs_sum_reset(struct nvs_fs *fs)
+{
+	(void)memset(fs->sum_bloom, 0, sizeof(fs->sum_bloom));
+	fs->sum_ate_cnt = 0U;
+}
+
+/* account for a valid ate written in the current sector */
+static void nvs_sum_add(struct nvs_fs *fs, uint16_t id)
+{
+	size_t bit1, bit2;
+
+	nvs_sum_bits(id, &bit1, &bit2);
+	fs->sum_bloom[bit1 / 8U] |= BIT(bit1 % 8U);
+	fs->sum_bloom[bit2 / 8U] |= BIT(bit2 % 8U);
+
+	if (fs->sum_ate_cnt < UINT16_MAX) {
+		fs->sum_ate_cnt++;
+	}
+}
+
+/* write the summary of the current sector at the data write address,
+ * returns the offset of its end to store in the close ate, or 0 if it
+ * was not written.
+ */
+static uint16_t nvs_sum_wrt(struct nvs_fs *fs)
+{
+	struct nvs_sector_sum sum;
+
+	/* the summary must not reach the next ate, it would be taken for a
+	 * partially written ate if the close ate is not written.
+	 */
+	if (fs->data_wra + nvs_sum_size(fs) > fs->ate_wra) {
+		return 0;
+	}
+
+	sum.version = NVS_SUM_VERSION;
+	sum.bloom_size = sizeof(sum.bloom);
+	sum.ate_cnt = fs->sum_ate_cnt;
+	memcpy(sum.bloom, fs->sum_bloom, sizeof(sum.bloom));
+	sum.crc8 = crc8_ccitt(0xff, &sum,
+			      offsetof(struct nvs_sector_sum, crc8));
+
+	if (nvs_flash_data_wrt(fs, &sum, sizeof(sum))) {
+		return 0;
+	}
+
+	return (uint16_t)(fs->data_wra & ADDR_OFFS_MASK);
+}
+
+/* read the summary of the sector closed by close_ate, addr is in that
+ * sector. Returns 0 if the summary is valid, 1 if not, errcode if error.
+ * A summary written with another layout or filter size is not valid, its
+ * end is not where this one expects it and its crc8 could match by chance.
+ */
+static int nvs_sum_rd(struct nvs_fs *fs, uint32_t addr,
+		      const struct nvs_ate *close_ate,
+		      struct nvs_sector_sum *sum)
+{
+	size_t sum_size = nvs_sum_size(fs);
+	int rc;
+
+	if (nvs_ate_crc8_check(close_ate) || (close_ate->len < sum_size) ||
+	    (close_ate->len > close_ate->offset)) {
+		return 1;
+	}
+
+	addr &= ADDR_SECT_MASK;
+	addr += close_ate->len - sum_size;
+
+	rc = nvs_flash_rd(fs, addr, sum, sizeof(*sum));
+	if (rc) {
+		return rc;
+	}
+
+	if ((crc8_ccitt(0xff, sum, offsetof(struct nvs_sector_sum, crc8)) !=
+	     sum->crc8) || (sum->version != NVS_SUM_VERSION) ||
+	    (sum->bloom_size != sizeof(sum->bloom))) {
+		return 1;
+	}
+
+	return 0;
+}
+
+/* returns true if the sector closed by close_ate is known to have no
+ * valid ate of id, id is NVS_ID_ANY for walks through all ate's.
+ */
+static bool nvs_sum_skip(struct nvs_fs *fs, uint32_t addr,
+			 const struct nvs_ate *close_ate, int32_t id)
+{
+	struct nvs_sector_sum sum;
+	size_t bit1, bit2;
+
+	if ((id == NVS_ID_ANY) || nvs_sum_rd(fs, addr, close_ate, &sum)) {
+		return false;
+	}
+
+	nvs_sum_bits(id, &bit1, &bit2);
+
+	return !(sum.bloom[bit1 / 8U] & BIT(bit1 % 8U)) ||
+	       !(sum.bloom[bit2 / 8U] & BIT(bit2 % 8U));
+}
+
+/* returns true if the sector closed by close_ate is known to have no
+ * valid ate at all.
+ */
+static bool nvs_sum_empty(struct nvs_fs *fs, uint32_t addr,
+			  const struct nvs_ate *close_ate)
+{
+	struct nvs_sector_sum sum;
+
+	return !nvs_sum_rd(fs, addr, close_ate, &sum) && (sum.ate_cnt == 0U);
+}
+#else
+static inline size_t nvs_sum_size(struct nvs_fs *fs)
+{
+	return 0;
+}
+
+static inline void nvs_sum_reset(struct nvs_fs *fs)
+{
+}
+
+static inline void nvs_sum_add(struct nvs_fs *fs, uint16_t id)
+{
+}
+
+static inline uint16_t nvs_sum_wrt(struct nvs_fs *fs)
+{
+	return 0;
+}
+
+static inline bool nvs_sum_skip(struct nvs_fs *fs, uint32_t addr,
+				const struct nvs_ate *close_ate, int32_t id)
+{
+	return false;
+}
+
+static inline bool nvs_sum_empty(struct nvs_fs *fs, uint32_t addr,
+				 const struct nvs_ate *close_ate)
+{
+	return false;
+}
+#endif /* CONFIG_NVS_SECTOR_SUMMARY */
+/* end sector summary routines */
+
 /* store an entry in flash */
 static int nvs_flash_wrt_entry(struct nvs_fs *fs, uint16_t id, const void *data,
 				size_t len)
@@ -303,6 +577,7 @@ static int nvs_flash_wrt_entry(struct nvs_fs *fs, uint16_t id, const void *data,
 	int rc;
 	struct nvs_ate entry;
 	size_t ate_size;
+	uint32_t ate_addr = fs->ate_wra;
 
 	ate_size = nvs_al_size(fs, sizeof(struct nvs_ate));
 
@@ -322,6 +597,9 @@ static int nvs_flash_wrt_entry(struct nvs_fs *fs, uint16_t id, const void *data,
 		return rc;
 	}
 
+	nvs_lookup_set(fs, id, ate_addr);
+	nvs_sum_add(fs, id);
+
 	return 0;
 }
 /* end of flash routines */
@@ -366,9 +644,11 @@ static int nvs_recover_last_ate(struct nvs_fs *fs, uint32_t *addr)
 }
 
 /* walking through allocation entry list, from newest to oldest entries
- * read ate from addr, modify addr to the previous ate
+ * read ate from addr, modify addr to the previous ate. Unless id is
+ * NVS_ID_ANY, the sectors known to have no valid ate of id are skipped.
  */
-static int nvs_prev_ate(struct nvs_fs *fs, uint32_t *addr, struct nvs_ate *ate)
+static int nvs_prev_ate_id(struct nvs_fs *fs, uint32_t *addr,
+			   struct nvs_ate *ate, int32_t id)
 {
 	int rc;
 	struct nvs_ate close_ate;
@@ -387,23 +667,26 @@ static int nvs_prev_ate(struct nvs_fs *fs, uint32_t *addr, struct nvs_ate *ate)
 	}
 
 	/* last ate in sector, do jump to previous sector */
-	if (((*addr) >> ADDR_SECT_SHIFT) == 0U) {
-		*addr += ((fs->sector_count - 1) << ADDR_SECT_SHIFT);
-	} else {
-		*addr -= (1 << ADDR_SECT_SHIFT);
-	}
+	do {
+		if (((*addr) >> ADDR_SECT_SHIFT) == 0U) {
+			*addr += ((fs->sector_count - 1) << ADDR_SECT_SHIFT);
+		} else {
+			*addr -= (1 << ADDR_SECT_SHIFT);
+		}
 
-	rc = nvs_flash_ate_rd(fs, *addr, &close_ate);
-	if (rc) {
-		return rc;
-	}
+		rc = nvs_flash_ate_rd(fs, *addr, &close_ate);
+		if (rc) {
+			return rc;
+		}
 
-	rc = nvs_ate_cmp_const(&close_ate, fs->flash_parameters->erase_value);
-	/* at the end of filesystem */
-	if (!rc) {
-		*addr = fs->ate_wra;
-		return 0;
-	}
+		rc = nvs_ate_cmp_const(&close_ate,
+				       fs->flash_parameters->erase_value);
+		/* at the end of filesystem */
+		if (!rc) {
+			*addr = fs->ate_wra;
+			return 0;
+		}
+	} while (nvs_sum_skip(fs, *addr, &close_ate, id));
 
 	if (!nvs_ate_crc8_check(&close_ate)) {
 		/* update the address so it points to the last added ate.
@@ -428,6 +711,90 @@ static int nvs_prev_ate(struct nvs_fs *fs, uint32_t *addr, struct nvs_ate *ate)
 	return nvs_recover_last_ate(fs, addr);
 }
 
+static int nvs_prev_ate(struct nvs_fs *fs, uint32_t *addr, struct nvs_ate *ate)
+{
+	return nvs_prev_ate_id(fs, addr, ate, NVS_ID_ANY);
+}
+
+/* find the latest valid ate for id, on success its address is returned in
+ * addr. Returns -ENOENT if there is no such ate.
+ */
+static int nvs_find_latest_ate(struct nvs_fs *fs, uint16_t id, uint32_t *addr,
+			       struct nvs_ate *ate)
+{
+	int rc;
+	uint32_t wlk_addr, rd_addr;
+
+	if (nvs_lookup_get(fs, id, &rd_addr)) {
+		if (rd_addr == NVS_LOOKUP_NONE) {
+			return -ENOENT;
+		}
+		rc = nvs_flash_ate_rd(fs, rd_addr, ate);
+		if (rc) {
+			return rc;
+		}
+		if ((ate->id == id) && (!nvs_ate_crc8_check(ate))) {
+			*addr = rd_addr;
+			return 0;
+		}
+		LOG_WRN("Stale lookup cache entry for id %d", id);
+	}
+
+	wlk_addr = fs->ate_wra;
+	do {
+		rd_addr = wlk_addr;
+		rc = nvs_prev_ate_id(fs, &wlk_addr, ate, id);
+		if (rc) {
+			return rc;
+		}
+		if ((ate->id == id) && (!nvs_ate_crc8_check(ate))) {
+			*addr = rd_addr;
+			return 0;
+		}
+	} while (wlk_addr != fs->ate_wra);
+
+	return -ENOENT;
+}
+
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+/* build the lookup cache by walking through all ate's from newest to oldest,
+ * the first valid ate found for an id is its latest.
+ */
+static int nvs_lookup_rebuild(struct nvs_fs *fs)
+{
+	int rc, slot;
+	uint32_t addr, ate_addr;
+	struct nvs_ate ate;
+
+	nvs_lookup_clear(fs);
+
+	addr = fs->ate_wra;
+	do {
+		ate_addr = addr;
+		rc = nvs_prev_ate(fs, &addr, &ate);
+		if (rc) {
+			return rc;
+		}
+		if (nvs_ate_crc8_check(&ate)) {
+			continue;
+		}
+		slot = nvs_lookup_slot(fs, ate.id);
+		if (slot < 0) {
+			fs->lookup_full = true;
+		} else if (fs->lookup_addr[slot] == NVS_LOOKUP_EMPTY) {
+			fs->lookup_id[slot] = ate.id;
+			fs->lookup_addr[slot] = ate_addr;
+		}
+	} while (addr != fs->ate_wra);
+
+	if (fs->lookup_full) {
+		LOG_WRN("Lookup cache too small for all ids");
+	}
+
+	return 0;
+}
+#endif /* CONFIG_NVS_LOOKUP_CACHE */
+
 static void nvs_sector_advance(struct nvs_fs *fs, uint32_t *addr)
 {
 	*addr += (1 << ADDR_SECT_SHIFT);
@@ -448,7 +815,7 @@ static int nvs_sector_close(struct nvs_fs *fs)
 	ate_size = nvs_al_size(fs, sizeof(struct nvs_ate));
 
 	close_ate.id = 0xFFFF;
-	close_ate.len = 0U;
+	close_ate.len = nvs_sum_wrt(fs);
 	close_ate.offset = (uint16_t)((fs->ate_wra + ate_size) & ADDR_OFFS_MASK);
 
 	fs->ate_wra &= ADDR_SECT_MASK;
@@ -461,31 +828,55 @@ static int nvs_sector_close(struct nvs_fs *fs)
 	nvs_sector_advance(fs, &fs->ate_wra);
 
 	fs->data_wra = fs->ate_wra & ADDR_SECT_MASK;
+	nvs_sum_reset(fs);
 
 	return 0;
 }
 
 
-/* garbage collection: the address ate_wra has been updated to the new sector
- * that has just been started. The data to gc is in the sector after this new
+/* returns true if data of len bytes moved by garbage collection fits in the
+ * write sector. When the sector after the write sector is the one being
+ * collected, the write sector has been started for the moved data, which
+ * always fits.
+ */
+static bool nvs_gc_fits(struct nvs_fs *fs, size_t len)
+{
+#ifdef CONFIG_NVS_GC_BACKGROUND
+	size_t ate_size;
+
+	if (fs->gc_erased == 0U) {
+		return true;
+	}
+
+	/* leave space for a delete ate, as writes do */
+	ate_size = nvs_al_size(fs, sizeof(struct nvs_ate));
+	return fs->ate_wra >= fs->data_wra + nvs_al_size(fs, len) +
+			      ate_size + nvs_sum_size(fs);
+#else
+	return true;
+#endif
+}
+
+/* prepare the garbage collection of the sector at sec_addr into the write
  * sector.
  */
-static int nvs_gc(struct nvs_fs *fs)
+static int nvs_gc_start(struct nvs_fs *fs, struct nvs_gc_state *gc,
+			uint32_t sec_addr)
 {
 	int rc;
-	struct nvs_ate close_ate, gc_ate, wlk_ate;
-	uint32_t sec_addr, gc_addr, gc_prev_addr, wlk_addr, wlk_prev_addr,
-	      data_addr, stop_addr;
+	struct nvs_ate close_ate;
 	size_t ate_size;
 
 	ate_size = nvs_al_size(fs, sizeof(struct nvs_ate));
 
-	sec_addr = (fs->ate_wra & ADDR_SECT_MASK);
-	nvs_sector_advance(fs, &sec_addr);
-	gc_addr = sec_addr + fs->sector_size - ate_size;
+	gc->sec_addr = sec_addr;
+	gc->addr = sec_addr + fs->sector_size - ate_size;
+	gc->active = true;
+	gc->blocked = false;
+	gc->walk = false;
 
 	/* if the sector is not closed don't do gc */
-	rc = nvs_flash_ate_rd(fs, gc_addr, &close_ate);
+	rc = nvs_flash_ate_rd(fs, gc->addr, &close_ate);
 	if (rc < 0) {
 		/* flash error */
 		return rc;
@@ -493,58 +884,86 @@ static int nvs_gc(struct nvs_fs *fs)
 
 	rc = nvs_ate_cmp_const(&close_ate, fs->flash_parameters->erase_value);
 	if (!rc) {
-		rc = nvs_flash_erase_sector(fs, sec_addr);
-		if (rc) {
-			return rc;
-		}
 		return 0;
 	}
 
-	stop_addr = gc_addr - ate_size;
+	if (nvs_sum_empty(fs, gc->addr, &close_ate)) {
+		/* nothing to move */
+		return 0;
+	}
+
+	gc->stop_addr = gc->addr - ate_size;
 
 	if (!nvs_ate_crc8_check(&close_ate)) {
-		gc_addr &= ADDR_SECT_MASK;
-		gc_addr += close_ate.offset;
+		gc->addr &= ADDR_SECT_MASK;
+		gc->addr += close_ate.offset;
 	} else {
-		rc = nvs_recover_last_ate(fs, &gc_addr);
+		rc = nvs_recover_last_ate(fs, &gc->addr);
 		if (rc) {
 			return rc;
 		}
 	}
 
-	do {
-		gc_prev_addr = gc_addr;
-		rc = nvs_prev_ate(fs, &gc_addr, &gc_ate);
+	gc->walk = true;
+	return 0;
+}
+
+/* examine up to max ate's of the sector being garbage collected, moving the
+ * latest ones to the write sector, then erase the sector. Returns 0 once the
+ * sector is erased, 1 if ate's are left, -ENOSPC if the next data to move
+ * does not fit in the write sector, errcode if error.
+ */
+static int nvs_gc_step(struct nvs_fs *fs, struct nvs_gc_state *gc,
+		       uint32_t max)
+{
+	int rc;
+	struct nvs_ate gc_ate, wlk_ate;
+	uint32_t gc_prev_addr, wlk_addr, data_addr, ate_addr;
+
+	while (gc->walk) {
+		if (max == 0U) {
+			return 1;
+		}
+		max--;
+
+		gc_prev_addr = gc->addr;
+		rc = nvs_prev_ate(fs, &gc->addr, &gc_ate);
 		if (rc) {
 			return rc;
 		}
 
+		if (gc_prev_addr == gc->stop_addr) {
+			gc->walk = false;
+		}
+
 		if (nvs_ate_crc8_check(&gc_ate)) {
 			continue;
 		}
 
-		wlk_addr = fs->ate_wra;
-		do {
-			wlk_prev_addr = wlk_addr;
-			rc = nvs_prev_ate(fs, &wlk_addr, &wlk_ate);
-			if (rc) {
-				return rc;
-			}
-			/* if ate with same id is reached we might need to copy.
-			 * only consider valid wlk_ate's. Something wrong might
-			 * have been written that has the same ate but is
-			 * invalid, don't consider these as a match.
-			 */
-			if ((wlk_ate.id == gc_ate.id) &&
-			    (!nvs_ate_crc8_check(&wlk_ate))) {
-				break;
-			}
-		} while (wlk_addr != fs->ate_wra);
+		/* find the latest valid ate with the same id. Something wrong
+		 * might have been written that has the same id but is
+		 * invalid, this is not considered a match.
+		 */
+		rc = nvs_find_latest_ate(fs, gc_ate.id, &wlk_addr, &wlk_ate);
+		if (rc == -ENOENT) {
+			continue;
+		}
+		if (rc) {
+			return rc;
+		}
 
-		/* if walk has reached the same address as gc_addr copy is
-		 * needed unless it is a deleted item.
+		/* if the latest ate is the one at gc_addr copy is needed
+		 * unless it is a deleted item.
 		 */
-		if ((wlk_prev_addr == gc_prev_addr) && gc_ate.len) {
+		if ((wlk_addr == gc_prev_addr) && gc_ate.len) {
+			if (!nvs_gc_fits(fs, gc_ate.len)) {
+				/* examine the ate again later */
+				gc->addr = gc_prev_addr;
+				gc->walk = true;
+				gc->blocked = true;
+				return -ENOSPC;
+			}
+
 			/* copy needed */
 			LOG_DBG("Moving %d, len %d", gc_ate.id, gc_ate.len);
 
@@ -559,20 +978,213 @@ static int nvs_gc(struct nvs_fs *fs)
 				return rc;
 			}
 
+			ate_addr = fs->ate_wra;
 			rc = nvs_flash_ate_wrt(fs, &gc_ate);
 			if (rc) {
 				return rc;
 			}
+			nvs_lookup_set(fs, gc_ate.id, ate_addr);
+			nvs_sum_add(fs, gc_ate.id);
 		}
-	} while (gc_prev_addr != stop_addr);
+	}
 
-	rc = nvs_flash_erase_sector(fs, sec_addr);
+	rc = nvs_flash_erase_sector(fs, gc->sec_addr);
 	if (rc) {
 		return rc;
 	}
+
+	gc->active = false;
 	return 0;
 }
 
+/* garbage collection: the address ate_wra has been updated to the new sector
+ * that has just been started. The data to gc is in the sector after this new
+ * sector.
+ */
+static int nvs_gc(struct nvs_fs *fs)
+{
+	int rc;
+	struct nvs_gc_state gc;
+	uint32_t sec_addr;
+
+	sec_addr = (fs->ate_wra & ADDR_SECT_MASK);
+	nvs_sector_advance(fs, &sec_addr);
+
+	rc = nvs_gc_start(fs, &gc, sec_addr);
+	if (rc) {
+		return rc;
+	}
+
+	return nvs_gc_step(fs, &gc, UINT32_MAX);
+}
+
+/* background garbage collection routines */
+#ifdef CONFIG_NVS_GC_BACKGROUND
+/* Besides the sector after the write sector, which is always kept erased,
+ * the background garbage collection erases the sector after it, the oldest
+ * one, moving its latest ate's to the write sector. gc_erased counts the
+ * erased sectors after the write sector: a write which closes the write
+ * sector only collects a sector when it drops to 1. The gc_erased count is
+ * 0 while the sector after the write sector is being collected.
+ */
+static void nvs_gc_bg_reset(struct nvs_fs *fs, uint16_t erased)
+{
+	fs->gc.active = false;
+	fs->gc_erased = erased;
+}
+
+static bool nvs_gc_bg_wanted(struct nvs_fs *fs)
+{
+	if (fs->gc.active) {
+		return !fs->gc.blocked;
+	}
+
+	/* with 3 sectors the oldest sector is the one before the write sector,
+	 * which startup needs closed to find the write sector.
+	 */
+	return fs->ready && (fs->gc_erased == 1U) && (fs->sector_count > 3U) &&
+	       ((fs->ate_wra - fs->data_wra) * 100U <
+		CONFIG_NVS_GC_BACKGROUND_THRESHOLD * fs->sector_size);
+}
+
+static void nvs_gc_bg_kick(struct nvs_fs *fs)
+{
+	if (nvs_gc_bg_wanted(fs)) {
+		(void)k_delayed_work_submit(&fs->gc_work, K_NO_WAIT);
+	}
+}
+
+/* stop the background gc, a run of the work item which is already waiting for
+ * the lock finds nothing to do.
+ */
+static void nvs_gc_bg_stop(struct nvs_fs *fs)
+{
+	k_mutex_lock(&fs->nvs_lock, K_FOREVER);
+	nvs_gc_bg_reset(fs, 0U);
+	(void)k_delayed_work_cancel(&fs->gc_work);
+	k_mutex_unlock(&fs->nvs_lock);
+}
+
+/* start the background gc of the oldest sector, the sector after the erased
+ * sector which follows the write sector.
+ */
+static int nvs_gc_bg_start(struct nvs_fs *fs)
+{
+	int rc;
+	uint32_t sec_addr;
+	uint8_t erase_value = fs->flash_parameters->erase_value;
+
+	sec_addr = (fs->ate_wra & ADDR_SECT_MASK);
+	nvs_sector_advance(fs, &sec_addr);
+	nvs_sector_advance(fs, &sec_addr);
+
+	rc = nvs_flash_cmp_const(fs, sec_addr + fs->sector_size -
+				 nvs_al_size(fs, sizeof(struct nvs_ate)),
+				 erase_value, sizeof(struct nvs_ate));
+	if (!rc) {
+		/* sectors which have never been used need no erase */
+		rc = nvs_flash_cmp_const(fs, sec_addr, erase_value,
+					 fs->sector_size);
+		if (!rc) {
+			fs->gc_erased++;
+			return 0;
+		}
+	}
+	if (rc < 0) {
+		return rc;
+	}
+
+	return nvs_gc_start(fs, &fs->gc, sec_addr);
+}
+
+static void nvs_gc_bg_work(struct k_work *work)
+{
+	struct nvs_fs *fs = CONTAINER_OF(work, struct nvs_fs, gc_work.work);
+	int rc = 0;
+
+	k_mutex_lock(&fs->nvs_lock, K_FOREVER);
+
+	if (!nvs_gc_bg_wanted(fs)) {
+		goto end;
+	}
+
+	if (!fs->gc.active) {
+		rc = nvs_gc_bg_start(fs);
+		if (rc || !fs->gc.active) {
+			goto end;
+		}
+	}
+
+	rc = nvs_gc_step(fs, &fs->gc, CONFIG_NVS_GC_BACKGROUND_STEP);
+	if (rc == 0) {
+		fs->gc_erased++;
+	} else if (rc == 1) {
+		rc = 0;
+		(void)k_delayed_work_submit(&fs->gc_work, K_NO_WAIT);
+	} else if (rc == -ENOSPC) {
+		/* finished by the write which closes the write sector */
+		rc = 0;
+	}
+
+end:
+	if (rc) {
+		/* a write will collect the sector again if needed */
+		LOG_ERR("Background gc failed: %d", rc);
+		fs->gc.active = false;
+	}
+	k_mutex_unlock(&fs->nvs_lock);
+}
+
+/* garbage collection after the write sector has been closed, the sector after
+ * the new write sector has to be erased before it is used.
+ */
+static int nvs_gc_bg_closed(struct nvs_fs *fs)
+{
+	int rc;
+	uint32_t sec_addr;
+
+	if (fs->gc_erased > 1U) {
+		fs->gc_erased--;
+		return 0;
+	}
+
+	/* the background gc did not complete in time */
+	fs->gc_erased = 0U;
+	if (!fs->gc.active) {
+		sec_addr = (fs->ate_wra & ADDR_SECT_MASK);
+		nvs_sector_advance(fs, &sec_addr);
+		rc = nvs_gc_start(fs, &fs->gc, sec_addr);
+		if (rc) {
+			fs->gc.active = false;
+			return rc;
+		}
+	}
+
+	rc = nvs_gc_step(fs, &fs->gc, UINT32_MAX);
+	if (rc) {
+		fs->gc.active = false;
+		return rc;
+	}
+
+	fs->gc_erased = 1U;
+	return 0;
+}
+#else
+static inline void nvs_gc_bg_reset(struct nvs_fs *fs, uint16_t erased)
+{
+}
+
+static inline void nvs_gc_bg_kick(struct nvs_fs *fs)
+{
+}
+
+static inline int nvs_gc_bg_closed(struct nvs_fs *fs)
+{
+	return nvs_gc(fs);
+}
+#endif /* CONFIG_NVS_GC_BACKGROUND */
+/* end background garbage collection routines */
+
 static int nvs_startup(struct nvs_fs *fs)
 {
 	int rc;
@@ -585,9 +1197,14 @@ static int nvs_startup(struct nvs_fs *fs)
 	uint32_t addr = 0U;
 	uint16_t i, closed_sectors = 0;
 	uint8_t erase_value = fs->flash_parameters->erase_value;
+	bool gc_needed;
 
 	k_mutex_lock(&fs->nvs_lock, K_FOREVER);
 
+	nvs_sum_reset(fs);
+	/* a gc restarted below moves data to an empty write sector */
+	nvs_gc_bg_reset(fs, 0U);
+
 	ate_size = nvs_al_size(fs, sizeof(struct nvs_ate));
 	/* step through the sectors to find a open sector following
 	 * a closed sector, this is where NVS can to write.
@@ -662,6 +1279,8 @@ static int nvs_startup(struct nvs_fs *fs)
 				rc = -ESPIPE;
 				goto end;
 			}
+
+			nvs_sum_add(fs, last_ate.id);
 		}
 
 		fs->ate_wra -= ate_size;
@@ -693,7 +1312,8 @@ static int nvs_startup(struct nvs_fs *fs)
 	if (rc < 0) {
 		goto end;
 	}
-	if (rc) {
+	gc_needed = (rc != 0);
+	if (gc_needed) {
 		/* the sector after fs->ate_wrt is not empty */
 		rc = nvs_flash_erase_sector(fs, fs->ate_wra);
 		if (rc) {
@@ -702,12 +1322,26 @@ static int nvs_startup(struct nvs_fs *fs)
 		fs->ate_wra &= ADDR_SECT_MASK;
 		fs->ate_wra += (fs->sector_size - 2 * ate_size);
 		fs->data_wra = (fs->ate_wra & ADDR_SECT_MASK);
+		nvs_sum_reset(fs);
+	}
+
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+	/* the cache has to be in place before gc, which relies on it */
+	rc = nvs_lookup_rebuild(fs);
+	if (rc) {
+		goto end;
+	}
+#endif
+
+	if (gc_needed) {
 		rc = nvs_gc(fs);
 		if (rc) {
 			goto end;
 		}
 	}
 
+	nvs_gc_bg_reset(fs, 1U);
+
 end:
 	k_mutex_unlock(&fs->nvs_lock);
 	return rc;
@@ -723,6 +1357,11 @@ int nvs_clear(struct nvs_fs *fs)
 		return -EACCES;
 	}
 
+#ifdef CONFIG_NVS_GC_BACKGROUND
+	/* stop the background gc, nvs_init() has to be called again */
+	nvs_gc_bg_stop(fs);
+#endif
+
 	for (uint16_t i = 0; i < fs->sector_count; i++) {
 		addr = i << ADDR_SECT_SHIFT;
 		rc = nvs_flash_erase_sector(fs, addr);
@@ -740,7 +1379,17 @@ int nvs_init(struct nvs_fs *fs, const char *dev_name)
 	struct flash_pages_info info;
 	size_t write_block_size;
 
+#ifdef CONFIG_NVS_GC_BACKGROUND
+	if (fs->ready) {
+		/* initialized again, the lock and the work item are in use */
+		nvs_gc_bg_stop(fs);
+	} else {
+		k_mutex_init(&fs->nvs_lock);
+		k_delayed_work_init(&fs->gc_work, nvs_gc_bg_work);
+	}
+#else
 	k_mutex_init(&fs->nvs_lock);
+#endif
 
 	fs->flash_device = device_get_binding(dev_name);
 	if (!fs->flash_device) {
@@ -786,6 +1435,7 @@ int nvs_init(struct nvs_fs *fs, const char *dev_name)
 
 	/* nvs is ready for use */
 	fs->ready = true;
+	nvs_gc_bg_kick(fs);
 
 	LOG_INF("%d Sectors of %d bytes", fs->sector_count, fs->sector_size);
 	LOG_INF("alloc wra: %d, %x",
@@ -803,7 +1453,7 @@ ssize_t nvs_write(struct nvs_fs *fs, uint16_t id, const void *data, size_t len)
 	int rc, gc_count;
 	size_t ate_size, data_size;
 	struct nvs_ate wlk_ate;
-	uint32_t wlk_addr, rd_addr;
+	uint32_t rd_addr;
 	uint16_t required_space = 0U; /* no space, appropriate for delete ate */
 	bool prev_found = false;
 
@@ -815,32 +1465,21 @@ ssize_t nvs_write(struct nvs_fs *fs, uint16_t id, const void *data, size_t len)
 	ate_size = nvs_al_size(fs, sizeof(struct nvs_ate));
 	data_size = nvs_al_size(fs, len);
 
-	/* The maximum data size is sector size - 3 ate
+	/* The maximum data size is sector size - 3 ate - sector summary
 	 * where: 1 ate for data, 1 ate for sector close
 	 * and 1 ate to always allow a delete.
 	 */
-	if ((len > (fs->sector_size - 3 * ate_size)) ||
+	if ((len > (fs->sector_size - 3 * ate_size - nvs_sum_size(fs))) ||
 	    ((len > 0) && (data == NULL))) {
 		return -EINVAL;
 	}
 
 	/* find latest entry with same id */
-	wlk_addr = fs->ate_wra;
-	rd_addr = wlk_addr;
-
-	while (1) {
-		rd_addr = wlk_addr;
-		rc = nvs_prev_ate(fs, &wlk_addr, &wlk_ate);
-		if (rc) {
-			return rc;
-		}
-		if ((wlk_ate.id == id) && (!nvs_ate_crc8_check(&wlk_ate))) {
-			prev_found = true;
-			break;
-		}
-		if (wlk_addr == fs->ate_wra) {
-			break;
-		}
+	rc = nvs_find_latest_ate(fs, id, &rd_addr, &wlk_ate);
+	if (rc == 0) {
+		prev_found = true;
+	} else if (rc != -ENOENT) {
+		return rc;
 	}
 
 	if (prev_found) {
@@ -873,8 +1512,8 @@ ssize_t nvs_write(struct nvs_fs *fs, uint16_t id, const void *data, size_t len)
 
 	/* calculate required space if the entry contains data */
 	if (data_size) {
-		/* Leave space for delete ate */
-		required_space = data_size + ate_size;
+		/* Leave space for delete ate and sector summary */
+		required_space = data_size + ate_size + nvs_sum_size(fs);
 	}
 
 	k_mutex_lock(&fs->nvs_lock, K_FOREVER);
@@ -904,13 +1543,14 @@ ssize_t nvs_write(struct nvs_fs *fs, uint16_t id, const void *data, size_t len)
 			goto end;
 		}
 
-		rc = nvs_gc(fs);
+		rc = nvs_gc_bg_closed(fs);
 		if (rc) {
 			goto end;
 		}
 		gc_count++;
 	}
 	rc = len;
+	nvs_gc_bg_kick(fs);
 end:
 	k_mutex_unlock(&fs->nvs_lock);
 	return rc;
@@ -943,12 +1583,20 @@ ssize_t nvs_read_hist(struct nvs_fs *fs, uint16_t id, void *data, size_t len,
 
 	cnt_his = 0U;
 
-	wlk_addr = fs->ate_wra;
+	k_mutex_lock(&fs->nvs_lock, K_FOREVER);
+
+	/* start at the latest entry of id, this validates what the lookup
+	 * cache returns and falls back to a full walk if it is stale.
+	 */
+	rc = nvs_find_latest_ate(fs, id, &wlk_addr, &wlk_ate);
+	if (rc) {
+		goto err;
+	}
 	rd_addr = wlk_addr;
 
 	while (cnt_his <= cnt) {
 		rd_addr = wlk_addr;
-		rc = nvs_prev_ate(fs, &wlk_addr, &wlk_ate);
+		rc = nvs_prev_ate_id(fs, &wlk_addr, &wlk_ate, id);
 		if (rc) {
 			goto err;
 		}
@@ -962,7 +1610,8 @@ ssize_t nvs_read_hist(struct nvs_fs *fs, uint16_t id, void *data, size_t len,
 
 	if (((wlk_addr == fs->ate_wra) && (wlk_ate.id != id)) ||
 	    (wlk_ate.len == 0U) || (cnt_his < cnt)) {
-		return -ENOENT;
+		rc = -ENOENT;
+		goto err;
 	}
 
 	rd_addr &= ADDR_SECT_MASK;
@@ -972,9 +1621,11 @@ ssize_t nvs_read_hist(struct nvs_fs *fs, uint16_t id, void *data, size_t len,
 		goto err;
 	}
 
+	k_mutex_unlock(&fs->nvs_lock);
 	return wlk_ate.len;
 
 err:
+	k_mutex_unlock(&fs->nvs_lock);
 	return rc;
 }
 
@@ -1003,7 +1654,7 @@ ssize_t nvs_calc_free_space(struct nvs_fs *fs)
 
 	free_space = 0;
 	for (uint16_t i = 1; i < fs->sector_count; i++) {
-		free_space += (fs->sector_size - ate_size);
+		free_space += (fs->sector_size - ate_size - nvs_sum_size(fs));
 	}
 
 	step_addr = fs->ate_wra;
@@ -1017,7 +1668,8 @@ ssize_t nvs_calc_free_space(struct nvs_fs *fs)
 		wlk_addr = fs->ate_wra;
 
 		while (1) {
-			rc = nvs_prev_ate(fs, &wlk_addr, &wlk_ate);
+			rc = nvs_prev_ate_id(fs, &wlk_addr, &wlk_ate,
+					     step_ate.id);
 			if (rc) {
 				return rc;
 			}
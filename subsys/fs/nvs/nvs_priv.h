@@ -28,6 +28,19 @@ extern "C" {
 
 #define NVS_BLOCK_SIZE 32
 
+/*
+ * Lookup cache address values that are not ATE addresses
+ *   EMPTY: the slot is unused
+ *   NONE: the id has no entry in the file system
+ */
+#define NVS_LOOKUP_EMPTY 0xFFFFFFFF
+#define NVS_LOOKUP_NONE 0xFFFFFFFE
+
+/*
+ * Id argument of the walks through all the allocation table entries
+ */
+#define NVS_ID_ANY -1
+
 /* Allocation Table Entry */
 struct nvs_ate {
 	uint16_t id;	/* data id */
@@ -41,6 +54,24 @@ BUILD_ASSERT(offsetof(struct nvs_ate, crc8) ==
 		 sizeof(struct nvs_ate) - sizeof(uint8_t),
 		 "crc8 must be the last member");
 
+#ifdef CONFIG_NVS_SECTOR_SUMMARY
+/* Sector summary, written after the data of a sector when it is closed.
+ * The len of the close ate holds the offset of its end, or 0 if there is
+ * no summary.
+ */
+struct nvs_sector_sum {
+	uint8_t version;	/* layout version, NVS_SUM_VERSION */
+	uint8_t bloom_size;	/* size of the bloom filter */
+	uint16_t ate_cnt;	/* number of valid ate's in the sector */
+	/* bloom filter of the ids of the valid ate's in the sector */
+	uint8_t bloom[CONFIG_NVS_SECTOR_SUMMARY_BLOOM_SIZE];
+	uint8_t crc8;	/* crc8 check of the summary */
+} __packed;
+
+#define NVS_SUM_VERSION 1
+#define NVS_SUM_BLOOM_BITS (CONFIG_NVS_SECTOR_SUMMARY_BLOOM_SIZE * 8)
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -30,11 +30,20 @@ static uint8_t uart_output_buf;
 
 LOG_OUTPUT_DEFINE(log_output_uart, char_out, &uart_output_buf, 1);
 
+static uint32_t format_flag(void)
+{
+	if (IS_ENABLED(CONFIG_LOG_BACKEND_UART_DICT_ENABLE)) {
+		return LOG_OUTPUT_FLAG_FORMAT_DICT;
+	}
+
+	return IS_ENABLED(CONFIG_LOG_BACKEND_UART_SYST_ENABLE) ?
+		LOG_OUTPUT_FLAG_FORMAT_SYST : 0;
+}
+
 static void put(const struct log_backend *const backend,
 		struct log_msg *msg)
 {
-	uint32_t flag = IS_ENABLED(CONFIG_LOG_BACKEND_UART_SYST_ENABLE) ?
-		LOG_OUTPUT_FLAG_FORMAT_SYST : 0;
+	uint32_t flag = format_flag();
 
 	log_backend_std_put(&log_output_uart, flag, msg);
 }
@@ -54,15 +63,18 @@ static void dropped(const struct log_backend *const backend, uint32_t cnt)
 {
 	ARG_UNUSED(backend);
 
-	log_backend_std_dropped(&log_output_uart, cnt);
+	if (IS_ENABLED(CONFIG_LOG_BACKEND_UART_DICT_ENABLE)) {
+		log_output_dropped_dict_process(&log_output_uart, cnt);
+	} else {
+		log_backend_std_dropped(&log_output_uart, cnt);
+	}
 }
 
 static void sync_string(const struct log_backend *const backend,
 		     struct log_msg_ids src_level, uint32_t timestamp,
 		     const char *fmt, va_list ap)
 {
-	uint32_t flag = IS_ENABLED(CONFIG_LOG_BACKEND_UART_SYST_ENABLE) ?
-		LOG_OUTPUT_FLAG_FORMAT_SYST : 0;
+	uint32_t flag = format_flag();
 
 	log_backend_std_sync_string(&log_output_uart, flag, src_level,
 				    timestamp, fmt, ap);
@@ -72,8 +84,7 @@ static void sync_hexdump(const struct log_backend *const backend,
 			 struct log_msg_ids src_level, uint32_t timestamp,
 			 const char *metadata, const uint8_t *data, uint32_t length)
 {
-	uint32_t flag = IS_ENABLED(CONFIG_LOG_BACKEND_UART_SYST_ENABLE) ?
-		LOG_OUTPUT_FLAG_FORMAT_SYST : 0;
+	uint32_t flag = format_flag();
 
 	log_backend_std_sync_hexdump(&log_output_uart, flag, src_level,
 				     timestamp, metadata, data, length);
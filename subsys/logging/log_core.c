@@ -64,6 +64,8 @@ static bool panic_mode;
 static bool backend_attached;
 static atomic_t buffered_cnt;
 static atomic_t dropped_cnt;
+static atomic_t list_consumer;
+static bool consumer_takeover;
 static k_tid_t proc_tid;
 static uint32_t log_strdup_in_use;
 static uint32_t log_strdup_max;
@@ -113,7 +115,7 @@ uint32_t z_log_get_s_mask(const char *str, uint32_t nargs)
  *
  * @return True if address identified within read only section.
  */
-static bool is_rodata(const void *addr)
+bool z_log_is_rodata(const void *addr)
 {
 #if defined(CONFIG_ARM) || defined(CONFIG_ARC) || defined(CONFIG_X86)
 	extern const char *_image_rodata_start[];
@@ -164,7 +166,7 @@ static void detect_missed_strdup(struct log_msg *msg)
 	while (mask) {
 		idx = 31 - __builtin_clz(mask);
 		str = (const char *)log_msg_arg_get(msg, idx);
-		if (!is_rodata(str) && !log_is_strdup(str) &&
+		if (!z_log_is_rodata(str) && !log_is_strdup(str) &&
 			(str != log_strdup_fail_msg)) {
 			const char *src_name =
 				log_source_name_get(CONFIG_LOG_DOMAIN_ID,
@@ -192,11 +194,13 @@ static inline void msg_finalize(struct log_msg *msg,
 
 	atomic_inc(&buffered_cnt);
 
-	key = irq_lock();
-
-	log_list_add_tail(&list, msg);
-
-	irq_unlock(key);
+	if (IS_ENABLED(CONFIG_LOG_LOCKLESS)) {
+		log_list_add_tail(&list, msg);
+	} else {
+		key = irq_lock();
+		log_list_add_tail(&list, msg);
+		irq_unlock(key);
+	}
 
 	if (panic_mode) {
 		key = irq_lock();
@@ -418,7 +422,7 @@ void log_generic(struct log_msg_ids src_level, const char *fmt, va_list ap,
 				uint32_t idx = 31 - __builtin_clz(mask);
 				const char *str = (const char *)args[idx];
 
-				/* is_rodata(str) is not checked,
+				/* z_log_is_rodata(str) is not checked,
 				 * because log_strdup does it.
 				 * Hence, we will do only optional check
 				 * if already not duplicated.
@@ -605,6 +609,11 @@ void z_impl_log_panic(void)
 		}
 	}
 
+	/* The context which was interrupted by the panic may be in the middle
+	 * of taking a message off the list and will never finish it.
+	 */
+	consumer_takeover = true;
+
 	if (!IS_ENABLED(CONFIG_LOG_IMMEDIATE)) {
 		/* Flush */
 		while (log_process(false) == true) {
@@ -677,17 +686,52 @@ void dropped_notify(void)
 	}
 }
 
+/*
+ * The lock-free list has a single consumer. Contexts which process messages
+ * take turns only while they take a message off the list, with interrupts
+ * locked on the local CPU. A context on the same CPU therefore never finds
+ * the list taken, and a context on another CPU waits for a few instructions
+ * at most. After a panic, the list is taken over from a context which was
+ * interrupted while holding it.
+ */
+static unsigned int list_consumer_claim(void)
+{
+	unsigned int key = arch_irq_lock();
+
+	while (!atomic_cas(&list_consumer, 0, 1)) {
+		if (consumer_takeover) {
+			break;
+		}
+	}
+
+	return key;
+}
+
+static void list_consumer_release(unsigned int key)
+{
+	atomic_clear(&list_consumer);
+	arch_irq_unlock(key);
+}
+
 bool z_impl_log_process(bool bypass)
 {
 	struct log_msg *msg;
+	unsigned int key;
+	bool more;
 
 	if (!backend_attached && !bypass) {
 		return false;
 	}
-	unsigned int key = irq_lock();
 
-	msg = log_list_head_get(&list);
-	irq_unlock(key);
+	if (IS_ENABLED(CONFIG_LOG_LOCKLESS)) {
+		key = list_consumer_claim();
+		msg = log_list_head_get(&list);
+		list_consumer_release(key);
+	} else {
+		key = irq_lock();
+		msg = log_list_head_get(&list);
+		irq_unlock(key);
+	}
 
 	if (msg != NULL) {
 		atomic_dec(&buffered_cnt);
@@ -698,7 +742,15 @@ bool z_impl_log_process(bool bypass)
 		dropped_notify();
 	}
 
-	return (log_list_head_peek(&list) != NULL);
+	if (IS_ENABLED(CONFIG_LOG_LOCKLESS)) {
+		key = list_consumer_claim();
+		more = (log_list_head_peek(&list) != NULL);
+		list_consumer_release(key);
+	} else {
+		more = (log_list_head_peek(&list) != NULL);
+	}
+
+	return more;
 }
 
 #ifdef CONFIG_USERSPACE
@@ -887,7 +939,7 @@ char *log_strdup(const char *str)
 	int err;
 
 	if (IS_ENABLED(CONFIG_LOG_IMMEDIATE) ||
-	    is_rodata(str) || _is_user_context()) {
+	    z_log_is_rodata(str) || _is_user_context()) {
 		return (char *)str;
 	}
 
@@ -1184,7 +1236,15 @@ static void log_process_thread_func(void *dummy1, void *dummy2, void *dummy3)
 
 	while (true) {
 		if (log_process(false) == false) {
-			k_sem_take(&log_process_thread_sem, K_FOREVER);
+			/* With the lock-free list, messages can be left
+			 * behind one which is still being added. Check them
+			 * again later, as adding it does not wake the thread.
+			 */
+			k_sem_take(&log_process_thread_sem,
+				   IS_ENABLED(CONFIG_LOG_LOCKLESS) &&
+				   atomic_get(&buffered_cnt) ?
+				   K_MSEC(CONFIG_LOG_PROCESS_THREAD_SLEEP_MS) :
+				   K_FOREVER);
 		}
 	}
 }
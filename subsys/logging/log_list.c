@@ -6,6 +6,138 @@
 
 #include "log_list.h"
 
+#if defined(CONFIG_LOG_LOCKLESS)
+#include <kernel_structs.h>
+
+static inline struct log_msg *next_get(struct log_msg *msg)
+{
+	return atomic_ptr_get((atomic_ptr_t *)&msg->next);
+}
+
+static void queue_init(struct log_list_queue *queue)
+{
+	queue->stub.next = NULL;
+	queue->head = &queue->stub;
+	atomic_ptr_set(&queue->tail, &queue->stub);
+}
+
+static void queue_add(struct log_list_queue *queue, struct log_msg *msg)
+{
+	struct log_msg *prev;
+
+	msg->next = NULL;
+	prev = atomic_ptr_set(&queue->tail, msg);
+
+	/* Until prev is linked, the consumer sees the queue ending at prev. */
+	atomic_ptr_set((atomic_ptr_t *)&prev->next, msg);
+}
+
+static struct log_msg *queue_peek(struct log_list_queue *queue)
+{
+	struct log_msg *head = queue->head;
+
+	if (head == &queue->stub) {
+		head = next_get(head);
+		if (head == NULL) {
+			return NULL;
+		}
+
+		queue->head = head;
+	}
+
+	return head;
+}
+
+static struct log_msg *queue_get(struct log_list_queue *queue)
+{
+	struct log_msg *head = queue_peek(queue);
+	struct log_msg *next;
+
+	if (head == NULL) {
+		return NULL;
+	}
+
+	next = next_get(head);
+	if (next == NULL) {
+		if (atomic_ptr_get(&queue->tail) != head) {
+			/* A producer swapped the tail but did not link yet. */
+			return NULL;
+		}
+
+		/* Last message, the stub takes its place. */
+		queue_add(queue, &queue->stub);
+		next = next_get(head);
+		if (next == NULL) {
+			return NULL;
+		}
+	}
+
+	queue->head = next;
+
+	return head;
+}
+
+/* Return the queue with the oldest message at its head. */
+static struct log_list_queue *queue_oldest(struct log_list_t *list)
+{
+	struct log_list_queue *oldest = NULL;
+	struct log_msg *oldest_msg = NULL;
+
+	for (int i = 0; i < ARRAY_SIZE(list->queues); i++) {
+		struct log_msg *msg = queue_peek(&list->queues[i]);
+
+		if (msg == NULL) {
+			continue;
+		}
+
+		/* Timestamps wrap, compare the difference. */
+		if (oldest_msg == NULL ||
+		    (int32_t)(msg->hdr.timestamp -
+			      oldest_msg->hdr.timestamp) < 0) {
+			oldest = &list->queues[i];
+			oldest_msg = msg;
+		}
+	}
+
+	return oldest;
+}
+
+void log_list_init(struct log_list_t *list)
+{
+	for (int i = 0; i < ARRAY_SIZE(list->queues); i++) {
+		queue_init(&list->queues[i]);
+	}
+}
+
+void log_list_add_tail(struct log_list_t *list, struct log_msg *msg)
+{
+#if CONFIG_MP_NUM_CPUS > 1
+	/* Being moved to another CPU is harmless, the queue is multi
+	 * producer. It would only order the message after the messages
+	 * of the other CPU.
+	 */
+	queue_add(&list->queues[arch_curr_cpu()->id], msg);
+#else
+	queue_add(&list->queues[0], msg);
+#endif
+}
+
+struct log_msg *log_list_head_peek(struct log_list_t *list)
+{
+	struct log_list_queue *queue = queue_oldest(list);
+
+	return (queue != NULL) ? queue_peek(queue) : NULL;
+}
+
+struct log_msg *log_list_head_get(struct log_list_t *list)
+{
+	struct log_list_queue *queue = queue_oldest(list);
+
+	return (queue != NULL) ? queue_get(queue) : NULL;
+}
+
+#else /* CONFIG_LOG_LOCKLESS */
+
 void log_list_init(struct log_list_t *list)
 {
 	list->tail = NULL;
@@ -39,3 +171,5 @@ struct log_msg *log_list_head_get(struct log_list_t *list)
 
 	return msg;
 }
+
+#endif /* CONFIG_LOG_LOCKLESS */
@@ -12,11 +12,33 @@
 extern "C" {
 #endif
 
+#if defined(CONFIG_LOG_LOCKLESS)
+/** @brief Lock-free queue, filled by any context and emptied by one.
+ *
+ * Producers swap the tail and then link the previous tail to their message.
+ * The stub is kept in the queue so that the tail never gets NULL.
+ */
+struct log_list_queue {
+	struct log_msg *head;
+	atomic_ptr_t tail;
+	struct log_msg stub;
+};
+
+/** @brief List instance structure.
+ *
+ * Every CPU adds messages to its own queue and the consumer merges the
+ * queues by timestamp.
+ */
+struct log_list_t {
+	struct log_list_queue queues[CONFIG_MP_NUM_CPUS];
+};
+#else
 /** @brief List instance structure. */
 struct log_list_t {
 	struct log_msg *head;
 	struct log_msg *tail;
 };
+#endif
 
 /** @brief Initialize log list instance.
  *
@@ -25,6 +47,9 @@ struct log_list_t {
 void log_list_init(struct log_list_t *list);
 
 /** @brief Add item to the tail of the list.
+ *
+ * With CONFIG_LOG_LOCKLESS, it can be called from any context without
+ * locking. Other functions must only be called by one context at a time.
  *
  * @param list List instance.
  * @param msg  Message.
@@ -33,6 +58,9 @@ void log_list_init(struct log_list_t *list);
 void log_list_add_tail(struct log_list_t *list, struct log_msg *msg);
 
 /** @brief Remove item from the head of the list.
+ *
+ * With CONFIG_LOG_LOCKLESS, NULL may be returned while the list is not
+ * empty, when the message at the head is still being added.
  *
  * @param list List instance.
  *
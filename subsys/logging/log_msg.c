@@ -44,11 +44,81 @@ struct k_mem_slab log_msg_pool;
 static uint8_t __noinit __aligned(sizeof(void *))
 		log_msg_pool_buf[CONFIG_LOG_BUFFER_SIZE];
 
+#if defined(CONFIG_LOG_LOCKLESS)
+/* Free chunks form a stack linked by index. The head holds the index of
+ * the top chunk in the lower half and a tag in the upper half. The tag is
+ * incremented on every pop, so that a pop which read the next index before
+ * the chunk was taken and given back by another context fails to swap.
+ */
+#define POOL_IDX_MASK 0xFFFF
+#define POOL_TAG_INC 0x10000
+#define POOL_END POOL_IDX_MASK
+
+BUILD_ASSERT(NUM_OF_MSGS < POOL_END, "Too many log message chunks");
+
+static uint16_t pool_next[NUM_OF_MSGS];
+static atomic_t pool_head;
+
+void log_msg_pool_init(void)
+{
+	for (int i = 0; i < NUM_OF_MSGS; i++) {
+		pool_next[i] = (i + 1 < NUM_OF_MSGS) ? i + 1 : POOL_END;
+	}
+
+	atomic_set(&pool_head, NUM_OF_MSGS ? 0 : POOL_END);
+}
+
+static int chunk_alloc(union log_msg_chunk **chunk, k_timeout_t timeout)
+{
+	atomic_val_t old;
+	atomic_val_t new;
+	uint32_t idx;
+
+	ARG_UNUSED(timeout);
+
+	do {
+		old = atomic_get(&pool_head);
+		idx = old & POOL_IDX_MASK;
+		if (idx == POOL_END) {
+			return -ENOMEM;
+		}
+
+		new = ((old + POOL_TAG_INC) & ~POOL_IDX_MASK) | pool_next[idx];
+	} while (!atomic_cas(&pool_head, old, new));
+
+	*chunk = (union log_msg_chunk *)&log_msg_pool_buf[idx * MSG_SIZE];
+
+	return 0;
+}
+
+static void chunk_free(void *chunk)
+{
+	uint32_t idx = ((uint8_t *)chunk - log_msg_pool_buf) / MSG_SIZE;
+	atomic_val_t old;
+
+	do {
+		old = atomic_get(&pool_head);
+		pool_next[idx] = old & POOL_IDX_MASK;
+	} while (!atomic_cas(&pool_head, old,
+			     (old & ~POOL_IDX_MASK) | idx));
+}
+#else
 void log_msg_pool_init(void)
 {
 	k_mem_slab_init(&log_msg_pool, log_msg_pool_buf, MSG_SIZE, NUM_OF_MSGS);
 }
 
+static int chunk_alloc(union log_msg_chunk **chunk, k_timeout_t timeout)
+{
+	return k_mem_slab_alloc(&log_msg_pool, (void **)chunk, timeout);
+}
+
+static void chunk_free(void *chunk)
+{
+	k_mem_slab_free(&log_msg_pool, &chunk);
+}
+#endif
+
 /* Return true if interrupts were unlocked in the context of this call. */
 static bool is_irq_unlocked(void)
 {
@@ -74,10 +144,9 @@ static bool block_on_alloc(void)
 union log_msg_chunk *log_msg_chunk_alloc(void)
 {
 	union log_msg_chunk *msg = NULL;
-	int err = k_mem_slab_alloc(&log_msg_pool, (void **)&msg,
-		   block_on_alloc()
-		   ? K_MSEC(CONFIG_LOG_BLOCK_IN_THREAD_TIMEOUT_MS)
-		   : K_NO_WAIT);
+	int err = chunk_alloc(&msg, block_on_alloc()
+			      ? K_MSEC(CONFIG_LOG_BLOCK_IN_THREAD_TIMEOUT_MS)
+			      : K_NO_WAIT);
 
 	if (err != 0) {
 		msg = log_msg_no_space_handle();
@@ -97,7 +166,7 @@ static void cont_free(struct log_msg_cont *cont)
 
 	while (cont != NULL) {
 		next = cont->next;
-		k_mem_slab_free(&log_msg_pool, (void **)&cont);
+		chunk_free(cont);
 		cont = next;
 	}
 }
@@ -156,7 +225,7 @@ static void msg_free(struct log_msg *msg)
 		cont_free(msg->payload.ext.next);
 	}
 
-	k_mem_slab_free(&log_msg_pool, (void **)&msg);
+	chunk_free(msg);
 }
 
 union log_msg_chunk *log_msg_no_space_handle(void)
@@ -169,9 +238,7 @@ union log_msg_chunk *log_msg_no_space_handle(void)
 		do {
 			more = log_process(true);
 			log_dropped();
-			err = k_mem_slab_alloc(&log_msg_pool,
-					       (void **)&msg,
-					       K_NO_WAIT);
+			err = chunk_alloc(&msg, K_NO_WAIT);
 		} while ((err != 0) && more);
 	} else {
 		log_dropped();
@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log_output.h>
+#include <logging/log_ctrl.h>
+#include <logging/log.h>
+#include <sys/__assert.h>
+#include <string.h>
+
+/* Dictionary based output. Instead of formatting messages, records with
+ * the address of the format string and the raw arguments are written, and
+ * scripts/logging/dictionary/log_parser.py formats them on the host using
+ * the database generated from the ELF file by database_gen.py. Values are
+ * in the byte order of the target, and addresses and arguments take
+ * sizeof(log_arg_t) bytes.
+ *
+ * Every record starts with its type. A standard message follows with the
+ * ids (2 bytes), the timestamp (4 bytes), the address of the format
+ * string, the number of arguments (1 byte), the mask of string arguments
+ * copied in the record (2 bytes), the arguments and the copied strings,
+ * each terminated with a NUL character. Strings which are not in read
+ * only memory are copied, as they are not in the database.
+ *
+ * A hexdump message follows with the ids, the timestamp, the address of
+ * the metadata string, the data length (2 bytes) and the data. Messages
+ * of level 0 are raw strings logged by printk, standard messages when
+ * logging is immediate and hexdump messages otherwise.
+ *
+ * A dropped messages indication follows with the number of dropped
+ * messages (4 bytes).
+ *
+ * The ids hold the level in bits 0-2, the domain ID in bits 3-5 and the
+ * source ID in bits 6-15.
+ */
+#define DICT_MSG_STD		1
+#define DICT_MSG_HEXDUMP	2
+#define DICT_MSG_DROPPED	3
+
+#define DICT_HEXDUMP_CHUNK	16
+
+/* Longest string copied in a record. Without immediate logging the strings
+ * which are not in read only memory come from log_strdup().
+ */
+#ifdef CONFIG_LOG_STRDUP_MAX_STRING
+#define DICT_STR_MAX_LEN	CONFIG_LOG_STRDUP_MAX_STRING
+#else
+#define DICT_STR_MAX_LEN	128
+#endif
+
+static void dict_write(const struct log_output *log_output,
+		       const void *data, size_t length)
+{
+	const uint8_t *bytes = data;
+	int processed;
+
+	if (IS_ENABLED(CONFIG_LOG_IMMEDIATE)) {
+		/* The output buffer cannot be shared between contexts */
+		while (length) {
+			processed = log_output->func((uint8_t *)bytes, length,
+					log_output->control_block->ctx);
+			bytes += processed;
+			length -= processed;
+		}
+
+		return;
+	}
+
+	while (length) {
+		size_t offset = log_output->control_block->offset;
+		size_t part = MIN(length, log_output->size - offset);
+
+		memcpy(&log_output->buf[offset], bytes, part);
+		log_output->control_block->offset = offset + part;
+		bytes += part;
+		length -= part;
+
+		if (log_output->control_block->offset == log_output->size) {
+			log_output_flush(log_output);
+		}
+	}
+}
+
+static void header_write(const struct log_output *log_output, uint8_t type,
+			 struct log_msg_ids src_level, uint32_t timestamp,
+			 const char *str)
+{
+	uint16_t ids = src_level.level | (src_level.domain_id << 3) |
+		       (src_level.source_id << 6);
+	log_arg_t addr = (log_arg_t)str;
+
+	dict_write(log_output, &type, sizeof(type));
+	dict_write(log_output, &ids, sizeof(ids));
+	dict_write(log_output, &timestamp, sizeof(timestamp));
+	dict_write(log_output, &addr, sizeof(addr));
+}
+
+static void std_write(const struct log_output *log_output,
+		      struct log_msg_ids src_level, uint32_t timestamp,
+		      const char *fmt, log_arg_t *args, uint8_t nargs)
+{
+	uint32_t mask = z_log_get_s_mask(fmt, nargs);
+	uint16_t copied = 0U;
+	int i;
+
+	for (i = 0; i < nargs; i++) {
+		const void *str = (const void *)args[i];
+
+		if ((mask & BIT(i)) && !z_log_is_rodata(str)) {
+			copied |= BIT(i);
+		}
+	}
+
+	header_write(log_output, DICT_MSG_STD, src_level, timestamp, fmt);
+	dict_write(log_output, &nargs, sizeof(nargs));
+	dict_write(log_output, &copied, sizeof(copied));
+	dict_write(log_output, args, nargs * sizeof(log_arg_t));
+
+	for (i = 0; i < nargs; i++) {
+		if (copied & BIT(i)) {
+			const char *str = (const char *)args[i];
+
+			dict_write(log_output, str,
+				   strnlen(str, DICT_STR_MAX_LEN));
+			dict_write(log_output, "", 1);
+		}
+	}
+}
+
+void log_output_msg_dict_process(const struct log_output *log_output,
+				 struct log_msg *msg)
+{
+	struct log_msg_ids src_level = {
+		.level = log_msg_level_get(msg),
+		.domain_id = log_msg_domain_id_get(msg),
+		.source_id = log_msg_source_id_get(msg),
+	};
+	uint32_t timestamp = log_msg_timestamp_get(msg);
+
+	if (log_msg_is_std(msg)) {
+		log_arg_t args[LOG_MAX_NARGS];
+		uint32_t nargs = log_msg_nargs_get(msg);
+		int i;
+
+		for (i = 0; i < nargs; i++) {
+			args[i] = log_msg_arg_get(msg, i);
+		}
+
+		std_write(log_output, src_level, timestamp,
+			  log_msg_str_get(msg), args, nargs);
+	} else {
+		uint8_t buf[DICT_HEXDUMP_CHUNK];
+		uint16_t length = msg->hdr.params.hexdump.length;
+		uint32_t offset = 0U;
+		size_t part;
+
+		header_write(log_output, DICT_MSG_HEXDUMP, src_level,
+			     timestamp, log_msg_str_get(msg));
+		dict_write(log_output, &length, sizeof(length));
+
+		do {
+			part = sizeof(buf);
+			log_msg_hexdump_data_get(msg, buf, &part, offset);
+			dict_write(log_output, buf, part);
+			offset += part;
+		} while (part);
+	}
+
+	log_output_flush(log_output);
+}
+
+void log_output_string_dict_process(const struct log_output *log_output,
+				    struct log_msg_ids src_level,
+				    uint32_t timestamp, const char *fmt,
+				    va_list ap)
+{
+	log_arg_t args[LOG_MAX_NARGS];
+	uint32_t nargs = log_count_args(fmt);
+	int i;
+
+	__ASSERT_NO_MSG(nargs <= LOG_MAX_NARGS);
+
+	for (i = 0; i < nargs; i++) {
+		args[i] = va_arg(ap, log_arg_t);
+	}
+
+	std_write(log_output, src_level, timestamp, fmt, args, nargs);
+
+	log_output_flush(log_output);
+}
+
+void log_output_hexdump_dict_process(const struct log_output *log_output,
+				     struct log_msg_ids src_level,
+				     uint32_t timestamp, const char *metadata,
+				     const uint8_t *data, uint32_t length)
+{
+	uint16_t len = MIN(length, LOG_MSG_HEXDUMP_MAX_LENGTH);
+
+	header_write(log_output, DICT_MSG_HEXDUMP, src_level, timestamp,
+		     metadata);
+	dict_write(log_output, &len, sizeof(len));
+	dict_write(log_output, data, len);
+
+	log_output_flush(log_output);
+}
+
+void log_output_dropped_dict_process(const struct log_output *log_output,
+				     uint32_t cnt)
+{
+	uint8_t type = DICT_MSG_DROPPED;
+
+	dict_write(log_output, &type, sizeof(type));
+	dict_write(log_output, &cnt, sizeof(cnt));
+
+	log_output_flush(log_output);
+}
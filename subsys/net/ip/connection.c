@@ -59,6 +59,27 @@ static struct net_conn conns[CONFIG_NET_MAX_CONN];
 static sys_slist_t conn_unused;
 static sys_slist_t conn_used;
 
+#if defined(CONFIG_NET_CONN_HASH_SIZE)
+#define CONN_HASH_SIZE CONFIG_NET_CONN_HASH_SIZE
+#else
+#define CONN_HASH_SIZE 1
+#endif
+
+/* UDP and TCP handlers bound to a local port, indexed by protocol, local
+ * port and family. Handlers without a port or a family are kept in
+ * conn_wildcard and are checked for every UDP or TCP packet.
+ */
+static sys_slist_t conn_hash[CONN_HASH_SIZE];
+static sys_slist_t conn_wildcard;
+
+/* Iterator over the handlers that may accept a packet */
+struct conn_iter {
+	sys_slist_t *lists[2];
+	sys_snode_t *node;
+	uint8_t list;
+	bool indexed;
+};
+
 #if (CONFIG_NET_CONN_LOG_LEVEL >= LOG_LEVEL_DBG)
 static inline
 void conn_register_debug(struct net_conn *conn,
@@ -134,6 +155,97 @@ static void conn_set_used(struct net_conn *conn)
 	sys_slist_prepend(&conn_used, &conn->node);
 }
 
+static inline bool conn_is_indexed(uint16_t proto, uint8_t family)
+{
+	if (!(IS_ENABLED(CONFIG_NET_UDP) && proto == IPPROTO_UDP) &&
+	    !(IS_ENABLED(CONFIG_NET_TCP) && proto == IPPROTO_TCP)) {
+		return false;
+	}
+
+	return family == AF_INET || family == AF_INET6;
+}
+
+/* Port is in network byte order */
+static sys_slist_t *conn_index_list(uint16_t proto, uint8_t family,
+				    uint16_t port)
+{
+	if (!port) {
+		return &conn_wildcard;
+	}
+
+	return &conn_hash[(ntohs(port) + proto + family) % CONN_HASH_SIZE];
+}
+
+/* Return the index list the handler belongs to, or NULL if it is only
+ * reachable through conn_used.
+ */
+static sys_slist_t *conn_index_get(struct net_conn *conn)
+{
+	if (!(IS_ENABLED(CONFIG_NET_UDP) && conn->proto == IPPROTO_UDP) &&
+	    !(IS_ENABLED(CONFIG_NET_TCP) && conn->proto == IPPROTO_TCP)) {
+		return NULL;
+	}
+
+	if (!conn_is_indexed(conn->proto, conn->family)) {
+		return &conn_wildcard;
+	}
+
+	return conn_index_list(conn->proto, conn->family,
+			       net_sin(&conn->local_addr)->sin_port);
+}
+
+static struct net_conn *conn_iter_get(struct conn_iter *iter)
+{
+	while (iter->node == NULL) {
+		if (iter->list + 1 >= ARRAY_SIZE(iter->lists) ||
+		    iter->lists[iter->list + 1] == NULL) {
+			return NULL;
+		}
+
+		iter->list++;
+		iter->node = sys_slist_peek_head(iter->lists[iter->list]);
+	}
+
+	if (iter->indexed) {
+		return CONTAINER_OF(iter->node, struct net_conn, lookup_node);
+	}
+
+	return CONTAINER_OF(iter->node, struct net_conn, node);
+}
+
+/* UDP and TCP lookups only visit the index bucket of the local port and
+ * the wildcard handlers, anything else walks every handler in use. The
+ * caller still has to check each returned handler, as buckets are shared
+ * between keys. Port is in network byte order.
+ */
+static struct net_conn *conn_iter_first(struct conn_iter *iter,
+					uint16_t proto, uint8_t family,
+					uint16_t port)
+{
+	iter->indexed = conn_is_indexed(proto, family);
+	iter->list = 0U;
+
+	if (iter->indexed) {
+		iter->lists[0] = conn_index_list(proto, family, port);
+		iter->lists[1] = iter->lists[0] == &conn_wildcard ?
+				 NULL : &conn_wildcard;
+	} else {
+		iter->lists[0] = &conn_used;
+		iter->lists[1] = NULL;
+	}
+
+	iter->node = sys_slist_peek_head(iter->lists[0]);
+
+	return conn_iter_get(iter);
+}
+
+static struct net_conn *conn_iter_next(struct conn_iter *iter)
+{
+	iter->node = sys_slist_peek_next(iter->node);
+
+	return conn_iter_get(iter);
+}
+
 static void conn_set_unused(struct net_conn *conn)
 {
 	(void)memset(conn, 0, sizeof(*conn));
@@ -148,10 +260,11 @@ static struct net_conn *conn_find_handler(uint16_t proto, uint8_t family,
 					  uint16_t remote_port,
 					  uint16_t local_port)
 {
+	struct conn_iter iter;
 	struct net_conn *conn;
-	struct net_conn *tmp;
 
-	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&conn_used, conn, tmp, node) {
+	for (conn = conn_iter_first(&iter, proto, family, htons(local_port));
+	     conn; conn = conn_iter_next(&iter)) {
 		if (conn->proto != proto) {
 			continue;
 		}
@@ -250,6 +363,7 @@ int net_conn_register(uint16_t proto, uint8_t family,
 		      struct net_conn_handle **handle)
 {
 	struct net_conn *conn;
+	sys_slist_t *list;
 	uint8_t flags = 0U;
 
 	conn = conn_find_handler(proto, family, remote_addr, local_addr,
@@ -355,6 +469,11 @@ int net_conn_register(uint16_t proto, uint8_t family,
 
 	conn_set_used(conn);
 
+	list = conn_index_get(conn);
+	if (list) {
+		sys_slist_prepend(list, &conn->lookup_node);
+	}
+
 	conn_register_debug(conn, remote_port, local_port);
 
 	return 0;
@@ -366,6 +485,7 @@ error:
 int net_conn_unregister(struct net_conn_handle *handle)
 {
 	struct net_conn *conn = (struct net_conn *)handle;
+	sys_slist_t *list;
 
 	if (conn < &conns[0] || conn > &conns[CONFIG_NET_MAX_CONN]) {
 		return -EINVAL;
@@ -377,6 +497,11 @@ int net_conn_unregister(struct net_conn_handle *handle)
 
 	NET_DBG("Connection handler %p removed", conn);
 
+	list = conn_index_get(conn);
+	if (list) {
+		sys_slist_find_and_remove(list, &conn->lookup_node);
+	}
+
 	sys_slist_find_and_remove(&conn_used, &conn->node);
 
 	conn_set_unused(conn);
@@ -516,7 +641,9 @@ enum net_verdict net_conn_input(struct net_pkt *pkt,
 	bool is_bcast_pkt = false;
 	bool raw_pkt_delivered = false;
 	int16_t best_rank = -1;
+	struct conn_iter iter;
 	struct net_conn *conn;
+	uint32_t depth = 0U;
 	uint16_t src_port;
 	uint16_t dst_port;
 
@@ -580,7 +707,11 @@ enum net_verdict net_conn_input(struct net_pkt *pkt,
 		}
 	}
 
-	SYS_SLIST_FOR_EACH_CONTAINER(&conn_used, conn, node) {
+	for (conn = conn_iter_first(&iter, proto, net_pkt_family(pkt),
+				    dst_port);
+	     conn; conn = conn_iter_next(&iter)) {
+		depth++;
+
 		/* For packet socket data, the proto is set to ETH_P_ALL but
 		 * the listener might have a specific protocol set. This is ok
 		 * and let the packet pass this check in this case.
@@ -719,6 +850,10 @@ enum net_verdict net_conn_input(struct net_pkt *pkt,
 		}
 	}
 
+	if (iter.indexed) {
+		net_stats_update_conn_lookup(pkt_iface, depth);
+	}
+
 	if ((is_mcast_pkt && mcast_pkt_delivered) || raw_pkt_delivered) {
 		/* As one or more multicast or raw socket packets have already
 		 * been delivered in the loop above, we shall not call the
@@ -789,6 +924,11 @@ void net_conn_init(void)
 
 	sys_slist_init(&conn_unused);
 	sys_slist_init(&conn_used);
+	sys_slist_init(&conn_wildcard);
+
+	for (i = 0; i < CONN_HASH_SIZE; i++) {
+		sys_slist_init(&conn_hash[i]);
+	}
 
 	for (i = 0; i < CONFIG_NET_MAX_CONN; i++) {
 		sys_slist_prepend(&conn_unused, &conns[i].node);
@@ -50,6 +50,9 @@ struct net_conn {
 	/** Internal slist node */
 	sys_snode_t node;
 
+	/** Internal slist node for the handler index */
+	sys_snode_t lookup_node;
+
 	/** Remote IP address */
 	struct sockaddr remote_addr;
 
@@ -1193,14 +1193,19 @@ static int get_context_txtime(struct net_context *context,
 }
 
 /* If buf is not NULL, then use it. Otherwise read the data to be written
- * to net_pkt from msghdr.
+ * to net_pkt from msghdr. For zero-copy sends the data is already in the
+ * frags chain, which is handed over to the net_pkt instead.
  */
 static int context_write_data(struct net_pkt *pkt, const void *buf,
-			      int buf_len, const struct msghdr *msghdr)
+			      int buf_len, const struct msghdr *msghdr,
+			      struct net_buf **frags)
 {
 	int ret = 0;
 
-	if (msghdr) {
+	if (frags && *frags) {
+		net_pkt_append_buffer(pkt, *frags);
+		*frags = NULL;
+	} else if (msghdr) {
 		int i;
 
 		for (i = 0; i < msghdr->msg_iovlen; i++) {
@@ -1223,7 +1228,8 @@ static int context_setup_udp_packet(struct net_context *context,
 				    size_t len,
 				    const struct msghdr *msg,
 				    const struct sockaddr *dst_addr,
-				    socklen_t addrlen)
+				    socklen_t addrlen,
+				    struct net_buf **frags)
 {
 	int ret = -EINVAL;
 	uint16_t dst_port = 0U;
@@ -1263,7 +1269,7 @@ static int context_setup_udp_packet(struct net_context *context,
 		return ret;
 	}
 
-	ret = context_write_data(pkt, buf, len, msg);
+	ret = context_write_data(pkt, buf, len, msg, frags);
 	if (ret) {
 		return ret;
 	}
@@ -1351,9 +1357,11 @@ static int context_sendto(struct net_context *context,
 			  net_context_send_cb_t cb,
 			  k_timeout_t timeout,
 			  void *user_data,
-			  bool sendto)
+			  bool sendto,
+			  struct net_buf **frags)
 {
 	const struct msghdr *msghdr = NULL;
+	bool zerocopy = frags && *frags;
 	struct net_pkt *pkt;
 	size_t tmp_len;
 	int ret;
@@ -1528,14 +1536,17 @@ static int context_sendto(struct net_context *context,
 		}
 	}
 
-	pkt = context_alloc_pkt(context, len, PKT_WAIT_TIME);
+	/* Zero-copy data does not need room in the packet, and cannot be
+	 * truncated to fit it either.
+	 */
+	pkt = context_alloc_pkt(context, zerocopy ? 0 : len, PKT_WAIT_TIME);
 	if (!pkt) {
 		return -ENOBUFS;
 	}
 
 	tmp_len = net_pkt_available_payload_buffer(
 				pkt, net_context_get_ip_proto(context));
-	if (tmp_len < len) {
+	if (tmp_len < len && !zerocopy) {
 		len = tmp_len;
 	}
 
@@ -1595,7 +1606,7 @@ static int context_sendto(struct net_context *context,
 
 	if (IS_ENABLED(CONFIG_NET_OFFLOAD) &&
 	    net_if_is_ip_offloaded(net_context_get_iface(context))) {
-		ret = context_write_data(pkt, buf, len, msghdr);
+		ret = context_write_data(pkt, buf, len, msghdr, NULL);
 		if (ret < 0) {
 			goto fail;
 		}
@@ -1613,18 +1624,33 @@ static int context_sendto(struct net_context *context,
 	} else if (IS_ENABLED(CONFIG_NET_UDP) &&
 	    net_context_get_ip_proto(context) == IPPROTO_UDP) {
 		ret = context_setup_udp_packet(context, pkt, buf, len, msghdr,
-					       dst_addr, addrlen);
+					       dst_addr, addrlen, frags);
 		if (ret < 0) {
 			goto fail;
 		}
 
+		if (zerocopy && net_if_get_mtu(net_pkt_iface(pkt)) &&
+		    net_pkt_get_len(pkt) > net_if_get_mtu(net_pkt_iface(pkt))) {
+			ret = -EMSGSIZE;
+			goto fail;
+		}
+
 		context_finalize_packet(context, pkt);
 
 		ret = net_send_data(pkt);
 	} else if (IS_ENABLED(CONFIG_NET_TCP) &&
 		   net_context_get_ip_proto(context) == IPPROTO_TCP) {
 
-		ret = context_write_data(pkt, buf, len, msghdr);
+		if (zerocopy && pkt->buffer) {
+			/* Only the payload is queued, the headers are added
+			 * per segment. Drop the buffer reserved for them so
+			 * it does not sit in the send queue.
+			 */
+			net_buf_unref(pkt->buffer);
+			pkt->buffer = NULL;
+		}
+
+		ret = context_write_data(pkt, buf, len, msghdr, frags);
 		if (ret < 0) {
 			goto fail;
 		}
@@ -1638,7 +1664,7 @@ static int context_sendto(struct net_context *context,
 		ret = net_tcp_send_data(context, cb, user_data);
 	} else if (IS_ENABLED(CONFIG_NET_SOCKETS_PACKET) &&
 		   net_context_get_family(context) == AF_PACKET) {
-		ret = context_write_data(pkt, buf, len, msghdr);
+		ret = context_write_data(pkt, buf, len, msghdr, NULL);
 		if (ret < 0) {
 			goto fail;
 		}
@@ -1649,7 +1675,7 @@ static int context_sendto(struct net_context *context,
 	} else if (IS_ENABLED(CONFIG_NET_SOCKETS_CAN) &&
 		   net_context_get_family(context) == AF_CAN &&
 		   net_context_get_ip_proto(context) == CAN_RAW) {
-		ret = context_write_data(pkt, buf, len, msghdr);
+		ret = context_write_data(pkt, buf, len, msghdr, NULL);
 		if (ret < 0) {
 			goto fail;
 		}
@@ -1710,7 +1736,7 @@ int net_context_send(struct net_context *context,
 	}
 
 	ret = context_sendto(context, buf, len, &context->remote,
-			     addrlen, cb, timeout, user_data, false);
+			     addrlen, cb, timeout, user_data, false, NULL);
 unlock:
 	k_mutex_unlock(&context->lock);
 
@@ -1729,7 +1755,7 @@ int net_context_sendmsg(struct net_context *context,
 	k_mutex_lock(&context->lock, K_FOREVER);
 
 	ret = context_sendto(context, msghdr, 0, NULL, 0,
-			     cb, timeout, user_data, true);
+			     cb, timeout, user_data, true, NULL);
 
 	k_mutex_unlock(&context->lock);
 
@@ -1750,12 +1776,208 @@ int net_context_sendto(struct net_context *context,
 	k_mutex_lock(&context->lock, K_FOREVER);
 
 	ret = context_sendto(context, buf, len, dst_addr, addrlen,
-			     cb, timeout, user_data, true);
+			     cb, timeout, user_data, true, NULL);
+
+	k_mutex_unlock(&context->lock);
+
+	return ret;
+}
+
+#if defined(CONFIG_NET_CONTEXT_ZEROCOPY)
+/* Application buffers of one zero-copy send. The sender holds a reference
+ * until net_context_sendmsg_zc() returns, and every network buffer that
+ * points to the data holds another one: for TCP, both the buffers of the
+ * send queue and those of the segments sent from it.
+ */
+struct zc_send {
+	atomic_t refs;
+	net_context_zc_cb_t cb;
+	void *user_data;
+};
+
+static void zc_buf_destroy(struct net_buf *buf);
+
+NET_BUF_POOL_DEFINE(zc_bufs, CONFIG_NET_CONTEXT_ZEROCOPY_BUFS, 0, 0,
+		    zc_buf_destroy);
+
+K_MEM_SLAB_DEFINE(zc_slab, sizeof(struct zc_send),
+		  CONFIG_NET_CONTEXT_ZEROCOPY_BUFS, 4);
+
+static struct zc_send *zc_owner[CONFIG_NET_CONTEXT_ZEROCOPY_BUFS];
+
+static void zc_send_unref(struct zc_send *zc)
+{
+	if (atomic_dec(&zc->refs) != 1) {
+		return;
+	}
+
+	if (zc->cb) {
+		zc->cb(zc->user_data);
+	}
+
+	k_mem_slab_free(&zc_slab, (void **)&zc);
+}
+
+static void zc_buf_destroy(struct net_buf *buf)
+{
+	struct zc_send *zc = zc_owner[net_buf_id(buf)];
+
+	net_buf_destroy(buf);
+	zc_send_unref(zc);
+}
+
+int net_context_zc_slice(struct net_buf *from, size_t pos, size_t len,
+			 struct net_buf **frags)
+{
+	struct net_buf *buf, *slice, *last = NULL;
+	struct zc_send *zc;
+	size_t skip, left, part;
+
+	*frags = NULL;
+
+	for (buf = from, skip = pos, left = len; buf && left;
+	     buf = buf->frags) {
+		if (skip >= buf->len) {
+			skip -= buf->len;
+			continue;
+		}
+
+		if (net_buf_pool_get(buf->pool_id) != &zc_bufs) {
+			return -ENOTSUP;
+		}
+
+		left -= MIN(buf->len - skip, left);
+		skip = 0;
+	}
+
+	if (left) {
+		return -EINVAL;
+	}
+
+	for (buf = from, skip = pos, left = len; left; buf = buf->frags) {
+		if (skip >= buf->len) {
+			skip -= buf->len;
+			continue;
+		}
+
+		part = MIN(buf->len - skip, left);
+
+		slice = net_buf_alloc_with_data(&zc_bufs, buf->data + skip,
+						part, K_NO_WAIT);
+		if (!slice) {
+			if (*frags) {
+				net_buf_unref(*frags);
+				*frags = NULL;
+			}
+
+			return -ENOBUFS;
+		}
+
+		zc = zc_owner[net_buf_id(buf)];
+		zc_owner[net_buf_id(slice)] = zc;
+		atomic_inc(&zc->refs);
+
+		if (last) {
+			net_buf_frag_insert(last, slice);
+		} else {
+			*frags = slice;
+		}
+
+		last = slice;
+		left -= part;
+		skip = 0;
+	}
+
+	return 0;
+}
+
+int net_context_sendmsg_zc(struct net_context *context,
+			   const struct msghdr *msghdr,
+			   int flags,
+			   net_context_zc_cb_t cb,
+			   k_timeout_t timeout,
+			   void *user_data)
+{
+	struct net_buf *frags = NULL;
+	struct net_buf *last = NULL;
+	struct zc_send *zc;
+	int ret = 0;
+	size_t i;
+
+	ARG_UNUSED(flags);
+
+	/* Only the TCP stack of tcp2.c sends segments from the loaned
+	 * buffers without copying them.
+	 */
+	if (net_context_get_ip_proto(context) != IPPROTO_UDP &&
+	    !(IS_ENABLED(CONFIG_NET_TCP2) &&
+	      net_context_get_ip_proto(context) == IPPROTO_TCP)) {
+		return -EOPNOTSUPP;
+	}
+
+	if (IS_ENABLED(CONFIG_NET_OFFLOAD) &&
+	    net_if_is_ip_offloaded(net_context_get_iface(context))) {
+		return -EOPNOTSUPP;
+	}
+
+	if (k_mem_slab_alloc(&zc_slab, (void **)&zc, timeout) < 0) {
+		return -ENOBUFS;
+	}
+
+	atomic_set(&zc->refs, 1);
+	zc->cb = cb;
+	zc->user_data = user_data;
+
+	for (i = 0; i < msghdr->msg_iovlen; i++) {
+		struct net_buf *buf;
+
+		if (!msghdr->msg_iov[i].iov_len) {
+			continue;
+		}
+
+		buf = net_buf_alloc_with_data(&zc_bufs,
+					      msghdr->msg_iov[i].iov_base,
+					      msghdr->msg_iov[i].iov_len,
+					      timeout);
+		if (!buf) {
+			ret = -ENOBUFS;
+			goto out;
+		}
+
+		zc_owner[net_buf_id(buf)] = zc;
+		atomic_inc(&zc->refs);
+
+		if (last) {
+			net_buf_frag_insert(last, buf);
+		} else {
+			frags = buf;
+		}
+
+		last = buf;
+	}
+
+	k_mutex_lock(&context->lock, K_FOREVER);
+
+	ret = context_sendto(context, msghdr, 0, NULL, 0,
+			     NULL, timeout, NULL, true, &frags);
 
 	k_mutex_unlock(&context->lock);
 
+out:
+	/* Buffers not handed over to a packet are released here */
+	if (frags) {
+		net_buf_unref(frags);
+	}
+
+	if (ret < 0) {
+		zc->cb = NULL;
+	}
+
+	zc_send_unref(zc);
+
 	return ret;
 }
+#endif /* CONFIG_NET_CONTEXT_ZEROCOPY */
 
 enum net_verdict net_context_packet_received(struct net_conn *conn,
 					     struct net_pkt *pkt,
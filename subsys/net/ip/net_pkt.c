@@ -1904,6 +1904,17 @@ int net_pkt_pull(struct net_pkt *pkt, size_t length)
 			rem = length;
 		}
 
+		/* External data belongs to someone else (zero-copy sends),
+		 * so move the start of the buffer instead of the data.
+		 */
+		if ((c_op->buf->flags & NET_BUF_EXTERNAL_DATA) &&
+		    c_op->pos == c_op->buf->data && rem < left) {
+			net_buf_pull(c_op->buf, rem);
+			c_op->pos = c_op->buf->data;
+			length -= rem;
+			continue;
+		}
+
 		c_op->buf->len -= rem;
 		left -= rem;
 		if (left) {
@@ -113,6 +113,26 @@ static inline int net_context_get_timestamp(struct net_context *context,
 }
 #endif
 
+#if defined(CONFIG_NET_CONTEXT_ZEROCOPY)
+/* Point *frags to len bytes of the zero-copy buffers chained from from,
+ * pos bytes in, without copying them. Returns -ENOTSUP if some of that
+ * data is not held in zero-copy buffers.
+ */
+int net_context_zc_slice(struct net_buf *from, size_t pos, size_t len,
+			 struct net_buf **frags);
+#else
+static inline int net_context_zc_slice(struct net_buf *from, size_t pos,
+				       size_t len, struct net_buf **frags)
+{
+	ARG_UNUSED(from);
+	ARG_UNUSED(pos);
+	ARG_UNUSED(len);
+	ARG_UNUSED(frags);
+
+	return -ENOTSUP;
+}
+#endif
+
 #if defined(CONFIG_COAP)
 /**
  * @brief CoAP init function declaration. It belongs here because we don't want
@@ -1130,6 +1130,13 @@ static void net_shell_print_statistics(struct net_if *iface, void *user_data)
 	   GET_STAT(iface, tcp.connrst));
 #endif
 
+#if defined(CONFIG_NET_STATISTICS_CONN) && defined(CONFIG_NET_NATIVE)
+	PR("Conn lookups   %d\tdepth\t%d\tmax\t%d\n",
+	   GET_STAT(iface, conn.lookups),
+	   GET_STAT(iface, conn.depth),
+	   GET_STAT(iface, conn.max_depth));
+#endif
+
 #if defined(CONFIG_NET_CONTEXT_TIMESTAMP) && defined(CONFIG_NET_NATIVE)
 	if (GET_STAT(iface, tx_time.count) > 0) {
 		PR("Network pkt TX time %lu us\n",
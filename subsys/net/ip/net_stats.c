@@ -154,6 +154,13 @@ static inline void stats(struct net_if *iface)
 			 GET_STAT(iface, tcp.connrst));
 #endif
 
+#if defined(CONFIG_NET_STATISTICS_CONN)
+		NET_INFO("Conn lookups   %d\tdepth\t%d\tmax\t%d",
+			 GET_STAT(iface, conn.lookups),
+			 GET_STAT(iface, conn.depth),
+			 GET_STAT(iface, conn.max_depth));
+#endif
+
 		NET_INFO("Bytes received %u", GET_STAT(iface, bytes.received));
 		NET_INFO("Bytes sent     %u", GET_STAT(iface, bytes.sent));
 		NET_INFO("Processing err %d",
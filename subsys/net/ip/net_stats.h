@@ -269,6 +269,33 @@ static inline void net_stats_update_tcp_seg_rexmit(struct net_if *iface)
 #define net_stats_update_tcp_seg_rexmit(iface)
 #endif /* CONFIG_NET_STATISTICS_TCP */
 
+#if defined(CONFIG_NET_STATISTICS_CONN) && defined(CONFIG_NET_NATIVE)
+/* Connection lookup stats */
+static inline void net_stats_update_conn_lookup(struct net_if *iface,
+						uint32_t depth)
+{
+	UPDATE_STAT(iface, stats.conn.lookups++);
+	UPDATE_STAT(iface, stats.conn.depth += depth);
+
+	if (depth > net_stats.conn.max_depth) {
+		net_stats.conn.max_depth = depth;
+	}
+
+#if defined(CONFIG_NET_STATISTICS_PER_INTERFACE)
+	if (depth > iface->stats.conn.max_depth) {
+		iface->stats.conn.max_depth = depth;
+	}
+#endif
+}
+#else
+static inline void net_stats_update_conn_lookup(struct net_if *iface,
+						uint32_t depth)
+{
+	ARG_UNUSED(iface);
+	ARG_UNUSED(depth);
+}
+#endif /* CONFIG_NET_STATISTICS_CONN */
+
 static inline void net_stats_update_per_proto_recv(struct net_if *iface,
 						   enum net_ip_protocol proto)
 {
@@ -16,6 +16,8 @@ LOG_MODULE_REGISTER(net_route, CONFIG_NET_ROUTE_LOG_LEVEL);
 #include <limits.h>
 #include <zephyr/types.h>
 #include <sys/slist.h>
+#include <sys/dlist.h>
+#include <sys/math_extras.h>
 
 #include <net/net_pkt.h>
 #include <net/net_core.h>
@@ -36,7 +38,7 @@ LOG_MODULE_REGISTER(net_route, CONFIG_NET_ROUTE_LOG_LEVEL);
 /* We keep track of the routes in a separate list so that we can remove
  * the oldest routes (at tail) if needed.
  */
-static sys_slist_t routes;
+static sys_dlist_t routes = SYS_DLIST_STATIC_INIT(&routes);
 
 static void net_route_nexthop_remove(struct net_nbr *nbr)
 {
@@ -253,12 +255,254 @@ static int nbr_nexthop_put(struct net_nbr *nbr)
 /* Route was accessed, so place it in front of the routes list */
 static inline void update_route_access(struct net_route_entry *route)
 {
-	sys_slist_find_and_remove(&routes, &route->node);
-	sys_slist_prepend(&routes, &route->node);
+	sys_dlist_remove(&route->node);
+	sys_dlist_prepend(&routes, &route->node);
 }
 
-struct net_route_entry *net_route_lookup(struct net_if *iface,
-					 struct in6_addr *dst)
+#if defined(CONFIG_NET_ROUTE_LPM)
+/* Routes are also kept in a path compressed binary trie keyed by their
+ * prefix. A node either holds the routes with exactly its prefix, or
+ * only branches to two children. The root is the zero length prefix.
+ */
+struct route_lpm_node {
+	struct route_lpm_node *parent;
+	struct route_lpm_node *child[2];
+	sys_slist_t routes;
+	struct in6_addr prefix;
+	uint8_t len;
+};
+
+/* Every prefix adds at most one branching node to the trie */
+static struct route_lpm_node lpm_nodes[2 * CONFIG_NET_MAX_ROUTES];
+static struct route_lpm_node *lpm_free;
+static struct route_lpm_node lpm_root;
+
+static inline int lpm_bit(const struct in6_addr *addr, uint8_t pos)
+{
+	return (addr->s6_addr[pos / 8U] >> (7 - pos % 8U)) & 1;
+}
+
+static uint8_t lpm_common_len(const struct in6_addr *a,
+			      const struct in6_addr *b, uint8_t max)
+{
+	uint8_t len = 0U;
+	int i;
+
+	for (i = 0; i < 16 && len < max; i++) {
+		uint8_t diff = a->s6_addr[i] ^ b->s6_addr[i];
+
+		if (diff) {
+			len += u32_count_leading_zeros(diff) - 24;
+			break;
+		}
+
+		len += 8U;
+	}
+
+	return MIN(len, max);
+}
+
+static struct route_lpm_node *lpm_node_alloc(const struct in6_addr *prefix,
+					     uint8_t len)
+{
+	struct route_lpm_node *node = lpm_free;
+
+	if (!node) {
+		return NULL;
+	}
+
+	lpm_free = node->child[0];
+
+	(void)memset(node, 0, sizeof(*node));
+	net_ipaddr_copy(&node->prefix, prefix);
+	node->len = len;
+
+	return node;
+}
+
+static void lpm_node_free(struct route_lpm_node *node)
+{
+	node->child[0] = lpm_free;
+	lpm_free = node;
+}
+
+static inline void lpm_link(struct route_lpm_node *parent, int bit,
+			    struct route_lpm_node *child)
+{
+	parent->child[bit] = child;
+	child->parent = parent;
+}
+
+/* Return the node for the prefix, creating it if needed */
+static struct route_lpm_node *lpm_insert(const struct in6_addr *prefix,
+					 uint8_t len)
+{
+	struct route_lpm_node *node = &lpm_root;
+
+	while (node->len < len) {
+		int bit = lpm_bit(prefix, node->len);
+		struct route_lpm_node *child = node->child[bit];
+		struct route_lpm_node *split;
+		uint8_t common;
+
+		if (!child) {
+			child = lpm_node_alloc(prefix, len);
+			if (child) {
+				lpm_link(node, bit, child);
+			}
+
+			return child;
+		}
+
+		common = lpm_common_len(prefix, &child->prefix,
+					MIN(len, child->len));
+		if (common == child->len) {
+			node = child;
+			continue;
+		}
+
+		/* The prefix ends or branches off inside the compressed
+		 * path to the child, so put a node there.
+		 */
+		split = lpm_node_alloc(prefix, common);
+		if (!split) {
+			return NULL;
+		}
+
+		lpm_link(node, bit, split);
+		lpm_link(split, lpm_bit(&child->prefix, common), child);
+
+		node = split;
+	}
+
+	return node;
+}
+
+static struct route_lpm_node *lpm_find(const struct in6_addr *prefix,
+				       uint8_t len)
+{
+	struct route_lpm_node *node = &lpm_root;
+
+	while (node && node->len < len) {
+		node = node->child[lpm_bit(prefix, node->len)];
+	}
+
+	if (node && node->len == len &&
+	    net_ipv6_is_prefix(prefix->s6_addr, node->prefix.s6_addr, len)) {
+		return node;
+	}
+
+	return NULL;
+}
+
+/* Drop nodes which neither hold routes nor branch any more */
+static void lpm_prune(struct route_lpm_node *node)
+{
+	while (node != &lpm_root && sys_slist_is_empty(&node->routes) &&
+	       !(node->child[0] && node->child[1])) {
+		struct route_lpm_node *parent = node->parent;
+		struct route_lpm_node *child;
+
+		child = node->child[0] ? node->child[0] : node->child[1];
+
+		if (child) {
+			lpm_link(parent, parent->child[1] == node, child);
+		} else {
+			parent->child[parent->child[1] == node] = NULL;
+		}
+
+		lpm_node_free(node);
+
+		if (child) {
+			break;
+		}
+
+		node = parent;
+	}
+}
+
+static int lpm_add(struct net_route_entry *route)
+{
+	struct route_lpm_node *node;
+
+	node = lpm_insert(&route->addr, route->prefix_len);
+	if (!node) {
+		return -ENOMEM;
+	}
+
+	sys_slist_prepend(&node->routes, &route->lpm_node);
+
+	return 0;
+}
+
+static void lpm_del(struct net_route_entry *route)
+{
+	struct route_lpm_node *node;
+
+	node = lpm_find(&route->addr, route->prefix_len);
+	if (!node) {
+		return;
+	}
+
+	if (sys_slist_find_and_remove(&node->routes, &route->lpm_node)) {
+		lpm_prune(node);
+	}
+}
+
+static struct net_route_entry *route_find(struct net_if *iface,
+					  struct in6_addr *dst)
+{
+	struct route_lpm_node *node = &lpm_root;
+	struct net_route_entry *found = NULL;
+
+	while (node && net_ipv6_is_prefix(dst->s6_addr, node->prefix.s6_addr,
+					  node->len)) {
+		struct net_route_entry *route;
+
+		SYS_SLIST_FOR_EACH_CONTAINER(&node->routes, route, lpm_node) {
+			if (!iface || route->iface == iface) {
+				found = route;
+				break;
+			}
+		}
+
+		if (node->len == 128U) {
+			break;
+		}
+
+		node = node->child[lpm_bit(dst, node->len)];
+	}
+
+	return found;
+}
+
+static void lpm_init(void)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(lpm_nodes); i++) {
+		lpm_node_free(&lpm_nodes[i]);
+	}
+}
+#else
+static inline int lpm_add(struct net_route_entry *route)
+{
+	ARG_UNUSED(route);
+
+	return 0;
+}
+
+static inline void lpm_del(struct net_route_entry *route)
+{
+	ARG_UNUSED(route);
+}
+
+static inline void lpm_init(void)
+{
+}
+
+static struct net_route_entry *route_find(struct net_if *iface,
+					  struct in6_addr *dst)
 {
 	struct net_route_entry *route, *found = NULL;
 	uint8_t longest_match = 0U;
@@ -286,6 +530,97 @@ struct net_route_entry *net_route_lookup(struct net_if *iface,
 		}
 	}
 
+	return found;
+}
+#endif /* CONFIG_NET_ROUTE_LPM */
+
+#if CONFIG_NET_ROUTE_CACHE_SIZE > 0
+/* Direct mapped cache of recent lookups. Any change to the routes
+ * flushes it, so the cached entries are always valid.
+ */
+struct route_cache_entry {
+	struct in6_addr dst;
+	struct net_if *iface;
+	struct net_route_entry *route;
+};
+
+static struct route_cache_entry route_cache[CONFIG_NET_ROUTE_CACHE_SIZE];
+
+static inline struct route_cache_entry *route_cache_slot(struct net_if *iface,
+							 struct in6_addr *dst)
+{
+	uint32_t hash = UNALIGNED_GET(&dst->s6_addr32[2]) ^
+			UNALIGNED_GET(&dst->s6_addr32[3]) ^
+			POINTER_TO_UINT(iface);
+
+	hash ^= hash >> 16;
+
+	return &route_cache[hash % CONFIG_NET_ROUTE_CACHE_SIZE];
+}
+
+static struct net_route_entry *route_cache_get(struct net_if *iface,
+					       struct in6_addr *dst)
+{
+	struct route_cache_entry *entry = route_cache_slot(iface, dst);
+
+	if (entry->route && entry->iface == iface &&
+	    net_ipv6_addr_cmp(&entry->dst, dst)) {
+		return entry->route;
+	}
+
+	return NULL;
+}
+
+static void route_cache_put(struct net_if *iface, struct in6_addr *dst,
+			    struct net_route_entry *route)
+{
+	struct route_cache_entry *entry = route_cache_slot(iface, dst);
+
+	net_ipaddr_copy(&entry->dst, dst);
+	entry->iface = iface;
+	entry->route = route;
+}
+
+static inline void route_cache_flush(void)
+{
+	(void)memset(route_cache, 0, sizeof(route_cache));
+}
+#else
+static inline struct net_route_entry *route_cache_get(struct net_if *iface,
+						      struct in6_addr *dst)
+{
+	ARG_UNUSED(iface);
+	ARG_UNUSED(dst);
+
+	return NULL;
+}
+
+static inline void route_cache_put(struct net_if *iface, struct in6_addr *dst,
+				   struct net_route_entry *route)
+{
+	ARG_UNUSED(iface);
+	ARG_UNUSED(dst);
+	ARG_UNUSED(route);
+}
+
+static inline void route_cache_flush(void)
+{
+}
+#endif /* CONFIG_NET_ROUTE_CACHE_SIZE > 0 */
+
+struct net_route_entry *net_route_lookup(struct net_if *iface,
+					 struct in6_addr *dst)
+{
+	struct net_route_entry *found;
+
+	found = route_cache_get(iface, dst);
+	if (!found) {
+		found = route_find(iface, dst);
+		if (found) {
+			route_cache_put(iface, dst, found);
+		}
+	}
+
 	if (found) {
 		net_route_info("Found", found, dst);
 
@@ -353,9 +688,7 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 	nbr = nbr_new(iface, addr, prefix_len);
 	if (!nbr) {
 		/* Remove the oldest route and try again */
-		sys_snode_t *last = sys_slist_peek_tail(&routes);
-
-		sys_slist_find_and_remove(&routes, last);
+		sys_dnode_t *last = sys_dlist_peek_tail(&routes);
 
 		route = CONTAINER_OF(last,
 				     struct net_route_entry,
@@ -390,18 +723,27 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 		}
 	}
 
+	route = net_route_data(nbr);
+	route->iface = iface;
+
+	if (lpm_add(route) < 0) {
+		NET_ERR("No room for the route in the lookup trie!");
+		nbr_free(nbr);
+		return NULL;
+	}
+
 	tmp = get_nexthop_route();
 	if (!tmp) {
 		NET_ERR("No nexthop route available!");
+		lpm_del(route);
+		nbr_free(nbr);
 		return NULL;
 	}
 
 	nexthop_route = net_nexthop_data(tmp);
 
-	route = net_route_data(nbr);
-	route->iface = iface;
-
-	sys_slist_prepend(&routes, &route->node);
+	sys_dlist_prepend(&routes, &route->node);
+	route_cache_flush();
 
 	tmp = nbr_nexthop_get(iface, nexthop);
 
@@ -454,13 +796,18 @@ int net_route_del(struct net_route_entry *route)
 	net_mgmt_event_notify(NET_EVENT_IPV6_ROUTE_DEL, route->iface);
 #endif
 
-	sys_slist_find_and_remove(&routes, &route->node);
+	if (sys_dnode_is_linked(&route->node)) {
+		sys_dlist_remove(&route->node);
+	}
 
 	nbr = net_route_get_nbr(route);
 	if (!nbr) {
 		return -ENOENT;
 	}
 
+	lpm_del(route);
+	route_cache_flush();
+
 	net_route_info("Deleted", route, &route->addr);
 
 	SYS_SLIST_FOR_EACH_CONTAINER(&route->nexthop, nexthop_route, node) {
@@ -910,6 +1257,8 @@ int net_route_packet_if(struct net_pkt *pkt, struct net_if *iface)
 
 void net_route_init(void)
 {
+	lpm_init();
+
 	NET_DBG("Allocated %d routing entries (%zu bytes)",
 		CONFIG_NET_MAX_ROUTES, sizeof(net_route_entries_pool));
 
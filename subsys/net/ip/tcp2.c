@@ -31,6 +31,9 @@ static int tcp_window = NET_IPV6_MTU;
 
 static sys_slist_t tcp_conns = SYS_SLIST_STATIC_INIT(&tcp_conns);
 
+/* Connections with both endpoints known, indexed by their 4-tuple */
+static sys_slist_t tcp_conn_hash[CONFIG_NET_TCP_CONN_HASH_SIZE];
+
 static K_MEM_SLAB_DEFINE(tcp_conns_slab, sizeof(struct tcp),
 				CONFIG_NET_MAX_CONTEXTS, 4);
 
@@ -290,6 +293,60 @@ static void tcp_send_queue_flush(struct tcp *conn)
 	}
 }
 
+static uint32_t tcp_endpoints_hash(const union tcp_endpoint *local,
+				   const union tcp_endpoint *remote)
+{
+	const uint32_t *la, *ra;
+	uint32_t hash;
+	int words;
+
+	if (local->sa.sa_family == AF_INET) {
+		la = (const uint32_t *)&local->sin.sin_addr;
+		ra = (const uint32_t *)&remote->sin.sin_addr;
+		words = sizeof(struct in_addr) / sizeof(uint32_t);
+	} else {
+		la = (const uint32_t *)&local->sin6.sin6_addr;
+		ra = (const uint32_t *)&remote->sin6.sin6_addr;
+		words = sizeof(struct in6_addr) / sizeof(uint32_t);
+	}
+
+	/* Ports are at the same offset for both families */
+	hash = ((uint32_t)local->sin.sin_port << 16) | remote->sin.sin_port;
+
+	for (int i = 0; i < words; i++) {
+		hash = (hash ^ la[i] ^ (ra[i] << 1)) * 0x9E3779B1U;
+	}
+
+	return (hash >> 16) % CONFIG_NET_TCP_CONN_HASH_SIZE;
+}
+
+static inline sys_slist_t *tcp_conn_bucket(struct tcp *conn)
+{
+	return &tcp_conn_hash[tcp_endpoints_hash(&conn->src, &conn->dst)];
+}
+
+/* To be called once both conn->src and conn->dst are set */
+static void tcp_conn_hash_add(struct tcp *conn)
+{
+	int key = irq_lock();
+
+	if (!conn->in_hash) {
+		sys_slist_prepend(tcp_conn_bucket(conn), &conn->hash_next);
+		conn->in_hash = true;
+	}
+
+	irq_unlock(key);
+}
+
+static void tcp_conn_hash_remove(struct tcp *conn)
+{
+	if (conn->in_hash) {
+		sys_slist_find_and_remove(tcp_conn_bucket(conn),
+					  &conn->hash_next);
+		conn->in_hash = false;
+	}
+}
+
 static int tcp_conn_unref(struct tcp *conn)
 {
 	int key, ref_count = atomic_get(&conn->ref_count);
@@ -336,6 +393,7 @@ static int tcp_conn_unref(struct tcp *conn)
 	k_delayed_work_cancel(&conn->timewait_timer);
 	k_delayed_work_cancel(&conn->fin_timer);
 
+	tcp_conn_hash_remove(conn);
 	sys_slist_find_and_remove(&tcp_conns, &conn->next);
 
 	memset(conn, 0, sizeof(*conn));
@@ -753,6 +811,46 @@ static int tcp_pkt_peek(struct net_pkt *to, struct net_pkt *from, size_t pos,
 	return net_pkt_copy(to, from, len);
 }
 
+/* Packet holding len bytes of the send queue, pos bytes in. Data loaned
+ * with net_context_sendmsg_zc() is referenced rather than copied, so that
+ * its buffers are released only when the segment is freed too.
+ */
+static struct net_pkt *tcp_pkt_data(struct tcp *conn, size_t pos, size_t len)
+{
+	struct net_buf *frags;
+	struct net_pkt *pkt;
+	int ret;
+
+	ret = net_context_zc_slice(conn->send_data->buffer, pos, len, &frags);
+	if (ret == 0) {
+		pkt = tcp_pkt_alloc(conn, 0);
+		if (!pkt) {
+			net_buf_unref(frags);
+			return NULL;
+		}
+
+		net_pkt_append_buffer(pkt, frags);
+
+		return pkt;
+	}
+
+	if (ret != -ENOTSUP) {
+		return NULL;
+	}
+
+	pkt = tcp_pkt_alloc(conn, len);
+	if (!pkt) {
+		return NULL;
+	}
+
+	if (tcp_pkt_peek(pkt, conn->send_data, pos, len) < 0) {
+		tcp_pkt_unref(pkt);
+		return NULL;
+	}
+
+	return pkt;
+}
+
 static bool tcp_window_full(struct tcp *conn)
 {
 	bool window_full = !(conn->unacked_len < conn->send_win);
@@ -791,20 +889,13 @@ static int tcp_send_data(struct tcp *conn)
 		   conn->send_win - conn->unacked_len,
 		   conn_mss(conn));
 
-	pkt = tcp_pkt_alloc(conn, len);
+	pkt = tcp_pkt_data(conn, pos, len);
 	if (!pkt) {
 		NET_ERR("conn: %p packet allocation failed, len=%d", conn, len);
 		ret = -ENOBUFS;
 		goto out;
 	}
 
-	ret = tcp_pkt_peek(pkt, conn->send_data, pos, len);
-	if (ret < 0) {
-		tcp_pkt_unref(pkt);
-		ret = -ENOBUFS;
-		goto out;
-	}
-
 	ret = tcp_out_ext(conn, PSH | ACK, pkt, conn->seq + conn->unacked_len);
 	if (ret == 0) {
 		conn->unacked_len += len;
@@ -1012,39 +1103,29 @@ out:
 	return ret;
 }
 
-static bool tcp_endpoint_cmp(union tcp_endpoint *ep, struct net_pkt *pkt,
-			     enum pkt_addr which)
-{
-	union tcp_endpoint ep_tmp;
-
-	if (tcp_endpoint_set(&ep_tmp, pkt, which) < 0) {
-		return false;
-	}
-
-	return !memcmp(ep, &ep_tmp, tcp_endpoint_len(ep->sa.sa_family));
-}
-
-static bool tcp_conn_cmp(struct tcp *conn, struct net_pkt *pkt)
-{
-	return tcp_endpoint_cmp(&conn->src, pkt, TCP_EP_DST) &&
-		tcp_endpoint_cmp(&conn->dst, pkt, TCP_EP_SRC);
-}
-
 static struct tcp *tcp_conn_search(struct net_pkt *pkt)
 {
-	bool found = false;
+	union tcp_endpoint local, remote;
 	struct tcp *conn;
-	struct tcp *tmp;
+	size_t len;
 
-	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&tcp_conns, conn, tmp, next) {
+	if (tcp_endpoint_set(&local, pkt, TCP_EP_DST) < 0 ||
+	    tcp_endpoint_set(&remote, pkt, TCP_EP_SRC) < 0) {
+		return NULL;
+	}
 
-		found = tcp_conn_cmp(conn, pkt);
-		if (found) {
-			break;
+	len = tcp_endpoint_len(local.sa.sa_family);
+
+	SYS_SLIST_FOR_EACH_CONTAINER(
+		&tcp_conn_hash[tcp_endpoints_hash(&local, &remote)],
+		conn, hash_next) {
+		if (!memcmp(&conn->src, &local, len) &&
+		    !memcmp(&conn->dst, &remote, len)) {
+			return conn;
 		}
 	}
 
-	return found ? conn : NULL;
+	return NULL;
 }
 
 static struct tcp *tcp_conn_new(struct net_pkt *pkt);
@@ -1126,6 +1207,8 @@ static struct tcp *tcp_conn_new(struct net_pkt *pkt)
 		goto err;
 	}
 
+	tcp_conn_hash_add(conn);
+
 	NET_DBG("conn: src: %s, dst: %s",
 		log_strdup(net_sprint_addr(conn->src.sa.sa_family,
 				(const void *)&conn->src.sin.sin_addr)),
@@ -1676,6 +1759,10 @@ int net_tcp_connect(struct net_context *context,
 		ret = -EPROTONOSUPPORT;
 	}
 
+	if (ret == 0) {
+		tcp_conn_hash_add(conn);
+	}
+
 	NET_DBG("conn: %p src: %s, dst: %s", conn,
 		log_strdup(net_sprint_addr(conn->src.sa.sa_family,
 				(const void *)&conn->src.sin.sin_addr)),
@@ -1869,6 +1956,7 @@ static enum net_verdict tcp_input(struct net_conn *net_conn,
 			conn = context->tcp;
 			tcp_endpoint_set(&conn->dst, pkt, TCP_EP_SRC);
 			tcp_endpoint_set(&conn->src, pkt, TCP_EP_DST);
+			tcp_conn_hash_add(conn);
 			/* Make an extra reference, the sanity check suite
 			 * will delete the connection explicitly
 			 */
@@ -1990,6 +2078,7 @@ enum net_verdict tp_input(struct net_conn *net_conn,
 				conn = context->tcp;
 				tcp_endpoint_set(&conn->dst, pkt, TCP_EP_SRC);
 				tcp_endpoint_set(&conn->src, pkt, TCP_EP_DST);
+				tcp_conn_hash_add(conn);
 				conn->iface = pkt->iface;
 				tcp_conn_ref(conn);
 			}
@@ -178,6 +178,7 @@ struct tcp_options {
 
 struct tcp { /* TCP connection */
 	sys_snode_t next;
+	sys_snode_t hash_next; /* in tcp_conn_hash, once endpoints are set */
 	struct net_context *context;
 	struct net_pkt *send_data;
 	struct net_if *iface;
@@ -207,6 +208,7 @@ struct tcp { /* TCP connection */
 	bool in_retransmission : 1;
 	bool in_connect : 1;
 	bool in_close : 1;
+	bool in_hash : 1;
 };
 
 #define _flags(_fl, _op, _mask, _cond)					\
@@ -31,6 +31,7 @@ LOG_MODULE_REGISTER(LOG_MODULE_NAME);
 #include <net/net_ip.h>
 #include <net/http_parser_url.h>
 #include <net/socket.h>
+#include <sys/fdtable.h>
 #if defined(CONFIG_LWM2M_DTLS_SUPPORT)
 #include <net/tls_credentials.h>
 #endif
@@ -88,6 +89,8 @@ struct observe_node {
 	uint8_t  token[MAX_TOKEN_LEN];
 	int64_t event_timestamp;
 	int64_t last_timestamp;
+	int64_t due_timestamp;
+	int heap_index;
 	uint32_t min_period_sec;
 	uint32_t max_period_sec;
 	uint32_t counter;
@@ -107,6 +110,15 @@ struct notification_attrs {
 
 static struct observe_node observe_node_data[CONFIG_LWM2M_ENGINE_MAX_OBSERVER];
 
+/* Observers in a min-heap on due_timestamp, the time at which their next
+ * notification has to be checked.  Resources are set from any thread,
+ * so the heap and the timestamps of the observers are protected by
+ * observe_lock.
+ */
+static struct observe_node *observe_heap[CONFIG_LWM2M_ENGINE_MAX_OBSERVER];
+static int observe_heap_len;
+static struct k_spinlock observe_lock;
+
 #define MAX_PERIODIC_SERVICE	10
 
 struct service_node {
@@ -120,6 +132,33 @@ static struct service_node service_node_data[MAX_PERIODIC_SERVICE];
 
 static sys_slist_t engine_obj_list;
 static sys_slist_t engine_obj_inst_list;
+
+/* Bumped whenever an object instance or a resource instance goes away,
+ * so that resource handles know to resolve their path again.  Handles
+ * which failed to resolve hold 0, which is never a current generation.
+ */
+static uint32_t engine_generation = 1U;
+
+#if defined(CONFIG_LWM2M_ENGINE_PATH_INDEX)
+/* Objects are keyed by their ID, object instances by the object ID in the
+ * upper and the instance ID in the lower 16 bits.  Entries which don't fit
+ * are counted in "overflow" and are only found by walking the lists.
+ */
+struct engine_index_entry {
+	uint32_t key;
+	void *ptr;
+};
+
+struct engine_index {
+	struct engine_index_entry entries[CONFIG_LWM2M_ENGINE_PATH_INDEX_SIZE];
+	int len;
+	int overflow;
+};
+
+static struct engine_index engine_obj_index;
+static struct engine_index engine_obj_inst_index;
+#endif
+
 static sys_slist_t engine_observer_list;
 static sys_slist_t engine_service_list;
 
@@ -129,10 +168,17 @@ static struct k_thread engine_thread_data;
 
 #define MAX_POLL_FD		CONFIG_NET_SOCKETS_POLL_MAX
 
+/* The first entry is the wakeup file descriptor, which has no context */
 static struct lwm2m_ctx *sock_ctx[MAX_POLL_FD];
 static struct pollfd sock_fds[MAX_POLL_FD];
 static int sock_nfds;
 
+/* Raised to wake the engine thread up from poll() when it has to
+ * recompute its timeout, e.g. after a resource change.
+ */
+static struct k_poll_signal engine_wakeup_signal =
+	K_POLL_SIGNAL_INITIALIZER(engine_wakeup_signal);
+
 #define NUM_BLOCK1_CONTEXT	CONFIG_LWM2M_NUM_BLOCK1_CONTEXT
 
 /* TODO: figure out what's correct value */
@@ -355,9 +401,108 @@ static void clear_attrs(void *ref)
 	}
 }
 
+static void engine_wakeup(void)
+{
+	k_poll_signal_raise(&engine_wakeup_signal, 0);
+}
+
+/* observer scheduling, called with observe_lock held */
+
+static int64_t observe_due(struct observe_node *obs)
+{
+	/* same conditions as a manual notification and an automatic one;
+	 * observers without a maximum period are checked at the engine
+	 * update interval.
+	 */
+	if (obs->event_timestamp > obs->last_timestamp) {
+		return obs->last_timestamp + 1 +
+		       (int64_t)MSEC_PER_SEC * obs->min_period_sec;
+	}
+
+	return obs->last_timestamp + 1 +
+	       MAX((int64_t)MSEC_PER_SEC * obs->max_period_sec,
+		   ENGINE_UPDATE_INTERVAL_MS);
+}
+
+static void observe_heap_set(int i, struct observe_node *obs)
+{
+	observe_heap[i] = obs;
+	obs->heap_index = i;
+}
+
+static void observe_heap_fix(int i)
+{
+	struct observe_node *obs = observe_heap[i];
+	int child;
+
+	while (i > 0 && observe_heap[(i - 1) / 2]->due_timestamp >
+			obs->due_timestamp) {
+		observe_heap_set(i, observe_heap[(i - 1) / 2]);
+		i = (i - 1) / 2;
+	}
+
+	while ((child = 2 * i + 1) < observe_heap_len) {
+		if (child + 1 < observe_heap_len &&
+		    observe_heap[child + 1]->due_timestamp <
+		    observe_heap[child]->due_timestamp) {
+			child++;
+		}
+
+		if (observe_heap[child]->due_timestamp >=
+		    obs->due_timestamp) {
+			break;
+		}
+
+		observe_heap_set(i, observe_heap[child]);
+		i = child;
+	}
+
+	observe_heap_set(i, obs);
+}
+
+static void observe_reschedule(struct observe_node *obs)
+{
+	obs->due_timestamp = observe_due(obs);
+	observe_heap_fix(obs->heap_index);
+}
+
+static void observe_schedule(struct observe_node *obs)
+{
+	obs->due_timestamp = observe_due(obs);
+	observe_heap_set(observe_heap_len++, obs);
+	observe_heap_fix(obs->heap_index);
+}
+
+static void observe_unschedule(struct observe_node *obs)
+{
+	int i = obs->heap_index;
+
+	observe_heap_len--;
+	if (i < observe_heap_len) {
+		observe_heap_set(i, observe_heap[observe_heap_len]);
+		observe_heap_fix(i);
+	}
+}
+
+static void engine_free_observer(sys_snode_t *prev_node,
+				 struct observe_node *obs)
+{
+	k_spinlock_key_t key;
+
+	sys_slist_remove(&engine_observer_list, prev_node, &obs->node);
+
+	key = k_spin_lock(&observe_lock);
+	observe_unschedule(obs);
+	k_spin_unlock(&observe_lock, key);
+
+	(void)memset(obs, 0, sizeof(*obs));
+}
+
 int lwm2m_notify_observer(uint16_t obj_id, uint16_t obj_inst_id, uint16_t res_id)
 {
 	struct observe_node *obs;
+	k_spinlock_key_t key;
+	bool first;
 	int ret = 0;
 
 	/* look for observers which match our resource */
@@ -367,7 +512,16 @@ int lwm2m_notify_observer(uint16_t obj_id, uint16_t obj_inst_id, uint16_t res_id
 		    (obs->path.level < 3 ||
 		     obs->path.res_id == res_id)) {
 			/* update the event time for this observer */
+			key = k_spin_lock(&observe_lock);
 			obs->event_timestamp = k_uptime_get();
+			observe_reschedule(obs);
+			first = obs->heap_index == 0;
+			k_spin_unlock(&observe_lock, key);
+
+			/* the engine may sleep past the new due time */
+			if (first) {
+				engine_wakeup();
+			}
 
 			LOG_DBG("NOTIFY EVENT %u/%u/%u",
 				obj_id, obj_inst_id, res_id);
@@ -396,6 +550,7 @@ static int engine_add_observer(struct lwm2m_message *msg,
 	struct notification_attrs attrs = {
 		.flags = BIT(LWM2M_ATTR_PMIN) | BIT(LWM2M_ATTR_PMAX),
 	};
+	k_spinlock_key_t key;
 	int i, ret;
 
 	if (!msg || !msg->ctx) {
@@ -525,6 +680,10 @@ static int engine_add_observer(struct lwm2m_message *msg,
 	sys_slist_append(&engine_observer_list,
 			 &observe_node_data[i].node);
 
+	key = k_spin_lock(&observe_lock);
+	observe_schedule(&observe_node_data[i]);
+	k_spin_unlock(&observe_lock, key);
+
 	LOG_DBG("OBSERVER ADDED %u/%u/%u(%u) token:'%s' addr:%s",
 		msg->path.obj_id, msg->path.obj_inst_id,
 		msg->path.res_id, msg->path.level,
@@ -559,8 +718,7 @@ static int engine_remove_observer(const uint8_t *token, uint8_t tkl)
 		return -ENOENT;
 	}
 
-	sys_slist_remove(&engine_observer_list, prev_node, &found_obj->node);
-	(void)memset(found_obj, 0, sizeof(*found_obj));
+	engine_free_observer(prev_node, found_obj);
 
 	LOG_DBG("observer '%s' removed", log_strdup(sprint_token(token, tkl)));
 
@@ -581,8 +739,88 @@ static void engine_remove_observer_by_id(uint16_t obj_id, int32_t obj_inst_id)
 			continue;
 		}
 
-		sys_slist_remove(&engine_observer_list, prev_node, &obs->node);
-		(void)memset(obs, 0, sizeof(*obs));
+		engine_free_observer(prev_node, obs);
+	}
+}
+
+/* engine object index */
+
+#if defined(CONFIG_LWM2M_ENGINE_PATH_INDEX)
+#define OBJ_INST_KEY(obj_id, obj_inst_id) \
+	(((uint32_t)(obj_id) << 16) | (uint16_t)(obj_inst_id))
+
+/* Position of the first entry with a key not lower than the given one */
+static int engine_index_bound(struct engine_index *idx, uint32_t key)
+{
+	int lo = 0, hi = idx->len;
+
+	while (lo < hi) {
+		int mid = (lo + hi) / 2;
+
+		if (idx->entries[mid].key < key) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+
+	return lo;
+}
+
+static void engine_index_add(struct engine_index *idx, uint32_t key,
+			     void *ptr)
+{
+	int pos;
+
+	if (idx->len == ARRAY_SIZE(idx->entries)) {
+		idx->overflow++;
+		return;
+	}
+
+	pos = engine_index_bound(idx, key);
+	memmove(&idx->entries[pos + 1], &idx->entries[pos],
+		(idx->len - pos) * sizeof(idx->entries[0]));
+	idx->entries[pos].key = key;
+	idx->entries[pos].ptr = ptr;
+	idx->len++;
+}
+
+static void engine_index_remove(struct engine_index *idx, uint32_t key,
+				void *ptr)
+{
+	int pos = engine_index_bound(idx, key);
+
+	if (pos == idx->len || idx->entries[pos].ptr != ptr) {
+		if (idx->overflow > 0) {
+			idx->overflow--;
+		}
+
+		return;
+	}
+
+	idx->len--;
+	memmove(&idx->entries[pos], &idx->entries[pos + 1],
+		(idx->len - pos) * sizeof(idx->entries[0]));
+}
+
+/* Returns NULL if the key is not in the index */
+static void *engine_index_find(struct engine_index *idx, uint32_t key)
+{
+	int pos = engine_index_bound(idx, key);
+
+	if (pos < idx->len && idx->entries[pos].key == key) {
+		return idx->entries[pos].ptr;
+	}
+
+	return NULL;
+}
+#endif
+
+static void engine_invalidate_res_handles(void)
+{
+	engine_generation++;
+	if (engine_generation == 0U) {
+		engine_generation = 1U;
 	}
 }
 
@@ -591,18 +829,32 @@ static void engine_remove_observer_by_id(uint16_t obj_id, int32_t obj_inst_id)
 void lwm2m_register_obj(struct lwm2m_engine_obj *obj)
 {
 	sys_slist_append(&engine_obj_list, &obj->node);
+#if defined(CONFIG_LWM2M_ENGINE_PATH_INDEX)
+	engine_index_add(&engine_obj_index, obj->obj_id, obj);
+#endif
 }
 
 void lwm2m_unregister_obj(struct lwm2m_engine_obj *obj)
 {
 	engine_remove_observer_by_id(obj->obj_id, -1);
 	sys_slist_find_and_remove(&engine_obj_list, &obj->node);
+#if defined(CONFIG_LWM2M_ENGINE_PATH_INDEX)
+	engine_index_remove(&engine_obj_index, obj->obj_id, obj);
+#endif
+	engine_invalidate_res_handles();
 }
 
 static struct lwm2m_engine_obj *get_engine_obj(int obj_id)
 {
 	struct lwm2m_engine_obj *obj;
 
+#if defined(CONFIG_LWM2M_ENGINE_PATH_INDEX)
+	obj = engine_index_find(&engine_obj_index, obj_id);
+	if (obj || engine_obj_index.overflow == 0) {
+		return obj;
+	}
+#endif
+
 	SYS_SLIST_FOR_EACH_CONTAINER(&engine_obj_list, obj, node) {
 		if (obj->obj_id == obj_id) {
 			return obj;
@@ -618,6 +870,12 @@ lwm2m_get_engine_obj_field(struct lwm2m_engine_obj *obj, int res_id)
 	int i;
 
 	if (obj && obj->fields && obj->field_count > 0) {
+		/* Most objects list their fields in resource ID order */
+		if (res_id < obj->field_count &&
+		    obj->fields[res_id].res_id == res_id) {
+			return &obj->fields[res_id];
+		}
+
 		for (i = 0; i < obj->field_count; i++) {
 			if (obj->fields[i].res_id == res_id) {
 				return &obj->fields[i];
@@ -633,6 +891,11 @@ lwm2m_get_engine_obj_field(struct lwm2m_engine_obj *obj, int res_id)
 static void engine_register_obj_inst(struct lwm2m_engine_obj_inst *obj_inst)
 {
 	sys_slist_append(&engine_obj_inst_list, &obj_inst->node);
+#if defined(CONFIG_LWM2M_ENGINE_PATH_INDEX)
+	engine_index_add(&engine_obj_inst_index,
+			 OBJ_INST_KEY(obj_inst->obj->obj_id,
+				      obj_inst->obj_inst_id), obj_inst);
+#endif
 }
 
 static void engine_unregister_obj_inst(struct lwm2m_engine_obj_inst *obj_inst)
@@ -640,6 +903,12 @@ static void engine_unregister_obj_inst(struct lwm2m_engine_obj_inst *obj_inst)
 	engine_remove_observer_by_id(
 			obj_inst->obj->obj_id, obj_inst->obj_inst_id);
 	sys_slist_find_and_remove(&engine_obj_inst_list, &obj_inst->node);
+#if defined(CONFIG_LWM2M_ENGINE_PATH_INDEX)
+	engine_index_remove(&engine_obj_inst_index,
+			    OBJ_INST_KEY(obj_inst->obj->obj_id,
+					 obj_inst->obj_inst_id), obj_inst);
+#endif
+	engine_invalidate_res_handles();
 }
 
 static struct lwm2m_engine_obj_inst *get_engine_obj_inst(int obj_id,
@@ -647,6 +916,14 @@ static struct lwm2m_engine_obj_inst *get_engine_obj_inst(int obj_id,
 {
 	struct lwm2m_engine_obj_inst *obj_inst;
 
+#if defined(CONFIG_LWM2M_ENGINE_PATH_INDEX)
+	obj_inst = engine_index_find(&engine_obj_inst_index,
+				     OBJ_INST_KEY(obj_id, obj_inst_id));
+	if (obj_inst || engine_obj_inst_index.overflow == 0) {
+		return obj_inst;
+	}
+#endif
+
 	SYS_SLIST_FOR_EACH_CONTAINER(&engine_obj_inst_list, obj_inst,
 				     node) {
 		if (obj_inst->obj->obj_id == obj_id &&
@@ -663,6 +940,22 @@ next_engine_obj_inst(int obj_id, int obj_inst_id)
 {
 	struct lwm2m_engine_obj_inst *obj_inst, *next = NULL;
 
+#if defined(CONFIG_LWM2M_ENGINE_PATH_INDEX)
+	if (engine_obj_inst_index.overflow == 0) {
+		/* obj_inst_id is -1 to get the first instance */
+		uint32_t key = obj_inst_id < 0 ? OBJ_INST_KEY(obj_id, 0) :
+			       OBJ_INST_KEY(obj_id, obj_inst_id) + 1;
+		int pos = engine_index_bound(&engine_obj_inst_index, key);
+
+		if (pos < engine_obj_inst_index.len &&
+		    engine_obj_inst_index.entries[pos].key >> 16 == obj_id) {
+			next = engine_obj_inst_index.entries[pos].ptr;
+		}
+
+		return next;
+	}
+#endif
+
 	SYS_SLIST_FOR_EACH_CONTAINER(&engine_obj_inst_list, obj_inst,
 				     node) {
 		if (obj_inst->obj->obj_id == obj_id &&
@@ -1261,10 +1554,15 @@ static int path_to_objs(const struct lwm2m_obj_path *path,
 		return -ENOENT;
 	}
 
-	for (i = 0; i < oi->resource_count; i++) {
+	/* Resources and resource instances are usually in ID order too */
+	if (path->res_id < oi->resource_count &&
+	    oi->resources[path->res_id].res_id == path->res_id) {
+		r = &oi->resources[path->res_id];
+	}
+
+	for (i = 0; !r && i < oi->resource_count; i++) {
 		if (oi->resources[i].res_id == path->res_id) {
 			r = &oi->resources[i];
-			break;
 		}
 	}
 
@@ -1273,10 +1571,15 @@ static int path_to_objs(const struct lwm2m_obj_path *path,
 		return -ENOENT;
 	}
 
-	for (i = 0; i < r->res_inst_count; i++) {
+	if (path->res_inst_id < r->res_inst_count &&
+	    r->res_instances[path->res_inst_id].res_inst_id ==
+	    path->res_inst_id) {
+		ri = &r->res_instances[path->res_inst_id];
+	}
+
+	for (i = 0; !ri && i < r->res_inst_count; i++) {
 		if (r->res_instances[i].res_inst_id == path->res_inst_id) {
 			ri = &r->res_instances[i];
-			break;
 		}
 	}
 
@@ -1361,46 +1664,22 @@ int lwm2m_engine_set_res_data(char *pathstr, void *data_ptr, uint16_t data_len,
 	return ret;
 }
 
-static int lwm2m_engine_set(char *pathstr, void *value, uint16_t len)
+static int engine_set_res(struct lwm2m_obj_path *path,
+			  struct lwm2m_engine_obj_inst *obj_inst,
+			  struct lwm2m_engine_obj_field *obj_field,
+			  struct lwm2m_engine_res *res,
+			  struct lwm2m_engine_res_inst *res_inst,
+			  void *value, uint16_t len)
 {
-	struct lwm2m_obj_path path;
-	struct lwm2m_engine_obj_inst *obj_inst;
-	struct lwm2m_engine_obj_field *obj_field;
-	struct lwm2m_engine_res *res = NULL;
-	struct lwm2m_engine_res_inst *res_inst = NULL;
 	void *data_ptr = NULL;
 	size_t max_data_len = 0;
 	int ret = 0;
 	bool changed = false;
 
-	LOG_DBG("path:%s, value:%p, len:%d", log_strdup(pathstr), value, len);
-
-	/* translate path -> path_obj */
-	ret = string_to_path(pathstr, &path, '/');
-	if (ret < 0) {
-		return ret;
-	}
-
-	if (path.level < 3) {
-		LOG_ERR("path must have at least 3 parts");
-		return -EINVAL;
-	}
-
-	/* look up resource obj */
-	ret = path_to_objs(&path, &obj_inst, &obj_field, &res, &res_inst);
-	if (ret < 0) {
-		return ret;
-	}
-
-	if (!res_inst) {
-		LOG_ERR("res instance %d not found", path.res_inst_id);
-		return -ENOENT;
-	}
-
 	if (LWM2M_HAS_RES_FLAG(res_inst, LWM2M_RES_DATA_FLAG_RO)) {
 		LOG_ERR("res instance data pointer is read-only "
-			"[%u/%u/%u/%u:%u]", path.obj_id, path.obj_inst_id,
-			path.res_id, path.res_inst_id, path.level);
+			"[%u/%u/%u/%u:%u]", path->obj_id, path->obj_inst_id,
+			path->res_id, path->res_inst_id, path->level);
 		return -EACCES;
 	}
 
@@ -1417,8 +1696,8 @@ static int lwm2m_engine_set(char *pathstr, void *value, uint16_t len)
 
 	if (!data_ptr) {
 		LOG_ERR("res instance data pointer is NULL [%u/%u/%u/%u:%u]",
-			path.obj_id, path.obj_inst_id, path.res_id,
-			path.res_inst_id, path.level);
+			path->obj_id, path->obj_inst_id, path->res_id,
+			path->res_inst_id, path->level);
 		return -EINVAL;
 	}
 
@@ -1426,7 +1705,7 @@ static int lwm2m_engine_set(char *pathstr, void *value, uint16_t len)
 	if (len > res_inst->max_data_len -
 		(obj_field->data_type == LWM2M_RES_TYPE_STRING ? 1 : 0)) {
 		LOG_ERR("length %u is too long for res instance %d data",
-			len, path.res_id);
+			len, path->res_id);
 		return -ENOMEM;
 	}
 
@@ -1516,12 +1795,49 @@ static int lwm2m_engine_set(char *pathstr, void *value, uint16_t len)
 	}
 
 	if (changed) {
-		NOTIFY_OBSERVER_PATH(&path);
+		NOTIFY_OBSERVER_PATH(path);
 	}
 
 	return ret;
 }
 
+static int lwm2m_engine_set(char *pathstr, void *value, uint16_t len)
+{
+	struct lwm2m_obj_path path;
+	struct lwm2m_engine_obj_inst *obj_inst;
+	struct lwm2m_engine_obj_field *obj_field;
+	struct lwm2m_engine_res *res = NULL;
+	struct lwm2m_engine_res_inst *res_inst = NULL;
+	int ret = 0;
+
+	LOG_DBG("path:%s, value:%p, len:%d", log_strdup(pathstr), value, len);
+
+	/* translate path -> path_obj */
+	ret = string_to_path(pathstr, &path, '/');
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (path.level < 3) {
+		LOG_ERR("path must have at least 3 parts");
+		return -EINVAL;
+	}
+
+	/* look up resource obj */
+	ret = path_to_objs(&path, &obj_inst, &obj_field, &res, &res_inst);
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (!res_inst) {
+		LOG_ERR("res instance %d not found", path.res_inst_id);
+		return -ENOENT;
+	}
+
+	return engine_set_res(&path, obj_inst, obj_field, res, res_inst,
+			      value, len);
+}
+
 int lwm2m_engine_set_opaque(char *pathstr, char *data_ptr, uint16_t data_len)
 {
 	return lwm2m_engine_set(pathstr, data_ptr, data_len);
@@ -1632,41 +1948,15 @@ int lwm2m_engine_get_res_data(char *pathstr, void **data_ptr, uint16_t *data_len
 	return 0;
 }
 
-static int lwm2m_engine_get(char *pathstr, void *buf, uint16_t buflen)
+static int engine_get_res(struct lwm2m_engine_obj_inst *obj_inst,
+			  struct lwm2m_engine_obj_field *obj_field,
+			  struct lwm2m_engine_res *res,
+			  struct lwm2m_engine_res_inst *res_inst,
+			  void *buf, uint16_t buflen)
 {
-	int ret = 0;
-	struct lwm2m_obj_path path;
-	struct lwm2m_engine_obj_inst *obj_inst;
-	struct lwm2m_engine_obj_field *obj_field;
-	struct lwm2m_engine_res *res = NULL;
-	struct lwm2m_engine_res_inst *res_inst = NULL;
 	void *data_ptr = NULL;
 	size_t data_len = 0;
 
-	LOG_DBG("path:%s, buf:%p, buflen:%d", log_strdup(pathstr), buf, buflen);
-
-	/* translate path -> path_obj */
-	ret = string_to_path(pathstr, &path, '/');
-	if (ret < 0) {
-		return ret;
-	}
-
-	if (path.level < 3) {
-		LOG_ERR("path must have at least 3 parts");
-		return -EINVAL;
-	}
-
-	/* look up resource obj */
-	ret = path_to_objs(&path, &obj_inst, &obj_field, &res, &res_inst);
-	if (ret < 0) {
-		return ret;
-	}
-
-	if (!res_inst) {
-		LOG_ERR("res instance %d not found", path.res_inst_id);
-		return -ENOENT;
-	}
-
 	/* setup initial data elements */
 	data_ptr = res_inst->data_ptr;
 	data_len = res_inst->data_len;
@@ -1762,6 +2052,42 @@ static int lwm2m_engine_get(char *pathstr, void *buf, uint16_t buflen)
 	return 0;
 }
 
+static int lwm2m_engine_get(char *pathstr, void *buf, uint16_t buflen)
+{
+	int ret = 0;
+	struct lwm2m_obj_path path;
+	struct lwm2m_engine_obj_inst *obj_inst;
+	struct lwm2m_engine_obj_field *obj_field;
+	struct lwm2m_engine_res *res = NULL;
+	struct lwm2m_engine_res_inst *res_inst = NULL;
+
+	LOG_DBG("path:%s, buf:%p, buflen:%d", log_strdup(pathstr), buf, buflen);
+
+	/* translate path -> path_obj */
+	ret = string_to_path(pathstr, &path, '/');
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (path.level < 3) {
+		LOG_ERR("path must have at least 3 parts");
+		return -EINVAL;
+	}
+
+	/* look up resource obj */
+	ret = path_to_objs(&path, &obj_inst, &obj_field, &res, &res_inst);
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (!res_inst) {
+		LOG_ERR("res instance %d not found", path.res_inst_id);
+		return -ENOENT;
+	}
+
+	return engine_get_res(obj_inst, obj_field, res, res_inst, buf, buflen);
+}
+
 int lwm2m_engine_get_opaque(char *pathstr, void *buf, uint16_t buflen)
 {
 	return lwm2m_engine_get(pathstr, buf, buflen);
@@ -1858,6 +2184,102 @@ int lwm2m_engine_get_resource(char *pathstr, struct lwm2m_engine_res **res)
 	return path_to_objs(&path, NULL, NULL, res, NULL);
 }
 
+static int res_handle_resolve(struct lwm2m_engine_res_handle *handle)
+{
+	struct lwm2m_obj_path path = {
+		.obj_id = handle->obj_id,
+		.obj_inst_id = handle->obj_inst_id,
+		.res_id = handle->res_id,
+		.res_inst_id = handle->res_inst_id,
+		.level = handle->level,
+	};
+	struct lwm2m_engine_res_inst *res_inst = NULL;
+	int ret;
+
+	handle->generation = 0U;
+
+	ret = path_to_objs(&path, &handle->obj_inst, &handle->obj_field,
+			   &handle->res, &res_inst);
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (!res_inst) {
+		LOG_ERR("res instance %d not found", path.res_inst_id);
+		return -ENOENT;
+	}
+
+	handle->res_inst = res_inst;
+	handle->generation = engine_generation;
+
+	return 0;
+}
+
+int lwm2m_engine_get_res_handle(char *pathstr,
+				struct lwm2m_engine_res_handle *handle)
+{
+	struct lwm2m_obj_path path;
+	int ret;
+
+	ret = string_to_path(pathstr, &path, '/');
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (path.level < 3) {
+		LOG_ERR("path must have at least 3 parts");
+		return -EINVAL;
+	}
+
+	(void)memset(handle, 0, sizeof(*handle));
+	handle->obj_id = path.obj_id;
+	handle->obj_inst_id = path.obj_inst_id;
+	handle->res_id = path.res_id;
+	handle->res_inst_id = path.res_inst_id;
+	handle->level = path.level;
+
+	return res_handle_resolve(handle);
+}
+
+int lwm2m_engine_set_by_handle(struct lwm2m_engine_res_handle *handle,
+			       void *value, uint16_t len)
+{
+	struct lwm2m_obj_path path = {
+		.obj_id = handle->obj_id,
+		.obj_inst_id = handle->obj_inst_id,
+		.res_id = handle->res_id,
+		.res_inst_id = handle->res_inst_id,
+		.level = handle->level,
+	};
+	int ret;
+
+	if (handle->generation != engine_generation) {
+		ret = res_handle_resolve(handle);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	return engine_set_res(&path, handle->obj_inst, handle->obj_field,
+			      handle->res, handle->res_inst, value, len);
+}
+
+int lwm2m_engine_get_by_handle(struct lwm2m_engine_res_handle *handle,
+			       void *buf, uint16_t buflen)
+{
+	int ret;
+
+	if (handle->generation != engine_generation) {
+		ret = res_handle_resolve(handle);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	return engine_get_res(handle->obj_inst, handle->obj_field,
+			      handle->res, handle->res_inst, buf, buflen);
+}
+
 void lwm2m_engine_get_binding(char *binding)
 {
 	if (IS_ENABLED(CONFIG_LWM2M_QUEUE_MODE_ENABLED)) {
@@ -1951,6 +2373,7 @@ int lwm2m_engine_delete_res_inst(char *pathstr)
 	res_inst->max_data_len = 0U;
 	res_inst->data_len = 0U;
 	res_inst->res_inst_id = RES_INSTANCE_NOT_CREATED;
+	engine_invalidate_res_handles();
 
 	return 0;
 }
@@ -2447,6 +2870,7 @@ static int lwm2m_write_attr_handler(struct lwm2m_engine_obj *obj,
 	struct lwm2m_attr *attr;
 	struct notification_attrs nattrs = { 0 };
 	struct observe_node *obs;
+	k_spinlock_key_t key;
 	uint8_t type = 0U;
 	void *nattr_ptrs[NR_LWM2M_ATTR] = {
 		&nattrs.pmin, &nattrs.pmax, &nattrs.gt, &nattrs.lt, &nattrs.st
@@ -2762,8 +3186,11 @@ static int lwm2m_write_attr_handler(struct lwm2m_engine_obj *obj,
 			obs->path.res_id, obs->path.level,
 			obs->min_period_sec, obs->max_period_sec,
 			nattrs.pmin, MAX(nattrs.pmin, nattrs.pmax));
+		key = k_spin_lock(&observe_lock);
 		obs->min_period_sec = (uint32_t)nattrs.pmin;
 		obs->max_period_sec = (uint32_t)MAX(nattrs.pmin, nattrs.pmax);
+		observe_reschedule(obs);
+		k_spin_unlock(&observe_lock, key);
 		(void)memset(&nattrs, 0, sizeof(nattrs));
 	}
 
@@ -4012,44 +4439,75 @@ int lwm2m_engine_add_service(k_work_handler_t service, uint32_t period_ms)
 	sys_slist_append(&engine_service_list,
 			 &service_node_data[i].node);
 
+	engine_wakeup();
+
 	return 0;
 }
 
-static int lwm2m_engine_service(void)
+/* Take the next observer to notify, if one is due by the given time */
+static struct observe_node *engine_next_observer(int64_t timestamp,
+						 bool *manual_trigger)
 {
-	struct observe_node *obs;
-	struct service_node *srv;
-	int64_t timestamp, service_due_timestamp;
+	struct observe_node *obs = NULL;
+	k_spinlock_key_t key = k_spin_lock(&observe_lock);
+
+	if (observe_heap_len > 0 &&
+	    observe_heap[0]->due_timestamp <= timestamp) {
+		obs = observe_heap[0];
 
-	/*
-	 * 1. scan the observer list
-	 * 2. For each notify event found, scan the observer list
-	 * 3. For each observer match, generate a NOTIFY message,
-	 *    attaching the notify response handler
-	 */
-	timestamp = k_uptime_get();
-	SYS_SLIST_FOR_EACH_CONTAINER(&engine_observer_list, obs, node) {
 		/*
 		 * manual notify requirements:
 		 * - event_timestamp > last_timestamp
 		 * - current timestamp > last_timestamp + min_period_sec
+		 * otherwise it is an automatic time-based notify.
 		 */
-		if (obs->event_timestamp > obs->last_timestamp &&
-		    timestamp > obs->last_timestamp +
-				MSEC_PER_SEC * obs->min_period_sec) {
-			obs->last_timestamp = k_uptime_get();
-			generate_notify_message(obs, true);
+		*manual_trigger = obs->event_timestamp > obs->last_timestamp;
+		obs->last_timestamp = timestamp;
+		observe_reschedule(obs);
+	}
 
-		/*
-		 * automatic time-based notify requirements:
-		 * - current timestamp > last_timestamp + max_period_sec
-		 */
-		} else if (timestamp > obs->last_timestamp +
-				MSEC_PER_SEC * obs->max_period_sec) {
-			obs->last_timestamp = k_uptime_get();
-			generate_notify_message(obs, false);
-		}
+	k_spin_unlock(&observe_lock, key);
+
+	return obs;
+}
+
+/*
+ * Time until the first observer is due, plus the batch window, so that
+ * the observers due within the window are notified in the same pass.
+ */
+static int64_t engine_next_observer_timeout_ms(int64_t max_timeout)
+{
+	k_spinlock_key_t key = k_spin_lock(&observe_lock);
+	int64_t timeout = max_timeout;
 
+	if (observe_heap_len > 0) {
+		timeout = MIN(timeout, observe_heap[0]->due_timestamp +
+			      MSEC_PER_SEC *
+			      CONFIG_LWM2M_ENGINE_NOTIFY_BATCH_WINDOW -
+			      k_uptime_get());
+	}
+
+	k_spin_unlock(&observe_lock, key);
+
+	return MAX(timeout, 0);
+}
+
+static int lwm2m_engine_service(void)
+{
+	struct observe_node *obs;
+	struct service_node *srv;
+	int64_t timestamp, service_due_timestamp, timeout;
+	bool manual_trigger;
+
+	/*
+	 * 1. take the observers which are due from the observer heap
+	 * 2. For each one, generate a NOTIFY message, attaching the
+	 *    notify response handler
+	 */
+	timestamp = k_uptime_get();
+	while ((obs = engine_next_observer(timestamp,
+					   &manual_trigger)) != NULL) {
+		generate_notify_message(obs, manual_trigger);
 	}
 
 	timestamp = k_uptime_get();
@@ -4063,8 +4521,21 @@ static int lwm2m_engine_service(void)
 		}
 	}
 
-	/* calculate how long to sleep till the next service */
-	return engine_next_service_timeout_ms(ENGINE_UPDATE_INTERVAL_MS);
+	/* calculate how long to sleep till the next service or notify */
+	timeout = engine_next_observer_timeout_ms(
+			engine_next_service_timeout_ms(INT32_MAX));
+
+	/* without a wakeup descriptor, changes are picked up by polling */
+	if (sock_fds[0].fd < 0) {
+		return MIN(timeout, ENGINE_UPDATE_INTERVAL_MS);
+	}
+
+	/* nothing to do until woken up */
+	if (timeout == INT32_MAX) {
+		return SYS_FOREVER_MS;
+	}
+
+	return timeout;
 }
 
 int lwm2m_engine_context_close(struct lwm2m_ctx *client_ctx)
@@ -4082,9 +4553,7 @@ int lwm2m_engine_context_close(struct lwm2m_ctx *client_ctx)
 	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&engine_observer_list,
 					  obs, tmp, node) {
 		if (obs->ctx == client_ctx) {
-			sys_slist_remove(&engine_observer_list, prev_node,
-					 &obs->node);
-			(void)memset(obs, 0, sizeof(*obs));
+			engine_free_observer(prev_node, obs);
 		} else {
 			prev_node = &obs->node;
 		}
@@ -4129,12 +4598,14 @@ int lwm2m_socket_add(struct lwm2m_ctx *ctx)
 	sock_fds[sock_nfds].events = POLLIN;
 	sock_nfds++;
 
+	engine_wakeup();
+
 	return 0;
 }
 
 void lwm2m_socket_del(struct lwm2m_ctx *ctx)
 {
-	for (int i = 0; i < sock_nfds; i++) {
+	for (int i = 1; i < sock_nfds; i++) {
 		if (sock_ctx[i] != ctx) {
 			continue;
 		}
@@ -4151,10 +4622,80 @@ void lwm2m_socket_del(struct lwm2m_ctx *ctx)
 		/* Remove the last entry. */
 		sock_ctx[sock_nfds] = NULL;
 		sock_fds[sock_nfds].fd = -1;
+
+		engine_wakeup();
 		break;
 	}
 }
 
+/* The wakeup descriptor is readable while engine_wakeup_signal is raised */
+
+static ssize_t engine_wakeup_read(void *obj, void *buf, size_t sz)
+{
+	k_poll_signal_reset(&engine_wakeup_signal);
+
+	return 0;
+}
+
+static ssize_t engine_wakeup_write(void *obj, const void *buf, size_t sz)
+{
+	engine_wakeup();
+
+	return sz;
+}
+
+static int engine_wakeup_close(void *obj)
+{
+	return 0;
+}
+
+static int engine_wakeup_ioctl(void *obj, unsigned int request,
+			       va_list args)
+{
+	struct zsock_pollfd *pfd;
+	struct k_poll_event **pev;
+	struct k_poll_event *pev_end;
+
+	switch (request) {
+	case ZFD_IOCTL_POLL_PREPARE:
+		pfd = va_arg(args, struct zsock_pollfd *);
+		pev = va_arg(args, struct k_poll_event **);
+		pev_end = va_arg(args, struct k_poll_event *);
+
+		if (*pev == pev_end) {
+			return -ENOMEM;
+		}
+
+		k_poll_event_init(*pev, K_POLL_TYPE_SIGNAL,
+				  K_POLL_MODE_NOTIFY_ONLY,
+				  &engine_wakeup_signal);
+		(*pev)++;
+		return 0;
+
+	case ZFD_IOCTL_POLL_UPDATE:
+		pfd = va_arg(args, struct zsock_pollfd *);
+		pev = va_arg(args, struct k_poll_event **);
+
+		if ((*pev)->state != K_POLL_STATE_NOT_READY) {
+			pfd->revents |= ZSOCK_POLLIN;
+		}
+
+		(*pev)++;
+		return 0;
+
+	default:
+		errno = EOPNOTSUPP;
+		return -1;
+	}
+}
+
+static const struct fd_op_vtable engine_wakeup_vtable = {
+	.read = engine_wakeup_read,
+	.write = engine_wakeup_write,
+	.close = engine_wakeup_close,
+	.ioctl = engine_wakeup_ioctl,
+};
+
 /* LwM2M main work loop */
 
 static void socket_receive_loop(void)
@@ -4167,14 +4708,14 @@ static void socket_receive_loop(void)
 
 	while (1) {
 		/* wait for sockets */
-		if (sock_nfds < 1) {
+		if (sock_nfds < 2 && sock_fds[0].fd < 0) {
 			k_msleep(lwm2m_engine_service());
 			continue;
 		}
 
 		/*
-		 * FIXME: Currently we timeout and restart poll in case fds
-		 *        were modified.
+		 * Changes to the fds and to the observers wake the poll up
+		 * through the wakeup descriptor.
 		 */
 		if (poll(sock_fds, sock_nfds, lwm2m_engine_service()) < 0) {
 			LOG_ERR("Error in poll:%d", errno);
@@ -4183,7 +4724,12 @@ static void socket_receive_loop(void)
 			continue;
 		}
 
-		for (i = 0; i < sock_nfds; i++) {
+		if (sock_fds[0].revents) {
+			k_poll_signal_reset(&engine_wakeup_signal);
+			sock_fds[0].revents = 0;
+		}
+
+		for (i = 1; i < sock_nfds; i++) {
 			if ((sock_fds[i].revents & POLLERR) ||
 			    (sock_fds[i].revents & POLLNVAL) ||
 			    (sock_fds[i].revents & POLLHUP)) {
@@ -4465,6 +5011,17 @@ static int lwm2m_engine_init(const struct device *dev)
 
 	(void)memset(block1_contexts, 0, sizeof(block1_contexts));
 
+	sock_fds[0].fd = z_reserve_fd();
+	sock_fds[0].events = POLLIN;
+	sock_nfds = 1;
+	if (sock_fds[0].fd < 0) {
+		LOG_WRN("No wakeup fd, polling every %d ms",
+			ENGINE_UPDATE_INTERVAL_MS);
+	} else {
+		z_finalize_fd(sock_fds[0].fd, &engine_wakeup_signal,
+			      &engine_wakeup_vtable);
+	}
+
 	/* start sock receive thread */
 	k_thread_create(&engine_thread_data,
 			&engine_thread_stack[0],
@@ -169,6 +169,8 @@ int zsock_socket_internal(int family, int type, int proto)
 	/* recv_q and accept_q are in union */
 	k_fifo_init(&ctx->recv_q);
 
+	sock_epoll_init(ctx);
+
 	/* TCP context is effectively owned by both application
 	 * and the stack: stack may detect that peer closed/aborted
 	 * connection, but it must not dispose of the context behind
@@ -230,6 +232,8 @@ int zsock_close_ctx(struct net_context *ctx)
 	 * as these are fail-free operations and we're closing
 	 * socket anyway.
 	 */
+	sock_epoll_close(ctx);
+
 	if (net_context_get_state(ctx) == NET_CONTEXT_LISTENING) {
 		(void)net_context_accept(ctx, NULL, K_NO_WAIT, NULL);
 	} else {
@@ -305,8 +309,10 @@ static void zsock_accepted_cb(struct net_context *new_ctx,
 		(void)net_context_recv(new_ctx, zsock_received_cb, K_NO_WAIT,
 				       NULL);
 		k_fifo_init(&new_ctx->recv_q);
+		sock_epoll_init(new_ctx);
 
 		k_fifo_put(&parent->accept_q, new_ctx);
+		sock_epoll_ready(parent);
 	}
 }
 
@@ -331,6 +337,7 @@ static void zsock_received_cb(struct net_context *ctx,
 			 */
 			sock_set_eof(ctx);
 			k_fifo_cancel_wait(&ctx->recv_q);
+			sock_epoll_ready(ctx);
 			NET_DBG("Marked socket %p as peer-closed", ctx);
 		} else {
 			net_pkt_set_eof(last_pkt, true);
@@ -349,6 +356,7 @@ static void zsock_received_cb(struct net_context *ctx,
 	net_pkt_set_rx_stats_tick(pkt, k_cycle_get_32());
 
 	k_fifo_put(&ctx->recv_q, pkt);
+	sock_epoll_ready(ctx);
 }
 
 int zsock_bind_ctx(struct net_context *ctx, const struct sockaddr *addr,
@@ -578,6 +586,43 @@ static inline int z_vrfy_zsock_accept(int sock, struct sockaddr *addr,
 #define WAIT_BUFS K_MSEC(100)
 #define MAX_WAIT_BUFS K_SECONDS(10)
 
+/* Returns 0 if a failed send should be tried again, -1 with errno set
+ * otherwise.
+ */
+static int sock_send_wait(int status, k_timeout_t timeout,
+			  uint64_t buf_timeout)
+{
+	if (((status == -ENOBUFS) || (status == -EAGAIN)) &&
+	    K_TIMEOUT_EQ(timeout, K_FOREVER)) {
+		/* If we cannot get any buffers in reasonable
+		 * amount of time, then do not wait forever as
+		 * there might be some bigger issue.
+		 * If we get -EAGAIN and cannot recover, then
+		 * it means that the sending window is blocked
+		 * and we just cannot send anything.
+		 */
+		int64_t remaining = buf_timeout - z_tick_get();
+
+		if (remaining <= 0) {
+			if (status == -ENOBUFS) {
+				errno = ENOMEM;
+			} else {
+				errno = ENOBUFS;
+			}
+
+			return -1;
+		}
+
+		k_sleep(WAIT_BUFS);
+
+		return 0;
+	}
+
+	errno = -status;
+
+	return -1;
+}
+
 ssize_t zsock_sendto_ctx(struct net_context *ctx, const void *buf, size_t len,
 			 int flags,
 			 const struct sockaddr *dest_addr, socklen_t addrlen)
@@ -613,33 +658,11 @@ ssize_t zsock_sendto_ctx(struct net_context *ctx, const void *buf, size_t len,
 		}
 
 		if (status < 0) {
-			if (((status == -ENOBUFS) || (status == -EAGAIN)) &&
-			    K_TIMEOUT_EQ(timeout, K_FOREVER)) {
-				/* If we cannot get any buffers in reasonable
-				 * amount of time, then do not wait forever as
-				 * there might be some bigger issue.
-				 * If we get -EAGAIN and cannot recover, then
-				 * it means that the sending window is blocked
-				 * and we just cannot send anything.
-				 */
-				int64_t remaining = buf_timeout - z_tick_get();
-
-				if (remaining <= 0) {
-					if (status == -ENOBUFS) {
-						errno = ENOMEM;
-					} else {
-						errno = ENOBUFS;
-					}
-
-					return -1;
-				}
-
-				k_sleep(WAIT_BUFS);
-				continue;
-			} else {
-				errno = -status;
+			if (sock_send_wait(status, timeout, buf_timeout) < 0) {
 				return -1;
 			}
+
+			continue;
 		}
 
 		break;
@@ -920,6 +943,31 @@ void net_socket_update_tc_rx_time(struct net_pkt *pkt, uint32_t end_tick)
 	}
 }
 
+static int sock_get_src_addr(struct net_context *ctx, struct net_pkt *pkt,
+			     struct sockaddr *src_addr, socklen_t *addrlen)
+{
+	int rv;
+
+	rv = sock_get_pkt_src_addr(pkt, net_context_get_ip_proto(ctx),
+				   src_addr, *addrlen);
+	if (rv < 0) {
+		return rv;
+	}
+
+	/* addrlen is a value-result argument, set to actual
+	 * size of source address
+	 */
+	if (src_addr->sa_family == AF_INET) {
+		*addrlen = sizeof(struct sockaddr_in);
+	} else if (src_addr->sa_family == AF_INET6) {
+		*addrlen = sizeof(struct sockaddr_in6);
+	} else {
+		return -ENOTSUP;
+	}
+
+	return 0;
+}
+
 static inline ssize_t zsock_recv_dgram(struct net_context *ctx,
 				       void *buf,
 				       size_t max_len,
@@ -961,24 +1009,11 @@ static inline ssize_t zsock_recv_dgram(struct net_context *ctx,
 	if (src_addr && addrlen) {
 		int rv;
 
-		rv = sock_get_pkt_src_addr(pkt, net_context_get_ip_proto(ctx),
-					   src_addr, *addrlen);
+		rv = sock_get_src_addr(ctx, pkt, src_addr, addrlen);
 		if (rv < 0) {
 			errno = -rv;
 			goto fail;
 		}
-
-		/* addrlen is a value-result argument, set to actual
-		 * size of source address
-		 */
-		if (src_addr->sa_family == AF_INET) {
-			*addrlen = sizeof(struct sockaddr_in);
-		} else if (src_addr->sa_family == AF_INET6) {
-			*addrlen = sizeof(struct sockaddr_in6);
-		} else {
-			errno = ENOTSUP;
-			goto fail;
-		}
 	}
 
 	recv_len = net_pkt_remaining_data(pkt);
@@ -1162,6 +1197,218 @@ ssize_t z_vrfy_zsock_recvfrom(int sock, void *buf, size_t max_len, int flags,
 #include <syscalls/zsock_recvfrom_mrsh.c>
 #endif /* CONFIG_USERSPACE */
 
+#if defined(CONFIG_NET_SOCKETS_ZEROCOPY)
+static struct net_context *sock_get_native_ctx(int sock)
+{
+	const struct socket_op_vtable *vtable;
+	void *ctx;
+
+	ctx = get_sock_vtable(sock, &vtable);
+	if (ctx == NULL) {
+		errno = EBADF;
+		return NULL;
+	}
+
+	if (vtable != &sock_fd_op_vtable) {
+		errno = EOPNOTSUPP;
+		return NULL;
+	}
+
+	return ctx;
+}
+
+ssize_t zsock_sendmsg_zc(int sock, const struct msghdr *msg, int flags,
+			 zsock_zc_cb_t cb, void *user_data)
+{
+	k_timeout_t timeout = K_FOREVER;
+	uint64_t buf_timeout = 0;
+	struct net_context *ctx;
+	int status;
+
+	ctx = sock_get_native_ctx(sock);
+	if (ctx == NULL) {
+		return -1;
+	}
+
+	if ((flags & ZSOCK_MSG_DONTWAIT) || sock_is_nonblock(ctx)) {
+		timeout = K_NO_WAIT;
+	} else {
+		buf_timeout = z_timeout_end_calc(MAX_WAIT_BUFS);
+	}
+
+	/* Register the callback before sending in order to receive the response
+	 * from the peer.
+	 */
+	status = net_context_recv(ctx, zsock_received_cb,
+				  K_NO_WAIT, ctx->user_data);
+	if (status < 0) {
+		errno = -status;
+		return -1;
+	}
+
+	while (1) {
+		/* Wait a while for earlier zero-copy sends to release their
+		 * buffers, then let sock_send_wait() decide whether to retry.
+		 */
+		status = net_context_sendmsg_zc(ctx, msg, flags, cb,
+						K_TIMEOUT_EQ(timeout, K_NO_WAIT) ?
+						K_NO_WAIT : WAIT_BUFS,
+						user_data);
+		if (status < 0) {
+			if (sock_send_wait(status, timeout, buf_timeout) < 0) {
+				return -1;
+			}
+
+			continue;
+		}
+
+		break;
+	}
+
+	return status;
+}
+
+/* Hand the unread part of pkt over to the caller and release the rest */
+static int sock_pkt_loan(struct net_pkt *pkt, struct net_buf **frags)
+{
+	struct net_buf *buf;
+
+	if (pkt->buffer && pkt->buffer->ref > 1) {
+		/* The buffers are shared with another packet, so they
+		 * cannot be trimmed. Loan a private copy instead.
+		 */
+		struct net_pkt *clone = net_pkt_clone(pkt, K_NO_WAIT);
+
+		net_pkt_unref(pkt);
+		if (!clone) {
+			return -ENOBUFS;
+		}
+
+		pkt = clone;
+	}
+
+	buf = pkt->buffer;
+	pkt->buffer = NULL;
+
+	/* Drop the fragments that only hold headers or already read data */
+	while (buf && buf != pkt->cursor.buf) {
+		buf = net_buf_frag_del(NULL, buf);
+	}
+
+	if (buf) {
+		net_buf_pull(buf, pkt->cursor.pos - buf->data);
+		if (!buf->len) {
+			buf = net_buf_frag_del(NULL, buf);
+		}
+	}
+
+	net_pkt_unref(pkt);
+
+	*frags = buf;
+
+	return 0;
+}
+
+ssize_t zsock_recvfrom_zc(int sock, struct net_buf **frags, int flags,
+			  struct sockaddr *src_addr, socklen_t *addrlen)
+{
+	k_timeout_t timeout = K_FOREVER;
+	struct net_context *ctx;
+	struct net_pkt *pkt;
+	size_t recv_len;
+	int res;
+
+	*frags = NULL;
+
+	ctx = sock_get_native_ctx(sock);
+	if (ctx == NULL) {
+		return -1;
+	}
+
+	if (flags & ZSOCK_MSG_PEEK) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	if ((flags & ZSOCK_MSG_DONTWAIT) || sock_is_nonblock(ctx)) {
+		timeout = K_NO_WAIT;
+	}
+
+	if (net_context_get_type(ctx) == SOCK_DGRAM) {
+		pkt = k_fifo_get(&ctx->recv_q, timeout);
+		if (!pkt) {
+			errno = EAGAIN;
+			return -1;
+		}
+
+		if (src_addr && addrlen) {
+			res = sock_get_src_addr(ctx, pkt, src_addr, addrlen);
+			if (res < 0) {
+				net_pkt_unref(pkt);
+				errno = -res;
+				return -1;
+			}
+		}
+	} else {
+		if (!net_context_is_used(ctx)) {
+			errno = EBADF;
+			return -1;
+		}
+
+		do {
+			if (sock_is_eof(ctx)) {
+				return 0;
+			}
+
+			res = k_fifo_wait_non_empty(&ctx->recv_q, timeout);
+			/* EAGAIN when timeout expired, EINTR when cancelled */
+			if (res && res != -EAGAIN && res != -EINTR) {
+				errno = -res;
+				return -1;
+			}
+
+			pkt = k_fifo_get(&ctx->recv_q, K_NO_WAIT);
+			if (!pkt) {
+				if (sock_is_eof(ctx)) {
+					return 0;
+				}
+
+				errno = EAGAIN;
+				return -1;
+			}
+
+			if (net_pkt_eof(pkt)) {
+				sock_set_eof(ctx);
+			}
+
+			if (!net_pkt_remaining_data(pkt)) {
+				net_pkt_unref(pkt);
+				pkt = NULL;
+			}
+		} while (pkt == NULL);
+	}
+
+	recv_len = net_pkt_remaining_data(pkt);
+
+	if (IS_ENABLED(CONFIG_NET_PKT_RXTIME_STATS)) {
+		net_socket_update_tc_rx_time(pkt, k_cycle_get_32());
+	}
+
+	res = sock_pkt_loan(pkt, frags);
+
+	if (net_context_get_type(ctx) == SOCK_STREAM) {
+		net_context_update_recv_wnd(ctx, recv_len);
+	}
+
+	if (res < 0) {
+		errno = -res;
+		return -1;
+	}
+
+	return recv_len;
+}
+#endif /* CONFIG_NET_SOCKETS_ZEROCOPY */
+
 /* As this is limited function, we don't follow POSIX signature, with
  * "..." instead of last arg.
  */
@@ -1240,6 +1487,21 @@ static int zsock_poll_update_ctx(struct net_context *ctx,
 	return 0;
 }
 
+#if defined(CONFIG_NET_SOCKETS_EPOLL)
+static int zsock_epoll_events_ctx(struct net_context *ctx)
+{
+	/* Like poll(), assume that socket is always writable */
+	int events = ZSOCK_POLLOUT;
+
+	/* recv_q and accept_q are shared via a union */
+	if (!k_fifo_is_empty(&ctx->recv_q) || sock_is_eof(ctx)) {
+		events |= ZSOCK_POLLIN;
+	}
+
+	return events;
+}
+#endif /* CONFIG_NET_SOCKETS_EPOLL */
+
 static inline int time_left(uint32_t start, uint32_t timeout)
 {
 	uint32_t elapsed = k_uptime_get_32() - start;
@@ -1819,6 +2081,21 @@ static int sock_ioctl_vmeth(void *obj, unsigned int request, va_list args)
 		return zsock_poll_update_ctx(obj, pfd, pev);
 	}
 
+#if defined(CONFIG_NET_SOCKETS_EPOLL)
+	case ZFD_IOCTL_EPOLL_WATCHERS: {
+		struct net_context *ctx = obj;
+		sys_slist_t **watchers;
+
+		watchers = va_arg(args, sys_slist_t **);
+		*watchers = &ctx->epoll_watchers;
+
+		return 0;
+	}
+
+	case ZFD_IOCTL_EPOLL_EVENTS:
+		return zsock_epoll_events_ctx(obj);
+#endif /* CONFIG_NET_SOCKETS_EPOLL */
+
 	default:
 		errno = EOPNOTSUPP;
 		return -1;
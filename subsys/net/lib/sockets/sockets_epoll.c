@@ -0,0 +1,408 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_sock_epoll, CONFIG_NET_SOCKETS_LOG_LEVEL);
+
+#include <kernel.h>
+#include <net/net_context.h>
+#include <net/socket.h>
+#include <sys/fdtable.h>
+
+#include "sockets_internal.h"
+
+/* A socket in an interest set. The entry sits on the watchers list of
+ * the socket, and on the ready list of the set from the time the socket
+ * reports that it may be ready until a wait finds out that it is not.
+ */
+struct epoll_entry {
+	sys_snode_t watch_node;
+	sys_dnode_t set_node;
+	sys_dnode_t ready_node;
+	struct epoll_set *set;
+	sys_slist_t *watchers;
+	const struct fd_op_vtable *vtable;
+	void *obj;
+	int fd;
+	struct zsock_epoll_event event;
+};
+
+struct epoll_set {
+	sys_dlist_t entries;
+	sys_dlist_t ready;
+	struct k_sem wakeup;
+};
+
+/* A socket can be in several sets, so one lock covers all of them */
+static struct k_spinlock epoll_lock;
+
+K_MEM_SLAB_DEFINE(epoll_sets, sizeof(struct epoll_set),
+		  CONFIG_NET_SOCKETS_EPOLL_MAX, 4);
+K_MEM_SLAB_DEFINE(epoll_entries, sizeof(struct epoll_entry),
+		  CONFIG_NET_SOCKETS_EPOLL_ENTRIES, 4);
+
+static const struct fd_op_vtable epoll_fd_op_vtable;
+
+/* Called with epoll_lock held */
+static void epoll_mark_ready(struct epoll_entry *entry)
+{
+	if (sys_dnode_is_linked(&entry->ready_node)) {
+		return;
+	}
+
+	sys_dlist_append(&entry->set->ready, &entry->ready_node);
+	k_sem_give(&entry->set->wakeup);
+}
+
+/* Called with epoll_lock held */
+static void epoll_entry_free(struct epoll_entry *entry)
+{
+	sys_slist_find_and_remove(entry->watchers, &entry->watch_node);
+	sys_dlist_remove(&entry->set_node);
+
+	if (sys_dnode_is_linked(&entry->ready_node)) {
+		sys_dlist_remove(&entry->ready_node);
+	}
+
+	k_mem_slab_free(&epoll_entries, (void **)&entry);
+}
+
+/* Called with epoll_lock held */
+static struct epoll_entry *epoll_entry_find(struct epoll_set *set, int fd)
+{
+	struct epoll_entry *entry;
+
+	SYS_DLIST_FOR_EACH_CONTAINER(&set->entries, entry, set_node) {
+		if (entry->fd == fd) {
+			return entry;
+		}
+	}
+
+	return NULL;
+}
+
+void sock_epoll_notify(sys_slist_t *watchers)
+{
+	k_spinlock_key_t key = k_spin_lock(&epoll_lock);
+	struct epoll_entry *entry;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(watchers, entry, watch_node) {
+		epoll_mark_ready(entry);
+	}
+
+	k_spin_unlock(&epoll_lock, key);
+}
+
+void sock_epoll_detach(sys_slist_t *watchers)
+{
+	k_spinlock_key_t key = k_spin_lock(&epoll_lock);
+	sys_snode_t *node;
+
+	while ((node = sys_slist_peek_head(watchers)) != NULL) {
+		epoll_entry_free(CONTAINER_OF(node, struct epoll_entry,
+					      watch_node));
+	}
+
+	k_spin_unlock(&epoll_lock, key);
+}
+
+int zsock_epoll_create(int flags)
+{
+	struct epoll_set *set;
+	int fd;
+
+	if (flags != 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	fd = z_reserve_fd();
+	if (fd < 0) {
+		return -1;
+	}
+
+	if (k_mem_slab_alloc(&epoll_sets, (void **)&set, K_NO_WAIT) < 0) {
+		z_free_fd(fd);
+		errno = ENOMEM;
+		return -1;
+	}
+
+	sys_dlist_init(&set->entries);
+	sys_dlist_init(&set->ready);
+	k_sem_init(&set->wakeup, 0, 1);
+
+	z_finalize_fd(fd, set, &epoll_fd_op_vtable);
+
+	return fd;
+}
+
+static int epoll_add(struct epoll_set *set, int fd,
+		     const struct fd_op_vtable *vtable, void *obj,
+		     struct zsock_epoll_event *event)
+{
+	struct epoll_entry *entry;
+	sys_slist_t *watchers;
+
+	if (epoll_entry_find(set, fd)) {
+		return -EEXIST;
+	}
+
+	/* Only objects which report their readiness can be watched */
+	if (z_fdtable_call_ioctl(vtable, obj, ZFD_IOCTL_EPOLL_WATCHERS,
+				 &watchers) < 0) {
+		return -EPERM;
+	}
+
+	if (k_mem_slab_alloc(&epoll_entries, (void **)&entry,
+			     K_NO_WAIT) < 0) {
+		return -ENOMEM;
+	}
+
+	entry->set = set;
+	entry->watchers = watchers;
+	entry->vtable = vtable;
+	entry->obj = obj;
+	entry->fd = fd;
+	entry->event = *event;
+	sys_dnode_init(&entry->ready_node);
+
+	sys_slist_append(watchers, &entry->watch_node);
+	sys_dlist_append(&set->entries, &entry->set_node);
+
+	/* The socket may already be ready, let the next wait check it */
+	epoll_mark_ready(entry);
+
+	return 0;
+}
+
+int zsock_epoll_ctl(int epfd, int op, int fd,
+		    struct zsock_epoll_event *event)
+{
+	const struct fd_op_vtable *vtable;
+	struct epoll_entry *entry;
+	struct epoll_set *set;
+	k_spinlock_key_t key;
+	void *obj;
+	int ret = 0;
+
+	set = z_get_fd_obj(epfd, &epoll_fd_op_vtable, EINVAL);
+	if (set == NULL) {
+		return -1;
+	}
+
+	obj = z_get_fd_obj_and_vtable(fd, &vtable);
+	if (obj == NULL) {
+		return -1;
+	}
+
+	if (obj == set || (op != ZSOCK_EPOLL_CTL_DEL && event == NULL)) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	key = k_spin_lock(&epoll_lock);
+
+	switch (op) {
+	case ZSOCK_EPOLL_CTL_ADD:
+		ret = epoll_add(set, fd, vtable, obj, event);
+		break;
+
+	case ZSOCK_EPOLL_CTL_MOD:
+		entry = epoll_entry_find(set, fd);
+		if (entry == NULL) {
+			ret = -ENOENT;
+			break;
+		}
+
+		entry->event = *event;
+		epoll_mark_ready(entry);
+		break;
+
+	case ZSOCK_EPOLL_CTL_DEL:
+		entry = epoll_entry_find(set, fd);
+		if (entry == NULL) {
+			ret = -ENOENT;
+			break;
+		}
+
+		epoll_entry_free(entry);
+		break;
+
+	default:
+		ret = -EINVAL;
+		break;
+	}
+
+	k_spin_unlock(&epoll_lock, key);
+
+	if (ret < 0) {
+		errno = -ret;
+		return -1;
+	}
+
+	return 0;
+}
+
+/* Called with epoll_lock held. Only the entries on the ready list are
+ * checked, every other socket in the set is known not to be ready.
+ */
+static int epoll_collect(struct epoll_set *set,
+			 struct zsock_epoll_event *events, int maxevents)
+{
+	struct epoll_entry *entry, *next;
+	sys_dlist_t reported;
+	sys_dnode_t *node;
+	int count = 0;
+
+	sys_dlist_init(&reported);
+
+	SYS_DLIST_FOR_EACH_CONTAINER_SAFE(&set->ready, entry, next,
+					  ready_node) {
+		int revents;
+
+		if (count == maxevents) {
+			break;
+		}
+
+		revents = z_fdtable_call_ioctl(entry->vtable, entry->obj,
+					       ZFD_IOCTL_EPOLL_EVENTS);
+		if (revents < 0) {
+			revents = ZSOCK_EPOLLERR;
+		}
+
+		revents &= entry->event.events | ZSOCK_EPOLLERR |
+			   ZSOCK_EPOLLHUP;
+
+		sys_dlist_remove(&entry->ready_node);
+
+		if (revents == 0) {
+			continue;
+		}
+
+		events[count].events = revents;
+		events[count].data = entry->event.data;
+		count++;
+
+		/* Level triggered sockets are checked again by the next
+		 * wait, after the sockets which were not reported now.
+		 */
+		if (!(entry->event.events & ZSOCK_EPOLLET)) {
+			sys_dlist_append(&reported, &entry->ready_node);
+		}
+	}
+
+	while ((node = sys_dlist_get(&reported)) != NULL) {
+		sys_dlist_append(&set->ready, node);
+	}
+
+	return count;
+}
+
+int zsock_epoll_wait(int epfd, struct zsock_epoll_event *events,
+		     int maxevents, int timeout)
+{
+	struct epoll_set *set;
+	k_spinlock_key_t key;
+	k_timeout_t wait;
+	uint64_t end;
+	int count;
+
+	set = z_get_fd_obj(epfd, &epoll_fd_op_vtable, EINVAL);
+	if (set == NULL) {
+		return -1;
+	}
+
+	if (events == NULL || maxevents <= 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	wait = timeout < 0 ? K_FOREVER : K_MSEC(timeout);
+	end = z_timeout_end_calc(wait);
+
+	for (;;) {
+		key = k_spin_lock(&epoll_lock);
+		count = epoll_collect(set, events, maxevents);
+		k_spin_unlock(&epoll_lock, key);
+
+		if (count > 0 || K_TIMEOUT_EQ(wait, K_NO_WAIT)) {
+			return count;
+		}
+
+		if (!K_TIMEOUT_EQ(wait, K_FOREVER)) {
+			int64_t remaining = end - z_tick_get();
+
+			if (remaining <= 0) {
+				return 0;
+			}
+
+			wait = Z_TIMEOUT_TICKS(remaining);
+		}
+
+		/* Check once more after a timeout, a socket may have
+		 * become ready just before it.
+		 */
+		if (k_sem_take(&set->wakeup, wait) < 0) {
+			wait = K_NO_WAIT;
+		}
+	}
+}
+
+static ssize_t epoll_read_vmeth(void *obj, void *buffer, size_t count)
+{
+	ARG_UNUSED(obj);
+	ARG_UNUSED(buffer);
+	ARG_UNUSED(count);
+
+	errno = EINVAL;
+	return -1;
+}
+
+static ssize_t epoll_write_vmeth(void *obj, const void *buffer,
+				 size_t count)
+{
+	ARG_UNUSED(obj);
+	ARG_UNUSED(buffer);
+	ARG_UNUSED(count);
+
+	errno = EINVAL;
+	return -1;
+}
+
+static int epoll_ioctl_vmeth(void *obj, unsigned int request, va_list args)
+{
+	ARG_UNUSED(obj);
+	ARG_UNUSED(request);
+	ARG_UNUSED(args);
+
+	errno = EOPNOTSUPP;
+	return -1;
+}
+
+static int epoll_close_vmeth(void *obj)
+{
+	struct epoll_set *set = obj;
+	k_spinlock_key_t key = k_spin_lock(&epoll_lock);
+	sys_dnode_t *node;
+
+	while ((node = sys_dlist_peek_head(&set->entries)) != NULL) {
+		epoll_entry_free(CONTAINER_OF(node, struct epoll_entry,
+					      set_node));
+	}
+
+	k_spin_unlock(&epoll_lock, key);
+
+	k_mem_slab_free(&epoll_sets, (void **)&set);
+
+	return 0;
+}
+
+static const struct fd_op_vtable epoll_fd_op_vtable = {
+	.read = epoll_read_vmeth,
+	.write = epoll_write_vmeth,
+	.close = epoll_close_vmeth,
+	.ioctl = epoll_ioctl_vmeth,
+};
@@ -40,6 +40,24 @@ static inline bool net_socket_is_tls(void *obj)
 }
 #endif
 
+#if defined(CONFIG_NET_SOCKETS_EPOLL)
+/* Tell the interest sets on the watchers list that the socket may have
+ * become ready.
+ */
+void sock_epoll_notify(sys_slist_t *watchers);
+
+/* Remove a socket being closed from all interest sets */
+void sock_epoll_detach(sys_slist_t *watchers);
+
+#define sock_epoll_init(ctx) sys_slist_init(&(ctx)->epoll_watchers)
+#define sock_epoll_ready(ctx) sock_epoll_notify(&(ctx)->epoll_watchers)
+#define sock_epoll_close(ctx) sock_epoll_detach(&(ctx)->epoll_watchers)
+#else
+#define sock_epoll_init(ctx)
+#define sock_epoll_ready(ctx)
+#define sock_epoll_close(ctx)
+#endif
+
 #define sock_is_eof(ctx) sock_get_flag(ctx, SOCK_EOF)
 #define sock_set_eof(ctx) sock_set_flag(ctx, SOCK_EOF, SOCK_EOF)
 #define sock_is_nonblock(ctx) sock_get_flag(ctx, SOCK_NONBLOCK)
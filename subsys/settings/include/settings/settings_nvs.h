@@ -37,7 +37,22 @@ struct settings_nvs {
 	struct settings_store cf_store;
 	struct nvs_fs cf_nvs;
 	uint16_t last_name_id;
+	/* Largest name ID in use when the current batch of saves started */
+	uint16_t batch_last_name_id;
+	/* Set during a batch of saves, which stores last_name_id at its end */
+	bool batch;
 	const char *flash_dev_name;
+#ifdef CONFIG_SETTINGS_NVS_NAME_CACHE
+	/* Hash of each setting's name to the ID of its name entry */
+	struct settings_nvs_cache_entry {
+		uint16_t name_hash;
+		uint16_t name_id;
+	} cache[CONFIG_SETTINGS_NVS_NAME_CACHE_SIZE];
+	/* One bit per name ID from NVS_NAMECNT_ID + 1 on, set if cached */
+	uint32_t cache_ids[(CONFIG_SETTINGS_NVS_NAME_CACHE_SIZE + 31) / 32];
+	/* Set when every name stored in the NVS is in the cache */
+	bool cache_complete;
+#endif
 };
 
 /* register nvs to be a source of settings */
@@ -24,6 +24,15 @@ sys_slist_t settings_handlers;
 
 K_MUTEX_DEFINE(settings_lock);
 
+#if defined(CONFIG_SETTINGS_HANDLER_INDEX)
+/* Static and dynamic handlers sorted by name, valid until a handler is
+ * registered. The length is -1 when the handlers do not fit.
+ */
+static struct settings_handler_static *
+	settings_index[CONFIG_SETTINGS_HANDLER_INDEX_SIZE];
+static int settings_index_len;
+static bool settings_index_valid;
+#endif /* CONFIG_SETTINGS_HANDLER_INDEX */
 
 void settings_store_init(void);
 
@@ -32,6 +41,9 @@ void settings_init(void)
 #if defined(CONFIG_SETTINGS_DYNAMIC_HANDLERS)
 	sys_slist_init(&settings_handlers);
 #endif /* CONFIG_SETTINGS_DYNAMIC_HANDLERS */
+#if defined(CONFIG_SETTINGS_HANDLER_INDEX)
+	settings_index_valid = false;
+#endif /* CONFIG_SETTINGS_HANDLER_INDEX */
 	settings_store_init();
 }
 
@@ -56,6 +68,9 @@ int settings_register(struct settings_handler *handler)
 		}
 	}
 	sys_slist_append(&settings_handlers, &handler->node);
+#if defined(CONFIG_SETTINGS_HANDLER_INDEX)
+	settings_index_valid = false;
+#endif /* CONFIG_SETTINGS_HANDLER_INDEX */
 
 end:
 	k_mutex_unlock(&settings_lock);
@@ -134,6 +149,128 @@ int settings_name_next(const char *name, const char **next)
 	return rc;
 }
 
+#if defined(CONFIG_SETTINGS_HANDLER_INDEX)
+/* Insert a handler after the handlers with a lower or equal name */
+static void settings_index_insert(struct settings_handler_static *ch)
+{
+	int i;
+
+	if (settings_index_len == CONFIG_SETTINGS_HANDLER_INDEX_SIZE) {
+		settings_index_len = -1;
+		return;
+	}
+
+	for (i = settings_index_len; i > 0; i--) {
+		if (strcmp(settings_index[i - 1]->name, ch->name) <= 0) {
+			break;
+		}
+		settings_index[i] = settings_index[i - 1];
+	}
+
+	settings_index[i] = ch;
+	settings_index_len++;
+}
+
+static void settings_index_build(void)
+{
+	settings_index_len = 0;
+	settings_index_valid = true;
+
+	Z_STRUCT_SECTION_FOREACH(settings_handler_static, ch) {
+		settings_index_insert(ch);
+		if (settings_index_len < 0) {
+			return;
+		}
+	}
+
+#if defined(CONFIG_SETTINGS_DYNAMIC_HANDLERS)
+	struct settings_handler *ch;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&settings_handlers, ch, node) {
+		settings_index_insert((struct settings_handler_static *)ch);
+		if (settings_index_len < 0) {
+			return;
+		}
+	}
+#endif /* CONFIG_SETTINGS_DYNAMIC_HANDLERS */
+}
+
+/* Compare a handler name with the first len characters of a name */
+static int settings_index_cmp(const char *hname, const char *name,
+			      size_t len)
+{
+	int rc = strncmp(hname, name, len);
+
+	if ((rc == 0) && (hname[len] != '\0')) {
+		rc = 1;
+	}
+
+	return rc;
+}
+
+/* Find the handler named like the first len characters of a name. Like
+ * the linear search, the last registered of equally named handlers wins.
+ */
+static struct settings_handler_static *settings_index_find(const char *name,
+							   size_t len)
+{
+	struct settings_handler_static *found = NULL;
+	int lo = 0;
+	int hi = settings_index_len;
+
+	while (lo < hi) {
+		int mid = lo + (hi - lo) / 2;
+		int rc = settings_index_cmp(settings_index[mid]->name, name,
+					    len);
+
+		if (rc <= 0) {
+			if (rc == 0) {
+				found = settings_index[mid];
+			}
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+
+	return found;
+}
+
+/* Search the index for each prefix of the name which ends at a
+ * separator or at the end of the name, the longest first.
+ */
+static struct settings_handler_static *settings_index_lookup(const char *name,
+							     const char **next)
+{
+	struct settings_handler_static *ch;
+	size_t end = 0;
+	size_t len;
+
+	while ((name[end] != '\0') && (name[end] != SETTINGS_NAME_END)) {
+		end++;
+	}
+
+	for (len = end + 1; len-- > 0; ) {
+		if ((len != end) && (name[len] != SETTINGS_NAME_SEPARATOR)) {
+			continue;
+		}
+
+		ch = settings_index_find(name, len);
+		if (ch == NULL) {
+			continue;
+		}
+
+		if (next && (name[len] == SETTINGS_NAME_SEPARATOR)) {
+			*next = &name[len + 1];
+		}
+
+		return ch;
+	}
+
+	return NULL;
+}
+#endif /* CONFIG_SETTINGS_HANDLER_INDEX */
+
 struct settings_handler_static *settings_parse_and_lookup(const char *name,
 							const char **next)
 {
@@ -145,6 +282,26 @@ struct settings_handler_static *settings_parse_and_lookup(const char *name,
 		*next = NULL;
 	}
 
+#if defined(CONFIG_SETTINGS_HANDLER_INDEX)
+	if (!name) {
+		return NULL;
+	}
+
+	k_mutex_lock(&settings_lock, K_FOREVER);
+
+	if (!settings_index_valid) {
+		settings_index_build();
+	}
+
+	if (settings_index_len >= 0) {
+		bestmatch = settings_index_lookup(name, next);
+		k_mutex_unlock(&settings_lock);
+		return bestmatch;
+	}
+
+	k_mutex_unlock(&settings_lock);
+#endif /* CONFIG_SETTINGS_HANDLER_INDEX */
+
 	Z_STRUCT_SECTION_FOREACH(settings_handler_static, ch) {
 		if (!settings_name_steq(name, ch->name, &tmpnext)) {
 			continue;
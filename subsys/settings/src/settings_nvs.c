@@ -7,6 +7,7 @@
 
 #include <errno.h>
 #include <string.h>
+#include <sys/math_extras.h>
 
 #include "settings/settings.h"
 #include "settings/settings_nvs.h"
@@ -23,12 +24,16 @@ struct settings_nvs_read_fn_arg {
 
 static int settings_nvs_load(struct settings_store *cs,
 			     const struct settings_load_arg *arg);
+static int settings_nvs_save_start(struct settings_store *cs);
 static int settings_nvs_save(struct settings_store *cs, const char *name,
 			     const char *value, size_t val_len);
+static int settings_nvs_save_end(struct settings_store *cs);
 
 static struct settings_store_itf settings_nvs_itf = {
 	.csi_load = settings_nvs_load,
+	.csi_save_start = settings_nvs_save_start,
 	.csi_save = settings_nvs_save,
+	.csi_save_end = settings_nvs_save_end,
 };
 
 static ssize_t settings_nvs_read_fn(void *back_end, void *data, size_t len)
@@ -48,6 +53,200 @@ static ssize_t settings_nvs_read_fn(void *back_end, void *data, size_t len)
 	return rc;
 }
 
+#ifdef CONFIG_SETTINGS_NVS_NAME_CACHE
+/* The name cache is an open addressing hash table from the hash of a
+ * setting's name to the ID of its name entry.  Names with the same hash
+ * are told apart by reading them back from the NVS.  A slot with name
+ * ID 0 is unused, as name IDs start above NVS_NAMECNT_ID.  cache_ids
+ * marks the cached name IDs, so that the lowest free one is found
+ * without looking at the table.
+ */
+static uint16_t settings_nvs_cache_hash(const char *name)
+{
+	uint32_t hash = 2166136261U;
+
+	while (*name) {
+		hash = (hash ^ (uint8_t)*name++) * 16777619U;
+	}
+
+	return (hash >> 16) ^ hash;
+}
+
+static void settings_nvs_cache_clear(struct settings_nvs *cf)
+{
+	(void)memset(cf->cache, 0, sizeof(cf->cache));
+	(void)memset(cf->cache_ids, 0, sizeof(cf->cache_ids));
+	cf->cache_complete = false;
+}
+
+static void settings_nvs_cache_mark(struct settings_nvs *cf, uint16_t name_id,
+				    bool used)
+{
+	size_t bit = name_id - (NVS_NAMECNT_ID + 1);
+
+	if (bit >= CONFIG_SETTINGS_NVS_NAME_CACHE_SIZE) {
+		return;
+	}
+
+	if (used) {
+		cf->cache_ids[bit / 32] |= BIT(bit % 32);
+	} else {
+		cf->cache_ids[bit / 32] &= ~BIT(bit % 32);
+	}
+}
+
+static void settings_nvs_cache_add(struct settings_nvs *cf, uint16_t hash,
+				   uint16_t name_id)
+{
+	size_t pos = hash % CONFIG_SETTINGS_NVS_NAME_CACHE_SIZE;
+
+	for (size_t i = 0; i < CONFIG_SETTINGS_NVS_NAME_CACHE_SIZE; i++) {
+		if (cf->cache[pos].name_id == 0U) {
+			cf->cache[pos].name_hash = hash;
+			cf->cache[pos].name_id = name_id;
+			settings_nvs_cache_mark(cf, name_id, true);
+			return;
+		}
+		if (++pos == CONFIG_SETTINGS_NVS_NAME_CACHE_SIZE) {
+			pos = 0;
+		}
+	}
+
+	/* From now on, a name that is not found may still be stored */
+	cf->cache_complete = false;
+}
+
+static void settings_nvs_cache_del(struct settings_nvs *cf, uint16_t hash,
+				   uint16_t name_id)
+{
+	size_t size = CONFIG_SETTINGS_NVS_NAME_CACHE_SIZE;
+	size_t hole, pos, home, i;
+
+	hole = hash % size;
+	for (i = 0; i < size; i++) {
+		if (cf->cache[hole].name_id == name_id) {
+			break;
+		}
+		if (cf->cache[hole].name_id == 0U) {
+			return;
+		}
+		hole = (hole + 1) % size;
+	}
+
+	if (i == size) {
+		return;
+	}
+
+	/* Move entries after the hole back into it if they would no longer
+	 * be reachable from their home slot otherwise.
+	 */
+	pos = hole;
+	for (i = 1; i < size; i++) {
+		pos = (pos + 1) % size;
+		if (cf->cache[pos].name_id == 0U) {
+			break;
+		}
+
+		home = cf->cache[pos].name_hash % size;
+		if ((pos > hole && (home <= hole || home > pos)) ||
+		    (pos < hole && (home <= hole && home > pos))) {
+			cf->cache[hole] = cf->cache[pos];
+			hole = pos;
+		}
+	}
+
+	cf->cache[hole].name_id = 0U;
+	settings_nvs_cache_mark(cf, name_id, false);
+}
+
+/* returns the name ID of name, or NVS_NAMECNT_ID if it is not cached */
+static uint16_t settings_nvs_cache_find(struct settings_nvs *cf,
+					const char *name, uint16_t hash)
+{
+	char rdname[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN + 1];
+	size_t pos = hash % CONFIG_SETTINGS_NVS_NAME_CACHE_SIZE;
+	ssize_t rc;
+
+	for (size_t i = 0; i < CONFIG_SETTINGS_NVS_NAME_CACHE_SIZE; i++) {
+		if (cf->cache[pos].name_id == 0U) {
+			break;
+		}
+
+		if (cf->cache[pos].name_hash == hash) {
+			rc = nvs_read(&cf->cf_nvs, cf->cache[pos].name_id,
+				      &rdname, sizeof(rdname));
+			if (rc > 0 && (size_t)rc < sizeof(rdname)) {
+				rdname[rc] = '\0';
+				if (!strcmp(name, rdname)) {
+					return cf->cache[pos].name_id;
+				}
+			}
+		}
+
+		if (++pos == CONFIG_SETTINGS_NVS_NAME_CACHE_SIZE) {
+			pos = 0;
+		}
+	}
+
+	return NVS_NAMECNT_ID;
+}
+
+/* Returns the lowest name ID not in use, or NVS_NAMECNT_ID if it is not
+ * known. Only valid when the cache is complete.
+ */
+static uint16_t settings_nvs_cache_free_id(struct settings_nvs *cf)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(cf->cache_ids); i++) {
+		uint32_t free = ~cf->cache_ids[i];
+		size_t bit;
+
+		if (free == 0U) {
+			continue;
+		}
+
+		bit = i * 32 + u32_count_trailing_zeros(free);
+		if (bit >= CONFIG_SETTINGS_NVS_NAME_CACHE_SIZE) {
+			break;
+		}
+
+		return NVS_NAMECNT_ID + 1 + bit;
+	}
+
+	/* The IDs the cache can tell about are all in use */
+	return NVS_NAMECNT_ID;
+}
+
+/* Cache the names of all stored settings, so that saves made before the
+ * first settings_load() do not have to walk them either.
+ */
+static void settings_nvs_cache_fill(struct settings_nvs *cf)
+{
+	char name[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN + 1];
+	uint16_t name_id;
+	ssize_t rc;
+
+	settings_nvs_cache_clear(cf);
+	cf->cache_complete = true;
+
+	for (name_id = cf->last_name_id; name_id > NVS_NAMECNT_ID; name_id--) {
+		rc = nvs_read(&cf->cf_nvs, name_id, &name, sizeof(name));
+		if (rc == -ENOENT || rc == 0) {
+			continue;
+		}
+
+		if (rc < 0 || (size_t)rc >= sizeof(name)) {
+			/* The ID may be in use, don't hand it out */
+			cf->cache_complete = false;
+			continue;
+		}
+
+		name[rc] = '\0';
+		settings_nvs_cache_add(cf, settings_nvs_cache_hash(name),
+				       name_id);
+	}
+}
+#endif /* CONFIG_SETTINGS_NVS_NAME_CACHE */
+
 int settings_nvs_src(struct settings_nvs *cf)
 {
 	cf->cf_store.cs_itf = &settings_nvs_itf;
@@ -77,6 +276,11 @@ static int settings_nvs_load(struct settings_store *cs,
 
 	name_id = cf->last_name_id + 1;
 
+#ifdef CONFIG_SETTINGS_NVS_NAME_CACHE
+	settings_nvs_cache_clear(cf);
+	cf->cache_complete = true;
+#endif
+
 	while (1) {
 
 		name_id--;
@@ -114,6 +318,10 @@ static int settings_nvs_load(struct settings_store *cs,
 
 		/* Found a name, this might not include a trailing \0 */
 		name[rc1] = '\0';
+#ifdef CONFIG_SETTINGS_NVS_NAME_CACHE
+		settings_nvs_cache_add(cf, settings_nvs_cache_hash(name),
+				       name_id);
+#endif
 		read_fn_arg.fs = &cf->cf_nvs;
 		read_fn_arg.id = name_id + NVS_NAME_ID_OFFSET;
 
@@ -122,31 +330,29 @@ static int settings_nvs_load(struct settings_store *cs,
 			settings_nvs_read_fn, &read_fn_arg,
 			(void *)arg);
 		if (ret) {
+#ifdef CONFIG_SETTINGS_NVS_NAME_CACHE
+			/* The names not visited yet are not cached */
+			cf->cache_complete = false;
+#endif
 			break;
 		}
 	}
 	return ret;
 }
 
-static int settings_nvs_save(struct settings_store *cs, const char *name,
-			     const char *value, size_t val_len)
+/* Walk all name IDs from the largest one in use down, reading each name.
+ * Returns the name ID of name, or NVS_NAMECNT_ID if it is not stored, in
+ * which case free_id is set to the lowest unused name ID.
+ */
+static uint16_t settings_nvs_find_name(struct settings_nvs *cf,
+				       const char *name, uint16_t *free_id)
 {
-	struct settings_nvs *cf = (struct settings_nvs *)cs;
 	char rdname[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN + 1];
-	uint16_t name_id, write_name_id;
-	bool delete, write_name;
-	int rc = 0;
-
-	if (!name) {
-		return -EINVAL;
-	}
-
-	/* Find out if we are doing a delete */
-	delete = ((value == NULL) || (val_len == 0));
+	uint16_t name_id;
+	int rc;
 
 	name_id = cf->last_name_id + 1;
-	write_name_id = cf->last_name_id + 1;
-	write_name = true;
+	*free_id = cf->last_name_id + 1;
 
 	while (1) {
 		name_id--;
@@ -159,7 +365,7 @@ static int settings_nvs_save(struct settings_store *cs, const char *name,
 		if (rc < 0) {
 			/* Error or entry not found */
 			if (rc == -ENOENT) {
-				write_name_id = name_id;
+				*free_id = name_id;
 			}
 			continue;
 		}
@@ -170,10 +376,102 @@ static int settings_nvs_save(struct settings_store *cs, const char *name,
 			continue;
 		}
 
-		if ((delete) && (name_id == cf->last_name_id)) {
+		return name_id;
+	}
+
+	return NVS_NAMECNT_ID;
+}
+
+/* Store the largest name ID in use, unless a batch of saves is in
+ * progress, which stores it once when it ends. The batch is not atomic:
+ * values and names it writes below the stored ID are used at the next
+ * load even if the batch did not end.
+ */
+static int settings_nvs_store_last_name_id(struct settings_nvs *cf)
+{
+	if (cf->batch) {
+		return 0;
+	}
+
+	return nvs_write(&cf->cf_nvs, NVS_NAMECNT_ID, &cf->last_name_id,
+			 sizeof(uint16_t));
+}
+
+static int settings_nvs_save_start(struct settings_store *cs)
+{
+	struct settings_nvs *cf = (struct settings_nvs *)cs;
+
+	cf->batch = true;
+	cf->batch_last_name_id = cf->last_name_id;
+
+	return 0;
+}
+
+static int settings_nvs_save_end(struct settings_store *cs)
+{
+	struct settings_nvs *cf = (struct settings_nvs *)cs;
+	int rc;
+
+	cf->batch = false;
+
+	if (cf->last_name_id == cf->batch_last_name_id) {
+		return 0;
+	}
+
+	rc = settings_nvs_store_last_name_id(cf);
+
+	return (rc < 0) ? rc : 0;
+}
+
+static int settings_nvs_save(struct settings_store *cs, const char *name,
+			     const char *value, size_t val_len)
+{
+	struct settings_nvs *cf = (struct settings_nvs *)cs;
+	uint16_t name_id, write_name_id;
+	bool delete, write_name;
+	int rc = 0;
+#ifdef CONFIG_SETTINGS_NVS_NAME_CACHE
+	uint16_t name_hash;
+#endif
+
+	if (!name) {
+		return -EINVAL;
+	}
+
+	/* Find out if we are doing a delete */
+	delete = ((value == NULL) || (val_len == 0));
+
+#ifdef CONFIG_SETTINGS_NVS_NAME_CACHE
+	name_hash = settings_nvs_cache_hash(name);
+	name_id = settings_nvs_cache_find(cf, name, name_hash);
+	if (name_id == NVS_NAMECNT_ID) {
+		write_name_id = cf->cache_complete ?
+				settings_nvs_cache_free_id(cf) : NVS_NAMECNT_ID;
+		if (write_name_id == NVS_NAMECNT_ID) {
+			name_id = settings_nvs_find_name(cf, name,
+							 &write_name_id);
+			if (name_id != NVS_NAMECNT_ID) {
+				settings_nvs_cache_add(cf, name_hash, name_id);
+			}
+		}
+	}
+#else
+	name_id = settings_nvs_find_name(cf, name, &write_name_id);
+#endif
+
+	write_name = (name_id == NVS_NAMECNT_ID);
+	if (!write_name) {
+		write_name_id = name_id;
+	}
+
+	if (delete) {
+		if (write_name) {
+			return 0;
+		}
+
+		if (name_id == cf->last_name_id) {
 			cf->last_name_id--;
-			rc = nvs_write(&cf->cf_nvs, NVS_NAMECNT_ID,
-				       &cf->last_name_id, sizeof(uint16_t));
+			rc = settings_nvs_store_last_name_id(cf);
 			if (rc < 0) {
 				/* Error: can't to store
 				 * the largest name ID in use.
@@ -182,26 +480,20 @@ static int settings_nvs_save(struct settings_store *cs, const char *name,
 			}
 		}
 
-		if (delete) {
-			rc = nvs_delete(&cf->cf_nvs, name_id);
+		rc = nvs_delete(&cf->cf_nvs, name_id);
 
-			if (rc >= 0) {
-				rc = nvs_delete(&cf->cf_nvs, name_id +
-					NVS_NAME_ID_OFFSET);
-			}
-
-			if (rc < 0) {
-				return rc;
-			}
+		if (rc >= 0) {
+			rc = nvs_delete(&cf->cf_nvs, name_id +
+				NVS_NAME_ID_OFFSET);
+		}
 
-			return 0;
+		if (rc < 0) {
+			return rc;
 		}
-		write_name_id = name_id;
-		write_name = false;
-		break;
-	}
 
-	if (delete) {
+#ifdef CONFIG_SETTINGS_NVS_NAME_CACHE
+		settings_nvs_cache_del(cf, name_hash, name_id);
+#endif
 		return 0;
 	}
 
@@ -220,13 +512,15 @@ static int settings_nvs_save(struct settings_store *cs, const char *name,
 		if (rc < 0) {
 			return rc;
 		}
+#ifdef CONFIG_SETTINGS_NVS_NAME_CACHE
+		settings_nvs_cache_add(cf, name_hash, write_name_id);
+#endif
 	}
 
 	/* update the last_name_id and write to flash if required*/
 	if (write_name_id > cf->last_name_id) {
 		cf->last_name_id = write_name_id;
-		rc = nvs_write(&cf->cf_nvs, NVS_NAMECNT_ID, &cf->last_name_id,
-			       sizeof(uint16_t));
+		rc = settings_nvs_store_last_name_id(cf);
 	}
 
 	if (rc < 0) {
@@ -255,6 +549,10 @@ int settings_nvs_backend_init(struct settings_nvs *cf)
 		cf->last_name_id = last_name_id;
 	}
 
+#ifdef CONFIG_SETTINGS_NVS_NAME_CACHE
+	settings_nvs_cache_fill(cf);
+#endif
+
 	LOG_DBG("Initialized");
 	return 0;
 }
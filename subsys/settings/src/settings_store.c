@@ -115,6 +115,168 @@ int settings_delete(const char *name)
 	return settings_save_one(name, NULL, 0);
 }
 
+#if defined(CONFIG_SETTINGS_TRANSACTION)
+/* Staged settings are stored back to back in the buffer, each one as a
+ * header followed by its NUL terminated name and its value.
+ */
+struct settings_staged {
+	uint8_t name_len;
+	uint16_t val_len;
+} __packed;
+
+static uint8_t settings_stage_buf[CONFIG_SETTINGS_TRANSACTION_BUF_SIZE];
+static size_t settings_stage_len;
+static k_tid_t settings_stage_owner;
+
+static size_t settings_staged_size(const struct settings_staged *hdr)
+{
+	return sizeof(*hdr) + hdr->name_len + 1 + hdr->val_len;
+}
+
+/* Remove the setting staged under name, if any */
+static void settings_stage_remove(const char *name, size_t name_len)
+{
+	struct settings_staged hdr;
+	size_t off = 0;
+	size_t size;
+
+	while (off < settings_stage_len) {
+		memcpy(&hdr, &settings_stage_buf[off], sizeof(hdr));
+		size = settings_staged_size(&hdr);
+
+		if ((hdr.name_len == name_len) &&
+		    !memcmp(&settings_stage_buf[off + sizeof(hdr)], name,
+			    name_len)) {
+			memmove(&settings_stage_buf[off],
+				&settings_stage_buf[off + size],
+				settings_stage_len - off - size);
+			settings_stage_len -= size;
+			return;
+		}
+
+		off += size;
+	}
+}
+
+int settings_save_begin(void)
+{
+	if (!settings_save_dst) {
+		return -ENOENT;
+	}
+
+	k_mutex_lock(&settings_lock, K_FOREVER);
+
+	if (settings_stage_owner == k_current_get()) {
+		k_mutex_unlock(&settings_lock);
+		return -EBUSY;
+	}
+
+	settings_stage_owner = k_current_get();
+	settings_stage_len = 0;
+
+	return 0;
+}
+
+int settings_save_stage(const char *name, const void *value, size_t val_len)
+{
+	struct settings_staged hdr;
+	size_t name_len;
+	uint8_t *dst;
+
+	if (settings_stage_owner != k_current_get()) {
+		return -EINVAL;
+	}
+
+	if (!name || (val_len > 0 && value == NULL)) {
+		return -EINVAL;
+	}
+
+	name_len = strlen(name);
+	if (name_len > SETTINGS_MAX_NAME_LEN || val_len > UINT16_MAX) {
+		return -EINVAL;
+	}
+
+	if (!value) {
+		val_len = 0;
+	}
+
+	settings_stage_remove(name, name_len);
+
+	hdr.name_len = name_len;
+	hdr.val_len = val_len;
+	if (settings_staged_size(&hdr) >
+	    sizeof(settings_stage_buf) - settings_stage_len) {
+		return -ENOMEM;
+	}
+
+	dst = &settings_stage_buf[settings_stage_len];
+	memcpy(dst, &hdr, sizeof(hdr));
+	dst += sizeof(hdr);
+	memcpy(dst, name, name_len + 1);
+	dst += name_len + 1;
+	if (val_len > 0) {
+		memcpy(dst, value, val_len);
+	}
+
+	settings_stage_len += settings_staged_size(&hdr);
+
+	return 0;
+}
+
+static void settings_stage_end(void)
+{
+	settings_stage_owner = NULL;
+	settings_stage_len = 0;
+	k_mutex_unlock(&settings_lock);
+}
+
+int settings_save_commit(void)
+{
+	struct settings_store *cs = settings_save_dst;
+	struct settings_staged hdr;
+	const char *name;
+	const char *value;
+	size_t off = 0;
+	int rc = 0;
+	int rc2;
+
+	if (settings_stage_owner != k_current_get()) {
+		return -EINVAL;
+	}
+
+	if (cs->cs_itf->csi_save_start) {
+		rc = cs->cs_itf->csi_save_start(cs);
+	}
+
+	while (!rc && off < settings_stage_len) {
+		memcpy(&hdr, &settings_stage_buf[off], sizeof(hdr));
+		name = (const char *)&settings_stage_buf[off + sizeof(hdr)];
+		value = hdr.val_len ? name + hdr.name_len + 1 : NULL;
+
+		rc = cs->cs_itf->csi_save(cs, name, value, hdr.val_len);
+		off += settings_staged_size(&hdr);
+	}
+
+	if (cs->cs_itf->csi_save_end) {
+		rc2 = cs->cs_itf->csi_save_end(cs);
+		if (!rc) {
+			rc = rc2;
+		}
+	}
+
+	settings_stage_end();
+
+	return rc;
+}
+
+void settings_save_abort(void)
+{
+	if (settings_stage_owner == k_current_get()) {
+		settings_stage_end();
+	}
+}
+#endif /* CONFIG_SETTINGS_TRANSACTION */
+
 int settings_save(void)
 {
 	struct settings_store *cs;
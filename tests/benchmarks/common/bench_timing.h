@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_BENCHMARKS_COMMON_BENCH_TIMING_H_
+#define ZEPHYR_BENCHMARKS_COMMON_BENCH_TIMING_H_
+
+#include <zephyr.h>
+#include <timing/timing.h>
+
+/*
+ * Timestamps of the benchmarks, read with the timing functions so that the
+ * counter of the architecture is used where there is one (the TSC on x86),
+ * and the system timer cycles elsewhere.  Needs CONFIG_TIMING_FUNCTIONS=y.
+ */
+
+static inline void bench_timing_init(void)
+{
+	timing_init();
+	timing_start();
+}
+
+static inline timing_t bench_stamp(void)
+{
+	return timing_counter_get();
+}
+
+/* Cycles between two stamps, the measured intervals are short */
+static inline uint32_t bench_cycles(timing_t start, timing_t end)
+{
+	return (uint32_t)timing_cycles_get(&start, &end);
+}
+
+#endif /* ZEPHYR_BENCHMARKS_COMMON_BENCH_TIMING_H_ */
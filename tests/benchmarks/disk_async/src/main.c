@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <string.h>
+#include <errno.h>
+#include <disk/disk_access.h>
+
+#include "../../common/bench_timing.h"
+
+/* This benchmark writes and reads the whole RAM disk with asynchronous
+ * requests of one sector each, keeping up to a given number of requests
+ * queued, and reports the cycles spent per sector for each queue depth.
+ * Requests complete in order, so a request is reused once the request
+ * submitted depth requests later can be queued.
+ */
+
+#define SECTOR_SIZE 512
+#define SECTORS (CONFIG_DISK_RAM_VOLUME_SIZE * 1024 / SECTOR_SIZE)
+#define MAX_DEPTH 16
+
+static const int depths[] = { 1, 2, 4, 8, MAX_DEPTH };
+
+static struct disk_req reqs[MAX_DEPTH];
+static struct disk_sg sgs[MAX_DEPTH];
+static K_SEM_DEFINE(free_reqs, 0, MAX_DEPTH);
+static volatile int failures;
+
+static uint8_t src[SECTORS * SECTOR_SIZE];
+static uint8_t dst[SECTORS * SECTOR_SIZE];
+
+static void req_done(struct disk_req *req, int result)
+{
+	if (result != 0) {
+		failures++;
+	}
+
+	k_sem_give(&free_reqs);
+}
+
+static int transfer(uint8_t op, uint8_t *buf, int depth)
+{
+	int rc;
+
+	k_sem_reset(&free_reqs);
+	for (int i = 0; i < depth; i++) {
+		k_sem_give(&free_reqs);
+	}
+
+	for (uint32_t sector = 0; sector < SECTORS; sector++) {
+		struct disk_req *req = &reqs[sector % depth];
+		struct disk_sg *sg = &sgs[sector % depth];
+
+		k_sem_take(&free_reqs, K_FOREVER);
+
+		sg->buf = &buf[sector * SECTOR_SIZE];
+		sg->start_sector = sector;
+		sg->num_sector = 1;
+
+		req->sg = sg;
+		req->sg_count = 1;
+		req->op = op;
+		req->cb = req_done;
+
+		rc = disk_access_submit(CONFIG_DISK_RAM_VOLUME_NAME, req);
+		if (rc < 0) {
+			return rc;
+		}
+	}
+
+	/* wait until all the requests are completed */
+	for (int i = 0; i < depth; i++) {
+		k_sem_take(&free_reqs, K_FOREVER);
+	}
+
+	return failures ? -EIO : 0;
+}
+
+static int run(int depth)
+{
+	timing_t t0;
+	uint32_t write_cycles, read_cycles;
+	int rc;
+
+	memset(dst, 0, sizeof(dst));
+	for (int i = 0; i < sizeof(src); i++) {
+		src[i] = depth + i / SECTOR_SIZE + i;
+	}
+
+	t0 = bench_stamp();
+	rc = transfer(DISK_REQ_WRITE, src, depth);
+	write_cycles = bench_cycles(t0, bench_stamp());
+	if (rc < 0) {
+		return rc;
+	}
+
+	t0 = bench_stamp();
+	rc = transfer(DISK_REQ_READ, dst, depth);
+	read_cycles = bench_cycles(t0, bench_stamp());
+	if (rc < 0) {
+		return rc;
+	}
+
+	if (memcmp(src, dst, sizeof(src)) != 0) {
+		return -EIO;
+	}
+
+	printk("depth %2d write cycles/sector %6u read cycles/sector %6u\n",
+	       depth, write_cycles / SECTORS, read_cycles / SECTORS);
+
+	return 0;
+}
+
+void main(void)
+{
+	int rc;
+
+	bench_timing_init();
+
+	rc = disk_access_init(CONFIG_DISK_RAM_VOLUME_NAME);
+	if (rc < 0) {
+		printk("unable to initialize the RAM disk (%d)\n", rc);
+		return;
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(depths); i++) {
+		rc = run(depths[i]);
+		if (rc < 0) {
+			printk("failed with %d requests queued (%d)\n",
+			       depths[i], rc);
+			return;
+		}
+	}
+
+	printk("fin\n");
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <string.h>
+#include <fs/fs.h>
+#include <ff.h>
+#include <stats/stats.h>
+
+#include "../../common/bench_timing.h"
+
+/* This benchmark writes files on a FAT volume in the flash simulator, in
+ * chunks of several sizes, and reports the cycles spent per KiB written
+ * and the number of flash erases for each file.  The files are closed,
+ * and thus synced, before the erases are counted.
+ */
+
+#define FILE_SIZE (64 * 1024)
+#define MNTP "/NAND:"
+
+static const int chunk_sizes[] = { 4096, 512, 100 };
+
+static FATFS fat_fs;
+static struct fs_mount_t fatfs_mnt = {
+	.type = FS_FATFS,
+	.mnt_point = MNTP,
+	.fs_data = &fat_fs,
+};
+
+static uint8_t chunk[4096];
+
+static int erase_calls_walk(struct stats_hdr *hdr, void *arg,
+			    const char *name, uint16_t off)
+{
+	if (strcmp(name, "flash_erase_calls") == 0) {
+		*(uint32_t *)arg = *(uint32_t *)((uint8_t *)hdr + off);
+		return 1;
+	}
+
+	return 0;
+}
+
+static uint32_t erase_calls(void)
+{
+	struct stats_hdr *hdr = stats_group_find("flash_sim_stats");
+	uint32_t calls = 0;
+
+	if (hdr != NULL) {
+		(void)stats_walk(hdr, erase_calls_walk, &calls);
+	}
+
+	return calls;
+}
+
+static int run(int size)
+{
+	struct fs_file_t file;
+	timing_t t0;
+	uint32_t cycles, erases;
+	int written = 0;
+	int rc;
+
+	(void)fs_unlink(MNTP "/bench.bin");
+
+	erases = erase_calls();
+	t0 = bench_stamp();
+
+	rc = fs_open(&file, MNTP "/bench.bin", FS_O_CREATE | FS_O_WRITE);
+	if (rc < 0) {
+		return rc;
+	}
+
+	while (written < FILE_SIZE) {
+		rc = fs_write(&file, chunk, MIN(size, FILE_SIZE - written));
+		if (rc < 0) {
+			(void)fs_close(&file);
+			return rc;
+		}
+
+		written += rc;
+	}
+
+	rc = fs_close(&file);
+	if (rc < 0) {
+		return rc;
+	}
+
+	cycles = bench_cycles(t0, bench_stamp());
+	erases = erase_calls() - erases;
+
+	printk("chunk %4d cycles/KiB %8u erases %5u\n", size,
+	       cycles / (FILE_SIZE / 1024), erases);
+
+	return 0;
+}
+
+void main(void)
+{
+	int rc;
+
+	bench_timing_init();
+	memset(chunk, 0xa5, sizeof(chunk));
+
+	rc = fs_mount(&fatfs_mnt);
+	if (rc < 0) {
+		printk("unable to mount the FAT volume (%d)\n", rc);
+		return;
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(chunk_sizes); i++) {
+		rc = run(chunk_sizes[i]);
+		if (rc < 0) {
+			printk("unable to write with %d byte chunks (%d)\n",
+			       chunk_sizes[i], rc);
+			return;
+		}
+	}
+
+	printk("fin\n");
+}
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <bluetooth/bluetooth.h>
+#include <bluetooth/gatt.h>
+
+#include "../../common/bench_timing.h"
+
+/* This benchmark registers up to 96 dynamic services of 7 attributes each
+ * and reports the cycles spent per attribute lookup, as done by the ATT
+ * server for a Read By Type request of characteristic declarations and
+ * for a Read request of a single handle.  The requests start at handles
+ * spread over the whole database.
+ */
+
+#define LOOKUPS 2000
+#define MAX_SERVICES 96
+#define SVC_ATTRS 7
+
+/* Entries which fit in the response of a Read By Type request with the
+ * default MTU of 23 bytes.
+ */
+#define READ_TYPE_ENTRIES 3
+
+static const int service_counts[] = { 8, 32, 96 };
+
+static struct bt_uuid_128 svc_uuid = BT_UUID_INIT_128(
+	0xf0, 0xde, 0xbc, 0x9a, 0x78, 0x56, 0x34, 0x12,
+	0x78, 0x56, 0x34, 0x12, 0x78, 0x56, 0x34, 0x12);
+static struct bt_uuid_128 chrc_uuid = BT_UUID_INIT_128(
+	0xf2, 0xde, 0xbc, 0x9a, 0x78, 0x56, 0x34, 0x12,
+	0x78, 0x56, 0x34, 0x12, 0x78, 0x56, 0x34, 0x12);
+
+static uint8_t value;
+
+static const struct bt_gatt_attr svc_template[SVC_ATTRS] = {
+	BT_GATT_PRIMARY_SERVICE(&svc_uuid),
+	BT_GATT_CHARACTERISTIC(&chrc_uuid.uuid, BT_GATT_CHRC_READ,
+			       BT_GATT_PERM_READ, NULL, NULL, &value),
+	BT_GATT_CHARACTERISTIC(&chrc_uuid.uuid, BT_GATT_CHRC_READ,
+			       BT_GATT_PERM_READ, NULL, NULL, &value),
+	BT_GATT_CHARACTERISTIC(&chrc_uuid.uuid, BT_GATT_CHRC_READ,
+			       BT_GATT_PERM_READ, NULL, NULL, &value),
+};
+
+static struct bt_gatt_attr svc_attrs[MAX_SERVICES][SVC_ATTRS];
+static struct bt_gatt_service svcs[MAX_SERVICES];
+
+static uint8_t count_attr(const struct bt_gatt_attr *attr, uint16_t handle,
+			  void *user_data)
+{
+	int *found = user_data;
+
+	(*found)++;
+
+	return BT_GATT_ITER_CONTINUE;
+}
+
+static uint32_t run(uint16_t first, uint16_t last, bool read_type)
+{
+	timing_t t0;
+	uint32_t cycles;
+	int found = 0;
+	int i;
+
+	t0 = bench_stamp();
+
+	for (i = 0; i < LOOKUPS; i++) {
+		uint16_t handle = first + (i * 7919) % (last - first + 1);
+
+		if (read_type) {
+			bt_gatt_foreach_attr_type(handle, 0xffff,
+						  BT_UUID_GATT_CHRC, NULL,
+						  READ_TYPE_ENTRIES,
+						  count_attr, &found);
+		} else {
+			bt_gatt_foreach_attr(handle, handle, count_attr,
+					     &found);
+		}
+	}
+
+	cycles = bench_cycles(t0, bench_stamp());
+
+	if (found == 0) {
+		printk("no attributes found\n");
+	}
+
+	return cycles / LOOKUPS;
+}
+
+void main(void)
+{
+	int services = 0;
+	int i, err;
+
+	bench_timing_init();
+
+	for (i = 0; i < ARRAY_SIZE(service_counts); i++) {
+		uint16_t first, last;
+		uint32_t read_type, read;
+
+		for (; services < service_counts[i]; services++) {
+			memcpy(svc_attrs[services], svc_template,
+			       sizeof(svc_template));
+			svcs[services].attrs = svc_attrs[services];
+			svcs[services].attr_count = SVC_ATTRS;
+
+			err = bt_gatt_service_register(&svcs[services]);
+			if (err) {
+				printk("unable to register service %d: %d\n",
+				       services, err);
+				return;
+			}
+		}
+
+		first = svc_attrs[0][0].handle;
+		last = svc_attrs[services - 1][SVC_ATTRS - 1].handle;
+
+		read_type = run(first, last, true);
+		read = run(first, last, false);
+
+		printk("services %3d attrs %5d read_type %6u read %6u\n",
+		       services, last, read_type, read);
+	}
+
+	printk("fin\n");
+}
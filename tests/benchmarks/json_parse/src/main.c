@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <sys/util.h>
+#include <string.h>
+#include <data/json.h>
+
+#include "../../common/bench_timing.h"
+
+/* This benchmark measures the cycles needed to decode two payloads
+ * typical of cloud connected devices, in one buffer with
+ * json_obj_parse64() and in PIECE sized pieces with the stream API, and
+ * those needed to decode the telemetry with shuffled keys with
+ * json_obj_parse64() and json_obj_parse_indexed().
+ */
+
+#define ROUNDS 200
+#define PIECE 64
+#define TELEMETRY_FIELDS 40
+
+#define TELEMETRY_FIELD(i, _) int r##i;
+#define TELEMETRY_DESCR(i, _) \
+	JSON_OBJ_DESCR_PRIM(struct telemetry, r##i, JSON_TOK_NUMBER),
+
+struct telemetry {
+	UTIL_LISTIFY(TELEMETRY_FIELDS, TELEMETRY_FIELD, _)
+};
+
+static const struct json_obj_descr telemetry_descr[] = {
+	UTIL_LISTIFY(TELEMETRY_FIELDS, TELEMETRY_DESCR, _)
+};
+
+struct reported {
+	const char *fw_version;
+	const char *hw_revision;
+	int uptime;
+	int rssi;
+	int battery;
+	bool charging;
+	int temperature;
+	int humidity;
+};
+
+struct sensor {
+	const char *id;
+	const char *unit;
+	int value;
+	int interval;
+};
+
+struct shadow {
+	struct reported reported;
+	struct sensor sensors[4];
+	size_t sensors_len;
+	const char *client_token;
+	int version;
+	int timestamp;
+};
+
+static const struct json_obj_descr reported_descr[] = {
+	JSON_OBJ_DESCR_PRIM(struct reported, fw_version, JSON_TOK_STRING),
+	JSON_OBJ_DESCR_PRIM(struct reported, hw_revision, JSON_TOK_STRING),
+	JSON_OBJ_DESCR_PRIM(struct reported, uptime, JSON_TOK_NUMBER),
+	JSON_OBJ_DESCR_PRIM(struct reported, rssi, JSON_TOK_NUMBER),
+	JSON_OBJ_DESCR_PRIM(struct reported, battery, JSON_TOK_NUMBER),
+	JSON_OBJ_DESCR_PRIM(struct reported, charging, JSON_TOK_TRUE),
+	JSON_OBJ_DESCR_PRIM(struct reported, temperature, JSON_TOK_NUMBER),
+	JSON_OBJ_DESCR_PRIM(struct reported, humidity, JSON_TOK_NUMBER),
+};
+
+static const struct json_obj_descr sensor_descr[] = {
+	JSON_OBJ_DESCR_PRIM(struct sensor, id, JSON_TOK_STRING),
+	JSON_OBJ_DESCR_PRIM(struct sensor, unit, JSON_TOK_STRING),
+	JSON_OBJ_DESCR_PRIM(struct sensor, value, JSON_TOK_NUMBER),
+	JSON_OBJ_DESCR_PRIM(struct sensor, interval, JSON_TOK_NUMBER),
+};
+
+static const struct json_obj_descr shadow_descr[] = {
+	JSON_OBJ_DESCR_OBJECT(struct shadow, reported, reported_descr),
+	JSON_OBJ_DESCR_OBJ_ARRAY(struct shadow, sensors, 4, sensors_len,
+				 sensor_descr, ARRAY_SIZE(sensor_descr)),
+	JSON_OBJ_DESCR_PRIM_NAMED(struct shadow, "clientToken",
+				  client_token, JSON_TOK_STRING),
+	JSON_OBJ_DESCR_PRIM(struct shadow, version, JSON_TOK_NUMBER),
+	JSON_OBJ_DESCR_PRIM(struct shadow, timestamp, JSON_TOK_NUMBER),
+};
+
+static const char shadow_payload[] =
+	"{\"timestamp\":1600000000,\"version\":42,"
+	"\"clientToken\":\"a1b2c3d4-e5f6\","
+	"\"reported\":{\"temperature\":2150,\"humidity\":48,"
+	"\"battery\":87,\"charging\":false,\"rssi\":-67,"
+	"\"uptime\":86400,\"hw_revision\":\"B2\","
+	"\"fw_version\":\"2.4.1+build.17\"},"
+	"\"sensors\":["
+	"{\"value\":2150,\"unit\":\"cC\",\"id\":\"temp0\",\"interval\":60},"
+	"{\"value\":48,\"unit\":\"%\",\"id\":\"hum0\",\"interval\":60},"
+	"{\"value\":101325,\"unit\":\"Pa\",\"id\":\"press0\","
+	"\"interval\":300},"
+	"{\"value\":412,\"unit\":\"ppm\",\"id\":\"co2\",\"interval\":120}"
+	"]}";
+
+static char payload[1024];
+static char work[1024];
+static char stream_buf[1024];
+
+static union {
+	struct telemetry telemetry;
+	struct shadow shadow;
+} decoded;
+
+static void run(const char *name, size_t len,
+		const struct json_obj_descr *descr, size_t descr_len)
+{
+	struct json_obj_stream stream;
+	uint32_t parse = 0U, streamed = 0U;
+	timing_t t0;
+	int64_t expected = ((int64_t)1 << descr_len) - 1;
+	int64_t ret;
+
+	for (int i = 0; i < ROUNDS; i++) {
+		/* Strings are terminated in place, so parse a fresh copy */
+		memcpy(work, payload, len);
+
+		t0 = bench_stamp();
+		ret = json_obj_parse64(work, len, descr, descr_len, &decoded);
+		parse += bench_cycles(t0, bench_stamp());
+
+		if (ret != expected) {
+			printk("%s: parse returned %d\n", name, (int)ret);
+			return;
+		}
+
+		t0 = bench_stamp();
+		json_obj_stream_init(&stream, stream_buf, sizeof(stream_buf));
+		for (size_t off = 0; off < len; off += PIECE) {
+			(void)json_obj_stream_feed(&stream, &payload[off],
+						   MIN(PIECE, len - off));
+		}
+		ret = json_obj_stream_parse(&stream, descr, descr_len,
+					    &decoded);
+		streamed += bench_cycles(t0, bench_stamp());
+
+		if (ret != expected) {
+			printk("%s: stream parse returned %d\n", name, (int)ret);
+			return;
+		}
+	}
+
+	printk("%-9s bytes %4zu parse %7u stream %7u\n", name, len,
+	       parse / ROUNDS, streamed / ROUNDS);
+}
+
+static void run_shuffled(const struct telemetry *telemetry)
+{
+	static uint8_t index[TELEMETRY_FIELDS];
+	const int *readings = (const int *)telemetry;
+	uint32_t parse = 0U, indexed = 0U;
+	int64_t expected = ((int64_t)1 << TELEMETRY_FIELDS) - 1;
+	size_t len = 0;
+	timing_t t0;
+	int64_t ret;
+	int i, f;
+
+	(void)json_obj_descr_index(telemetry_descr, TELEMETRY_FIELDS, index);
+
+	/* The same readings with the keys in another order */
+	payload[len++] = '{';
+	for (i = 0; i < TELEMETRY_FIELDS; i++) {
+		f = (i * 17) % TELEMETRY_FIELDS;
+		len += snprintk(&payload[len], sizeof(payload) - len,
+				"\"r%d\":%d%c", f, readings[f],
+				i < TELEMETRY_FIELDS - 1 ? ',' : '}');
+	}
+
+	for (i = 0; i < ROUNDS; i++) {
+		memcpy(work, payload, len);
+
+		t0 = bench_stamp();
+		ret = json_obj_parse64(work, len, telemetry_descr,
+				       TELEMETRY_FIELDS, &decoded);
+		parse += bench_cycles(t0, bench_stamp());
+
+		if (ret != expected) {
+			printk("shuffled: parse returned %d\n", (int)ret);
+			return;
+		}
+
+		memcpy(work, payload, len);
+
+		t0 = bench_stamp();
+		ret = json_obj_parse_indexed(work, len, telemetry_descr,
+					     TELEMETRY_FIELDS, index,
+					     &decoded);
+		indexed += bench_cycles(t0, bench_stamp());
+
+		if (ret != expected) {
+			printk("shuffled: indexed parse returned %d\n",
+			       (int)ret);
+			return;
+		}
+	}
+
+	printk("%-9s bytes %4zu parse %7u indexed %7u\n", "shuffled", len,
+	       parse / ROUNDS, indexed / ROUNDS);
+}
+
+void main(void)
+{
+	struct telemetry telemetry;
+	int *readings = (int *)&telemetry;
+	int ret;
+
+	bench_timing_init();
+
+	for (int i = 0; i < TELEMETRY_FIELDS; i++) {
+		readings[i] = i * 1237 - 20000;
+	}
+
+	ret = json_obj_encode_buf(telemetry_descr, ARRAY_SIZE(telemetry_descr),
+				  &telemetry, payload, sizeof(payload));
+	if (ret < 0) {
+		printk("unable to encode telemetry\n");
+		return;
+	}
+
+	run("telemetry", strlen(payload), telemetry_descr,
+	    ARRAY_SIZE(telemetry_descr));
+	run_shuffled(&telemetry);
+
+	memcpy(payload, shadow_payload, sizeof(shadow_payload));
+	run("shadow", sizeof(shadow_payload) - 1, shadow_descr,
+	    ARRAY_SIZE(shadow_descr));
+
+	printk("fin\n");
+}
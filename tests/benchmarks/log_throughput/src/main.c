@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <logging/log.h>
+#include <logging/log_backend.h>
+#include <logging/log_ctrl.h>
+
+#include "../../common/bench_timing.h"
+
+LOG_MODULE_REGISTER(bench, LOG_LEVEL_INF);
+
+/* This benchmark reports the cycles spent per LOG_INF() when 1, 2 and 4
+ * threads log at once.  The threads have the same priority and yield after
+ * every message, so that they interleave, and a timer interrupt logs as
+ * well.  A backend which only counts the messages is attached, and the
+ * buffer is drained between rounds so that no message is dropped and only
+ * the allocation and queueing of messages is measured.
+ */
+
+#define MAX_THREADS 4
+#define LOGS_PER_ROUND 80
+#define ROUNDS 25
+#define STACK_SIZE 1024
+
+static const int thread_counts[] = { 1, 2, 4 };
+
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, MAX_THREADS, STACK_SIZE);
+static struct k_thread threads[MAX_THREADS];
+static struct k_timer timer;
+
+static atomic_t cycles;
+static atomic_t logs;
+static atomic_t received;
+static atomic_t dropped;
+
+static void put(const struct log_backend *const backend,
+		struct log_msg *msg)
+{
+	atomic_inc(&received);
+}
+
+static void panic(const struct log_backend *const backend)
+{
+}
+
+static void dropped_cb(const struct log_backend *const backend, uint32_t cnt)
+{
+	atomic_add(&dropped, cnt);
+}
+
+static const struct log_backend_api count_api = {
+	.put = put,
+	.panic = panic,
+	.dropped = dropped_cb,
+};
+
+LOG_BACKEND_DEFINE(count_backend, count_api, true);
+
+static void log_one(int id, int i)
+{
+	timing_t t0 = bench_stamp();
+
+	LOG_INF("thread %d message %d", id, i);
+
+	atomic_add(&cycles, bench_cycles(t0, bench_stamp()));
+	atomic_inc(&logs);
+}
+
+static void timer_handler(struct k_timer *timer)
+{
+	log_one(-1, 0);
+}
+
+static void producer(void *p1, void *p2, void *p3)
+{
+	int id = POINTER_TO_INT(p1);
+
+	for (int i = 0; i < LOGS_PER_ROUND; i++) {
+		log_one(id, i);
+		k_yield();
+	}
+}
+
+static void run(int nthreads)
+{
+	int round, i;
+
+	atomic_clear(&cycles);
+	atomic_clear(&logs);
+	atomic_clear(&received);
+	atomic_clear(&dropped);
+
+	for (round = 0; round < ROUNDS; round++) {
+		k_timer_start(&timer, K_MSEC(1), K_MSEC(1));
+
+		for (i = 0; i < nthreads; i++) {
+			k_thread_create(&threads[i], stacks[i], STACK_SIZE,
+					producer, INT_TO_POINTER(i), NULL, NULL,
+					K_PRIO_PREEMPT(1), 0, K_NO_WAIT);
+		}
+
+		for (i = 0; i < nthreads; i++) {
+			k_thread_join(&threads[i], K_FOREVER);
+		}
+
+		k_timer_stop(&timer);
+
+		/* Let the logging thread drain the buffer */
+		while (log_buffered_cnt()) {
+			k_sleep(K_MSEC(10));
+		}
+	}
+
+	printk("threads %d cycles/log %6u received %6u dropped %u\n",
+	       nthreads, (uint32_t)atomic_get(&cycles) / atomic_get(&logs),
+	       (uint32_t)atomic_get(&received), (uint32_t)atomic_get(&dropped));
+}
+
+void main(void)
+{
+	bench_timing_init();
+	k_timer_init(&timer, timer_handler, NULL);
+
+	for (int i = 0; i < ARRAY_SIZE(thread_counts); i++) {
+		run(thread_counts[i]);
+	}
+
+	printk("fin\n");
+}
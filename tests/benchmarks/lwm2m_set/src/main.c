@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <net/lwm2m.h>
+
+#include "../../common/bench_timing.h"
+
+/* This benchmark creates up to 32 instances each of the IPSO temperature
+ * and humidity sensor objects, and reports the cycles spent per set and
+ * get of the sensor value of the humidity sensors, through path strings
+ * and through resource handles.  The humidity sensor instances are the
+ * last ones in the engine's object instance list.
+ */
+
+#define CALLS 2000
+
+#define TEMP_SENSOR_ID 3303
+#define HUMIDITY_SENSOR_ID 3304
+#define SENSOR_VALUE_RID 5700
+
+static const int inst_counts[] = { 4, 16, 32 };
+
+static char paths[32][24];
+static struct lwm2m_engine_res_handle handles[32];
+
+static int create(int inst)
+{
+	char path[16];
+	int ret;
+
+	snprintk(path, sizeof(path), "%d/%d", TEMP_SENSOR_ID, inst);
+	ret = lwm2m_engine_create_obj_inst(path);
+	if (ret < 0) {
+		return ret;
+	}
+
+	snprintk(path, sizeof(path), "%d/%d", HUMIDITY_SENSOR_ID, inst);
+	ret = lwm2m_engine_create_obj_inst(path);
+	if (ret < 0) {
+		return ret;
+	}
+
+	snprintk(paths[inst], sizeof(paths[inst]), "%d/%d/%d",
+		 HUMIDITY_SENSOR_ID, inst, SENSOR_VALUE_RID);
+
+	return lwm2m_engine_get_res_handle(paths[inst], &handles[inst]);
+}
+
+static uint32_t run(int insts, bool handle, bool set)
+{
+	float32_value_t value = { 0 };
+	timing_t t0;
+	uint32_t cycles;
+	int ret = 0;
+	int i;
+
+	t0 = bench_stamp();
+
+	for (i = 0; i < CALLS && ret == 0; i++) {
+		int inst = (i * 7) % insts;
+
+		value.val1 = i;
+
+		if (handle && set) {
+			ret = lwm2m_engine_set_by_handle(&handles[inst], &value,
+							 sizeof(value));
+		} else if (handle) {
+			ret = lwm2m_engine_get_by_handle(&handles[inst], &value,
+							 sizeof(value));
+		} else if (set) {
+			ret = lwm2m_engine_set_float32(paths[inst], &value);
+		} else {
+			ret = lwm2m_engine_get_float32(paths[inst], &value);
+		}
+	}
+
+	cycles = bench_cycles(t0, bench_stamp());
+
+	if (ret < 0) {
+		printk("call %d failed: %d\n", i, ret);
+	}
+
+	return cycles / CALLS;
+}
+
+void main(void)
+{
+	int insts = 0;
+	int i, ret;
+
+	bench_timing_init();
+
+	for (i = 0; i < ARRAY_SIZE(inst_counts); i++) {
+		uint32_t set, get, handle_set, handle_get;
+
+		for (; insts < inst_counts[i]; insts++) {
+			ret = create(insts);
+			if (ret < 0) {
+				printk("unable to create instance %d: %d\n",
+				       insts, ret);
+				return;
+			}
+		}
+
+		set = run(insts, false, true);
+		get = run(insts, false, false);
+		handle_set = run(insts, true, true);
+		handle_get = run(insts, true, false);
+
+		printk("instances %3d set %6u get %6u handle set %6u get %6u\n",
+		       insts * 2, set, get, handle_set, handle_get);
+	}
+
+	printk("fin\n");
+}
@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <bluetooth/bluetooth.h>
+#include <bluetooth/mesh.h>
+
+#include "../../common/bench_timing.h"
+
+#include "net.h"
+
+/* This benchmark feeds network PDUs to the network layer of a provisioned
+ * node and reports the cycles spent per PDU.  The node receives as many
+ * fresh PDUs as its network message cache holds, then a copy of each of
+ * them relayed by a neighbor, with a lower TTL and thus another MIC, and
+ * finally PDUs to its own element from as many sources as its replay
+ * protection list holds.  The PDUs carry an unknown transport control
+ * opcode, so that the transport layer drops them once they are checked.
+ */
+
+#define PDUS CONFIG_BT_MESH_MSG_CACHE_SIZE
+#define SOURCES CONFIG_BT_MESH_CRPL
+#define PDU_MAX 29
+
+#define NET_IDX 0x000
+#define LOCAL_ADDR 0x0001
+#define GROUP_ADDR 0xc001
+#define FIRST_SRC 0x0100
+#define TTL 5
+
+static const uint8_t net_key[16] = {
+	0x7d, 0xd7, 0x36, 0x4c, 0xd8, 0x42, 0xad, 0x18,
+	0xc1, 0x7c, 0x2b, 0x82, 0x0c, 0x84, 0xc3, 0xd6,
+};
+static const uint8_t dev_key[16] = {
+	0x9d, 0x6d, 0xd0, 0xe9, 0x6e, 0xb2, 0x5d, 0xc1,
+	0x9a, 0x40, 0xed, 0x99, 0x14, 0xf8, 0xf0, 0x3f,
+};
+
+static struct bt_mesh_cfg_srv cfg_srv = {
+	.relay = BT_MESH_RELAY_DISABLED,
+	.beacon = BT_MESH_BEACON_DISABLED,
+	.frnd = BT_MESH_FRIEND_NOT_SUPPORTED,
+	.gatt_proxy = BT_MESH_GATT_PROXY_NOT_SUPPORTED,
+	.default_ttl = 7,
+	.net_transmit = BT_MESH_TRANSMIT(2, 20),
+	.relay_retransmit = BT_MESH_TRANSMIT(2, 20),
+};
+
+static struct bt_mesh_model root_models[] = {
+	BT_MESH_MODEL_CFG_SRV(&cfg_srv),
+};
+
+static struct bt_mesh_elem elements[] = {
+	BT_MESH_ELEM(0, root_models, BT_MESH_MODEL_NONE),
+};
+
+static const struct bt_mesh_comp comp = {
+	.cid = BT_COMP_ID_LF,
+	.elem = elements,
+	.elem_count = ARRAY_SIZE(elements),
+};
+
+struct pdu {
+	uint8_t data[PDU_MAX];
+	uint8_t len;
+};
+
+static struct pdu fresh[PDUS], relayed[PDUS], local[PDUS];
+
+/* Encrypts a PDU with the next sequence number of the local node, which
+ * is as good as the sequence number of any other source.
+ */
+static int pdu_create(uint16_t src, uint16_t dst, uint8_t ttl,
+		      struct pdu *pdu)
+{
+	NET_BUF_SIMPLE_DEFINE(buf, PDU_MAX);
+	struct bt_mesh_msg_ctx ctx = {
+		.net_idx = NET_IDX,
+		.app_idx = BT_MESH_KEY_UNUSED,
+		.addr = dst,
+		.send_ttl = ttl,
+	};
+	struct bt_mesh_net_tx tx = {
+		.sub = bt_mesh_subnet_get(NET_IDX),
+		.ctx = &ctx,
+		.src = src,
+	};
+	int err;
+
+	net_buf_simple_reserve(&buf, BT_MESH_NET_HDR_LEN);
+	net_buf_simple_add_u8(&buf, 0x3f);
+	net_buf_simple_add_be24(&buf, src);
+
+	err = bt_mesh_net_encode(&tx, &buf, false);
+	if (err) {
+		return err;
+	}
+
+	memcpy(pdu->data, buf.data, buf.len);
+	pdu->len = buf.len;
+
+	return 0;
+}
+
+static uint32_t run(struct pdu *pdus)
+{
+	struct net_buf_simple buf;
+	timing_t t0;
+	uint32_t cycles;
+	int i;
+
+	t0 = bench_stamp();
+
+	for (i = 0; i < PDUS; i++) {
+		net_buf_simple_init_with_data(&buf, pdus[i].data, pdus[i].len);
+		bt_mesh_net_recv(&buf, -40, BT_MESH_NET_IF_ADV);
+	}
+
+	cycles = bench_cycles(t0, bench_stamp());
+
+	return cycles / PDUS;
+}
+
+void main(void)
+{
+	uint32_t fresh_cycles, relayed_cycles, local_cycles;
+	int i, err;
+
+	bench_timing_init();
+
+	err = bt_mesh_init(NULL, &comp);
+	if (!err) {
+		err = bt_mesh_provision(net_key, NET_IDX, 0, 0, LOCAL_ADDR,
+					dev_key);
+	}
+
+	if (err) {
+		printk("unable to set up the mesh node: %d\n", err);
+		return;
+	}
+
+	for (i = 0; i < PDUS && !err; i++) {
+		uint16_t src = FIRST_SRC + i % SOURCES;
+		uint32_t seq = bt_mesh.seq;
+
+		err = pdu_create(src, GROUP_ADDR, TTL, &fresh[i]);
+		if (err) {
+			break;
+		}
+
+		/* Same sequence number, one hop further */
+		bt_mesh.seq = seq;
+		err = pdu_create(src, GROUP_ADDR, TTL - 1, &relayed[i]);
+	}
+
+	for (i = 0; i < PDUS && !err; i++) {
+		err = pdu_create(FIRST_SRC + i % SOURCES, LOCAL_ADDR, TTL,
+				 &local[i]);
+	}
+
+	if (err) {
+		printk("unable to create PDUs: %d\n", err);
+		return;
+	}
+
+	fresh_cycles = run(fresh);
+	relayed_cycles = run(relayed);
+	local_cycles = run(local);
+
+	printk("cache %5d rpl %5d fresh %7u duplicate %7u local %7u\n", PDUS,
+	       SOURCES, fresh_cycles, relayed_cycles, local_cycles);
+
+	printk("fin\n");
+}
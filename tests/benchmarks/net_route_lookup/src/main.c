@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <random/rand32.h>
+#include <net/net_if.h>
+#include <net/net_ip.h>
+
+#include "../../common/bench_timing.h"
+
+#include "ipv6.h"
+#include "route.h"
+
+/* This benchmark grows an IPv6 routing table from 16 to 1024 routes and
+ * reports the cycles spent per net_route_lookup() at each size.  The
+ * routes are non-overlapping /48, /56 and /64 prefixes, so that every
+ * one of them is actually added instead of updating a covering route.
+ */
+
+#define LOOKUPS 20000
+#define N_NEXTHOPS 8
+#define N_HOT 4
+
+static const int table_sizes[] = { 16, 64, 256, 1024 };
+
+static struct in6_addr dests[CONFIG_NET_MAX_ROUTES];
+static struct in6_addr nexthops[N_NEXTHOPS];
+
+/* Route i covers 2001:db8:i::/48 or a random /56 or /64 inside it */
+static uint8_t route_prefix(int i, struct in6_addr *addr)
+{
+	uint8_t len = 48 + (i % 3) * 8;
+
+	(void)memset(addr, 0, sizeof(*addr));
+	addr->s6_addr[0] = 0x20;
+	addr->s6_addr[1] = 0x01;
+	addr->s6_addr[2] = 0x0d;
+	addr->s6_addr[3] = 0xb8;
+	addr->s6_addr[4] = i >> 8;
+	addr->s6_addr[5] = i;
+
+	if (len > 48) {
+		sys_rand_get(&addr->s6_addr[6], (len - 48) / 8);
+	}
+
+	return len;
+}
+
+static int add_nexthops(struct net_if *iface)
+{
+	struct net_linkaddr lladdr;
+	uint8_t mac[6] = { 0x00, 0x00, 0x5e, 0x00, 0x53, 0x00 };
+	int i;
+
+	lladdr.addr = mac;
+	lladdr.len = sizeof(mac);
+	lladdr.type = NET_LINK_ETHERNET;
+
+	for (i = 0; i < N_NEXTHOPS; i++) {
+		net_ipv6_addr_create(&nexthops[i], 0xfe80, 0, 0, 0, 0, 0, 0,
+				     i + 1);
+		mac[5] = i + 1;
+
+		if (!net_ipv6_nbr_add(iface, &nexthops[i], &lladdr, false,
+				      NET_IPV6_NBR_STATE_REACHABLE)) {
+			return -ENOMEM;
+		}
+	}
+
+	return 0;
+}
+
+static uint32_t run(struct net_if *iface, int routes, bool hot)
+{
+	timing_t t0;
+	uint32_t cycles;
+	int found = 0;
+	int i;
+
+	t0 = bench_stamp();
+
+	for (i = 0; i < LOOKUPS; i++) {
+		int idx = hot ? i % N_HOT : (i * 7919) % routes;
+
+		if (net_route_lookup(iface, &dests[idx])) {
+			found++;
+		}
+	}
+
+	cycles = bench_cycles(t0, bench_stamp());
+
+	if (found != LOOKUPS) {
+		printk("only %d of %d lookups found a route\n", found,
+		       LOOKUPS);
+	}
+
+	return cycles / LOOKUPS;
+}
+
+void main(void)
+{
+	struct net_if *iface = net_if_get_default();
+	int routes = 0;
+	int i;
+
+	bench_timing_init();
+
+	if (add_nexthops(iface) < 0) {
+		printk("unable to add next hop neighbors\n");
+		return;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(table_sizes); i++) {
+		uint32_t spread, hot;
+
+		for (; routes < table_sizes[i]; routes++) {
+			struct in6_addr prefix;
+			uint8_t len = route_prefix(routes, &prefix);
+
+			if (!net_route_add(iface, &prefix, len,
+					   &nexthops[routes % N_NEXTHOPS])) {
+				printk("unable to add route %d\n", routes);
+				return;
+			}
+
+			/* Look up a host inside the prefix */
+			net_ipaddr_copy(&dests[routes], &prefix);
+			sys_rand_get(&dests[routes].s6_addr[len / 8],
+				     16 - len / 8);
+		}
+
+		spread = run(iface, routes, false);
+		hot = run(iface, routes, true);
+
+		printk("routes %4d cycles/lookup %6u hot %6u\n", routes,
+		       spread, hot);
+	}
+
+	printk("fin\n");
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <string.h>
+#include <drivers/flash.h>
+#include <fs/nvs.h>
+
+/* This benchmark measures the latency of NVS writes done at a steady pace,
+ * like settings saved by an application, with the flash simulator taking
+ * as long as a real flash to write and erase.  The writes cycle through all
+ * the sectors several times, and a histogram of their latency is printed.
+ * Without CONFIG_NVS_GC_BACKGROUND the write which fills a sector also
+ * erases the next one; with it the system work queue erases it between
+ * writes.
+ */
+
+#define FLASH_LABEL DT_CHOSEN_ZEPHYR_FLASH_CONTROLLER_LABEL
+#define SECTOR_SIZE 4096
+#define SECTOR_COUNT 8
+#define VALUE_SIZE 64
+#define IDS 32
+#define WRITES 2000
+#define WRITE_PERIOD_MS 2
+
+/* bucket i counts the latencies below 128 << i us, the last one the rest */
+#define BUCKETS 8
+#define BUCKET_MIN_US 128
+
+static struct nvs_fs fs;
+static uint8_t value[VALUE_SIZE];
+static uint32_t histogram[BUCKETS];
+
+static int mount(void)
+{
+	const struct device *dev = device_get_binding(FLASH_LABEL);
+	int rc;
+
+	(void)flash_write_protection_set(dev, false);
+	rc = flash_erase(dev, 0, SECTOR_SIZE * SECTOR_COUNT);
+	(void)flash_write_protection_set(dev, true);
+	if (rc) {
+		return rc;
+	}
+
+	fs.offset = 0;
+	fs.sector_size = SECTOR_SIZE;
+	fs.sector_count = SECTOR_COUNT;
+
+	return nvs_init(&fs, FLASH_LABEL);
+}
+
+void main(void)
+{
+	uint32_t t0, us, max = 0U, blocked = 0U;
+	int rc, i;
+
+	rc = mount();
+	if (rc) {
+		printk("unable to mount (%d)\n", rc);
+		return;
+	}
+
+	for (int n = 0; n < WRITES; n++) {
+		memset(value, n, sizeof(value));
+
+		t0 = k_cycle_get_32();
+		rc = nvs_write(&fs, n % IDS, value, sizeof(value));
+		us = k_cyc_to_us_floor32(k_cycle_get_32() - t0);
+		if (rc < 0) {
+			printk("write %d failed (%d)\n", n, rc);
+			return;
+		}
+
+		for (i = 0; i < BUCKETS - 1; i++) {
+			if (us < (BUCKET_MIN_US << i)) {
+				break;
+			}
+		}
+		histogram[i]++;
+
+		max = MAX(max, us);
+		if (us >= CONFIG_FLASH_SIMULATOR_MIN_ERASE_TIME_US) {
+			blocked++;
+		}
+
+		k_sleep(K_MSEC(WRITE_PERIOD_MS));
+	}
+
+	for (i = 0; i < BUCKETS - 1; i++) {
+		printk("latency < %5d us %5u\n", BUCKET_MIN_US << i,
+		       histogram[i]);
+	}
+	printk("latency >= %4d us %5u\n", BUCKET_MIN_US << (BUCKETS - 2),
+	       histogram[BUCKETS - 1]);
+
+	printk("writes %d max %u us blocked %u\n", WRITES, max, blocked);
+	printk("fin\n");
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <drivers/flash.h>
+#include <storage/flash_map.h>
+#include <fs/nvs.h>
+
+#include "../../common/bench_timing.h"
+
+/* This benchmark measures NVS lookup cost as the number of ids in the
+ * file system grows.  It writes MAX_KEYS ids in steps of KEY_STEP
+ * into the storage partition of the flash simulator and after every
+ * step reports the cycles needed to mount the file system and the
+ * average cycles of an nvs_read() over all ids written so far.  Build
+ * it with and without CONFIG_NVS_LOOKUP_CACHE to compare them.
+ */
+
+#define MAX_KEYS 512
+#define KEY_STEP 64
+#define SECTOR_PAGES 4
+
+static struct nvs_fs fs;
+
+static int mount(void)
+{
+	const struct flash_area *fa;
+	struct flash_pages_info info;
+	int err;
+
+	err = flash_area_open(FLASH_AREA_ID(storage), &fa);
+	if (err) {
+		return err;
+	}
+
+	err = flash_get_page_info_by_offs(flash_area_get_device(fa),
+					  fa->fa_off, &info);
+	if (err) {
+		return err;
+	}
+
+	fs.offset = fa->fa_off;
+	fs.sector_size = SECTOR_PAGES * info.size;
+	fs.sector_count = fa->fa_size / fs.sector_size;
+
+	return nvs_init(&fs, DT_CHOSEN_ZEPHYR_FLASH_CONTROLLER_LABEL);
+}
+
+void main(void)
+{
+	timing_t t0, t1;
+	uint32_t init, read;
+	uint32_t val;
+	int keys = 0;
+
+	bench_timing_init();
+
+	if (mount() || nvs_clear(&fs)) {
+		printk("unable to set up NVS\n");
+		return;
+	}
+
+	while (keys < MAX_KEYS) {
+		for (int i = 0; i < KEY_STEP; i++, keys++) {
+			val = keys;
+			(void)nvs_write(&fs, keys, &val, sizeof(val));
+		}
+
+		t0 = bench_stamp();
+		(void)mount();
+		t1 = bench_stamp();
+		init = bench_cycles(t0, t1);
+
+		read = 0U;
+		for (int id = 0; id < keys; id++) {
+			t0 = bench_stamp();
+			(void)nvs_read(&fs, id, &val, sizeof(val));
+			t1 = bench_stamp();
+			read += bench_cycles(t0, t1);
+
+			if (val != id) {
+				printk("id %d read back %u\n", id, val);
+			}
+		}
+
+		printk("keys %4d init %9u read %7u\n", keys, init,
+		       read / keys);
+	}
+
+	printk("fin\n");
+}
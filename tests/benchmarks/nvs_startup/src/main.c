@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <string.h>
+#include <errno.h>
+#include <drivers/flash.h>
+#include <fs/nvs.h>
+
+#include "../../common/bench_timing.h"
+
+/* This benchmark measures the cost of mounting an NVS file system and of
+ * the first lookups after it, as the partition grows from 64 KiB to the
+ * whole 1 MiB flash simulator.  Each partition is filled to three
+ * quarters with distinct ids, then remounted.  Build it with and without
+ * CONFIG_NVS_SECTOR_SUMMARY to compare them.
+ */
+
+#define FLASH_LABEL DT_CHOSEN_ZEPHYR_FLASH_CONTROLLER_LABEL
+#define SECTOR_SIZE 4096
+#define VALUE_SIZE 240
+#define READ_SAMPLES 64
+
+static const int sizes_kib[] = { 64, 128, 256, 512, 1024 };
+
+static struct nvs_fs fs;
+static uint8_t value[VALUE_SIZE];
+
+static int mount(size_t size)
+{
+	fs.offset = 0;
+	fs.sector_size = SECTOR_SIZE;
+	fs.sector_count = size / SECTOR_SIZE;
+
+	return nvs_init(&fs, FLASH_LABEL);
+}
+
+static int run(int size_kib)
+{
+	size_t size = size_kib * 1024;
+	const struct device *dev = device_get_binding(FLASH_LABEL);
+	int ids = size * 3 / 4 / (VALUE_SIZE + 8);
+	timing_t t0;
+	uint32_t init, read, missing;
+	int rc;
+
+	(void)flash_write_protection_set(dev, false);
+	rc = flash_erase(dev, 0, size);
+	(void)flash_write_protection_set(dev, true);
+	if (rc) {
+		return rc;
+	}
+
+	rc = mount(size);
+	if (rc) {
+		return rc;
+	}
+
+	for (int id = 0; id < ids; id++) {
+		memset(value, id, sizeof(value));
+		rc = nvs_write(&fs, id, value, sizeof(value));
+		if (rc < 0) {
+			return rc;
+		}
+	}
+
+	t0 = bench_stamp();
+	rc = mount(size);
+	init = bench_cycles(t0, bench_stamp());
+	if (rc) {
+		return rc;
+	}
+
+	read = 0U;
+	for (int i = 0; i < READ_SAMPLES; i++) {
+		int id = i * ids / READ_SAMPLES;
+
+		t0 = bench_stamp();
+		rc = nvs_read(&fs, id, value, sizeof(value));
+		read += bench_cycles(t0, bench_stamp());
+
+		if (rc != sizeof(value) || value[0] != (uint8_t)id) {
+			printk("id %d read back %d\n", id, rc);
+		}
+	}
+
+	t0 = bench_stamp();
+	rc = nvs_read(&fs, ids, value, sizeof(value));
+	missing = bench_cycles(t0, bench_stamp());
+	if (rc != -ENOENT) {
+		printk("id %d should not exist (%d)\n", ids, rc);
+	}
+
+	printk("size %4d KiB init %9u read %9u missing %9u\n", size_kib,
+	       init, read / READ_SAMPLES, missing);
+
+	return 0;
+}
+
+void main(void)
+{
+	int rc;
+
+	bench_timing_init();
+
+	for (int i = 0; i < ARRAY_SIZE(sizes_kib); i++) {
+		rc = run(sizes_kib[i]);
+		if (rc) {
+			printk("unable to run with %d KiB (%d)\n",
+			       sizes_kib[i], rc);
+			return;
+		}
+	}
+
+	printk("fin\n");
+}
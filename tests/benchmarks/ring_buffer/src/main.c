@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <sys/ring_buffer.h>
+
+#include "../../common/bench_timing.h"
+
+/* This benchmark moves XFER_BYTES through a byte mode ring buffer in
+ * CHUNK sized writes, each followed by a read, and reports the cycles
+ * spent per kilobyte.  See README.rst for the variants measured.
+ */
+
+#define XFER_BYTES (1024 * 1024)
+#define CHUNK 16
+
+enum mode {
+	LOCKED,
+	SPSC,
+	MPSC,
+};
+
+static const char *const mode_names[] = { "locked", "spsc  ", "mpsc  " };
+static const uint32_t sizes[] = { 256, 255 };
+
+static struct ring_buf rb;
+static uint8_t rb_data[256];
+static uint8_t tx[CHUNK];
+static uint8_t rx[CHUNK];
+
+static uint32_t put(enum mode mode)
+{
+	unsigned int key;
+	uint32_t ret;
+
+	switch (mode) {
+	case LOCKED:
+		key = irq_lock();
+		ret = ring_buf_put(&rb, tx, CHUNK);
+		irq_unlock(key);
+		return ret;
+	case SPSC:
+		return ring_buf_put(&rb, tx, CHUNK);
+	default:
+		return ring_buf_put_mp(&rb, tx, CHUNK);
+	}
+}
+
+static uint32_t get(enum mode mode)
+{
+	unsigned int key;
+	uint32_t ret;
+
+	if (mode == LOCKED) {
+		key = irq_lock();
+		ret = ring_buf_get(&rb, rx, CHUNK);
+		irq_unlock(key);
+		return ret;
+	}
+
+	return ring_buf_get(&rb, rx, CHUNK);
+}
+
+static uint32_t run(uint32_t size, enum mode mode)
+{
+	uint32_t cycles;
+	timing_t t0;
+
+	ring_buf_init(&rb, size, rb_data);
+
+	t0 = bench_stamp();
+
+	for (uint32_t sent = 0; sent < XFER_BYTES; sent += CHUNK) {
+		if (put(mode) != CHUNK || get(mode) != CHUNK) {
+			printk("transfer failed at %u bytes\n", sent);
+			return 0;
+		}
+	}
+
+	cycles = bench_cycles(t0, bench_stamp());
+
+	return cycles / (XFER_BYTES / 1024);
+}
+
+void main(void)
+{
+	bench_timing_init();
+
+	for (int i = 0; i < ARRAY_SIZE(sizes); i++) {
+		for (int mode = LOCKED; mode <= MPSC; mode++) {
+			printk("size %u %s cycles/KB %8u\n", sizes[i],
+			       mode_names[mode], run(sizes[i], mode));
+		}
+	}
+
+	printk("fin\n");
+}
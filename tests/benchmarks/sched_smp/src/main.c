@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+
+/* This is an SMP scheduler throughput benchmark.  It starts
+ * PAIRS_PER_CPU pairs of preemptible threads per CPU, each pair
+ * ping-ponging a token through two semaphores so that every hand-off
+ * readies one thread and pends another.  After RUN_MS milliseconds
+ * the main thread reports the total number of hand-offs per second.
+ * Build it with different CONFIG_MP_NUM_CPUS values, with and without
+ * CONFIG_SCHED_CPU_QUEUES, to see how the scheduler scales.
+ */
+
+#define PAIRS_PER_CPU 2
+#define N_PAIRS (PAIRS_PER_CPU * CONFIG_MP_NUM_CPUS)
+#define N_THREADS (2 * N_PAIRS)
+#define STACK_SIZE (1024 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define WORKER_PRIO 4
+#define RUN_MS 2000
+
+struct pair {
+	struct k_sem ping;
+	struct k_sem pong;
+	uint32_t count;
+};
+
+static struct pair pairs[N_PAIRS];
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, N_THREADS, STACK_SIZE);
+static struct k_thread threads[N_THREADS];
+static volatile bool done;
+
+static void pinger(void *p1, void *p2, void *p3)
+{
+	struct pair *pair = p1;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (!done) {
+		k_sem_give(&pair->ping);
+		k_sem_take(&pair->pong, K_FOREVER);
+		pair->count++;
+	}
+}
+
+static void ponger(void *p1, void *p2, void *p3)
+{
+	struct pair *pair = p1;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		k_sem_take(&pair->ping, K_FOREVER);
+		k_sem_give(&pair->pong);
+	}
+}
+
+void main(void)
+{
+	uint64_t total = 0U;
+
+	for (int i = 0; i < N_PAIRS; i++) {
+		k_sem_init(&pairs[i].ping, 0, 1);
+		k_sem_init(&pairs[i].pong, 0, 1);
+	}
+
+	for (int i = 0; i < N_THREADS; i++) {
+		k_thread_create(&threads[i], stacks[i], STACK_SIZE,
+				(i & 1) ? ponger : pinger,
+				&pairs[i / 2], NULL, NULL,
+				WORKER_PRIO, 0, K_NO_WAIT);
+	}
+
+	k_sleep(K_MSEC(RUN_MS));
+	done = true;
+
+	for (int i = 0; i < N_PAIRS; i++) {
+		total += pairs[i].count;
+	}
+
+	/* Each counted round trip is two hand-offs */
+	printk("cpus %d threads %d switches/s %u\n", CONFIG_MP_NUM_CPUS,
+	       N_THREADS, (uint32_t)(2 * total * MSEC_PER_SEC / RUN_MS));
+
+	for (int i = 0; i < N_THREADS; i++) {
+		k_thread_abort(&threads[i]);
+	}
+
+	printk("fin\n");
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <sys/util.h>
+#include <storage/flash_map.h>
+#include <settings/settings.h>
+
+#include "../../common/bench_timing.h"
+
+/* This benchmark measures the boot time cost of dispatching settings to
+ * their handlers.  It defines HANDLERS static handlers and saves KEYS
+ * settings spread over them into the storage partition of the flash
+ * simulator, then reports the cycles needed to load them and the
+ * average cycles of settings_parse_and_lookup() for one of their names.
+ * Build it with and without CONFIG_SETTINGS_HANDLER_INDEX to compare
+ * them.
+ */
+
+#define HANDLERS 50
+#define KEYS 500
+#define LOOKUP_ROUNDS 20
+
+static int loaded;
+
+static int bench_set(const char *name, size_t len, settings_read_cb read_cb,
+		     void *cb_arg)
+{
+	uint32_t val;
+
+	if (read_cb(cb_arg, &val, sizeof(val)) == sizeof(val)) {
+		loaded++;
+	}
+
+	return 0;
+}
+
+#define BENCH_HANDLER(i, _)						 \
+	SETTINGS_STATIC_HANDLER_DEFINE(bench_##i, "mod" STRINGIFY(i), NULL, \
+				       bench_set, NULL, NULL);
+
+UTIL_LISTIFY(HANDLERS, BENCH_HANDLER, _)
+
+static int erase_storage(void)
+{
+	const struct flash_area *fa;
+	int err;
+
+	err = flash_area_open(FLASH_AREA_ID(storage), &fa);
+	if (err) {
+		return err;
+	}
+
+	err = flash_area_erase(fa, 0, fa->fa_size);
+	flash_area_close(fa);
+
+	return err;
+}
+
+static void key_name(int key, char *name, size_t size)
+{
+	snprintk(name, size, "mod%d/key%03d", key % HANDLERS, key);
+}
+
+void main(void)
+{
+	char name[SETTINGS_MAX_NAME_LEN + 1];
+	timing_t t0, t1;
+	uint32_t load, lookup;
+	uint32_t val;
+
+	bench_timing_init();
+
+	if (erase_storage() || settings_subsys_init()) {
+		printk("unable to set up settings\n");
+		return;
+	}
+
+	for (int key = 0; key < KEYS; key++) {
+		key_name(key, name, sizeof(name));
+		val = key;
+
+		if (settings_save_one(name, &val, sizeof(val))) {
+			printk("unable to save key %d\n", key);
+			return;
+		}
+	}
+
+	loaded = 0;
+	t0 = bench_stamp();
+	(void)settings_load();
+	t1 = bench_stamp();
+	load = bench_cycles(t0, t1);
+
+	if (loaded != KEYS) {
+		printk("loaded %d of %d keys\n", loaded, KEYS);
+	}
+
+	lookup = 0U;
+	for (int round = 0; round < LOOKUP_ROUNDS; round++) {
+		for (int key = 0; key < KEYS; key++) {
+			const char *next;
+
+			key_name(key, name, sizeof(name));
+
+			t0 = bench_stamp();
+			(void)settings_parse_and_lookup(name, &next);
+			t1 = bench_stamp();
+			lookup += bench_cycles(t0, t1);
+		}
+	}
+
+	printk("handlers %3d keys %4d load %9u lookup %6u\n", HANDLERS, KEYS,
+	       load, lookup / (KEYS * LOOKUP_ROUNDS));
+	printk("fin\n");
+}
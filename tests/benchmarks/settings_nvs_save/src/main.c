@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <storage/flash_map.h>
+#include <settings/settings.h>
+
+#include "../../common/bench_timing.h"
+
+/* This benchmark measures the settings_save_one() cost of the NVS
+ * backend as the number of settings grows.  It saves MAX_KEYS settings
+ * in steps of KEY_STEP into the storage partition of the flash
+ * simulator and after every step reports the cycles needed to load
+ * them and the average cycles of saving a new value for each of them.
+ * Build it with and without CONFIG_SETTINGS_NVS_NAME_CACHE to compare
+ * them.
+ */
+
+#define MAX_KEYS 400
+#define KEY_STEP 50
+
+static int loaded;
+
+static int bench_set(const char *name, size_t len, settings_read_cb read_cb,
+		     void *cb_arg)
+{
+	uint32_t val;
+
+	if (read_cb(cb_arg, &val, sizeof(val)) == sizeof(val)) {
+		loaded++;
+	}
+
+	return 0;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(bench, "bench", NULL, bench_set, NULL,
+			       NULL);
+
+static int erase_storage(void)
+{
+	const struct flash_area *fa;
+	int err;
+
+	err = flash_area_open(FLASH_AREA_ID(storage), &fa);
+	if (err) {
+		return err;
+	}
+
+	err = flash_area_erase(fa, 0, fa->fa_size);
+	flash_area_close(fa);
+
+	return err;
+}
+
+static int save(int key, uint32_t val)
+{
+	char name[SETTINGS_MAX_NAME_LEN + 1];
+
+	snprintk(name, sizeof(name), "bench/key%03d", key);
+
+	return settings_save_one(name, &val, sizeof(val));
+}
+
+void main(void)
+{
+	timing_t t0, t1;
+	uint32_t load, total;
+	int keys = 0;
+	int round = 0;
+
+	bench_timing_init();
+
+	if (erase_storage() || settings_subsys_init()) {
+		printk("unable to set up settings\n");
+		return;
+	}
+
+	while (keys < MAX_KEYS) {
+		for (int i = 0; i < KEY_STEP; i++, keys++) {
+			if (save(keys, 0)) {
+				printk("unable to save key %d\n", keys);
+				return;
+			}
+		}
+
+		loaded = 0;
+		t0 = bench_stamp();
+		(void)settings_load();
+		t1 = bench_stamp();
+		load = bench_cycles(t0, t1);
+
+		if (loaded != keys) {
+			printk("loaded %d of %d keys\n", loaded, keys);
+		}
+
+		/* Store a new value, so that every save writes to flash */
+		round++;
+		total = 0U;
+		for (int key = 0; key < keys; key++) {
+			t0 = bench_stamp();
+			(void)save(key, round);
+			t1 = bench_stamp();
+			total += bench_cycles(t0, t1);
+		}
+
+		printk("keys %4d load %9u save %7u\n", keys, load,
+		       total / keys);
+	}
+
+	printk("fin\n");
+}
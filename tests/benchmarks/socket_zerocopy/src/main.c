@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <net/socket.h>
+#include <net/buf.h>
+
+#include "../../common/bench_timing.h"
+
+/* This benchmark compares copying and zero-copy socket I/O over the
+ * loopback interface.  For a connected UDP socket pair and then a TCP
+ * connection it pushes XFER_BYTES in CHUNK sized writes, receiving
+ * everything sent before the next write, and reports the cycles spent
+ * per kilobyte.  Zero-copy sends rotate through N_TX_BUFS buffers, and
+ * a send waits for a free one when all of them are still in flight.
+ */
+
+#define PORT 4242
+#define XFER_BYTES (256 * 1024)
+#define CHUNK 512
+#define N_TX_BUFS 8
+
+static char tx_bufs[N_TX_BUFS][CHUNK];
+static char rx_buf[CHUNK];
+static K_SEM_DEFINE(tx_free, N_TX_BUFS, N_TX_BUFS);
+
+static void tx_done(void *user_data)
+{
+	ARG_UNUSED(user_data);
+
+	k_sem_give(&tx_free);
+}
+
+static ssize_t send_chunk(int sock, bool zc, int n)
+{
+	struct iovec iov = {
+		.iov_base = tx_bufs[n % N_TX_BUFS],
+		.iov_len = CHUNK,
+	};
+	struct msghdr msg = {
+		.msg_iov = &iov,
+		.msg_iovlen = 1,
+	};
+	ssize_t ret;
+
+	if (!zc) {
+		return send(sock, iov.iov_base, CHUNK, 0);
+	}
+
+	k_sem_take(&tx_free, K_FOREVER);
+
+	ret = zsock_sendmsg_zc(sock, &msg, 0, tx_done, NULL);
+	if (ret < 0) {
+		k_sem_give(&tx_free);
+	}
+
+	return ret;
+}
+
+static ssize_t recv_data(int sock, bool zc, size_t max)
+{
+	struct net_buf *frags;
+	ssize_t ret;
+
+	if (!zc) {
+		return recv(sock, rx_buf, MIN(max, sizeof(rx_buf)), 0);
+	}
+
+	ret = zsock_recvfrom_zc(sock, &frags, 0, NULL, NULL);
+	if (frags) {
+		net_buf_unref(frags);
+	}
+
+	return ret;
+}
+
+static uint32_t run(int client, int server, bool zc_tx, bool zc_rx)
+{
+	size_t sent = 0, received = 0;
+	uint32_t cycles;
+	timing_t t0;
+
+	t0 = bench_stamp();
+
+	for (int n = 0; sent < XFER_BYTES; n++) {
+		if (send_chunk(client, zc_tx, n) != CHUNK) {
+			printk("send failed: %d\n", errno);
+			return 0;
+		}
+		sent += CHUNK;
+
+		while (received < sent) {
+			ssize_t ret = recv_data(server, zc_rx,
+						sent - received);
+
+			if (ret <= 0) {
+				printk("recv failed: %d\n", errno);
+				return 0;
+			}
+			received += ret;
+		}
+	}
+
+	cycles = bench_cycles(t0, bench_stamp());
+
+	/* Wait for the last zero-copy sends to complete */
+	for (int i = 0; i < N_TX_BUFS; i++) {
+		if (k_sem_take(&tx_free, K_SECONDS(5)) < 0) {
+			printk("zero-copy send did not complete\n");
+		}
+	}
+	for (int i = 0; i < N_TX_BUFS; i++) {
+		k_sem_give(&tx_free);
+	}
+
+	return cycles / (XFER_BYTES / 1024);
+}
+
+void main(void)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(PORT),
+	};
+	int client, server, listener;
+
+	bench_timing_init();
+	inet_pton(AF_INET, CONFIG_NET_CONFIG_MY_IPV4_ADDR, &addr.sin_addr);
+
+	server = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	client = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	if (server < 0 || client < 0 ||
+	    bind(server, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+	    connect(client, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+		printk("unable to set up UDP sockets: %d\n", errno);
+		return;
+	}
+
+	printk("udp copy cycles/KB %8u\n",
+	       run(client, server, false, false));
+	printk("udp zc   cycles/KB %8u\n", run(client, server, true, true));
+
+	close(client);
+	close(server);
+
+	addr.sin_port = htons(PORT + 1);
+
+	listener = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	client = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (listener < 0 || client < 0 ||
+	    bind(listener, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+	    listen(listener, 1) < 0 ||
+	    connect(client, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+		printk("unable to set up TCP sockets: %d\n", errno);
+		return;
+	}
+
+	server = accept(listener, NULL, NULL);
+	if (server < 0) {
+		printk("unable to accept TCP connection: %d\n", errno);
+		return;
+	}
+
+	printk("tcp copy cycles/KB %8u\n",
+	       run(client, server, false, false));
+	printk("tcp zc   cycles/KB %8u\n", run(client, server, true, true));
+
+	close(client);
+	close(server);
+	close(listener);
+
+	printk("fin\n");
+}
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <net/socket.h>
+
+#include "../../common/bench_timing.h"
+
+/* This benchmark measures TCP receive cost over the loopback interface
+ * as the number of open connections grows.  After opening every batch
+ * of IDLE_STEP idle connection pairs, it opens one more pair, pushes
+ * XFER_BYTES through it in CHUNK sized writes and reports the cycles
+ * spent per kilobyte sent and received.  The measured connection is
+ * always the most recently created one, the worst case for a linear
+ * connection lookup.  Build it with CONFIG_NET_TCP_CONN_HASH_SIZE=1 to compare
+ * with a single hash bucket.
+ */
+
+#define PORT 4242
+#define MAX_IDLE 64
+#define IDLE_STEP 16
+#define XFER_BYTES (64 * 1024)
+#define CHUNK 512
+
+static int idle[2 * MAX_IDLE];
+static char buf[CHUNK];
+
+static int open_pair(int listener, int *client, int *server)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(PORT),
+	};
+
+	inet_pton(AF_INET, CONFIG_NET_CONFIG_MY_IPV4_ADDR, &addr.sin_addr);
+
+	*client = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (*client < 0) {
+		return -errno;
+	}
+
+	if (connect(*client, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+		close(*client);
+		return -errno;
+	}
+
+	*server = accept(listener, NULL, NULL);
+	if (*server < 0) {
+		close(*client);
+		return -errno;
+	}
+
+	return 0;
+}
+
+static uint32_t measure(int listener)
+{
+	int client, server;
+	uint32_t cycles = 0U;
+
+	if (open_pair(listener, &client, &server) < 0) {
+		printk("unable to open measured connection\n");
+		return 0;
+	}
+
+	for (int sent = 0; sent < XFER_BYTES; sent += CHUNK) {
+		timing_t t0 = bench_stamp();
+		ssize_t got = 0;
+
+		if (send(client, buf, CHUNK, 0) != CHUNK) {
+			printk("send failed: %d\n", errno);
+			break;
+		}
+
+		while (got < CHUNK) {
+			ssize_t ret = recv(server, buf, CHUNK - got, 0);
+
+			if (ret <= 0) {
+				printk("recv failed: %d\n", errno);
+				goto out;
+			}
+			got += ret;
+		}
+		cycles += bench_cycles(t0, bench_stamp());
+	}
+
+out:
+	close(client);
+	close(server);
+
+	return cycles / (XFER_BYTES / 1024);
+}
+
+void main(void)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(PORT),
+	};
+	int listener, n_idle = 0;
+
+	bench_timing_init();
+
+	listener = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (listener < 0 ||
+	    bind(listener, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+	    listen(listener, 2) < 0) {
+		printk("unable to set up listener: %d\n", errno);
+		return;
+	}
+
+	while (true) {
+		printk("conns %3d cycles/KB %8u\n", 2 * n_idle + 2,
+		       measure(listener));
+
+		if (n_idle == MAX_IDLE) {
+			break;
+		}
+
+		for (int i = 0; i < IDLE_STEP; i++, n_idle++) {
+			if (open_pair(listener, &idle[2 * n_idle],
+				      &idle[2 * n_idle + 1]) < 0) {
+				printk("unable to open idle connection\n");
+				return;
+			}
+		}
+	}
+
+	for (int i = 0; i < 2 * n_idle; i++) {
+		close(idle[i]);
+	}
+
+	printk("fin\n");
+}
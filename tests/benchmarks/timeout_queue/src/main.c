@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <random/rand32.h>
+#include <timeout_q.h>
+
+#include "../../common/bench_timing.h"
+
+/* This is a timeout queue microbenchmark, measuring the cost of the
+ * low level z_add_timeout() and z_abort_timeout() primitives as the
+ * number of pending timeouts grows.  It arms N_TIMEOUTS timeouts with
+ * random expiries in batches of N_BATCH, and after each batch times
+ * N_PROBES add/abort cycles of one extra timeout.  Build it once with
+ * each CONFIG_TIMEOUT_QUEUE_* backend to compare them.
+ *
+ * All expiries are far enough in the future that nothing fires while
+ * the benchmark runs, even on slow targets with the linear backend.
+ */
+
+#define N_TIMEOUTS 10000
+#define N_BATCH 1000
+#define N_PROBES 100
+
+#define BASE_MS (10 * 60 * MSEC_PER_SEC)
+#define SPREAD_MS (60 * MSEC_PER_SEC)
+
+static struct _timeout timeouts[N_TIMEOUTS];
+static struct _timeout probe;
+
+static void expired(struct _timeout *t)
+{
+	printk("timeout %p fired during the benchmark\n", t);
+}
+
+static k_timeout_t random_timeout(void)
+{
+	uint32_t ms = BASE_MS + sys_rand32_get() % SPREAD_MS;
+
+	return K_TICKS(k_ms_to_ticks_ceil32(ms));
+}
+
+void main(void)
+{
+	int pending = 0;
+
+	bench_timing_init();
+
+	for (int i = 0; i < N_TIMEOUTS; i++) {
+		z_init_timeout(&timeouts[i]);
+	}
+	z_init_timeout(&probe);
+
+	while (pending < N_TIMEOUTS) {
+		uint32_t add = 0U, abort = 0U;
+
+		for (int i = 0; i < N_BATCH; i++, pending++) {
+			z_add_timeout(&timeouts[pending], expired,
+				      random_timeout());
+		}
+
+		for (int i = 0; i < N_PROBES; i++) {
+			k_timeout_t timeout = random_timeout();
+			timing_t t0, t1, t2;
+
+			t0 = bench_stamp();
+			z_add_timeout(&probe, expired, timeout);
+			t1 = bench_stamp();
+			z_abort_timeout(&probe);
+			t2 = bench_stamp();
+
+			add += bench_cycles(t0, t1);
+			abort += bench_cycles(t1, t2);
+		}
+
+		printk("pending %5d add %6u abort %6u\n", pending,
+		       add / N_PROBES, abort / N_PROBES);
+	}
+
+	for (int i = 0; i < N_TIMEOUTS; i++) {
+		z_abort_timeout(&timeouts[i]);
+	}
+
+	printk("fin\n");
+}
@@ -0,0 +1,377 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <ztest.h>
+#include <bluetooth/bluetooth.h>
+#include <bluetooth/mesh.h>
+
+#include "net.h"
+#include "rpl.h"
+
+/* The network message cache, the duplicate cache and the replay
+ * protection list are checked against models of their behavior, with
+ * random sequences of messages.  Their sizes are small, so that entries
+ * are evicted, removed from the hash tables and looked up again many
+ * times.
+ */
+
+#define CACHE_SIZE CONFIG_BT_MESH_MSG_CACHE_SIZE
+#define RPL_SIZE CONFIG_BT_MESH_CRPL
+
+#define PDUS (3 * CACHE_SIZE)
+#define PDU_MAX 29
+#define ROUNDS 2000
+
+#define NET_IDX 0x000
+#define LOCAL_ADDR 0x0001
+#define GROUP_ADDR 0xc001
+#define FIRST_SRC 0x0100
+#define SOURCES 5
+#define TTL 5
+
+static const uint8_t net_key[16] = {
+	0x7d, 0xd7, 0x36, 0x4c, 0xd8, 0x42, 0xad, 0x18,
+	0xc1, 0x7c, 0x2b, 0x82, 0x0c, 0x84, 0xc3, 0xd6,
+};
+static const uint8_t dev_key[16] = {
+	0x9d, 0x6d, 0xd0, 0xe9, 0x6e, 0xb2, 0x5d, 0xc1,
+	0x9a, 0x40, 0xed, 0x99, 0x14, 0xf8, 0xf0, 0x3f,
+};
+
+static struct bt_mesh_cfg_srv cfg_srv = {
+	.relay = BT_MESH_RELAY_DISABLED,
+	.beacon = BT_MESH_BEACON_DISABLED,
+	.frnd = BT_MESH_FRIEND_NOT_SUPPORTED,
+	.gatt_proxy = BT_MESH_GATT_PROXY_NOT_SUPPORTED,
+	.default_ttl = 7,
+	.net_transmit = BT_MESH_TRANSMIT(2, 20),
+	.relay_retransmit = BT_MESH_TRANSMIT(2, 20),
+};
+
+static struct bt_mesh_model root_models[] = {
+	BT_MESH_MODEL_CFG_SRV(&cfg_srv),
+};
+
+static struct bt_mesh_elem elements[] = {
+	BT_MESH_ELEM(0, root_models, BT_MESH_MODEL_NONE),
+};
+
+static const struct bt_mesh_comp comp = {
+	.cid = BT_COMP_ID_LF,
+	.elem = elements,
+	.elem_count = ARRAY_SIZE(elements),
+};
+
+/* A PDU and its copy relayed by a neighbor, with another TTL and MIC */
+struct pdu {
+	uint8_t data[2][PDU_MAX];
+	uint8_t len[2];
+	uint16_t src;
+	uint32_t seq;
+};
+
+static struct pdu pdus[PDUS];
+
+static uint32_t rand_state = 1U;
+
+static uint32_t rand_next(uint32_t range)
+{
+	rand_state = rand_state * 1103515245U + 12345U;
+
+	return (rand_state >> 16) % range;
+}
+
+static void pdu_encode(uint16_t src, uint8_t ttl, uint8_t *data,
+		       uint8_t *len)
+{
+	NET_BUF_SIMPLE_DEFINE(buf, PDU_MAX);
+	struct bt_mesh_msg_ctx ctx = {
+		.net_idx = NET_IDX,
+		.app_idx = BT_MESH_KEY_UNUSED,
+		.addr = GROUP_ADDR,
+		.send_ttl = ttl,
+	};
+	struct bt_mesh_net_tx tx = {
+		.sub = bt_mesh_subnet_get(NET_IDX),
+		.ctx = &ctx,
+		.src = src,
+	};
+	int err;
+
+	net_buf_simple_reserve(&buf, BT_MESH_NET_HDR_LEN);
+	net_buf_simple_add_u8(&buf, 0x3f);
+	net_buf_simple_add_be24(&buf, src);
+
+	err = bt_mesh_net_encode(&tx, &buf, false);
+	zassert_equal(err, 0, "can't encode a PDU: %d", err);
+
+	memcpy(data, buf.data, buf.len);
+	*len = buf.len;
+}
+
+static void setup_node(void)
+{
+	static bool done;
+	int i, err;
+
+	if (done) {
+		return;
+	}
+
+	err = bt_mesh_init(NULL, &comp);
+	zassert_equal(err, 0, "can't initialize mesh: %d", err);
+	err = bt_mesh_provision(net_key, NET_IDX, 0, 0, LOCAL_ADDR, dev_key);
+	zassert_equal(err, 0, "can't provision: %d", err);
+
+	/* PDUs encrypted with the sequence numbers of the local node, which
+	 * are as good as those of any other source.
+	 */
+	for (i = 0; i < PDUS; i++) {
+		pdus[i].src = FIRST_SRC + i % SOURCES;
+		pdus[i].seq = bt_mesh.seq;
+		pdu_encode(pdus[i].src, TTL, pdus[i].data[0], &pdus[i].len[0]);
+		bt_mesh.seq = pdus[i].seq;
+		pdu_encode(pdus[i].src, TTL - 1, pdus[i].data[1],
+			   &pdus[i].len[1]);
+	}
+
+	done = true;
+}
+
+/* Model of the duplicate cache and of the network message cache */
+static uint32_t dup_model[CACHE_SIZE];
+static int dup_model_next;
+static struct {
+	uint16_t src;
+	uint32_t seq;
+} msg_model[CACHE_SIZE];
+static int msg_model_next;
+
+static int decode_model(const struct pdu *pdu, int copy)
+{
+	const uint8_t *tail = pdu->data[copy] + pdu->len[copy];
+	uint32_t mic = sys_get_be32(tail - 4) ^ sys_get_be32(tail - 8);
+	int i;
+
+	for (i = 0; i < CACHE_SIZE; i++) {
+		if (dup_model[i] == mic) {
+			return -EINVAL;
+		}
+	}
+
+	dup_model[dup_model_next] = mic;
+	dup_model_next = (dup_model_next + 1) % CACHE_SIZE;
+
+	for (i = 0; i < CACHE_SIZE; i++) {
+		if (msg_model[i].src == pdu->src &&
+		    msg_model[i].seq == pdu->seq) {
+			return -ENOENT;
+		}
+	}
+
+	msg_model[msg_model_next].src = pdu->src;
+	msg_model[msg_model_next].seq = pdu->seq;
+	msg_model_next = (msg_model_next + 1) % CACHE_SIZE;
+
+	return 0;
+}
+
+static int decode(const struct pdu *pdu, int copy)
+{
+	NET_BUF_SIMPLE_DEFINE(buf, PDU_MAX);
+	struct net_buf_simple data;
+	struct bt_mesh_net_rx rx = { 0 };
+	uint8_t pdu_data[PDU_MAX];
+
+	memcpy(pdu_data, pdu->data[copy], pdu->len[copy]);
+	net_buf_simple_init_with_data(&data, pdu_data, pdu->len[copy]);
+
+	return bt_mesh_net_decode(&data, BT_MESH_NET_IF_ADV, &rx, &buf);
+}
+
+/*
+ * A PDU is dropped while it is in the duplicate cache, then while its
+ * source and sequence number are in the network message cache.
+ */
+static void test_msg_cache(void)
+{
+	const struct pdu *pdu;
+	int i, copy, ret, expected;
+
+	setup_node();
+
+	/* one pass in order, which fills and wraps both caches */
+	for (i = 0; i < PDUS; i++) {
+		ret = decode(&pdus[i], 0);
+		zassert_equal(ret, 0, "fresh PDU %d dropped: %d", i, ret);
+		zassert_equal(decode_model(&pdus[i], 0), 0, NULL);
+
+		ret = decode(&pdus[i], 0);
+		zassert_equal(ret, -EINVAL, "duplicate %d accepted: %d", i,
+			      ret);
+		ret = decode(&pdus[i], 1);
+		zassert_equal(ret, -ENOENT, "relayed %d accepted: %d", i, ret);
+		zassert_equal(decode_model(&pdus[i], 1), -ENOENT, NULL);
+	}
+
+	/* then random PDUs, some evicted and some still cached */
+	for (i = 0; i < ROUNDS; i++) {
+		pdu = &pdus[rand_next(PDUS)];
+		copy = rand_next(2);
+
+		expected = decode_model(pdu, copy);
+		ret = decode(pdu, copy);
+		zassert_equal(ret, expected, "round %d, PDU %d copy %d: %d",
+			      i, (int)(pdu - pdus), copy, ret);
+	}
+}
+
+/* Model of the replay protection list */
+static struct {
+	uint16_t src;
+	bool old_iv;
+	uint32_t seq;
+} rpl_model[RPL_SIZE];
+
+static bool rpl_check_model(uint16_t src, uint32_t seq, bool old_iv)
+{
+	int i, found = -1;
+
+	for (i = 0; i < RPL_SIZE && found < 0; i++) {
+		/* with the hash table, the entry of the source is found
+		 * even behind an empty slot
+		 */
+		if (rpl_model[i].src == src ||
+		    (!IS_ENABLED(CONFIG_BT_MESH_RPL_HASH) &&
+		     !rpl_model[i].src)) {
+			found = i;
+		}
+	}
+
+	for (i = 0; i < RPL_SIZE && found < 0; i++) {
+		if (!rpl_model[i].src) {
+			found = i;
+		}
+	}
+
+	if (found < 0) {
+		return true;
+	}
+
+	if (rpl_model[found].src) {
+		if (old_iv && !rpl_model[found].old_iv) {
+			return true;
+		}
+
+		if (!(!old_iv && rpl_model[found].old_iv) &&
+		    rpl_model[found].seq >= seq) {
+			return true;
+		}
+	}
+
+	rpl_model[found].src = src;
+	rpl_model[found].seq = seq;
+	rpl_model[found].old_iv = old_iv;
+
+	return false;
+}
+
+static void rpl_reset_model(void)
+{
+	int i;
+
+	for (i = 0; i < RPL_SIZE; i++) {
+		if (!rpl_model[i].src) {
+			continue;
+		}
+
+		if (rpl_model[i].old_iv) {
+			(void)memset(&rpl_model[i], 0, sizeof(rpl_model[i]));
+		} else {
+			rpl_model[i].old_iv = true;
+		}
+	}
+}
+
+static bool rpl_check(uint16_t src, uint32_t seq, bool old_iv)
+{
+	struct bt_mesh_net_rx rx = {
+		.ctx.addr = src,
+		.seq = seq,
+		.old_iv = old_iv,
+		.net_if = BT_MESH_NET_IF_ADV,
+		.local_match = 1,
+	};
+
+	return bt_mesh_rpl_check(&rx, NULL);
+}
+
+/*
+ * Messages are accepted when their sequence number is higher than the
+ * last one of their source, or when they use the new IV index, as long
+ * as the list has room for their source.  IV index updates drop the
+ * entries of the old old IV index, which leaves holes in the list.
+ */
+static void test_rpl(void)
+{
+	uint32_t seqs[2 * RPL_SIZE] = { 0 };
+	uint16_t src;
+	uint32_t seq;
+	bool old_iv, expected, ret;
+	int i;
+
+	setup_node();
+
+	bt_mesh_rpl_clear();
+	(void)memset(rpl_model, 0, sizeof(rpl_model));
+
+	/* fill the list, then a new source doesn't fit */
+	for (i = 0; i < RPL_SIZE; i++) {
+		zassert_false(rpl_check(FIRST_SRC + i, 10, false),
+			      "source %d rejected", i);
+		zassert_false(rpl_check_model(FIRST_SRC + i, 10, false), NULL);
+		zassert_true(rpl_check(FIRST_SRC + i, 10, false),
+			     "replay of source %d accepted", i);
+		zassert_false(rpl_check(FIRST_SRC + i, 11, false),
+			      "source %d rejected", i);
+		zassert_false(rpl_check_model(FIRST_SRC + i, 11, false), NULL);
+		seqs[i] = 11;
+	}
+
+	zassert_true(rpl_check(FIRST_SRC + RPL_SIZE, 1, false),
+		     "source accepted in a full list");
+
+	/* random messages and IV index updates */
+	for (i = 0; i < ROUNDS; i++) {
+		if (rand_next(50) == 0) {
+			bt_mesh_rpl_reset();
+			rpl_reset_model();
+			continue;
+		}
+
+		src = rand_next(ARRAY_SIZE(seqs));
+		seq = seqs[src] + rand_next(5);
+		seq = seq > 2 ? seq - 2 : 0;
+		old_iv = rand_next(10) == 0;
+		seqs[src] = MAX(seqs[src], seq);
+
+		expected = rpl_check_model(FIRST_SRC + src, seq, old_iv);
+		ret = rpl_check(FIRST_SRC + src, seq, old_iv);
+		zassert_equal(ret, expected,
+			      "round %d, source %d seq %u old IV %d: %d",
+			      i, src, seq, old_iv, ret);
+	}
+}
+
+void test_main(void)
+{
+	ztest_test_suite(mesh_cache,
+			 ztest_unit_test(test_msg_cache),
+			 ztest_unit_test(test_rpl));
+
+	ztest_run_test_suite(mesh_cache);
+}
@@ -11,6 +11,7 @@ extern void test_mheap_min_block_size(void);
 extern void test_mheap_block_desc(void);
 extern void test_mheap_calloc(void);
 extern void test_mheap_block_release(void);
+extern void test_mheap_tcache(void);
 
 /**
  * @brief Heap tests
@@ -30,6 +31,7 @@ void test_main(void)
 			 ztest_unit_test(test_mheap_malloc_align4),
 			 ztest_unit_test(test_mheap_min_block_size),
 			 ztest_unit_test(test_mheap_block_desc),
-			 ztest_unit_test(test_mheap_block_release));
+			 ztest_unit_test(test_mheap_block_release),
+			 ztest_unit_test(test_mheap_tcache));
 	ztest_run_test_suite(mheap_api);
 }
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <sys/sys_heap.h>
+#include "test_mheap.h"
+
+#define TCACHE_HEAP_SIZE 2048
+#define TCACHE_BLK_SIZE 32
+#define TCACHE_ROUNDS 16
+
+K_HEAP_DEFINE(tcache_heap, TCACHE_HEAP_SIZE);
+
+/**
+ * @brief Test the per-CPU k_heap allocation caches
+ *
+ * @ingroup kernel_heap_tests
+ *
+ * @details Repeatedly allocates and frees small blocks and checks that
+ * they are served from the cache and show up as stranded bytes while
+ * cached.  Then verifies that k_heap_tcache_flush() returns them all
+ * to a valid heap, and that an allocation too large for the remaining
+ * free memory reclaims cached blocks instead of failing.
+ *
+ * @see k_heap_tcache_stats_get(), k_heap_tcache_flush()
+ */
+void test_mheap_tcache(void)
+{
+#ifdef CONFIG_HEAP_TCACHE
+	struct k_heap_tcache_stats stats;
+	void *block[TCACHE_ROUNDS], *big;
+	size_t big_size;
+
+	for (int i = 0; i < TCACHE_ROUNDS; i++) {
+		block[i] = k_heap_alloc(&tcache_heap, TCACHE_BLK_SIZE,
+					K_NO_WAIT);
+		zassert_not_null(block[i], NULL);
+		k_heap_free(&tcache_heap, block[i]);
+	}
+
+	k_heap_tcache_stats_get(&tcache_heap, &stats);
+	/** TESTPOINT: only the first allocation misses the cache */
+	zassert_true(stats.hits >= TCACHE_ROUNDS - 1, NULL);
+	zassert_true(stats.stranded_bytes >= TCACHE_BLK_SIZE, NULL);
+
+	/** TESTPOINT: a flush empties the caches into a valid heap */
+	k_heap_tcache_flush(&tcache_heap);
+	k_heap_tcache_stats_get(&tcache_heap, &stats);
+	zassert_equal(stats.stranded_bytes, 0, NULL);
+	zassert_true(sys_heap_validate(&tcache_heap.heap), NULL);
+
+	/* Find the largest block the empty heap can serve */
+	for (big_size = TCACHE_HEAP_SIZE; big_size > 0; big_size -= 8) {
+		big = k_heap_alloc(&tcache_heap, big_size, K_NO_WAIT);
+		if (big != NULL) {
+			k_heap_free(&tcache_heap, big);
+			break;
+		}
+	}
+	zassert_true(big_size > 0, NULL);
+
+	/** TESTPOINT: cached blocks are reclaimed rather than failing */
+	block[0] = k_heap_alloc(&tcache_heap, TCACHE_BLK_SIZE, K_NO_WAIT);
+	zassert_not_null(block[0], NULL);
+	k_heap_free(&tcache_heap, block[0]);
+	k_heap_tcache_stats_get(&tcache_heap, &stats);
+	zassert_true(stats.stranded_bytes != 0, NULL);
+
+	big = k_heap_alloc(&tcache_heap, big_size, K_NO_WAIT);
+	zassert_not_null(big, NULL);
+	k_heap_tcache_stats_get(&tcache_heap, &stats);
+	zassert_equal(stats.stranded_bytes, 0, NULL);
+	k_heap_free(&tcache_heap, big);
+	zassert_true(sys_heap_validate(&tcache_heap.heap), NULL);
+#else
+	ztest_test_skip();
+#endif
+}
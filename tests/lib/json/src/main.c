@@ -95,6 +95,20 @@ static const struct json_obj_descr array_array_descr[] = {
 				   ARRAY_SIZE(array_descr)),
 };
 
+#define MANY_FIELDS 40
+
+#define MANY_FIELD(i, _) int f##i;
+#define MANY_FIELD_DESCR(i, _) \
+	JSON_OBJ_DESCR_PRIM(struct many_fields, f##i, JSON_TOK_NUMBER),
+
+struct many_fields {
+	UTIL_LISTIFY(MANY_FIELDS, MANY_FIELD, _)
+};
+
+static const struct json_obj_descr many_fields_descr[] = {
+	UTIL_LISTIFY(MANY_FIELDS, MANY_FIELD_DESCR, _)
+};
+
 static void test_json_encoding(void)
 {
 	struct test_struct ts = {
@@ -216,6 +230,154 @@ static void test_json_decoding(void)
 		     "Named nested string decoded correctly");
 }
 
+static void test_json_decoding_many_fields(void)
+{
+	struct many_fields mf;
+	const int *fields = (const int *)&mf;
+	char encoded[MANY_FIELDS * 12 + 2];
+	size_t len = 0;
+	int64_t ret;
+	int i;
+
+	/* Keys in reverse order, the worst case for the key lookup */
+	encoded[len++] = '{';
+	for (i = MANY_FIELDS - 1; i >= 0; i--) {
+		len += snprintk(&encoded[len], sizeof(encoded) - len,
+				"\"f%d\":%d%c", i, i * 3,
+				i > 0 ? ',' : '}');
+	}
+
+	memset(&mf, 0, sizeof(mf));
+	ret = json_obj_parse64(encoded, len, many_fields_descr,
+			       ARRAY_SIZE(many_fields_descr), &mf);
+
+	zassert_equal(ret, ((int64_t)1 << MANY_FIELDS) - 1,
+		      "All fields decoded");
+
+	for (i = 0; i < MANY_FIELDS; i++) {
+		zassert_equal(fields[i], i * 3, "Field %d decoded", i);
+	}
+}
+
+static void test_json_decoding_indexed(void)
+{
+	static const struct json_obj_descr same_names_descr[] = {
+		JSON_OBJ_DESCR_PRIM_NAMED(struct many_fields, "f", f0,
+					  JSON_TOK_NUMBER),
+		JSON_OBJ_DESCR_PRIM_NAMED(struct many_fields, "f", f1,
+					  JSON_TOK_NUMBER),
+	};
+	uint8_t index[MANY_FIELDS];
+	struct many_fields mf;
+	const int *fields = (const int *)&mf;
+	char encoded[MANY_FIELDS * 12 + 32];
+	size_t len = 0;
+	int64_t ret;
+	int i, f;
+
+	zassert_equal(json_obj_descr_index(same_names_descr,
+					   ARRAY_SIZE(same_names_descr),
+					   index), -EINVAL,
+		      "Fields with the same name not indexed");
+	zassert_equal(json_obj_descr_index(many_fields_descr,
+					   ARRAY_SIZE(many_fields_descr),
+					   index), 0, "Index built");
+
+	/* Shuffled keys, with an unknown one and one given twice */
+	len += snprintk(&encoded[len], sizeof(encoded) - len,
+			"{\"f7\":-1,\"f40\":1,");
+	for (i = 0; i < MANY_FIELDS; i++) {
+		f = (i * 17) % MANY_FIELDS;
+		len += snprintk(&encoded[len], sizeof(encoded) - len,
+				"\"f%d\":%d%c", f, f * 3,
+				i < MANY_FIELDS - 1 ? ',' : '}');
+	}
+
+	memset(&mf, 0, sizeof(mf));
+	ret = json_obj_parse_indexed(encoded, len, many_fields_descr,
+				     ARRAY_SIZE(many_fields_descr), index,
+				     &mf);
+
+	zassert_equal(ret, ((int64_t)1 << MANY_FIELDS) - 1,
+		      "All fields decoded");
+
+	for (i = 0; i < MANY_FIELDS; i++) {
+		zassert_equal(fields[i], i == 7 ? -1 : i * 3,
+			      "Field %d decoded once", i);
+	}
+}
+
+static void test_json_stream(void)
+{
+	struct test_struct ts;
+	struct json_obj_stream stream;
+	char buf[512];
+	const char next[] = "{\"some_int\":1}";
+	char encoded[] = "  \n{\"some_string\":\"{[ \\\" ]}\","
+		"\"some_int\":42,"
+		"\"some_bool\":true,"
+		"\"some_nested_struct\":{\"nested_int\":-1234,"
+		"\"nested_bool\":false,"
+		"\"nested_string\":\"}\"},"
+		"\"some_array\":[11,22],"
+		"\"another_b!@l\":true,"
+		"\"if\":false,"
+		"\"another-array\":[2,3,5,7],"
+		"\"4nother_ne$+\":{\"nested_int\":1234,"
+		"\"nested_bool\":true,"
+		"\"nested_string\":\"no escape necessary\"}"
+		"}{\"some_int\":1}";
+	size_t total = sizeof(encoded) - 1;
+	size_t off = 0;
+	size_t chunk = 1;
+	ssize_t consumed;
+	int64_t ret;
+
+	json_obj_stream_init(&stream, buf, sizeof(buf));
+
+	ret = json_obj_stream_parse(&stream, test_descr,
+				    ARRAY_SIZE(test_descr), &ts);
+	zassert_equal(ret, -EAGAIN, "Nothing to parse yet");
+
+	/* Feed pieces of growing size, splitting strings and escapes */
+	while (!json_obj_stream_complete(&stream)) {
+		size_t len = MIN(chunk, total - off);
+
+		zassert_true(len > 0, "Object ended early");
+
+		consumed = json_obj_stream_feed(&stream, &encoded[off], len);
+		zassert_true(consumed > 0 && consumed <= len,
+			     "Piece consumed");
+		off += consumed;
+		chunk = chunk % 7 + 1;
+	}
+
+	zassert_true(!strcmp(&encoded[off], next),
+		     "Stopped at the end of the object");
+	zassert_equal(json_obj_stream_feed(&stream, &encoded[off], 1), 0,
+		      "Nothing consumed after the end of the object");
+
+	ret = json_obj_stream_parse(&stream, test_descr,
+				    ARRAY_SIZE(test_descr), &ts);
+	zassert_equal(ret, (1 << ARRAY_SIZE(test_descr)) - 1,
+		      "All fields decoded correctly");
+	zassert_true(!strcmp(ts.some_string, "{[ \\\" ]}"),
+		     "String decoded correctly");
+	zassert_equal(ts.some_int, 42, "Integer decoded correctly");
+	zassert_true(!strcmp(ts.some_nested_struct.nested_string, "}"),
+		     "Nested string decoded correctly");
+	zassert_equal(ts.another_array_len, 4,
+		      "Array has correct number of items");
+
+	json_obj_stream_init(&stream, buf, sizeof(buf));
+	zassert_equal(json_obj_stream_feed(&stream, " [1]", 4), -EINVAL,
+		      "Only objects are accepted");
+
+	json_obj_stream_init(&stream, buf, 8);
+	zassert_equal(json_obj_stream_feed(&stream, encoded, total),
+		      -ENOMEM, "Buffer overflow detected");
+}
+
 static void test_json_decoding_array_array(void)
 {
 	int ret;
@@ -544,6 +706,9 @@ void test_main(void)
 	ztest_test_suite(lib_json_test,
 			 ztest_unit_test(test_json_encoding),
 			 ztest_unit_test(test_json_decoding),
+			 ztest_unit_test(test_json_decoding_many_fields),
+			 ztest_unit_test(test_json_decoding_indexed),
+			 ztest_unit_test(test_json_stream),
 			 ztest_unit_test(test_json_decoding_array_array),
 			 ztest_unit_test(test_json_obj_arr_encoding),
 			 ztest_unit_test(test_json_obj_arr_decoding),
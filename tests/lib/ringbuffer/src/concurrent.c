@@ -0,0 +1,231 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <sys/ring_buffer.h>
+
+/**
+ * @addtogroup lib_ringbuffer_tests
+ * @{
+ */
+
+#define STRESS_TIME_MS 500
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+
+/* The timer ISR and two threads produce in the multi-producer test */
+#define PRODUCER_THREADS 2
+#define PRODUCERS (PRODUCER_THREADS + 1)
+
+/* Records are a producer id, the record length and a sequence number
+ * repeated until the end of the record.
+ */
+#define RECORD_MIN 3
+#define RECORD_MAX 8
+
+static struct ring_buf stress_buf;
+static uint8_t stress_data[67];
+static struct k_timer stress_timer;
+static volatile bool stress_done;
+
+static uint8_t tx_seq[PRODUCERS];
+static uint8_t rx_seq[PRODUCERS];
+static uint32_t records[PRODUCERS];
+
+static K_THREAD_STACK_ARRAY_DEFINE(producer_stacks, PRODUCER_THREADS,
+				   STACK_SIZE);
+static struct k_thread producer_threads[PRODUCER_THREADS];
+
+static void spsc_timer_handler(struct k_timer *timer)
+{
+	uint8_t *data;
+	uint32_t size;
+	int err;
+
+	/* Fill whatever space is left, in one or two claims when wrapping */
+	for (int i = 0; i < 2; i++) {
+		size = ring_buf_put_claim(&stress_buf, &data, UINT32_MAX);
+		for (uint32_t j = 0; j < size; j++) {
+			data[j] = tx_seq[0]++;
+		}
+
+		err = ring_buf_put_finish(&stress_buf, size);
+		zassert_equal(err, 0, "put finish failed");
+	}
+}
+
+static void spsc_stress(uint32_t size)
+{
+	uint32_t received = 0;
+	int64_t end;
+	uint8_t *data;
+	uint32_t len;
+	int err;
+
+	ring_buf_init(&stress_buf, size, stress_data);
+	tx_seq[0] = 0U;
+	rx_seq[0] = 0U;
+
+	k_timer_init(&stress_timer, spsc_timer_handler, NULL);
+	k_timer_start(&stress_timer, K_MSEC(1), K_MSEC(1));
+
+	end = k_uptime_get() + STRESS_TIME_MS;
+	while (k_uptime_get() < end) {
+		len = ring_buf_get_claim(&stress_buf, &data, 5);
+		for (uint32_t i = 0; i < len; i++) {
+			zassert_equal(data[i], rx_seq[0]++,
+				      "byte %u out of order", received + i);
+		}
+
+		err = ring_buf_get_finish(&stress_buf, len);
+		zassert_equal(err, 0, "get finish failed");
+
+		received += len;
+		if (len == 0U) {
+			k_busy_wait(100);
+		}
+	}
+
+	k_timer_stop(&stress_timer);
+
+	zassert_true(received > size, "only %u bytes received", received);
+}
+
+/**
+ * @brief Test a timer ISR producing into a ring buffer read by a thread
+ *
+ * @details Neither side takes a lock. The consumer reads in small pieces
+ * and checks that the bytes arrive in order, with a power of 2 size and
+ * with an odd size.
+ *
+ * @see ring_buf_put_claim(), ring_buf_get_claim()
+ */
+void test_ringbuffer_spsc_stress(void)
+{
+	spsc_stress(64);
+	spsc_stress(sizeof(stress_data));
+}
+
+static bool produce(int id)
+{
+	uint8_t record[RECORD_MAX];
+	uint8_t len = RECORD_MIN + tx_seq[id] % (RECORD_MAX - RECORD_MIN + 1);
+
+	record[0] = id;
+	record[1] = len;
+	memset(&record[2], tx_seq[id], len - 2);
+
+	if (ring_buf_put_mp(&stress_buf, record, len) == 0U) {
+		return false;
+	}
+
+	tx_seq[id]++;
+	return true;
+}
+
+static void mpsc_timer_handler(struct k_timer *timer)
+{
+	while (produce(0)) {
+	}
+}
+
+static void mpsc_producer(void *p1, void *p2, void *p3)
+{
+	int id = POINTER_TO_INT(p1);
+
+	while (!stress_done) {
+		if (!produce(id)) {
+			/* Give the consumer time to catch up */
+			k_busy_wait(100);
+			k_yield();
+		}
+	}
+}
+
+static void mpsc_check(const uint8_t *record)
+{
+	uint8_t id = record[0];
+	uint8_t len = record[1];
+
+	zassert_true(id < PRODUCERS, "bad producer %u", id);
+	zassert_equal(len, RECORD_MIN + rx_seq[id] %
+		      (RECORD_MAX - RECORD_MIN + 1), "bad length %u", len);
+
+	for (int i = 2; i < len; i++) {
+		zassert_equal(record[i], rx_seq[id], "producer %u record %u "
+			      "corrupted", id, records[id]);
+	}
+
+	rx_seq[id]++;
+	records[id]++;
+}
+
+/**
+ * @brief Test several producers writing to a ring buffer at once
+ *
+ * @details A timer ISR and two threads write records with
+ * ring_buf_put_mp() while a thread reads them. The consumer checks that
+ * records are neither truncated, interleaved nor reordered.
+ *
+ * @see ring_buf_put_mp(), ring_buf_get()
+ */
+void test_ringbuffer_mpsc_stress(void)
+{
+	uint8_t record[RECORD_MAX];
+	uint32_t have = 0;
+	int64_t end;
+
+	ring_buf_init(&stress_buf, sizeof(stress_data), stress_data);
+	memset(tx_seq, 0, sizeof(tx_seq));
+	memset(rx_seq, 0, sizeof(rx_seq));
+	memset(records, 0, sizeof(records));
+	stress_done = false;
+
+	for (int i = 0; i < PRODUCER_THREADS; i++) {
+		k_thread_create(&producer_threads[i], producer_stacks[i],
+				K_THREAD_STACK_SIZEOF(producer_stacks[i]),
+				mpsc_producer,
+				INT_TO_POINTER(i + 1), NULL, NULL,
+				K_PRIO_PREEMPT(1), 0, K_NO_WAIT);
+	}
+
+	k_timer_init(&stress_timer, mpsc_timer_handler, NULL);
+	k_timer_start(&stress_timer, K_MSEC(1), K_MSEC(1));
+
+	end = k_uptime_get() + STRESS_TIME_MS;
+	while (k_uptime_get() < end) {
+		/* Read the header first, then the rest of the record */
+		uint32_t want = have < 2 ? 2 : record[1];
+
+		have += ring_buf_get(&stress_buf, &record[have], want - have);
+		if (have == 2 && (record[1] < RECORD_MIN ||
+				  record[1] > RECORD_MAX)) {
+			zassert_unreachable("bad record length %u", record[1]);
+		}
+
+		if (have >= 2 && have == record[1]) {
+			mpsc_check(record);
+			have = 0;
+		} else {
+			/* Let the producer threads run */
+			k_sleep(K_MSEC(1));
+		}
+	}
+
+	k_timer_stop(&stress_timer);
+	stress_done = true;
+
+	for (int i = 0; i < PRODUCER_THREADS; i++) {
+		k_thread_join(&producer_threads[i], K_FOREVER);
+	}
+
+	for (int i = 0; i < PRODUCERS; i++) {
+		zassert_true(records[i] > 0, "no records from producer %d", i);
+	}
+}
+
+/**
+ * @}
+ */
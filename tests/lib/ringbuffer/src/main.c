@@ -519,6 +519,9 @@ void test_ringbuffer_array_perf(void)
 }
 
 
+extern void test_ringbuffer_spsc_stress(void);
+extern void test_ringbuffer_mpsc_stress(void);
+
 /*test case main entry*/
 void test_main(void)
 {
@@ -538,7 +541,9 @@ void test_main(void)
 			 ztest_unit_test(test_byte_put_free),
 			 ztest_unit_test(test_byte_put_free),
 			 ztest_unit_test(test_capacity),
-			 ztest_unit_test(test_reset)
+			 ztest_unit_test(test_reset),
+			 ztest_unit_test(test_ringbuffer_spsc_stress),
+			 ztest_unit_test(test_ringbuffer_mpsc_stress)
 			 );
 	ztest_run_test_suite(test_ringbuffer_api);
 }
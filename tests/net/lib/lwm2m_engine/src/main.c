@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <string.h>
+#include <net/lwm2m.h>
+#include <ztest.h>
+
+#include "lwm2m_engine.h"
+
+#define TEMP_SENSOR_ID 3303
+#define SENSOR_VALUE_RID 5700
+#define SENSOR_UNITS_RID 5701
+
+extern void test_observe_timing(void);
+
+static void create_inst(uint16_t inst)
+{
+	char path[16];
+	int ret;
+
+	snprintk(path, sizeof(path), "%u/%u", TEMP_SENSOR_ID, inst);
+	ret = lwm2m_engine_create_obj_inst(path);
+	zassert_equal(ret, 0, "can't create %s: %d", path, ret);
+}
+
+static void delete_inst(uint16_t inst)
+{
+	int ret;
+
+	ret = lwm2m_delete_obj_inst(TEMP_SENSOR_ID, inst);
+	zassert_equal(ret, 0, "can't delete %u/%u: %d", TEMP_SENSOR_ID,
+		      inst, ret);
+}
+
+static void test_res_handle_set_get(void)
+{
+	struct lwm2m_engine_res_handle value_handle, units_handle;
+	float32_value_t value = { .val1 = 21, .val2 = 500000 };
+	float32_value_t rd;
+	char units[8];
+	int ret;
+
+	create_inst(0);
+
+	ret = lwm2m_engine_get_res_handle("3303/0/5700", &value_handle);
+	zassert_equal(ret, 0, "can't get handle: %d", ret);
+	ret = lwm2m_engine_get_res_handle("3303/0/5701", &units_handle);
+	zassert_equal(ret, 0, "can't get handle: %d", ret);
+
+	/* set by handle, get by path */
+	ret = lwm2m_engine_set_by_handle(&value_handle, &value, sizeof(value));
+	zassert_equal(ret, 0, "set by handle failed: %d", ret);
+	ret = lwm2m_engine_get_float32("3303/0/5700", &rd);
+	zassert_equal(ret, 0, "get by path failed: %d", ret);
+	zassert_true(rd.val1 == 21 && rd.val2 == 500000, "wrong value");
+
+	/* set by path, get by handle */
+	value.val1 = -4;
+	value.val2 = 250000;
+	ret = lwm2m_engine_set_float32("3303/0/5700", &value);
+	zassert_equal(ret, 0, "set by path failed: %d", ret);
+	(void)memset(&rd, 0, sizeof(rd));
+	ret = lwm2m_engine_get_by_handle(&value_handle, &rd, sizeof(rd));
+	zassert_equal(ret, 0, "get by handle failed: %d", ret);
+	zassert_true(rd.val1 == -4 && rd.val2 == 250000, "wrong value");
+
+	/* strings take their length */
+	ret = lwm2m_engine_set_by_handle(&units_handle, "Cel", 3);
+	zassert_equal(ret, 0, "set by handle failed: %d", ret);
+	ret = lwm2m_engine_get_string("3303/0/5701", units, sizeof(units));
+	zassert_equal(ret, 0, "get by path failed: %d", ret);
+	zassert_true(strcmp(units, "Cel") == 0, "wrong units %s", units);
+
+	(void)memset(units, 0, sizeof(units));
+	ret = lwm2m_engine_get_by_handle(&units_handle, units, sizeof(units));
+	zassert_equal(ret, 0, "get by handle failed: %d", ret);
+	zassert_true(strcmp(units, "Cel") == 0, "wrong units %s", units);
+
+	delete_inst(0);
+}
+
+static void test_res_handle_bad_path(void)
+{
+	struct lwm2m_engine_res_handle handle;
+	float32_value_t value = { .val1 = 7 };
+	float32_value_t rd;
+	int ret;
+
+	ret = lwm2m_engine_get_res_handle("3303/1", &handle);
+	zassert_equal(ret, -EINVAL, "handle for an object instance: %d", ret);
+
+	create_inst(1);
+	ret = lwm2m_engine_get_res_handle("3303/1/5799", &handle);
+	zassert_equal(ret, -ENOENT, "handle for a missing resource: %d", ret);
+	delete_inst(1);
+
+	/* the handle of a missing resource resolves once it exists */
+	ret = lwm2m_engine_get_res_handle("3303/1/5700", &handle);
+	zassert_equal(ret, -ENOENT, "handle for a missing instance: %d", ret);
+	ret = lwm2m_engine_get_by_handle(&handle, &rd, sizeof(rd));
+	zassert_equal(ret, -ENOENT, "get of a missing instance: %d", ret);
+
+	create_inst(1);
+	ret = lwm2m_engine_set_by_handle(&handle, &value, sizeof(value));
+	zassert_equal(ret, 0, "set by handle failed: %d", ret);
+	ret = lwm2m_engine_get_float32("3303/1/5700", &rd);
+	zassert_equal(ret, 0, "get by path failed: %d", ret);
+	zassert_equal(rd.val1, 7, "wrong value %d", rd.val1);
+
+	delete_inst(1);
+}
+
+static void test_res_handle_invalidation(void)
+{
+	struct lwm2m_engine_res_handle handle, other;
+	float32_value_t value = { .val1 = 12 };
+	float32_value_t rd;
+	int ret;
+
+	create_inst(2);
+	create_inst(3);
+
+	ret = lwm2m_engine_get_res_handle("3303/2/5700", &handle);
+	zassert_equal(ret, 0, "can't get handle: %d", ret);
+	ret = lwm2m_engine_get_res_handle("3303/3/5700", &other);
+	zassert_equal(ret, 0, "can't get handle: %d", ret);
+
+	ret = lwm2m_engine_set_by_handle(&other, &value, sizeof(value));
+	zassert_equal(ret, 0, "set by handle failed: %d", ret);
+
+	/* a deleted instance is looked up again, and is gone */
+	delete_inst(2);
+	ret = lwm2m_engine_get_by_handle(&handle, &rd, sizeof(rd));
+	zassert_equal(ret, -ENOENT, "get of a deleted instance: %d", ret);
+	ret = lwm2m_engine_set_by_handle(&handle, &value, sizeof(value));
+	zassert_equal(ret, -ENOENT, "set of a deleted instance: %d", ret);
+
+	/* handles of other instances still work after resolving again */
+	(void)memset(&rd, 0, sizeof(rd));
+	ret = lwm2m_engine_get_by_handle(&other, &rd, sizeof(rd));
+	zassert_equal(ret, 0, "get by handle failed: %d", ret);
+	zassert_equal(rd.val1, 12, "wrong value %d", rd.val1);
+
+	/* a new instance with the same ID is found through the old handle */
+	create_inst(2);
+	value.val1 = 30;
+	ret = lwm2m_engine_set_float32("3303/2/5700", &value);
+	zassert_equal(ret, 0, "set by path failed: %d", ret);
+	(void)memset(&rd, 0, sizeof(rd));
+	ret = lwm2m_engine_get_by_handle(&handle, &rd, sizeof(rd));
+	zassert_equal(ret, 0, "get by handle failed: %d", ret);
+	zassert_equal(rd.val1, 30, "wrong value %d", rd.val1);
+
+	delete_inst(2);
+	delete_inst(3);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(lwm2m_engine,
+			 ztest_unit_test(test_res_handle_set_get),
+			 ztest_unit_test(test_res_handle_bad_path),
+			 ztest_unit_test(test_res_handle_invalidation),
+			 ztest_unit_test(test_observe_timing));
+
+	ztest_run_test_suite(lwm2m_engine);
+}
@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <string.h>
+#include <net/socket.h>
+#include <net/coap.h>
+#include <net/lwm2m.h>
+#include <ztest.h>
+
+#include "lwm2m_engine.h"
+
+/* pmin and pmax are set to 1 and 3 seconds in prj.conf */
+#define PMIN_MS 1000
+#define PMAX_MS 3000
+
+/* how late a notification may arrive, on top of the batch window */
+#define LATE_MS (300 + MSEC_PER_SEC * CONFIG_LWM2M_ENGINE_NOTIFY_BATCH_WINDOW)
+/* how early, due to the time the previous notification took to arrive */
+#define EARLY_MS 50
+
+#define SERVER_PORT 5683
+
+static struct lwm2m_ctx client;
+static struct sockaddr_in6 client_addr;
+static int server_fd = -1;
+static uint8_t token[] = { 0x12, 0x34, 0x56, 0x78 };
+
+static void server_send(struct coap_packet *cpkt)
+{
+	ssize_t ret;
+
+	ret = sendto(server_fd, cpkt->data, cpkt->offset, 0,
+		     (struct sockaddr *)&client_addr, sizeof(client_addr));
+	zassert_equal(ret, cpkt->offset, "can't send to the client: %d",
+		      errno);
+}
+
+/*
+ * Wait for a response or a notification carrying our token, acknowledge
+ * it if needed, and return the time it arrived at.
+ */
+static int64_t server_recv(int32_t timeout_ms)
+{
+	static uint8_t buf[256];
+	struct pollfd pfd = { .fd = server_fd, .events = POLLIN };
+	struct coap_packet cpkt, ack;
+	uint8_t ack_buf[8];
+	uint8_t rx_token[8];
+	int64_t timestamp;
+	ssize_t len;
+	int ret;
+
+	ret = poll(&pfd, 1, timeout_ms);
+	zassert_equal(ret, 1, "nothing received in %d ms", timeout_ms);
+	timestamp = k_uptime_get();
+
+	len = recv(server_fd, buf, sizeof(buf), 0);
+	zassert_true(len > 0, "can't receive: %d", errno);
+
+	ret = coap_packet_parse(&cpkt, buf, len, NULL, 0);
+	zassert_equal(ret, 0, "bad CoAP packet: %d", ret);
+	zassert_equal(coap_header_get_code(&cpkt), COAP_RESPONSE_CODE_CONTENT,
+		      "bad response code");
+	zassert_equal(coap_header_get_token(&cpkt, rx_token), sizeof(token),
+		      "bad token length");
+	zassert_mem_equal(rx_token, token, sizeof(token), "bad token");
+
+	if (coap_header_get_type(&cpkt) == COAP_TYPE_CON) {
+		ret = coap_packet_init(&ack, ack_buf, sizeof(ack_buf), 1,
+				       COAP_TYPE_ACK, 0, NULL, 0,
+				       coap_header_get_id(&cpkt));
+		zassert_equal(ret, 0, "can't build the ACK: %d", ret);
+		server_send(&ack);
+	}
+
+	return timestamp;
+}
+
+static void set_value(int32_t val)
+{
+	float32_value_t value = { .val1 = val };
+	int ret;
+
+	ret = lwm2m_engine_set_float32("3303/4/5700", &value);
+	zassert_equal(ret, 0, "can't set the value: %d", ret);
+}
+
+static void check_interval(int64_t from, int64_t to, int32_t expected)
+{
+	zassert_true(to - from >= expected - EARLY_MS,
+		     "notified after %d ms, expected %d ms",
+		     (int)(to - from), expected);
+	zassert_true(to - from <= expected + LATE_MS,
+		     "notified after %d ms, expected %d ms",
+		     (int)(to - from), expected);
+}
+
+/*
+ * Test that notifications respect pmin and pmax, and that a change after
+ * pmin is notified at once although the engine sleeps until pmax.
+ */
+void test_observe_timing(void)
+{
+	struct sockaddr_in6 addr = {
+		.sin6_family = AF_INET6,
+		.sin6_port = htons(SERVER_PORT),
+		.sin6_addr = IN6ADDR_LOOPBACK_INIT,
+	};
+	socklen_t addr_len = sizeof(client_addr);
+	struct coap_packet cpkt;
+	uint8_t buf[64];
+	int64_t last, now;
+	int ret;
+
+	ret = lwm2m_engine_create_obj_inst("3303/4");
+	zassert_equal(ret, 0, "can't create 3303/4: %d", ret);
+
+	server_fd = socket(AF_INET6, SOCK_DGRAM, IPPROTO_UDP);
+	zassert_true(server_fd >= 0, "can't create the server socket: %d",
+		     errno);
+	ret = bind(server_fd, (struct sockaddr *)&addr, sizeof(addr));
+	zassert_equal(ret, 0, "can't bind the server socket: %d", errno);
+
+	ret = lwm2m_engine_set_string("0/0/0", "coap://[::1]:5683");
+	zassert_equal(ret, 0, "can't set the server URL: %d", ret);
+
+	(void)memset(&client, 0, sizeof(client));
+	ret = lwm2m_engine_start(&client);
+	zassert_equal(ret, 0, "can't start the engine: %d", ret);
+	ret = getsockname(client.sock_fd, (struct sockaddr *)&client_addr,
+			  &addr_len);
+	zassert_equal(ret, 0, "can't get the client address: %d", errno);
+	client_addr.sin6_addr = addr.sin6_addr;
+
+	/* observe the sensor value */
+	ret = coap_packet_init(&cpkt, buf, sizeof(buf), 1, COAP_TYPE_CON,
+			       sizeof(token), token, COAP_METHOD_GET,
+			       coap_next_id());
+	zassert_equal(ret, 0, "can't build the request: %d", ret);
+	ret = coap_append_option_int(&cpkt, COAP_OPTION_OBSERVE, 0);
+	zassert_equal(ret, 0, "can't add the observe option: %d", ret);
+	ret = coap_packet_append_option(&cpkt, COAP_OPTION_URI_PATH,
+					"3303", 4);
+	ret |= coap_packet_append_option(&cpkt, COAP_OPTION_URI_PATH, "4", 1);
+	ret |= coap_packet_append_option(&cpkt, COAP_OPTION_URI_PATH,
+					 "5700", 4);
+	zassert_equal(ret, 0, "can't add the path");
+	server_send(&cpkt);
+	last = server_recv(PMIN_MS);
+
+	/* without changes, a notification is sent every pmax */
+	now = server_recv(PMAX_MS + LATE_MS + 1000);
+	check_interval(last, now, PMAX_MS);
+	last = now;
+
+	now = server_recv(PMAX_MS + LATE_MS + 1000);
+	check_interval(last, now, PMAX_MS);
+	last = now;
+
+	/* a change right after a notification waits for pmin */
+	set_value(1);
+	now = server_recv(PMAX_MS + LATE_MS);
+	check_interval(last, now, PMIN_MS);
+	last = now;
+
+	/* a change after pmin is notified at once */
+	k_msleep(PMIN_MS + 500);
+	set_value(2);
+	now = server_recv(PMAX_MS);
+	check_interval(last, now, PMIN_MS + 500);
+	last = now;
+
+	/* and pmax counts again from that notification */
+	now = server_recv(PMAX_MS + LATE_MS + 1000);
+	check_interval(last, now, PMAX_MS);
+
+	ret = lwm2m_engine_context_close(&client);
+	zassert_equal(ret, 0, "can't close the context: %d", ret);
+	(void)close(server_fd);
+}
@@ -447,6 +447,45 @@ static void test_route_del_nexthop_again(void)
 	zassert_false((ret >= 0), "Route del again nexthop failed");
 }
 
+static void test_route_lookup_longest_prefix(void)
+{
+	struct in6_addr other_addr = { { { 0x20, 0x01, 0x0d, 0xb9, 0, 0, 0, 0,
+					   0, 0, 0, 0, 0, 0, 0, 0x1 } } };
+	struct net_route_entry *host_route, *prefix_route, *entry;
+
+	/* The host route is added first, as adding it second would find
+	 * and update the covering prefix route instead.
+	 */
+	host_route = net_route_add(my_iface, &dest_addr, 128, &peer_addr);
+	zassert_not_null(host_route, "Host route add failed");
+
+	prefix_route = net_route_add(my_iface, &generic_addr, 64, &peer_addr);
+	zassert_not_null(prefix_route, "Prefix route add failed");
+	zassert_not_equal(prefix_route, host_route, "Routes are the same");
+
+	entry = net_route_lookup(my_iface, &dest_addr);
+	zassert_equal_ptr(entry, host_route, "Host route not found");
+
+	entry = net_route_lookup(my_iface, &generic_addr);
+	zassert_equal_ptr(entry, prefix_route, "Prefix route not found");
+
+	entry = net_route_lookup(NULL, &generic_addr);
+	zassert_equal_ptr(entry, prefix_route, "Prefix route not found");
+
+	entry = net_route_lookup(my_iface, &other_addr);
+	zassert_is_null(entry, "Route found for other prefix");
+
+	zassert_false(net_route_del(host_route), "Host route del failed");
+
+	entry = net_route_lookup(my_iface, &dest_addr);
+	zassert_equal_ptr(entry, prefix_route, "Prefix route not used");
+
+	zassert_false(net_route_del(prefix_route), "Prefix route del failed");
+
+	entry = net_route_lookup(my_iface, &generic_addr);
+	zassert_is_null(entry, "Deleted route found");
+}
+
 static void test_route_add_many(void)
 {
 	int i;
@@ -491,6 +530,7 @@ void test_main(void)
 			ztest_unit_test(test_route_del_again),
 			ztest_unit_test(test_route_del_nexthop_again),
 			ztest_unit_test(test_populate_nbr_cache),
+			ztest_unit_test(test_route_lookup_longest_prefix),
 			ztest_unit_test(test_route_add_many),
 			ztest_unit_test(test_route_del_many));
 	ztest_run_test_suite(test_route);
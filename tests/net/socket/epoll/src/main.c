@@ -0,0 +1,240 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_SOCKETS_LOG_LEVEL);
+
+#include <stdio.h>
+#include <ztest_assert.h>
+
+#include <net/socket.h>
+#include <sys/fdtable.h>
+
+#include "../../socket_helpers.h"
+
+#define BUF_AND_SIZE(buf) buf, sizeof(buf) - 1
+#define STRLEN(buf) (sizeof(buf) - 1)
+
+#define TEST_STR_SMALL "test"
+
+#define SERVER_PORT 4242
+#define CLIENT_PORT 9898
+
+/* On QEMU, a wait takes +10ms from the requested time. */
+#define FUZZ 10
+
+void test_epoll_udp(void)
+{
+	int res;
+	int ep;
+	int c_sock;
+	int s_sock;
+	struct sockaddr_in6 c_addr;
+	struct sockaddr_in6 s_addr;
+	struct epoll_event ev;
+	struct epoll_event events[2];
+	uint32_t tstamp;
+	ssize_t len;
+	char buf[10];
+
+	prepare_sock_udp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, CLIENT_PORT,
+			    &c_sock, &c_addr);
+	prepare_sock_udp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, SERVER_PORT,
+			    &s_sock, &s_addr);
+
+	res = bind(s_sock, (struct sockaddr *)&s_addr, sizeof(s_addr));
+	zassert_equal(res, 0, "bind failed");
+
+	res = connect(c_sock, (struct sockaddr *)&s_addr, sizeof(s_addr));
+	zassert_equal(res, 0, "connect failed");
+
+	zassert_equal(epoll_create1(1), -1, "invalid flags accepted");
+	zassert_equal(errno, EINVAL, "");
+
+	ep = epoll_create1(0);
+	zassert_true(ep >= 0, "epoll_create1 failed");
+
+	ev.events = EPOLLIN;
+	ev.data.fd = c_sock;
+	res = epoll_ctl(ep, EPOLL_CTL_ADD, c_sock, &ev);
+	zassert_equal(res, 0, "adding client failed");
+
+	ev.data.fd = s_sock;
+	res = epoll_ctl(ep, EPOLL_CTL_ADD, s_sock, &ev);
+	zassert_equal(res, 0, "adding server failed");
+
+	res = epoll_ctl(ep, EPOLL_CTL_ADD, s_sock, &ev);
+	zassert_equal(res, -1, "socket added twice");
+	zassert_equal(errno, EEXIST, "");
+
+	res = epoll_ctl(ep, EPOLL_CTL_ADD, ep, &ev);
+	zassert_equal(res, -1, "set added to itself");
+	zassert_equal(errno, EINVAL, "");
+
+	/* Wait on non-ready sockets with timeout of 0 */
+	tstamp = k_uptime_get_32();
+	res = epoll_wait(ep, events, ARRAY_SIZE(events), 0);
+	zassert_true(k_uptime_get_32() - tstamp <= FUZZ, "");
+	zassert_equal(res, 0, "");
+
+	/* Wait on non-ready sockets with timeout of 30 */
+	tstamp = k_uptime_get_32();
+	res = epoll_wait(ep, events, ARRAY_SIZE(events), 30);
+	tstamp = k_uptime_get_32() - tstamp;
+	zassert_true(tstamp >= 30U && tstamp <= 30 + FUZZ * 2, "tstamp %d",
+		     tstamp);
+	zassert_equal(res, 0, "");
+
+	/* Send pkt for s_sock and wait with timeout of 30 */
+	len = send(c_sock, BUF_AND_SIZE(TEST_STR_SMALL), 0);
+	zassert_equal(len, STRLEN(TEST_STR_SMALL), "invalid send len");
+
+	tstamp = k_uptime_get_32();
+	res = epoll_wait(ep, events, ARRAY_SIZE(events), 30);
+	zassert_true(k_uptime_get_32() - tstamp <= FUZZ, "");
+	zassert_equal(res, 1, "");
+	zassert_equal(events[0].events, EPOLLIN, "");
+	zassert_equal(events[0].data.fd, s_sock, "");
+
+	/* Level triggered, so the socket stays ready until read */
+	res = epoll_wait(ep, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, 1, "");
+	zassert_equal(events[0].data.fd, s_sock, "");
+
+	len = recv(s_sock, BUF_AND_SIZE(buf), 0);
+	zassert_equal(len, STRLEN(TEST_STR_SMALL), "invalid recv len");
+
+	res = epoll_wait(ep, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, 0, "");
+
+	/* Edge triggered, so the socket is reported once per packet */
+	ev.events = EPOLLIN | EPOLLET;
+	res = epoll_ctl(ep, EPOLL_CTL_MOD, s_sock, &ev);
+	zassert_equal(res, 0, "modifying server failed");
+
+	len = send(c_sock, BUF_AND_SIZE(TEST_STR_SMALL), 0);
+	zassert_equal(len, STRLEN(TEST_STR_SMALL), "invalid send len");
+
+	res = epoll_wait(ep, events, ARRAY_SIZE(events), 30);
+	zassert_equal(res, 1, "");
+	zassert_equal(events[0].data.fd, s_sock, "");
+
+	res = epoll_wait(ep, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, 0, "");
+
+	len = recv(s_sock, BUF_AND_SIZE(buf), 0);
+	zassert_equal(len, STRLEN(TEST_STR_SMALL), "invalid recv len");
+
+	/* A removed socket is not reported any more */
+	res = epoll_ctl(ep, EPOLL_CTL_DEL, s_sock, NULL);
+	zassert_equal(res, 0, "removing server failed");
+
+	res = epoll_ctl(ep, EPOLL_CTL_DEL, s_sock, NULL);
+	zassert_equal(res, -1, "socket removed twice");
+	zassert_equal(errno, ENOENT, "");
+
+	len = send(c_sock, BUF_AND_SIZE(TEST_STR_SMALL), 0);
+	zassert_equal(len, STRLEN(TEST_STR_SMALL), "invalid send len");
+
+	res = epoll_wait(ep, events, ARRAY_SIZE(events), 30);
+	zassert_equal(res, 0, "");
+
+	/* Writability is reported right away */
+	ev.events = EPOLLOUT;
+	ev.data.fd = c_sock;
+	res = epoll_ctl(ep, EPOLL_CTL_MOD, c_sock, &ev);
+	zassert_equal(res, 0, "modifying client failed");
+
+	res = epoll_wait(ep, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, 1, "");
+	zassert_equal(events[0].events, EPOLLOUT, "");
+	zassert_equal(events[0].data.fd, c_sock, "");
+
+	/* A closed socket leaves the set */
+	res = close(c_sock);
+	zassert_equal(res, 0, "close failed");
+
+	res = epoll_wait(ep, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, 0, "");
+
+	res = close(s_sock);
+	zassert_equal(res, 0, "close failed");
+
+	res = close(ep);
+	zassert_equal(res, 0, "close failed");
+}
+
+void test_epoll_tcp_accept(void)
+{
+	int res;
+	int ep;
+	int c_sock;
+	int s_sock;
+	int new_sock;
+	struct sockaddr_in6 c_addr;
+	struct sockaddr_in6 s_addr;
+	struct epoll_event ev;
+	struct epoll_event events[1];
+
+	prepare_sock_tcp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, CLIENT_PORT,
+			    &c_sock, &c_addr);
+	prepare_sock_tcp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, SERVER_PORT,
+			    &s_sock, &s_addr);
+
+	res = bind(s_sock, (struct sockaddr *)&s_addr, sizeof(s_addr));
+	zassert_equal(res, 0, "bind failed");
+	res = listen(s_sock, 1);
+	zassert_equal(res, 0, "listen failed");
+
+	ep = epoll_create1(0);
+	zassert_true(ep >= 0, "epoll_create1 failed");
+
+	ev.events = EPOLLIN;
+	ev.data.fd = s_sock;
+	res = epoll_ctl(ep, EPOLL_CTL_ADD, s_sock, &ev);
+	zassert_equal(res, 0, "adding listener failed");
+
+	res = epoll_wait(ep, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, 0, "");
+
+	/* An incoming connection makes the listening socket readable */
+	res = connect(c_sock, (const struct sockaddr *)&s_addr,
+		      sizeof(s_addr));
+	zassert_equal(res, 0, "connect failed");
+
+	res = epoll_wait(ep, events, ARRAY_SIZE(events), 100);
+	zassert_equal(res, 1, "");
+	zassert_equal(events[0].events, EPOLLIN, "");
+	zassert_equal(events[0].data.fd, s_sock, "");
+
+	new_sock = accept(s_sock, NULL, NULL);
+	zassert_true(new_sock >= 0, "accept failed");
+
+	res = epoll_wait(ep, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, 0, "");
+
+	res = close(new_sock);
+	zassert_equal(res, 0, "close failed");
+
+	res = close(c_sock);
+	zassert_equal(res, 0, "close failed");
+
+	/* Closing the set releases the sockets in it */
+	res = close(ep);
+	zassert_equal(res, 0, "close failed");
+
+	res = close(s_sock);
+	zassert_equal(res, 0, "close failed");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(socket_epoll,
+			 ztest_unit_test(test_epoll_udp),
+			 ztest_unit_test(test_epoll_tcp_accept));
+
+	ztest_run_test_suite(socket_epoll);
+}
@@ -506,6 +506,83 @@ void test_socket_permission(void)
 #endif /* CONFIG_USERSPACE */
 }
 
+#if defined(CONFIG_NET_SOCKETS_ZEROCOPY)
+static K_SEM_DEFINE(zc_sent, 0, 1);
+
+static void zc_send_done(void *user_data)
+{
+	ARG_UNUSED(user_data);
+
+	k_sem_give(&zc_sent);
+}
+
+void test_v4_sendmsg_zc(void)
+{
+	/* Test that zsock_sendmsg_zc() delivers the data of a chain of
+	 * buffers and calls the completion callback once it is acked.
+	 */
+	int c_sock;
+	int s_sock;
+	int new_sock;
+	struct sockaddr_in c_saddr;
+	struct sockaddr_in s_saddr;
+	struct sockaddr addr;
+	socklen_t addrlen = sizeof(addr);
+	static char tx_buf[] = "zero-copy " TEST_STR_SMALL;
+	char rx_buf[sizeof(tx_buf)];
+	struct iovec io_vector[2];
+	struct msghdr msg;
+	size_t recved = 0;
+	ssize_t ret;
+
+	prepare_sock_tcp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, ANY_PORT,
+			    &c_sock, &c_saddr);
+	prepare_sock_tcp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, SERVER_PORT,
+			    &s_sock, &s_saddr);
+
+	test_bind(s_sock, (struct sockaddr *)&s_saddr, sizeof(s_saddr));
+	test_listen(s_sock);
+
+	test_connect(c_sock, (struct sockaddr *)&s_saddr, sizeof(s_saddr));
+	test_accept(s_sock, &new_sock, &addr, &addrlen);
+
+	io_vector[0].iov_base = tx_buf;
+	io_vector[0].iov_len = 5;
+	io_vector[1].iov_base = tx_buf + 5;
+	io_vector[1].iov_len = sizeof(tx_buf) - 5;
+
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_iov = io_vector;
+	msg.msg_iovlen = 2;
+
+	ret = zsock_sendmsg_zc(c_sock, &msg, 0, zc_send_done, NULL);
+	zassert_equal(ret, sizeof(tx_buf), "sendmsg_zc failed");
+
+	while (recved < sizeof(tx_buf)) {
+		ret = recv(new_sock, rx_buf + recved,
+			   sizeof(rx_buf) - recved, 0);
+		zassert_true(ret > 0, "recv failed");
+		recved += ret;
+	}
+
+	zassert_mem_equal(rx_buf, tx_buf, sizeof(tx_buf), "wrong data");
+
+	zassert_equal(k_sem_take(&zc_sent, K_SECONDS(1)), 0,
+		      "send completion not called");
+
+	test_close(c_sock);
+	test_close(new_sock);
+	test_close(s_sock);
+
+	k_sleep(TCP_TEARDOWN_TIMEOUT);
+}
+#else
+void test_v4_sendmsg_zc(void)
+{
+	ztest_test_skip();
+}
+#endif /* CONFIG_NET_SOCKETS_ZEROCOPY */
+
 void test_main(void)
 {
 #ifdef CONFIG_USERSPACE
@@ -523,7 +600,8 @@ void test_main(void)
 		ztest_user_unit_test(test_v6_sendto_recvfrom_null_dest),
 		ztest_unit_test(test_open_close_immediately),
 		ztest_user_unit_test(test_v4_accept_timeout),
-		ztest_user_unit_test(test_socket_permission)
+		ztest_user_unit_test(test_socket_permission),
+		ztest_unit_test(test_v4_sendmsg_zc)
 		);
 
 	ztest_run_test_suite(socket_tcp);
@@ -954,6 +954,96 @@ void test_v6_sendmsg_with_txtime(void)
 	test_started = false;
 }
 
+#if defined(CONFIG_NET_SOCKETS_ZEROCOPY)
+static K_SEM_DEFINE(zc_sent, 0, 1);
+
+static void zc_send_done(void *user_data)
+{
+	ARG_UNUSED(user_data);
+
+	k_sem_give(&zc_sent);
+}
+
+void test_v4_sendmsg_zc_recvfrom_zc(void)
+{
+	int rv;
+	int client_sock;
+	int server_sock;
+	struct sockaddr_in client_addr;
+	struct sockaddr_in server_addr;
+	struct sockaddr addr;
+	socklen_t addrlen;
+	struct msghdr msg;
+	struct iovec io_vector[2];
+	struct net_buf *frags;
+	ssize_t sent;
+	ssize_t recved;
+
+	prepare_sock_udp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, ANY_PORT,
+			    &client_sock, &client_addr);
+	prepare_sock_udp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, SERVER_PORT,
+			    &server_sock, &server_addr);
+
+	rv = bind(server_sock,
+		  (struct sockaddr *)&server_addr,
+		  sizeof(server_addr));
+	zassert_equal(rv, 0, "server bind failed");
+
+	rv = connect(client_sock, (struct sockaddr *)&server_addr,
+		     sizeof(server_addr));
+	zassert_equal(rv, 0, "connect failed");
+
+	/* Split the data so that it needs a chain of two buffers */
+	io_vector[0].iov_base = TEST_STR2;
+	io_vector[0].iov_len = 100;
+	io_vector[1].iov_base = TEST_STR2 + 100;
+	io_vector[1].iov_len = STRLEN(TEST_STR2) - 100;
+
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_iov = io_vector;
+	msg.msg_iovlen = 2;
+
+	sent = zsock_sendmsg_zc(client_sock, &msg, 0, zc_send_done, NULL);
+	zassert_equal(sent, STRLEN(TEST_STR2), "sendmsg_zc failed");
+
+	addrlen = sizeof(addr);
+	recved = zsock_recvfrom_zc(server_sock, &frags, 0, &addr, &addrlen);
+	zassert_equal(recved, STRLEN(TEST_STR2), "unexpected received bytes");
+	zassert_not_null(frags, "no fragments received");
+	zassert_equal(net_buf_frags_len(frags), recved,
+		      "fragments hold more than the payload");
+	zassert_equal(addrlen, sizeof(struct sockaddr_in),
+		      "unexpected addrlen");
+
+	clear_buf(rx_buf);
+	net_buf_linearize(rx_buf, sizeof(rx_buf), frags, 0, recved);
+	zassert_mem_equal(rx_buf, BUF_AND_SIZE(TEST_STR2), "wrong data");
+
+	net_buf_unref(frags);
+
+	zassert_equal(k_sem_take(&zc_sent, K_SECONDS(1)), 0,
+		      "send completion not called");
+
+	/* A failed send must not call the completion callback */
+	msg.msg_name = &server_addr;
+	msg.msg_namelen = 1;
+	sent = zsock_sendmsg_zc(server_sock, &msg, 0, zc_send_done, NULL);
+	zassert_equal(sent, -1, "sendmsg_zc with bad address succeeded");
+	zassert_equal(k_sem_take(&zc_sent, K_MSEC(100)), -EAGAIN,
+		      "completion called for a failed send");
+
+	rv = close(client_sock);
+	zassert_equal(rv, 0, "close failed");
+	rv = close(server_sock);
+	zassert_equal(rv, 0, "close failed");
+}
+#else
+void test_v4_sendmsg_zc_recvfrom_zc(void)
+{
+	ztest_test_skip();
+}
+#endif /* CONFIG_NET_SOCKETS_ZEROCOPY */
+
 void test_main(void)
 {
 	k_thread_system_pool_assign(k_current_get());
@@ -976,6 +1066,7 @@ void test_main(void)
 			 ztest_user_unit_test(test_v4_sendmsg_recvfrom_connected),
 			 ztest_unit_test(test_v6_sendmsg_recvfrom_connected),
 			 ztest_user_unit_test(test_v6_sendmsg_recvfrom_connected),
+			 ztest_unit_test(test_v4_sendmsg_zc_recvfrom_zc),
 			 ztest_unit_test(test_setup_eth),
 			 ztest_unit_test(test_v6_sendmsg_with_txtime),
 			 ztest_user_unit_test(test_v6_sendmsg_with_txtime)
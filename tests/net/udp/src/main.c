@@ -33,6 +33,7 @@ LOG_MODULE_REGISTER(net_test, NET_LOG_LEVEL);
 
 #include "ipv4.h"
 #include "ipv6.h"
+#include "net_stats.h"
 
 #include <ztest.h>
 
@@ -663,9 +664,137 @@ void test_udp(void)
 	zassert_false(test_failed, "udp tests failed");
 }
 
+#define CONN_INDEX_PORTS 16
+#define CONN_INDEX_BASE_PORT 5000
+
+static struct ud conn_index_ud6[CONN_INDEX_PORTS];
+static struct ud conn_index_ud4[CONN_INDEX_PORTS];
+static struct ud conn_index_wildcard_ud;
+
+static void conn_index_register(struct ud *ud, sa_family_t family,
+				uint16_t lport)
+{
+	struct net_conn_handle *handle;
+	int ret;
+
+	ud->local_port = lport;
+	ud->test = "conn_index";
+
+	ret = net_udp_register(family, NULL, NULL, 0, lport, test_ok, ud,
+			       &handle);
+	zassert_equal(ret, 0, "UDP register port %d failed (%d)", lport, ret);
+	ud->handle = handle;
+}
+
+static void conn_index_unregister(struct ud *ud)
+{
+	int ret;
+
+	ret = net_udp_unregister(ud->handle);
+	zassert_equal(ret, 0, "UDP unregister %p failed (%d)", ud->handle,
+		      ret);
+}
+
+/* Handlers bound to a port are found through the index, everything else
+ * falls back to the wildcard handler, including ports whose handler has
+ * been unregistered.
+ */
+void test_udp_conn_index(void)
+{
+	struct net_if *iface = net_if_get_default();
+	struct in6_addr in6addr_my = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+					   0, 0, 0, 0, 0, 0, 0, 0x1 } } };
+	struct in6_addr in6addr_peer = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0,
+					     0, 0, 0, 0, 0x4e, 0x11, 0, 0,
+					     0x2 } } };
+	struct in_addr in4addr_my = { { { 192, 0, 2, 1 } } };
+	struct in_addr in4addr_peer = { { { 192, 0, 2, 9 } } };
+	uint16_t port;
+	bool st;
+	int i;
+
+	k_thread_priority_set(k_current_get(), K_PRIO_COOP(7));
+
+	zassert_not_null(net_if_ipv6_addr_add(iface, &in6addr_my,
+					      NET_ADDR_MANUAL, 0),
+			 "Cannot add IPv6 address");
+	zassert_not_null(net_if_ipv4_addr_add(iface, &in4addr_my,
+					      NET_ADDR_MANUAL, 0),
+			 "Cannot add IPv4 address");
+
+	for (i = 0; i < CONN_INDEX_PORTS; i++) {
+		port = CONN_INDEX_BASE_PORT + i;
+		conn_index_register(&conn_index_ud6[i], AF_INET6, port);
+		conn_index_register(&conn_index_ud4[i], AF_INET, port);
+	}
+
+	conn_index_register(&conn_index_wildcard_ud, AF_UNSPEC, 0);
+
+#if defined(CONFIG_NET_STATISTICS_CONN)
+	net_stats.conn.max_depth = 0;
+#endif
+
+	for (i = 0; i < CONN_INDEX_PORTS; i++) {
+		port = CONN_INDEX_BASE_PORT + i;
+
+		st = send_ipv6_udp_msg(iface, &in6addr_peer, &in6addr_my,
+				       1234, port, &conn_index_ud6[i], false);
+		zassert_true(st, "IPv6 port %d not delivered", port);
+
+		st = send_ipv4_udp_msg(iface, &in4addr_peer, &in4addr_my,
+				       1234, port, &conn_index_ud4[i], false);
+		zassert_true(st, "IPv4 port %d not delivered", port);
+	}
+
+#if defined(CONFIG_NET_STATISTICS_CONN)
+	/* Each lookup visits one bucket, shared by at most both families
+	 * of the evenly spread ports, and the wildcard handler.
+	 */
+	zassert_true(net_stats.conn.max_depth <=
+		     2 * ceiling_fraction(CONN_INDEX_PORTS,
+					  CONFIG_NET_CONN_HASH_SIZE) + 1,
+		     "lookup examined %d handlers",
+		     net_stats.conn.max_depth);
+#endif
+
+	/* ports without a handler of their own go to the wildcard */
+	for (i = 0; i < CONN_INDEX_PORTS; i += 2) {
+		conn_index_unregister(&conn_index_ud6[i]);
+	}
+
+	for (i = 0; i < CONN_INDEX_PORTS; i++) {
+		port = CONN_INDEX_BASE_PORT + i;
+
+		st = send_ipv6_udp_msg(iface, &in6addr_peer, &in6addr_my,
+				       1234, port,
+				       (i % 2) ? &conn_index_ud6[i] :
+				       &conn_index_wildcard_ud, false);
+		zassert_true(st, "IPv6 port %d not delivered", port);
+	}
+
+	st = send_ipv4_udp_msg(iface, &in4addr_peer, &in4addr_my, 1234,
+			       CONN_INDEX_BASE_PORT + CONN_INDEX_PORTS,
+			       &conn_index_wildcard_ud, false);
+	zassert_true(st, "IPv4 unbound port not delivered");
+
+	conn_index_unregister(&conn_index_wildcard_ud);
+
+	st = send_ipv6_udp_msg(iface, &in6addr_peer, &in6addr_my, 1234,
+			       CONN_INDEX_BASE_PORT, NULL, true);
+	zassert_true(st, "IPv6 packet delivered without a handler");
+
+	for (i = 0; i < CONN_INDEX_PORTS; i++) {
+		if (i % 2) {
+			conn_index_unregister(&conn_index_ud6[i]);
+		}
+		conn_index_unregister(&conn_index_ud4[i]);
+	}
+}
+
 void test_main(void)
 {
 	ztest_test_suite(test_udp_fn,
-		ztest_unit_test(test_udp));
+		ztest_unit_test(test_udp),
+		ztest_unit_test(test_udp_conn_index));
 	ztest_run_test_suite(test_udp_fn);
 }
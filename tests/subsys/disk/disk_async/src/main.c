@@ -0,0 +1,324 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <string.h>
+#include <disk/disk_access.h>
+#include <ztest.h>
+
+#define DISK_NAME "ASYNC"
+#define SECTOR_SIZE 512
+#define SECTOR_COUNT 64
+#define MAX_REQS 8
+
+static uint8_t storage[SECTOR_COUNT][SECTOR_SIZE];
+static uint8_t wbuf[8 * SECTOR_SIZE];
+static uint8_t rbuf[8 * SECTOR_SIZE];
+
+/* Transfers done by the disk access thread */
+struct xfer {
+	uint8_t op;
+	size_t sg_count;
+	struct disk_sg sg[CONFIG_DISK_ACCESS_ASYNC_SG_MAX];
+};
+
+static struct xfer xfers[MAX_REQS];
+static size_t xfer_cnt;
+static uint32_t fail_sector = UINT32_MAX;
+static bool slow_transfer;
+static volatile bool transferring;
+
+static struct disk_req reqs[MAX_REQS];
+static struct disk_sg sgs[MAX_REQS];
+static struct disk_req *completed[MAX_REQS];
+static int results[MAX_REQS];
+static size_t completed_cnt;
+static K_SEM_DEFINE(completed_sem, 0, MAX_REQS);
+
+static int test_disk_init(struct disk_info *disk)
+{
+	return 0;
+}
+
+static int test_disk_status(struct disk_info *disk)
+{
+	return DISK_STATUS_OK;
+}
+
+static int test_disk_read(struct disk_info *disk, uint8_t *data_buf,
+			  uint32_t start_sector, uint32_t num_sector)
+{
+	zassert_false(transferring, "read during a transfer");
+	memcpy(data_buf, storage[start_sector], num_sector * SECTOR_SIZE);
+
+	return 0;
+}
+
+static int test_disk_write(struct disk_info *disk, const uint8_t *data_buf,
+			   uint32_t start_sector, uint32_t num_sector)
+{
+	zassert_false(transferring, "write during a transfer");
+	memcpy(storage[start_sector], data_buf, num_sector * SECTOR_SIZE);
+
+	return 0;
+}
+
+static int test_disk_ioctl(struct disk_info *disk, uint8_t cmd, void *buff)
+{
+	switch (cmd) {
+	case DISK_IOCTL_CTRL_SYNC:
+		break;
+	case DISK_IOCTL_GET_SECTOR_COUNT:
+		*(uint32_t *)buff = SECTOR_COUNT;
+		break;
+	case DISK_IOCTL_GET_SECTOR_SIZE:
+		*(uint32_t *)buff = SECTOR_SIZE;
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+static int test_disk_transfer(struct disk_info *disk, uint8_t op,
+			      const struct disk_sg *sg, size_t sg_count)
+{
+	struct xfer *x = &xfers[xfer_cnt++];
+	int rc = 0;
+
+	transferring = true;
+
+	x->op = op;
+	x->sg_count = sg_count;
+	memcpy(x->sg, sg, sg_count * sizeof(*sg));
+
+	for (size_t i = 0; i < sg_count; i++) {
+		size_t len = sg[i].num_sector * SECTOR_SIZE;
+
+		if (fail_sector - sg[i].start_sector < sg[i].num_sector) {
+			rc = -EIO;
+		} else if (op == DISK_REQ_READ) {
+			memcpy(sg[i].buf, storage[sg[i].start_sector], len);
+		} else {
+			memcpy(storage[sg[i].start_sector], sg[i].buf, len);
+		}
+	}
+
+	if (slow_transfer) {
+		k_msleep(20);
+	}
+
+	transferring = false;
+
+	return rc;
+}
+
+static const struct disk_operations test_disk_ops = {
+	.init = test_disk_init,
+	.status = test_disk_status,
+	.read = test_disk_read,
+	.write = test_disk_write,
+	.ioctl = test_disk_ioctl,
+	.transfer = test_disk_transfer,
+};
+
+static struct disk_info test_disk = {
+	.name = DISK_NAME,
+	.ops = &test_disk_ops,
+};
+
+static void req_cb(struct disk_req *req, int result)
+{
+	results[completed_cnt] = result;
+	completed[completed_cnt++] = req;
+	k_sem_give(&completed_sem);
+}
+
+static void async_setup(void)
+{
+	for (size_t i = 0; i < sizeof(wbuf); i++) {
+		wbuf[i] = (uint8_t)(i / SECTOR_SIZE + 1);
+	}
+
+	(void)memset(storage, 0, sizeof(storage));
+	(void)memset(rbuf, 0, sizeof(rbuf));
+	xfer_cnt = 0;
+	completed_cnt = 0;
+	fail_sector = UINT32_MAX;
+	slow_transfer = false;
+	k_sem_reset(&completed_sem);
+}
+
+/* Queue a request of one segment, buf_sector sectors into the buffer */
+static void submit(size_t idx, uint8_t op, uint32_t buf_sector,
+		   uint32_t start_sector, uint32_t num_sector)
+{
+	uint8_t *buf = (op == DISK_REQ_READ) ? rbuf : wbuf;
+	int rc;
+
+	sgs[idx].buf = &buf[buf_sector * SECTOR_SIZE];
+	sgs[idx].start_sector = start_sector;
+	sgs[idx].num_sector = num_sector;
+
+	(void)memset(&reqs[idx], 0, sizeof(reqs[idx]));
+	reqs[idx].sg = &sgs[idx];
+	reqs[idx].sg_count = 1;
+	reqs[idx].op = op;
+	reqs[idx].cb = req_cb;
+
+	rc = disk_access_submit(DISK_NAME, &reqs[idx]);
+	zassert_equal(rc, 0, "can't submit request %zu: %d", idx, rc);
+}
+
+/* Wait for the requests, which must complete in order */
+static void wait_completed(size_t count)
+{
+	for (size_t i = 0; i < count; i++) {
+		zassert_equal(k_sem_take(&completed_sem, K_SECONDS(1)), 0,
+			      "request %zu not completed", i);
+		zassert_equal(completed[i], &reqs[i],
+			      "request %zu completed out of order", i);
+		zassert_equal(reqs[i].result, results[i],
+			      "request %zu: bad stored result", i);
+	}
+}
+
+static void xfer_check(size_t idx, uint8_t op, size_t sg_count)
+{
+	zassert_true(idx < xfer_cnt, "transfer %zu not done", idx);
+	zassert_equal(xfers[idx].op, op, "transfer %zu: bad operation", idx);
+	zassert_equal(xfers[idx].sg_count, sg_count,
+		      "transfer %zu: %zu segments, expected %zu", idx,
+		      xfers[idx].sg_count, sg_count);
+}
+
+static void sg_check(size_t idx, size_t sg, uint32_t start_sector,
+		     uint32_t num_sector)
+{
+	zassert_equal(xfers[idx].sg[sg].start_sector, start_sector,
+		      "transfer %zu segment %zu: bad start", idx, sg);
+	zassert_equal(xfers[idx].sg[sg].num_sector, num_sector,
+		      "transfer %zu segment %zu: bad length", idx, sg);
+}
+
+/*
+ * The test thread is cooperative, so the requests are all queued before the
+ * disk access thread takes them in one batch.
+ */
+static void test_async_merge(void)
+{
+	async_setup();
+
+	/* adjacent on the disk and in memory: merged */
+	submit(0, DISK_REQ_WRITE, 0, 0, 2);
+	submit(1, DISK_REQ_WRITE, 2, 2, 2);
+	/* not adjacent on the disk */
+	submit(2, DISK_REQ_WRITE, 4, 10, 1);
+	/* not adjacent in memory */
+	submit(3, DISK_REQ_WRITE, 6, 11, 1);
+	/* another operation starts another transfer */
+	submit(4, DISK_REQ_READ, 0, 0, 4);
+
+	wait_completed(5);
+	for (size_t i = 0; i < 5; i++) {
+		zassert_equal(results[i], 0, "request %zu failed: %d", i,
+			      results[i]);
+	}
+
+	zassert_equal(xfer_cnt, 2, "%zu transfers", xfer_cnt);
+	xfer_check(0, DISK_REQ_WRITE, 3);
+	sg_check(0, 0, 0, 4);
+	sg_check(0, 1, 10, 1);
+	sg_check(0, 2, 11, 1);
+	xfer_check(1, DISK_REQ_READ, 1);
+	sg_check(1, 0, 0, 4);
+
+	zassert_mem_equal(rbuf, wbuf, 4 * SECTOR_SIZE, "bad data read");
+	zassert_mem_equal(storage[10], &wbuf[4 * SECTOR_SIZE], SECTOR_SIZE,
+			  "bad data written");
+	zassert_mem_equal(storage[11], &wbuf[6 * SECTOR_SIZE], SECTOR_SIZE,
+			  "bad data written");
+}
+
+static void test_async_error(void)
+{
+	struct disk_req req = { .sg = sgs, .sg_count = 1 };
+	int rc;
+
+	async_setup();
+	fail_sector = 40;
+
+	/* a failed transfer fails all the requests merged in it */
+	submit(0, DISK_REQ_WRITE, 0, 0, 1);
+	submit(1, DISK_REQ_WRITE, 1, 40, 1);
+	/* and no other */
+	submit(2, DISK_REQ_READ, 0, 41, 1);
+	submit(3, DISK_REQ_WRITE, 2, 41, 1);
+
+	wait_completed(4);
+	zassert_equal(xfer_cnt, 3, "%zu transfers", xfer_cnt);
+	zassert_equal(results[0], -EIO, "request 0: %d", results[0]);
+	zassert_equal(results[1], -EIO, "request 1: %d", results[1]);
+	zassert_equal(results[2], 0, "request 2: %d", results[2]);
+	zassert_equal(results[3], 0, "request 3: %d", results[3]);
+
+	/* invalid requests are not queued */
+	req.op = DISK_REQ_READ;
+	rc = disk_access_submit("NONE", &req);
+	zassert_equal(rc, -EINVAL, "request to a missing disk: %d", rc);
+	req.sg_count = 0;
+	rc = disk_access_submit(DISK_NAME, &req);
+	zassert_equal(rc, -EINVAL, "request without segments: %d", rc);
+	req.sg_count = 1;
+	req.op = 7;
+	rc = disk_access_submit(DISK_NAME, &req);
+	zassert_equal(rc, -EINVAL, "request of a bad operation: %d", rc);
+}
+
+/*
+ * Synchronous calls wait for the transfer the disk access thread is doing.
+ */
+static void test_async_sync_serialized(void)
+{
+	uint8_t data[SECTOR_SIZE];
+	int rc;
+
+	async_setup();
+	slow_transfer = true;
+
+	submit(0, DISK_REQ_WRITE, 0, 5, 1);
+
+	/* let the disk access thread start the transfer */
+	k_msleep(5);
+	zassert_true(transferring, "transfer not started");
+
+	/* the drivers assert that no transfer is in progress */
+	rc = disk_access_read(DISK_NAME, data, 5, 1);
+	zassert_equal(rc, 0, "can't read: %d", rc);
+	zassert_mem_equal(data, wbuf, SECTOR_SIZE, "read before the write");
+
+	rc = disk_access_write(DISK_NAME, &wbuf[SECTOR_SIZE], 6, 1);
+	zassert_equal(rc, 0, "can't write: %d", rc);
+
+	wait_completed(1);
+	zassert_equal(results[0], 0, "request 0: %d", results[0]);
+}
+
+void test_main(void)
+{
+	int rc;
+
+	rc = disk_access_register(&test_disk);
+	zassert_equal(rc, 0, "can't register the disk: %d", rc);
+
+	ztest_test_suite(disk_async,
+			 ztest_unit_test(test_async_merge),
+			 ztest_unit_test(test_async_error),
+			 ztest_unit_test(test_async_sync_serialized));
+
+	ztest_run_test_suite(disk_async);
+}
@@ -0,0 +1,270 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <string.h>
+#include <disk/disk_access.h>
+#include <ztest.h>
+
+#define DISK_NAME "CACHE"
+#define SECTOR_SIZE CONFIG_DISK_CACHE_SECTOR_SIZE
+#define SECTOR_COUNT 64
+
+static uint8_t storage[SECTOR_COUNT][SECTOR_SIZE];
+static uint8_t buf[8 * SECTOR_SIZE];
+static uint32_t disk_reads;
+static uint32_t disk_read_sectors;
+static bool write_fails;
+
+static int test_disk_init(struct disk_info *disk)
+{
+	return 0;
+}
+
+static int test_disk_status(struct disk_info *disk)
+{
+	return DISK_STATUS_OK;
+}
+
+static int test_disk_read(struct disk_info *disk, uint8_t *data_buf,
+			  uint32_t start_sector, uint32_t num_sector)
+{
+	zassert_true(start_sector + num_sector <= SECTOR_COUNT,
+		     "read of %u sectors at %u", num_sector, start_sector);
+
+	memcpy(data_buf, storage[start_sector], num_sector * SECTOR_SIZE);
+	disk_reads++;
+	disk_read_sectors += num_sector;
+
+	return 0;
+}
+
+static int test_disk_write(struct disk_info *disk, const uint8_t *data_buf,
+			   uint32_t start_sector, uint32_t num_sector)
+{
+	if (write_fails) {
+		return -EIO;
+	}
+
+	memcpy(storage[start_sector], data_buf, num_sector * SECTOR_SIZE);
+
+	return 0;
+}
+
+static int test_disk_ioctl(struct disk_info *disk, uint8_t cmd, void *buff)
+{
+	switch (cmd) {
+	case DISK_IOCTL_CTRL_SYNC:
+		break;
+	case DISK_IOCTL_GET_SECTOR_COUNT:
+		*(uint32_t *)buff = SECTOR_COUNT;
+		break;
+	case DISK_IOCTL_GET_SECTOR_SIZE:
+		*(uint32_t *)buff = SECTOR_SIZE;
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+static const struct disk_operations test_disk_ops = {
+	.init = test_disk_init,
+	.status = test_disk_status,
+	.read = test_disk_read,
+	.write = test_disk_write,
+	.ioctl = test_disk_ioctl,
+};
+
+static struct disk_info test_disk = {
+	.name = DISK_NAME,
+	.ops = &test_disk_ops,
+};
+
+static void fill_sector(uint8_t *sector, uint32_t num, uint8_t gen)
+{
+	memset(sector, (uint8_t)(num + gen), SECTOR_SIZE);
+}
+
+static void cache_setup(void)
+{
+	int rc;
+
+	for (uint32_t i = 0; i < SECTOR_COUNT; i++) {
+		fill_sector(storage[i], i, 0);
+	}
+
+	rc = disk_access_init(DISK_NAME);
+	zassert_equal(rc, 0, "can't initialize the disk: %d", rc);
+
+	disk_access_cache_invalidate();
+	disk_access_cache_stats_reset();
+	disk_reads = 0U;
+	disk_read_sectors = 0U;
+	write_fails = false;
+}
+
+static void read_check(uint32_t start, uint32_t count, uint8_t gen)
+{
+	uint8_t exp[SECTOR_SIZE];
+	int rc;
+
+	rc = disk_access_read(DISK_NAME, buf, start, count);
+	zassert_equal(rc, 0, "can't read %u sectors at %u: %d", count,
+		      start, rc);
+
+	for (uint32_t i = 0; i < count; i++) {
+		fill_sector(exp, start + i, gen);
+		zassert_mem_equal(&buf[i * SECTOR_SIZE], exp, SECTOR_SIZE,
+				  "bad data in sector %u", start + i);
+	}
+}
+
+static void stats_check(uint32_t hits, uint32_t misses, uint32_t readahead)
+{
+	struct disk_cache_stats stats;
+
+	disk_access_cache_stats_get(&stats);
+	zassert_equal(stats.hits, hits, "%u hits, expected %u", stats.hits,
+		      hits);
+	zassert_equal(stats.misses, misses, "%u misses, expected %u",
+		      stats.misses, misses);
+	zassert_equal(stats.readahead, readahead,
+		      "%u sectors read ahead, expected %u", stats.readahead,
+		      readahead);
+}
+
+static void test_cache_hit_miss(void)
+{
+	cache_setup();
+
+	read_check(10, 1, 0);
+	stats_check(0, 1, 0);
+	zassert_equal(disk_reads, 1, "%u disk reads", disk_reads);
+
+	read_check(10, 1, 0);
+	stats_check(1, 1, 0);
+	zassert_equal(disk_reads, 1, "hit read from the disk");
+
+	/* misses on both sides of a hit are read separately */
+	read_check(9, 3, 0);
+	stats_check(2, 3, 0);
+	zassert_equal(disk_reads, 3, "%u disk reads", disk_reads);
+
+	/* large reads bypass the cache */
+	read_check(30, 8, 0);
+	stats_check(2, 3, 0);
+	zassert_equal(disk_reads, 4, "%u disk reads", disk_reads);
+	read_check(30, 1, 0);
+	stats_check(2, 4, 0);
+
+	/* the least recently used sectors are evicted, the reads are not
+	 * sequential so that nothing is read ahead
+	 */
+	for (uint32_t i = 0; i < CONFIG_DISK_CACHE_SECTORS; i++) {
+		read_check(40 + 2 * i, 1, 0);
+	}
+
+	disk_reads = 0U;
+	read_check(10, 1, 0);
+	zassert_equal(disk_reads, 1, "evicted sector not read from the disk");
+	read_check(40 + 2 * (CONFIG_DISK_CACHE_SECTORS - 1), 1, 0);
+	zassert_equal(disk_reads, 1, "recent sector read from the disk");
+}
+
+static void test_cache_readahead(void)
+{
+	cache_setup();
+
+	/* the second of two sequential reads reads ahead */
+	read_check(0, 1, 0);
+	zassert_equal(disk_reads, 1, "%u disk reads", disk_reads);
+	read_check(1, 1, 0);
+	stats_check(0, 2, CONFIG_DISK_CACHE_READAHEAD);
+	zassert_equal(disk_reads, 3, "readahead not done in one read");
+
+	/* and the sectors read ahead are hits */
+	read_check(2, 2, 0);
+	stats_check(2, 2, CONFIG_DISK_CACHE_READAHEAD);
+	zassert_equal(disk_reads, 3, "sectors read ahead read again");
+
+	/* a read which is not sequential does not read ahead */
+	read_check(20, 1, 0);
+	stats_check(2, 3, CONFIG_DISK_CACHE_READAHEAD);
+	zassert_equal(disk_reads, 4, "%u disk reads", disk_reads);
+
+	/* readahead stops at the end of the disk */
+	read_check(SECTOR_COUNT - 3, 1, 0);
+	disk_read_sectors = 0U;
+	read_check(SECTOR_COUNT - 2, 1, 0);
+	zassert_equal(disk_read_sectors, 2, "%u sectors read",
+		      disk_read_sectors);
+	stats_check(2, 5, CONFIG_DISK_CACHE_READAHEAD + 1);
+
+	read_check(SECTOR_COUNT - 1, 1, 0);
+	stats_check(3, 5, CONFIG_DISK_CACHE_READAHEAD + 1);
+}
+
+static void test_cache_write(void)
+{
+	uint8_t data[SECTOR_SIZE];
+	int rc;
+
+	cache_setup();
+
+	/* a write updates the cached copy */
+	read_check(20, 1, 0);
+	fill_sector(data, 20, 1);
+	rc = disk_access_write(DISK_NAME, data, 20, 1);
+	zassert_equal(rc, 0, "can't write: %d", rc);
+	read_check(20, 1, 1);
+	stats_check(1, 1, 0);
+
+	/* a write does not add sectors to the cache */
+	fill_sector(data, 30, 1);
+	rc = disk_access_write(DISK_NAME, data, 30, 1);
+	zassert_equal(rc, 0, "can't write: %d", rc);
+	read_check(30, 1, 1);
+	stats_check(1, 2, 0);
+
+	/* a failed write drops the cached copy */
+	write_fails = true;
+	fill_sector(data, 20, 2);
+	rc = disk_access_write(DISK_NAME, data, 20, 1);
+	zassert_equal(rc, -EIO, "write did not fail: %d", rc);
+	read_check(20, 1, 1);
+	stats_check(1, 3, 0);
+
+	/* changes behind the cache are seen after invalidation only */
+	fill_sector(storage[20], 20, 3);
+	read_check(20, 1, 1);
+	disk_access_cache_invalidate();
+	read_check(20, 1, 3);
+	stats_check(2, 4, 0);
+
+	/* and after the disk is initialized again */
+	fill_sector(storage[20], 20, 4);
+	rc = disk_access_init(DISK_NAME);
+	zassert_equal(rc, 0, "can't initialize the disk: %d", rc);
+	read_check(20, 1, 4);
+	stats_check(2, 5, 0);
+}
+
+void test_main(void)
+{
+	int rc;
+
+	rc = disk_access_register(&test_disk);
+	zassert_equal(rc, 0, "can't register the disk: %d", rc);
+
+	ztest_test_suite(disk_cache,
+			 ztest_unit_test(test_cache_hit_miss),
+			 ztest_unit_test(test_cache_readahead),
+			 ztest_unit_test(test_cache_write));
+
+	ztest_run_test_suite(disk_cache);
+}
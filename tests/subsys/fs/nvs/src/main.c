@@ -190,6 +190,11 @@ void test_nvs_corrupted_write(void)
 	len = nvs_write(&fs, TEST_DATA_ID, wr_buf_2, sizeof(wr_buf_2));
 	zassert_true(len == sizeof(wr_buf_2), "nvs_write failed: %d", len);
 
+#ifdef CONFIG_NVS_GC_BACKGROUND
+	/* A reboot drops the background gc the write may have queued. */
+	(void)k_delayed_work_cancel(&fs.gc_work);
+#endif
+
 	/* Reinitialize the NVS. */
 	memset(&fs, 0, sizeof(fs));
 	test_nvs_init();
@@ -397,6 +402,62 @@ static int flash_sim_erase_calls_find(struct stats_hdr *hdr, void *arg,
 	return 0;
 }
 
+/*
+ * Test that the background garbage collection erases the oldest sector while
+ * the write sector fills, so that closing the write sector does not erase.
+ */
+void test_nvs_gc_background(void)
+{
+#ifdef CONFIG_NVS_GC_BACKGROUND
+	int err;
+	uint16_t i = 0;
+	uint32_t *flash_erase_stat;
+	uint32_t ate_wra;
+
+	const uint16_t max_id = 10;
+
+	stats_walk(sim_stats, flash_sim_erase_calls_find, &flash_erase_stat);
+
+	fs.sector_count = 4;
+
+	err = nvs_init(&fs, DT_CHOSEN_ZEPHYR_FLASH_CONTROLLER_LABEL);
+	zassert_true(err == 0,  "nvs_init call failure: %d", err);
+
+	/* Use every sector, then fill half of the write sector. */
+	do {
+		write_content(max_id, i, i + 1, &fs);
+		i++;
+	} while ((fs.ate_wra >> ADDR_SECT_SHIFT) != fs.sector_count - 1);
+
+	do {
+		write_content(max_id, i, i + 1, &fs);
+		i++;
+	} while ((fs.ate_wra >> ADDR_SECT_SHIFT) != 0 ||
+		 fs.ate_wra - fs.data_wra > fs.sector_size / 2);
+
+	/* Let the system work queue collect the oldest sector. */
+	k_sleep(K_MSEC(100));
+	zassert_equal(fs.gc_erased, 2, "background gc did not complete");
+	check_content(max_id, &fs);
+
+	*flash_erase_stat = 0;
+	ate_wra = fs.ate_wra;
+	while ((fs.ate_wra >> ADDR_SECT_SHIFT) == (ate_wra >> ADDR_SECT_SHIFT)) {
+		write_content(max_id, i, i + 1, &fs);
+		i++;
+	}
+
+	zassert_equal(*flash_erase_stat, 0, "sector erased by a write");
+	check_content(max_id, &fs);
+
+	err = nvs_init(&fs, DT_CHOSEN_ZEPHYR_FLASH_CONTROLLER_LABEL);
+	zassert_true(err == 0,  "nvs_init call failure: %d", err);
+	check_content(max_id, &fs);
+#else
+	ztest_test_skip();
+#endif
+}
+
 static int flash_sim_max_erase_calls_find(struct stats_hdr *hdr, void *arg,
 					  const char *name, uint16_t off)
 {
@@ -597,6 +658,141 @@ void test_delete(void)
 		     " any footprint in the storage");
 }
 
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+static int lookup_slot_find(uint16_t id)
+{
+	for (int i = 0; i < CONFIG_NVS_LOOKUP_CACHE_SIZE; i++) {
+		if ((fs.lookup_addr[i] != NVS_LOOKUP_EMPTY) &&
+		    (fs.lookup_id[i] == id)) {
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+#define LOOKUP_MAX_ID 10
+#define LOOKUP_DELETED 0xffffffff
+
+static uint32_t lookup_expected[LOOKUP_MAX_ID];
+
+static void lookup_write(uint16_t id, uint32_t data)
+{
+	ssize_t len;
+	int err;
+
+	if (data == LOOKUP_DELETED) {
+		err = nvs_delete(&fs, id);
+		zassert_true(err == 0,  "nvs_delete call failure: %d", err);
+	} else {
+		len = nvs_write(&fs, id, &data, sizeof(data));
+		zassert_true(len == sizeof(data), "nvs_write failed: %d", len);
+	}
+	lookup_expected[id] = data;
+}
+
+static void check_lookup_content(void)
+{
+	uint32_t data;
+	ssize_t len;
+
+	for (uint16_t id = 0; id < LOOKUP_MAX_ID; id++) {
+		len = nvs_read(&fs, id, &data, sizeof(data));
+		if (lookup_expected[id] == LOOKUP_DELETED) {
+			zassert_true(len == -ENOENT,
+				     "nvs_read shouldn't found the entry: %d",
+				     len);
+			continue;
+		}
+
+		zassert_true(len == sizeof(data),
+			     "nvs_read unexpected failure: %d", len);
+		zassert_equal(data, lookup_expected[id],
+			      "id %d: unexpected value %d", id, data);
+	}
+}
+#endif
+
+/*
+ * Test that reads seeded from the lookup cache return the latest entry,
+ * also after deletes and after garbage collection moved the entries, and
+ * that a stale cache entry is detected and the full walk is used instead.
+ */
+void test_nvs_lookup_cache(void)
+{
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+	int err;
+	ssize_t len;
+	uint32_t data;
+	uint32_t i;
+	uint16_t wraps;
+	uint32_t ate_wra, stale_addr;
+	int slot;
+
+	fs.sector_count = 3;
+
+	err = nvs_init(&fs, DT_CHOSEN_ZEPHYR_FLASH_CONTROLLER_LABEL);
+	zassert_true(err == 0,  "nvs_init call failure: %d", err);
+
+	for (uint16_t id = 0; id < LOOKUP_MAX_ID; id++) {
+		lookup_write(id, id);
+	}
+
+	/* cache hits, including the history behind a cached entry */
+	lookup_write(0, 100);
+
+	len = nvs_read_hist(&fs, 0, &data, sizeof(data), 1);
+	zassert_true(len == sizeof(data), "nvs_read_hist failure: %d", len);
+	zassert_equal(data, 0, "unexpected history value %d", data);
+
+	lookup_write(1, LOOKUP_DELETED);
+	check_lookup_content();
+
+	/* overwrite id 2 until every sector has been garbage collected */
+	i = 0;
+	wraps = 0;
+	ate_wra = fs.ate_wra;
+	while (wraps <= fs.sector_count) {
+		lookup_write(2, ++i);
+		if ((fs.ate_wra >> ADDR_SECT_SHIFT) !=
+		    (ate_wra >> ADDR_SECT_SHIFT)) {
+			wraps++;
+			ate_wra = fs.ate_wra;
+		}
+	}
+
+	check_lookup_content();
+
+	/* Make the entries of id 3 and of the deleted id 1 point at an ate
+	 * of id 4 that is older than their latest ate, the reads must notice
+	 * and walk the ate's instead.
+	 */
+	slot = lookup_slot_find(4);
+	zassert_true(slot >= 0, "id 4 missing from the cache");
+	stale_addr = fs.lookup_addr[slot];
+
+	lookup_write(3, 103);
+	lookup_write(1, 101);
+	lookup_write(1, LOOKUP_DELETED);
+
+	slot = lookup_slot_find(3);
+	zassert_true(slot >= 0, "id 3 missing from the cache");
+	fs.lookup_addr[slot] = stale_addr;
+
+	slot = lookup_slot_find(1);
+	zassert_true(slot >= 0, "id 1 missing from the cache");
+	fs.lookup_addr[slot] = stale_addr;
+
+	check_lookup_content();
+
+	err = nvs_init(&fs, DT_CHOSEN_ZEPHYR_FLASH_CONTROLLER_LABEL);
+	zassert_true(err == 0,  "nvs_init call failure: %d", err);
+	check_lookup_content();
+#else
+	ztest_test_skip();
+#endif
+}
+
 /*
  * Test that garbage-collection can recover all ate's even when the last ate,
  * ie close_ate, is corrupt. In this test the close_ate is set to point to the
@@ -714,6 +910,196 @@ void test_nvs_gc_corrupt_ate(void)
 	zassert_true(err == 0,  "nvs_init call failure: %d", err);
 }
 
+static int flash_sim_read_calls_find(struct stats_hdr *hdr, void *arg,
+				     const char *name, uint16_t off)
+{
+	if (!strcmp(name, "flash_read_calls")) {
+		uint32_t **flash_read_stat = (uint32_t **) arg;
+		*flash_read_stat = (uint32_t *)((uint8_t *)hdr + off);
+	}
+
+	return 0;
+}
+
+/*
+ * Test that lookups skip the closed sectors whose summary rules out the id,
+ * without missing entries behind them.
+ */
+void test_nvs_sector_summary(void)
+{
+#ifdef CONFIG_NVS_SECTOR_SUMMARY
+	int err;
+	ssize_t len;
+	uint32_t data;
+	uint32_t i = 0;
+	uint32_t *flash_read_stat;
+	const uint32_t ate_size = sizeof(struct nvs_ate);
+
+	stats_walk(sim_stats, flash_sim_read_calls_find, &flash_read_stat);
+
+	fs.sector_count = 4;
+
+	err = nvs_init(&fs, DT_CHOSEN_ZEPHYR_FLASH_CONTROLLER_LABEL);
+	zassert_true(err == 0,  "nvs_init call failure: %d", err);
+
+	data = 0x1234;
+	len = nvs_write(&fs, 1, &data, sizeof(data));
+	zassert_true(len == sizeof(data), "nvs_write failed: %d", len);
+
+	/* close sector 0 and sector 1, which hold id 2 only */
+	while ((fs.ate_wra >> ADDR_SECT_SHIFT) != 2U) {
+		data = ++i;
+		len = nvs_write(&fs, 2, &data, sizeof(data));
+		zassert_true(len == sizeof(data), "nvs_write failed: %d", len);
+	}
+
+	for (int pass = 0; pass < 2; pass++) {
+		/* a missing id only costs the close ate and the summary of
+		 * each closed sector
+		 */
+		*flash_read_stat = 0;
+		len = nvs_read(&fs, 5, &data, sizeof(data));
+		zassert_true(len == -ENOENT, "nvs_read should fail: %d", len);
+		zassert_true(*flash_read_stat < fs.sector_size / ate_size / 4,
+			     "%u flash reads for a missing id",
+			     *flash_read_stat);
+
+		len = nvs_read(&fs, 1, &data, sizeof(data));
+		zassert_true(len == sizeof(data),
+			     "nvs_read unexpected failure: %d", len);
+		zassert_equal(data, 0x1234, "unexpected value %d", data);
+
+		len = nvs_read(&fs, 2, &data, sizeof(data));
+		zassert_true(len == sizeof(data),
+			     "nvs_read unexpected failure: %d", len);
+		zassert_equal(data, i, "unexpected value %d", data);
+
+		/* the summaries are read from flash */
+		err = nvs_init(&fs, DT_CHOSEN_ZEPHYR_FLASH_CONTROLLER_LABEL);
+		zassert_true(err == 0,  "nvs_init call failure: %d", err);
+	}
+#else
+	ztest_test_skip();
+#endif
+}
+
+#ifdef CONFIG_NVS_SECTOR_SUMMARY
+/*
+ * Write sector 0 with an entry of id 1 and a summary whose filter rules out
+ * every id, then close sector 1 without a summary.
+ */
+static void sum_sectors_write(const struct device *flash_dev,
+			      uint8_t version, uint8_t bloom_size)
+{
+	const size_t ate_size = sizeof(struct nvs_ate);
+	size_t sum_size = ROUND_UP(sizeof(struct nvs_sector_sum),
+		flash_get_parameters(flash_dev)->write_block_size);
+	uint8_t sum_buf[ROUND_UP(sizeof(struct nvs_sector_sum), 8)];
+	struct nvs_sector_sum *sum = (struct nvs_sector_sum *)sum_buf;
+	struct nvs_ate ate, close_ate;
+	uint32_t data = 0xaa55aa55;
+	int err;
+
+	for (int i = 0; i < 4; i++) {
+		err = flash_erase(flash_dev, fs.offset + i * fs.sector_size,
+				  fs.sector_size);
+		zassert_true(err == 0,  "flash_erase failed: %d", err);
+	}
+
+	(void)memset(sum_buf, 0xff, sizeof(sum_buf));
+	sum->version = version;
+	sum->bloom_size = bloom_size;
+	sum->ate_cnt = 1;
+	(void)memset(sum->bloom, 0, sizeof(sum->bloom));
+	sum->crc8 = crc8_ccitt(0xff, sum,
+			       offsetof(struct nvs_sector_sum, crc8));
+
+	ate.id = 1;
+	ate.offset = 0;
+	ate.len = sizeof(data);
+	ate.part = 0xff;
+	ate.crc8 = crc8_ccitt(0xff, &ate, offsetof(struct nvs_ate, crc8));
+
+	close_ate.id = 0xffff;
+	close_ate.offset = fs.sector_size - 2 * ate_size;
+	close_ate.len = sizeof(data) + sum_size;
+	close_ate.part = 0xff;
+	close_ate.crc8 = crc8_ccitt(0xff, &close_ate,
+				    offsetof(struct nvs_ate, crc8));
+
+	err = flash_write(flash_dev, fs.offset, &data, sizeof(data));
+	zassert_true(err == 0,  "flash_write failed: %d", err);
+	err = flash_write(flash_dev, fs.offset + sizeof(data), sum_buf,
+			  sum_size);
+	zassert_true(err == 0,  "flash_write failed: %d", err);
+	err = flash_write(flash_dev, fs.offset + fs.sector_size -
+			  2 * ate_size, &ate, sizeof(ate));
+	zassert_true(err == 0,  "flash_write failed: %d", err);
+	err = flash_write(flash_dev, fs.offset + fs.sector_size - ate_size,
+			  &close_ate, sizeof(close_ate));
+	zassert_true(err == 0,  "flash_write failed: %d", err);
+
+	close_ate.len = 0;
+	close_ate.crc8 = crc8_ccitt(0xff, &close_ate,
+				    offsetof(struct nvs_ate, crc8));
+	err = flash_write(flash_dev, fs.offset + 2 * fs.sector_size -
+			  ate_size, &close_ate, sizeof(close_ate));
+	zassert_true(err == 0,  "flash_write failed: %d", err);
+}
+#endif
+
+/*
+ * Test that a summary written with another layout version or filter size is
+ * not trusted, even though its crc8 is valid.
+ */
+void test_nvs_sector_summary_invalid(void)
+{
+#if defined(CONFIG_NVS_SECTOR_SUMMARY) && !defined(CONFIG_NVS_LOOKUP_CACHE)
+	const struct device *flash_dev;
+	uint32_t data;
+	ssize_t len;
+	int err;
+
+	flash_dev = device_get_binding(DT_CHOSEN_ZEPHYR_FLASH_CONTROLLER_LABEL);
+	zassert_true(flash_dev != NULL,  "device_get_binding failure");
+
+	fs.sector_count = 4;
+
+	flash_write_protection_set(flash_dev, false);
+
+	/* a valid summary hides id 1, as its filter rules it out */
+	sum_sectors_write(flash_dev, NVS_SUM_VERSION,
+			  CONFIG_NVS_SECTOR_SUMMARY_BLOOM_SIZE);
+	err = nvs_init(&fs, DT_CHOSEN_ZEPHYR_FLASH_CONTROLLER_LABEL);
+	zassert_true(err == 0,  "nvs_init call failure: %d", err);
+	len = nvs_read(&fs, 1, &data, sizeof(data));
+	zassert_true(len == -ENOENT, "summary not used: %d", len);
+
+	/* summaries of another version or filter size are ignored */
+	sum_sectors_write(flash_dev, NVS_SUM_VERSION + 1,
+			  CONFIG_NVS_SECTOR_SUMMARY_BLOOM_SIZE);
+	err = nvs_init(&fs, DT_CHOSEN_ZEPHYR_FLASH_CONTROLLER_LABEL);
+	zassert_true(err == 0,  "nvs_init call failure: %d", err);
+	data = 0;
+	len = nvs_read(&fs, 1, &data, sizeof(data));
+	zassert_true(len == sizeof(data), "nvs_read failure: %d", len);
+	zassert_equal(data, 0xaa55aa55, "unexpected value %d", data);
+
+	sum_sectors_write(flash_dev, NVS_SUM_VERSION,
+			  CONFIG_NVS_SECTOR_SUMMARY_BLOOM_SIZE + 1);
+	err = nvs_init(&fs, DT_CHOSEN_ZEPHYR_FLASH_CONTROLLER_LABEL);
+	zassert_true(err == 0,  "nvs_init call failure: %d", err);
+	data = 0;
+	len = nvs_read(&fs, 1, &data, sizeof(data));
+	zassert_true(len == sizeof(data), "nvs_read failure: %d", len);
+	zassert_equal(data, 0xaa55aa55, "unexpected value %d", data);
+
+	flash_write_protection_set(flash_dev, true);
+#else
+	ztest_test_skip();
+#endif
+}
+
 void test_main(void)
 {
 	ztest_test_suite(test_nvs,
@@ -737,7 +1123,15 @@ void test_main(void)
 			 ztest_unit_test_setup_teardown(
 				 test_nvs_gc_corrupt_close_ate, setup, teardown),
 			 ztest_unit_test_setup_teardown(
-				 test_nvs_gc_corrupt_ate, setup, teardown)
+				 test_nvs_gc_corrupt_ate, setup, teardown),
+			 ztest_unit_test_setup_teardown(
+				 test_nvs_gc_background, setup, teardown),
+			 ztest_unit_test_setup_teardown(
+				 test_nvs_lookup_cache, setup, teardown),
+			 ztest_unit_test_setup_teardown(
+				 test_nvs_sector_summary, setup, teardown),
+			 ztest_unit_test_setup_teardown(
+				 test_nvs_sector_summary_invalid, setup, teardown)
 			);
 
 	ztest_run_test_suite(test_nvs);
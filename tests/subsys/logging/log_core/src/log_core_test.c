@@ -265,6 +265,51 @@ static void test_log_overflow(void)
 		      "Unexpected amount of messages received by the backend.");
 }
 
+static void log_flood_cb(struct log_backend const *const backend,
+			 struct log_msg *msg, size_t counter)
+{
+	uint32_t msgs_in_buf = CONFIG_LOG_BUFFER_SIZE/sizeof(union log_msg_chunk);
+
+	if (counter == 0) {
+		for (int i = 0; i < msgs_in_buf; i++) {
+			LOG_INF("test");
+		}
+	}
+}
+
+/*
+ * Test checks that messages logged while a message is being processed drop
+ * the oldest messages on overflow, as they do when nothing is processed.
+ */
+static void test_log_overflow_while_processing(void)
+{
+	uint32_t msgs_in_buf = CONFIG_LOG_BUFFER_SIZE/sizeof(union log_msg_chunk);
+
+	log_setup(false);
+	backend1_cb.check_timestamp = true;
+	backend1_cb.callback = log_flood_cb;
+
+	/* The backend holds the first message while the buffer is flooded,
+	 * which drops the second message and the first flooding one.
+	 */
+	backend1_cb.exp_timestamps[0] = 0U;
+	for (int i = 1; i < msgs_in_buf; i++) {
+		backend1_cb.exp_timestamps[i] = i + 2;
+	}
+
+	LOG_INF("test");
+	LOG_INF("test");
+
+	while (log_process(false)) {
+	}
+
+	zassert_equal(msgs_in_buf,
+		      backend1_cb.counter,
+		      "Unexpected amount of messages received by the backend.");
+	zassert_equal(2, backend1_cb.total_drops,
+		      "Unexpected amount of dropped messages.");
+}
+
 /*
  * Test checks if arguments are correctly processed by the logger.
  *
@@ -493,9 +538,20 @@ static void test_z_log_get_s_mask(void)
 				     "%d%d%d%d%d%d%d%d%d%d%d%d%d%d%d%s",
 				     32, 0x80000000);
 }
+static void log_panic_cb(struct log_backend const *const backend,
+			 struct log_msg *msg, size_t counter)
+{
+	if (!in_panic) {
+		in_panic = true;
+		log_panic();
+	}
+}
+
 /*
  * Test checks if panic is correctly executed. On panic logger should flush all
- * messages and process logs in place (not in deferred way).
+ * messages and process logs in place (not in deferred way). Panic is raised
+ * while the first message is being processed, as when a fault interrupts the
+ * logging thread.
  *
  * NOTE: this test must be the last in the suite because after this test log
  * is in panic mode.
@@ -503,25 +559,27 @@ static void test_z_log_get_s_mask(void)
 static void test_log_panic(void)
 {
 	log_setup(false);
+	backend1_cb.callback = log_panic_cb;
 
+	LOG_INF("test");
 	LOG_INF("test");
 	LOG_INF("test");
 
 	/* logs should be flushed in panic */
-	log_panic();
-	in_panic = true;
+	(void)log_process(false);
 
+	zassert_true(in_panic, "Expecting panic raised by the backend.");
 	zassert_true(backend1_cb.panic,
 		     "Expecting backend to receive panic notification.");
 
-	zassert_equal(2,
+	zassert_equal(3,
 		      backend1_cb.counter,
 		      "Unexpected amount of messages received by the backend.");
 
 	/* messages processed where called */
 	LOG_INF("test");
 
-	zassert_equal(3,
+	zassert_equal(4,
 		      backend1_cb.counter,
 		      "Unexpected amount of messages received by the backend.");
 }
@@ -532,6 +590,7 @@ void test_main(void)
 	ztest_test_suite(test_log_list,
 			 ztest_unit_test(test_log_backend_runtime_filtering),
 			 ztest_unit_test(test_log_overflow),
+			 ztest_unit_test(test_log_overflow_while_processing),
 			 ztest_unit_test(test_log_arguments),
 			 ztest_unit_test(test_log_from_declared_module),
 			 ztest_unit_test(test_log_strdup_gc),
@@ -146,6 +146,104 @@ void test_log_output_string(void)
 	validate_output_string(exp_str_no_crlf);
 }
 
+static void dict_append(uint8_t *buf, uint32_t *len, const void *data,
+			size_t size)
+{
+	memcpy(&buf[*len], data, size);
+	*len += size;
+}
+
+void test_log_output_dict(void)
+{
+	static const char fmt[] = "abc %d %s";
+	static const char fmt_max[] = "%d %d %d %d %d %d %d %d %d %d %d %d %d %d %d";
+	char str[] = "efg";
+	struct log_msg_ids src_level = {
+		.level = LOG_LEVEL_INF,
+		.source_id = log_const_source_id(
+				&LOG_ITEM_CONST_DATA(LOG_MODULE_NAME)),
+		.domain_id = CONFIG_LOG_DOMAIN_ID,
+	};
+	uint16_t ids = src_level.level | (src_level.domain_id << 3) |
+		       (src_level.source_id << 6);
+	uint32_t timestamp = 123456;
+	log_arg_t args[] = { 1, (log_arg_t)str };
+	log_arg_t addr = (log_arg_t)fmt;
+	uint8_t nargs = ARRAY_SIZE(args);
+	uint16_t copied = BIT(1);
+	uint32_t dropped = 7;
+	log_arg_t args_max[LOG_MAX_NARGS];
+	log_arg_t addr_max = (log_arg_t)fmt_max;
+	uint8_t nargs_max = LOG_MAX_NARGS;
+	uint16_t copied_max = 0U;
+	uint8_t exp[192];
+	uint32_t exp_len = 0;
+	uint8_t type;
+
+	if (!IS_ENABLED(CONFIG_LOG_DICTIONARY_SUPPORT)) {
+		ztest_test_skip();
+		return;
+	}
+
+	/* Standard message, the string on the stack is copied */
+	type = 1;
+	dict_append(exp, &exp_len, &type, sizeof(type));
+	dict_append(exp, &exp_len, &ids, sizeof(ids));
+	dict_append(exp, &exp_len, &timestamp, sizeof(timestamp));
+	dict_append(exp, &exp_len, &addr, sizeof(addr));
+	dict_append(exp, &exp_len, &nargs, sizeof(nargs));
+	dict_append(exp, &exp_len, &copied, sizeof(copied));
+	dict_append(exp, &exp_len, args, sizeof(args));
+	dict_append(exp, &exp_len, str, sizeof(str));
+
+	log_output_string_varg(&log_output, src_level, timestamp,
+			       LOG_OUTPUT_FLAG_FORMAT_DICT, fmt, 1, str);
+	zassert_equal(exp_len, mock_len, "Unexpected record length");
+	zassert_equal(0, memcmp(exp, mock_buffer, mock_len),
+		      "Unexpected record");
+
+	reset_mock_buffer();
+
+	/* Standard message with the largest number of arguments */
+	BUILD_ASSERT(LOG_MAX_NARGS == 15, "fmt_max has 15 arguments");
+	for (int i = 0; i < LOG_MAX_NARGS; i++) {
+		args_max[i] = i;
+	}
+
+	exp_len = 0;
+	dict_append(exp, &exp_len, &type, sizeof(type));
+	dict_append(exp, &exp_len, &ids, sizeof(ids));
+	dict_append(exp, &exp_len, &timestamp, sizeof(timestamp));
+	dict_append(exp, &exp_len, &addr_max, sizeof(addr_max));
+	dict_append(exp, &exp_len, &nargs_max, sizeof(nargs_max));
+	dict_append(exp, &exp_len, &copied_max, sizeof(copied_max));
+	dict_append(exp, &exp_len, args_max, sizeof(args_max));
+
+	log_output_string_varg(&log_output, src_level, timestamp,
+			       LOG_OUTPUT_FLAG_FORMAT_DICT, fmt_max,
+			       args_max[0], args_max[1], args_max[2],
+			       args_max[3], args_max[4], args_max[5],
+			       args_max[6], args_max[7], args_max[8],
+			       args_max[9], args_max[10], args_max[11],
+			       args_max[12], args_max[13], args_max[14]);
+	zassert_equal(exp_len, mock_len, "Unexpected record length");
+	zassert_equal(0, memcmp(exp, mock_buffer, mock_len),
+		      "Unexpected record");
+
+	reset_mock_buffer();
+
+	/* Dropped messages indication */
+	exp_len = 0;
+	type = 3;
+	dict_append(exp, &exp_len, &type, sizeof(type));
+	dict_append(exp, &exp_len, &dropped, sizeof(dropped));
+
+	log_output_dropped_dict_process(&log_output, dropped);
+	zassert_equal(exp_len, mock_len, "Unexpected record length");
+	zassert_equal(0, memcmp(exp, mock_buffer, mock_len),
+		      "Unexpected record");
+}
+
 /*test case main entry*/
 void test_main(void)
 {
@@ -153,6 +251,8 @@ void test_main(void)
 		ztest_unit_test_setup_teardown(test_log_output_raw_string,
 					       setup, teardown),
 		ztest_unit_test_setup_teardown(test_log_output_string,
+					       setup, teardown),
+		ztest_unit_test_setup_teardown(test_log_output_dict,
 					       setup, teardown)
 		);
 	ztest_run_test_suite(test_log_message);
@@ -462,6 +462,86 @@ static void test_direct_loading(void)
 	zassert_equal(23, val_directly_loaded, NULL);
 }
 
+static void test_transaction(void)
+{
+#if defined(CONFIG_SETTINGS_TRANSACTION)
+	static uint8_t big[CONFIG_SETTINGS_TRANSACTION_BUF_SIZE];
+	int rc;
+	uint8_t val;
+
+	/* Staging needs a transaction */
+	val = 1;
+	rc = settings_save_stage("val/1", &val, sizeof(val));
+	zassert_equal(rc, -EINVAL, NULL);
+
+	rc = settings_save_begin();
+	zassert_equal(rc, 0, NULL);
+	rc = settings_save_begin();
+	zassert_equal(rc, -EBUSY, "transactions nested");
+
+	/* Only the value staged last is written */
+	val = 41;
+	rc = settings_save_stage("val/1", &val, sizeof(val));
+	zassert_equal(rc, 0, NULL);
+	val = 42;
+	rc = settings_save_stage("val/2", &val, sizeof(val));
+	zassert_equal(rc, 0, NULL);
+	val = 43;
+	rc = settings_save_stage("val/1", &val, sizeof(val));
+	zassert_equal(rc, 0, NULL);
+
+	rc = settings_save_stage("val/3", big, sizeof(big));
+	zassert_equal(rc, -ENOMEM, "staging buffer overflowed");
+
+	rc = settings_save_commit();
+	zassert_equal(rc, 0, NULL);
+
+	memset(&data, 0, sizeof(data));
+	rc = settings_load();
+	zassert_true(rc == 0, NULL);
+	zassert_equal(43, data.val1, NULL);
+	zassert_equal(42, data.val2, NULL);
+	zassert_equal(35, data.val3, NULL);
+
+	/* Nothing staged in an aborted transaction is written */
+	rc = settings_save_begin();
+	zassert_equal(rc, 0, NULL);
+	val = 99;
+	rc = settings_save_stage("val/3", &val, sizeof(val));
+	zassert_equal(rc, 0, NULL);
+	rc = settings_save_stage("val/2", NULL, 0);
+	zassert_equal(rc, 0, NULL);
+	settings_save_abort();
+
+	rc = settings_save_commit();
+	zassert_equal(rc, -EINVAL, "commit after abort");
+
+	memset(&data, 0, sizeof(data));
+	rc = settings_load();
+	zassert_true(rc == 0, NULL);
+	zassert_equal(43, data.val1, NULL);
+	zassert_equal(42, data.val2, NULL);
+	zassert_equal(35, data.val3, NULL);
+
+	/* Deletions are staged too */
+	rc = settings_save_begin();
+	zassert_equal(rc, 0, NULL);
+	rc = settings_save_stage("val/2", NULL, 0);
+	zassert_equal(rc, 0, NULL);
+	rc = settings_save_commit();
+	zassert_equal(rc, 0, NULL);
+
+	memset(&data, 0, sizeof(data));
+	rc = settings_load();
+	zassert_true(rc == 0, NULL);
+	zassert_equal(43, data.val1, NULL);
+	zassert_equal(0, data.val2, NULL);
+	zassert_equal(35, data.val3, NULL);
+#else
+	ztest_test_skip();
+#endif
+}
+
 struct test_loading_data {
 	const char *n;
 	const char *v;
@@ -614,6 +694,7 @@ void test_main(void)
 			 ztest_unit_test(test_support_rtn),
 			 ztest_unit_test(test_register_and_loading),
 			 ztest_unit_test(test_direct_loading),
+			 ztest_unit_test(test_transaction),
 			 ztest_unit_test(test_direct_loading_filter)
 			);
 
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <storage/flash_map.h>
+
+#include "settings_priv.h"
+#include "settings/settings_nvs.h"
+#include "settings_test.h"
+
+#define NAME_ID(n) (NVS_NAMECNT_ID + (n))
+
+static struct settings_nvs cf;
+
+static void ids_backend_init(void)
+{
+	int rc;
+
+	rc = settings_nvs_backend_init(&cf);
+	zassert_equal(rc, 0, "can't initialize the NVS backend: %d", rc);
+}
+
+static void ids_save(const char *name, uint8_t val)
+{
+	int rc;
+
+	rc = cf.cf_store.cs_itf->csi_save(&cf.cf_store, name, &val,
+					  val ? sizeof(val) : 0);
+	zassert_equal(rc, 0, "can't save %s: %d", name, rc);
+}
+
+static void ids_check(uint16_t name_id, const char *name, uint8_t val)
+{
+	char rdname[16];
+	uint8_t rdval;
+	ssize_t rc;
+
+	rc = nvs_read(&cf.cf_nvs, name_id, rdname, sizeof(rdname));
+	zassert_equal(rc, strlen(name), "bad name length of %x: %d",
+		      name_id, rc);
+	zassert_mem_equal(rdname, name, rc, "%x is not %s", name_id, name);
+
+	rc = nvs_read(&cf.cf_nvs, name_id + NVS_NAME_ID_OFFSET, &rdval,
+		      sizeof(rdval));
+	zassert_equal(rc, sizeof(rdval), "no value for %s: %d", name, rc);
+	zassert_equal(rdval, val, "bad value of %s: %d", name, rdval);
+}
+
+/*
+ * Test that saves use the name ID a setting is stored under, that new
+ * names take the lowest free name ID and that both hold right after the
+ * backend is initialized, before any settings_load().
+ */
+void test_settings_nvs_name_ids(void)
+{
+	const struct flash_area *fa;
+	struct flash_sector sector;
+	uint32_t sector_cnt = 1;
+	uint8_t val;
+	int rc;
+
+	rc = flash_area_open(FLASH_AREA_ID(storage), &fa);
+	zassert_equal(rc, 0, "can't open the storage area: %d", rc);
+
+	rc = flash_area_get_sectors(FLASH_AREA_ID(storage), &sector_cnt,
+				    &sector);
+	zassert_true(rc == 0 || rc == -ENOMEM, "can't get sectors: %d", rc);
+
+	rc = flash_area_erase(fa, 0, fa->fa_size);
+	zassert_equal(rc, 0, "can't erase the storage area: %d", rc);
+
+	cf.cf_nvs.sector_size = sector.fs_size;
+	cf.cf_nvs.sector_count = MIN(CONFIG_SETTINGS_NVS_SECTOR_COUNT,
+				     fa->fa_size / sector.fs_size);
+	cf.cf_nvs.offset = fa->fa_off;
+	cf.flash_dev_name = fa->fa_dev_name;
+
+	ids_backend_init();
+	settings_nvs_dst(&cf);
+
+	ids_save("t/a", 1);
+	ids_save("t/b", 2);
+	ids_save("t/c", 3);
+	ids_check(NAME_ID(1), "t/a", 1);
+	ids_check(NAME_ID(2), "t/b", 2);
+	ids_check(NAME_ID(3), "t/c", 3);
+
+	/* a deleted name frees its ID for the next new name */
+	ids_save("t/b", 0);
+	zassert_equal(nvs_read(&cf.cf_nvs, NAME_ID(2), &val, sizeof(val)),
+		      -ENOENT, "t/b not deleted");
+	ids_save("t/d", 4);
+	ids_check(NAME_ID(2), "t/d", 4);
+	zassert_equal(cf.last_name_id, NAME_ID(3), "bad last name ID");
+
+	/* the stored names are known again right after initialization */
+	ids_backend_init();
+	ids_save("t/a", 5);
+	ids_check(NAME_ID(1), "t/a", 5);
+
+	ids_save("t/c", 0);
+	ids_save("t/e", 6);
+	ids_check(NAME_ID(3), "t/e", 6);
+
+	ids_save("t/f", 7);
+	ids_check(NAME_ID(4), "t/f", 7);
+	zassert_equal(cf.last_name_id, NAME_ID(4), "bad last name ID");
+
+	/* and survive a reload of the backend */
+	ids_backend_init();
+	zassert_equal(cf.last_name_id, NAME_ID(4), "bad last name ID");
+	ids_check(NAME_ID(1), "t/a", 5);
+	ids_check(NAME_ID(2), "t/d", 4);
+	ids_check(NAME_ID(3), "t/e", 6);
+	ids_check(NAME_ID(4), "t/f", 7);
+}